@@ -1,13 +1,31 @@
 #include "OpenGL/OpenGLException.hpp"
 #include "Avatar/Animal.hpp"
+#include "Model/TextureFactory.hpp"
+#include "Scene/Components.hpp"
+#include "Utils/Math/Bounds.hpp"
+#include "Utils/Math/EulerTransform.hpp"
+#include "Utils/Math/Frustum.hpp"
 #include "Utils/Model/ModelAdder.hpp"
 #include "Utils/Model/ShaderAdder.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 #include "Utils/StringFormat/StringFormat.hpp"
 #include "Animal.hpp"
 
+#include "glm/gtc/constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
 Animal::Animal(){
+    skeleton_ = &humanSkeleton_;
     isHumanForm_ = true;
     transformationProgress_ = 0.0f;
+    previousProgress_ = 0.0f;
+    drawnProgress_ = 0.0f;
+    walking_ = false;
+    gesturing_ = false;
+    animating_ = false;
     create();
 }
 
@@ -18,288 +36,844 @@ Animal::~Animal(){
 }
 
 void Animal::create(){
+    PROGRAM_TRACE_SCOPE("loading", "Animal::create");
+
     ShaderAdder::addShader(vertexShader.c_str(), fragmentShader.c_str(), nullptr, shaders_);
+    skinnedShader_ = ShaderAdder::addShader(skinnedVertexShader.c_str(), fragmentShader.c_str(), nullptr, shaders_);
+    if (!skinnedShader_) {
+        throw OpenGL::OpenGLException("Animal: Failed to create skinned shader");
+    }
    
-    humanRootJoint_ = createBoneHierarchy();
-    pigRootJoint_ = createPigBoneHierarchy();
+    createBoneHierarchy();
+    createPigBoneHierarchy();
+
+    createMorph();
+
+    humanSkin_ = createSkin(humanSkeleton_);
+    pigSkin_ = createSkin(pigSkeleton_);
+
+    humanGesture_ = createAnimation(humanSkeleton_, humanGraph_);
+    pigGesture_ = createAnimation(pigSkeleton_, pigGraph_);
+    // The pose each graph rests in as its clips store it, which only
+    // approximate the skeleton's
+    const std::pair<const AnimationGraph *, Pose *> rests[] = {
+        {&humanGraph_, &humanRest_}, {&pigGraph_, &pigRest_}};
+    for (const auto &rest : rests) {
+        AnimationGraph::Instance instance = rest.first->createInstance();
+        Pose *pose = rest.first->evaluate(instance, posePool_);
+        *rest.second = *pose;
+        posePool_.release(pose);
+    }
+    humanAnimation_ = humanGraph_.createInstance();
+    pigAnimation_ = pigGraph_.createInstance();
+
+    skeleton_ = &humanSkeleton_;
+}
+
+void Animal::createMorph() {
+    // Human joints and the pig joints they turn into. Hands and feet shrink
+    // away, the snout, ears and tail grow out of nothing
+    const MorphCorrespondence::NamePair names[] = {
+        {"torso", "pigTorso"},
+        {"head", "pigHead"},
+        {"leftShoulder", "frontLeftLeg"},
+        {"leftArm", "frontLeftFoot"},
+        {"rightShoulder", "frontRightLeg"},
+        {"rightArm", "frontRightFoot"},
+        {"leftHip", "hindLeftLeg"},
+        {"leftLeg", "hindLeftFoot"},
+        {"rightHip", "hindRightLeg"},
+        {"rightLeg", "hindRightFoot"},
+    };
+
+    morph_.build(humanSkeleton_, pigSkeleton_, names, sizeof(names) / sizeof(names[0]));
+    createShapeMorphs();
+
+    const size_t pairCount = morph_.size();
+    morphTransforms_.resize(pairCount);
+    morphOffsets_.resize(pairCount);
+    morphRotations_.resize(pairCount);
+    morphSizes_.resize(pairCount);
+}
+
+void Animal::createShapeMorphs() {
+    PROGRAM_TRACE_SCOPE("loading", "Animal::createShapeMorphs");
+
+    // A pair turning a cube into a sphere draws the sphere all along, blending
+    // from the cube's surface on the GPU instead of swapping meshes halfway
+    for (size_t i = 0; i < morph_.size(); i++) {
+        const MorphCorrespondence::Pair &pair = morph_.pair(i);
+        if (pair.first == MorphCorrespondence::Missing || pair.second == MorphCorrespondence::Missing) {
+            continue;
+        }
+
+        Model::Mesh *first = humanSkeleton_.model(pair.first);
+        Model::Mesh *second = pigSkeleton_.model(pair.second);
+        if (!first || !second || first->geometry() == second->geometry()) {
+            continue;
+        }
+
+        // The finer mesh is drawn, it can take the shape of the coarser one
+        const bool drawSecond = second->geometry()->vertexCount() > first->geometry()->vertexCount();
+        Model::Mesh *drawn = drawSecond ? second : first;
+        Model::Mesh *target = drawSecond ? first : second;
+
+        if (Model::Mesh *mesh = createShapeMorph(drawn, target)) {
+            morph_.setShapeMorph(i, mesh, drawSecond);
+        }
+    }
+}
+
+Model::Mesh *Animal::createShapeMorph(Model::Mesh *drawn, Model::Mesh *target) {
+    auto drawnPath = shapePaths_.find(drawn->geometry().get());
+    auto targetPath = shapePaths_.find(target->geometry().get());
+    if (drawnPath == shapePaths_.end() || targetPath == shapePaths_.end()) {
+        return nullptr;
+    }
+
+    const auto key = std::make_pair(drawn->geometry().get(), target->geometry().get());
+    auto cached = shapeMorphs_.find(key);
+    if (cached != shapeMorphs_.end()) {
+        return cached->second.get();
+    }
+
+    // Own geometry, the drawn model's geometry is shared by parts that do
+    // not morph
+    const Model::MeshData &shape = shapes_[drawnPath->second];
+    std::vector<float> positions;
+    std::vector<float> normals;
+    Model::ResampleMorphTarget(shape, shapes_[targetPath->second], positions, normals);
+
+    models_.push_back(std::make_shared<Model::Mesh>(
+        shape.positions, shape.normals, shape.textureCoordinates, shape.indices,
+        *(shaders_.front().get()), drawn->texture()));
+    models_.back()->geometry()->setBounds(shape.bounds);
+    models_.back()->geometry()->setLevels(shape.levels);
+    triangles_[models_.back()->geometry().get()].build(shape.positions.data(), shape.indices.data(),
+                                                       Model::BaseIndexCount(shape));
+    models_.back()->geometry()->setMorphTarget(positions, normals, *(shaders_.front().get()));
+    shapeMorphs_[key] = models_.back();
 
-    rootJoint_ = humanRootJoint_;
+    return models_.back().get();
+}
+
+// Joint motion over one loop of an authored clip: the rotation is the rest
+// rotation plus base plus swing and the size grows by grow, swing and grow
+// scaled by sin(harmonic * phase). Clips of both rigs share one table, joints
+// the rig does not have are skipped
+struct Animal::ClipMotion {
+    const char *joint;
+    glm::vec3 base;
+    glm::vec3 swing;
+    glm::vec3 grow;
+    float harmonic;
+};
+
+AnimationClip *Animal::createClip(const Skeleton &skeleton, const ClipMotion *motions,
+                                  size_t motionCount, float seconds, float bob) {
+    PROGRAM_TRACE_SCOPE("loading", "Animal::createClip");
+
+    // 30 frames per second, the last frame repeats the first
+    const int joints = skeleton.jointCount();
+    ClipSamples samples;
+    samples.jointCount = joints;
+    samples.frameRate = 30.0f;
+    samples.frameCount = static_cast<int>(seconds * samples.frameRate + 0.5f) + 1;
+
+    std::vector<const ClipMotion *> jointMotions(joints, nullptr);
+    for (size_t i = 0; i < motionCount; i++) {
+        int joint = skeleton.find(motions[i].joint);
+        if (joint >= 0) {
+            jointMotions[joint] = &motions[i];
+        }
+    }
+
+    for (int frame = 0; frame < samples.frameCount; frame++) {
+        const float phase = samples.frameCount > 1
+            ? 2.0f * glm::pi<float>() * frame / (samples.frameCount - 1) : 0.0f;
+
+        for (int joint = 0; joint < joints; joint++) {
+            glm::vec3 offset = skeleton.offset(joint);
+            glm::vec3 rotation = skeleton.rotation(joint);
+            glm::vec3 size = skeleton.size(joint);
+
+            // The root bobs twice per loop, once per step of a walk
+            if (skeleton.parent(joint) == Skeleton::NoParent) {
+                offset.y += bob * std::abs(std::sin(phase));
+            }
+            if (const ClipMotion *motion = jointMotions[joint]) {
+                const float wave = std::sin(motion->harmonic * phase);
+                rotation += motion->base + motion->swing * wave;
+                size *= glm::vec3(1.0f) + motion->grow * wave;
+            }
+
+            samples.offsets.push_back(offset);
+            samples.rotations.push_back(rotation);
+            samples.sizes.push_back(size);
+        }
+    }
+
+    clips_.emplace_back(new AnimationClip());
+    clips_.back()->build(samples);
+
+    return clips_.back().get();
+}
+
+int Animal::createAnimation(const Skeleton &skeleton, AnimationGraph &graph) {
+    PROGRAM_TRACE_SCOPE("loading", "Animal::createAnimation");
+
+    const glm::vec3 none(0.0f);
+
+    // Limbs swinging around X, opposite sides in antiphase
+    const ClipMotion walk[] = {
+        {"leftShoulder", none, glm::vec3(30.0f, 0.0f, 0.0f), none, 1.0f},
+        {"rightShoulder", none, glm::vec3(-30.0f, 0.0f, 0.0f), none, 1.0f},
+        {"leftHip", none, glm::vec3(-25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"rightHip", none, glm::vec3(25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"frontLeftLeg", none, glm::vec3(25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"frontRightLeg", none, glm::vec3(-25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"hindLeftLeg", none, glm::vec3(-25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"hindRightLeg", none, glm::vec3(25.0f, 0.0f, 0.0f), none, 1.0f},
+        {"head", none, glm::vec3(4.0f, 0.0f, 0.0f), none, 1.0f},
+        {"pigHead", none, glm::vec3(4.0f, 0.0f, 0.0f), none, 1.0f},
+    };
+    // Standing still, looking around
+    const ClipMotion idle[] = {
+        {"head", none, glm::vec3(0.0f, 8.0f, 3.0f), none, 1.0f},
+        {"leftShoulder", none, glm::vec3(0.0f, 0.0f, -3.0f), none, 1.0f},
+        {"rightShoulder", none, glm::vec3(0.0f, 0.0f, 3.0f), none, 1.0f},
+        {"pigHead", none, glm::vec3(5.0f, 6.0f, 0.0f), none, 2.0f},
+        {"tailBase", none, glm::vec3(0.0f, 10.0f, 0.0f), none, 1.0f},
+    };
+    // Waving the right hand high, the pig wags its tail and ears
+    const ClipMotion gesture[] = {
+        {"rightShoulder", glm::vec3(0.0f, 0.0f, 150.0f), glm::vec3(0.0f, 0.0f, 10.0f), none, 3.0f},
+        {"rightArm", none, glm::vec3(0.0f, 0.0f, 25.0f), none, 3.0f},
+        {"tailBase", none, glm::vec3(0.0f, 35.0f, 0.0f), none, 3.0f},
+        {"leftEar", none, glm::vec3(0.0f, 0.0f, 15.0f), none, 3.0f},
+        {"rightEar", none, glm::vec3(0.0f, 0.0f, -15.0f), none, 3.0f},
+    };
+    // The chest swelling, added on top of everything else
+    const ClipMotion breath[] = {
+        {"torso", none, none, glm::vec3(0.04f, 0.02f, 0.06f), 1.0f},
+        {"pigTorso", none, none, glm::vec3(0.05f, 0.05f, 0.02f), 1.0f},
+    };
+    const char *gestureJoints[] = {"rightShoulder", "tailBase", "leftEar", "rightEar"};
+
+    const int joints = skeleton.jointCount();
+    graph = AnimationGraph(joints);
+
+    const int gestureWeight = graph.addParameter("gesture", 0.0f);
+    const int breathWeight = graph.addParameter("breath", 0.0f);
+
+    // One stride in 1.25 seconds
+    const int locomotion = graph.addStateMachine("locomotion");
+    graph.addState(locomotion, "rest", graph.addClip(*createClip(skeleton, nullptr, 0, 0.0f, 0.0f)));
+    graph.addState(locomotion, "idle", graph.addClip(*createClip(skeleton, idle, sizeof(idle) / sizeof(idle[0]), 4.0f, 0.02f)));
+    graph.addState(locomotion, "walk", graph.addClip(*createClip(skeleton, walk, sizeof(walk) / sizeof(walk[0]), 1.25f, 0.08f)));
+    for (int state = 0; state < 3; state++) {
+        graph.addTransition(locomotion, AnimationGraph::AnyState, state, 0.3f);
+    }
+
+    // The gesture only moves its joints and their children, joints are
+    // stored parents first
+    std::vector<float> mask(joints, 0.0f);
+    for (int joint = 0; joint < joints; joint++) {
+        const int parent = skeleton.parent(joint);
+        if (parent != Skeleton::NoParent) {
+            mask[joint] = mask[parent];
+        }
+        for (const char *name : gestureJoints) {
+            if (skeleton.name(joint) == name) {
+                mask[joint] = 1.0f;
+            }
+        }
+    }
+    const int layered = graph.addMask(
+        locomotion,
+        graph.addClip(*createClip(skeleton, gesture, sizeof(gesture) / sizeof(gesture[0]), 1.5f, 0.0f)),
+        mask, gestureWeight);
+
+    // The breath clip starts at the rest pose, only its motion is added
+    Pose rest;
+    capturePose(skeleton, rest);
+    graph.setRoot(graph.addAdditive(
+        layered,
+        graph.addClip(*createClip(skeleton, breath, sizeof(breath) / sizeof(breath[0]), 4.0f, 0.0f)),
+        rest, breathWeight));
+
+    return gestureWeight;
+}
+
+void Animal::setWalking(bool walking) {
+    walking_ = walking;
+    animating_ = true;
+    requestLocomotion(walking ? "walk" : "rest");
+}
+
+void Animal::setGesturing(bool gesturing) {
+    gesturing_ = gesturing;
+    animating_ = true;
+}
+
+void Animal::requestLocomotion(const std::string &state) {
+    // Both rigs play along, the morph may switch forms at any time
+    AnimationGraph *graphs[] = {&humanGraph_, &pigGraph_};
+    AnimationGraph::Instance *animations[] = {&humanAnimation_, &pigAnimation_};
+    for (int i = 0; i < 2; i++) {
+        const int machine = graphs[i]->findStateMachine("locomotion");
+        graphs[i]->requestState(*animations[i], machine, graphs[i]->findState(machine, state));
+    }
+}
+
+void Animal::capturePose(const Skeleton &skeleton, Pose &pose) const {
+    const int joints = skeleton.jointCount();
+    pose.resize(joints);
+    for (int joint = 0; joint < joints; joint++) {
+        pose.offsets[joint] = skeleton.offset(joint);
+        pose.rotations[joint] = skeleton.rotation(joint);
+        pose.sizes[joint] = skeleton.size(joint);
+    }
+}
+
+void Animal::keepJointEdits() {
+    // The skeleton holds drawnPose_ unless a joint was edited since, the
+    // edit moves the reference and the last two poses along
+    for (size_t joint = 0; joint < drawnPose_.offsets.size(); joint++) {
+        const int index = static_cast<int>(joint);
+        const glm::vec3 offset = skeleton_->offset(index) - drawnPose_.offsets[joint];
+        const glm::vec3 rotation = skeleton_->rotation(index) - drawnPose_.rotations[joint];
+        const glm::vec3 size = skeleton_->size(index) - drawnPose_.sizes[joint];
+        if (offset == glm::vec3(0.0f) && rotation == glm::vec3(0.0f) && size == glm::vec3(0.0f)) {
+            continue;
+        }
+
+        referencePose_.offsets[joint] += offset;
+        referencePose_.rotations[joint] += rotation;
+        referencePose_.sizes[joint] += size;
+        for (Pose *pose : {&previousPose_, &currentPose_}) {
+            pose->offsets[joint] += offset;
+            pose->rotations[joint] += rotation;
+            pose->sizes[joint] += size;
+        }
+        drawnPose_.offsets[joint] = skeleton_->offset(index);
+        drawnPose_.rotations[joint] = skeleton_->rotation(index);
+        drawnPose_.sizes[joint] = skeleton_->size(index);
+    }
+}
+
+void Animal::updateAnimation(float deltaTime) {
+    PROGRAM_TRACE_SCOPE("animal", "Animal::updateAnimation");
+
+    if (posedSkeleton_ == skeleton_) {
+        keepJointEdits();
+    }
+
+    if (!animating_) {
+        // Settle on the last pose in case interpolate left the rig short of it
+        if (posedSkeleton_ == skeleton_) {
+            skeleton_->setPose(currentPose_.offsets.data(), currentPose_.rotations.data(),
+                               currentPose_.sizes.data());
+        }
+        posedSkeleton_ = nullptr;
+        return;
+    }
+
+    advanceAnimation(humanGraph_, humanAnimation_, humanGesture_, deltaTime);
+    advanceAnimation(pigGraph_, pigAnimation_, pigGesture_, deltaTime);
+
+    const bool human = skeleton_ == &humanSkeleton_;
+    AnimationGraph &graph = human ? humanGraph_ : pigGraph_;
+    AnimationGraph::Instance &animation = human ? humanAnimation_ : pigAnimation_;
+
+    // Play on top of the rig as edited when the animation starts
+    const bool started = posedSkeleton_ != skeleton_;
+    if (started) {
+        capturePose(*skeleton_, referencePose_);
+        drawnPose_ = referencePose_;
+    }
+
+    // Only how far the clips move from their rest pose is applied to the
+    // reference. Keep the pose of the tick before for interpolate, unless
+    // there is no earlier pose of this rig
+    Pose *pose = graph.evaluate(animation, posePool_);
+    const Pose &rest = human ? humanRest_ : pigRest_;
+    std::swap(previousPose_, currentPose_);
+    const size_t joints = pose->offsets.size();
+    currentPose_.resize(joints);
+    for (size_t joint = 0; joint < joints; joint++) {
+        currentPose_.offsets[joint] =
+            referencePose_.offsets[joint] + pose->offsets[joint] - rest.offsets[joint];
+        currentPose_.rotations[joint] =
+            referencePose_.rotations[joint] + pose->rotations[joint] - rest.rotations[joint];
+        currentPose_.sizes[joint] =
+            referencePose_.sizes[joint] + pose->sizes[joint] - rest.sizes[joint];
+    }
+    posePool_.release(pose);
+    if (started) {
+        previousPose_ = currentPose_;
+        posedSkeleton_ = skeleton_;
+    }
+
+    // Back at rest, the last pose was the rest clip on the reference
+    const float gesture = animation.parameters[human ? humanGesture_ : pigGesture_];
+    if (!walking_ && !gesturing_ && gesture <= 0.0f && !graph.isTransitioning(animation)) {
+        animating_ = false;
+    }
+}
+
+void Animal::interpolate(float alpha) {
+    PROGRAM_TRACE_SCOPE("animal", "Animal::interpolate");
+
+    drawnProgress_ = isTransforming()
+        ? previousProgress_ + (transformationProgress_ - previousProgress_) * alpha
+        : transformationProgress_;
+
+    if (posedSkeleton_ != skeleton_) {
+        return;
+    }
+    keepJointEdits();
+
+    // The same linear mix as the graph's blends, joints which did not move
+    // between the ticks stay cached
+    const size_t joints = currentPose_.offsets.size();
+    drawnPose_.resize(joints);
+    for (size_t joint = 0; joint < joints; joint++) {
+        drawnPose_.offsets[joint] = previousPose_.offsets[joint] +
+            (currentPose_.offsets[joint] - previousPose_.offsets[joint]) * alpha;
+        drawnPose_.rotations[joint] = previousPose_.rotations[joint] +
+            (currentPose_.rotations[joint] - previousPose_.rotations[joint]) * alpha;
+        drawnPose_.sizes[joint] = previousPose_.sizes[joint] +
+            (currentPose_.sizes[joint] - previousPose_.sizes[joint]) * alpha;
+    }
+    skeleton_->setPose(drawnPose_.offsets.data(), drawnPose_.rotations.data(), drawnPose_.sizes.data());
+}
+
+void Animal::advanceAnimation(AnimationGraph &graph, AnimationGraph::Instance &animation,
+                              int gestureParameter, float deltaTime) {
+    // The gesture fades in and out in a third of a second
+    float &gesture = animation.parameters[gestureParameter];
+    gesture = gesturing_ ? std::min(gesture + deltaTime * 3.0f, 1.0f)
+                         : std::max(gesture - deltaTime * 3.0f, 0.0f);
+
+    graph.update(animation, deltaTime);
 }
 
 void Animal::toggleForm() {
+    // Morph from the rigs as edited so far
+    morph_.capture(humanSkeleton_, pigSkeleton_);
+
     isHumanForm_ = !isHumanForm_;
     transformationProgress_ = 0.0001f;  // Set to a small non-zero value to trigger isTransforming()
+    previousProgress_ = transformationProgress_;
+    drawnProgress_ = transformationProgress_;
 }
 
-void Animal::draw(glm::mat4 &view, glm::mat4 &projection){
-    if (transformationProgress_ > 0.0f && transformationProgress_ < 1.0f) {
-        drawTransformation(view, projection);
-    } else if (rootJoint_) {
-        rootJoint_->draw(glm::mat4(1.0f), view, projection);
+Scene::Entity Animal::spawn(Scene::Registry &registry, const glm::mat4 &root,
+                           float radius) const {
+    const Scene::Entity entity = registry.create();
+    registry.emplace<Scene::Transform>(entity, Scene::Transform{root});
+    registry.emplace<Scene::Bounds>(
+        entity, Scene::Bounds{glm::vec4(glm::vec3(root[3]), radius)});
+    registry.emplace<Scene::AnimationState>(
+        entity, Scene::AnimationState{humanGraph_.createInstance(),
+                                      pigGraph_.createInstance(), 1.0f, true});
+
+    return entity;
+}
+
+void Animal::draw(glm::mat4 &view, glm::mat4 &projection, const Model::LodView &lod){
+    PROGRAM_TRACE_SCOPE("animal", "Animal::draw");
+
+    const Math::Frustum frustum(projection * view);
+
+    if (drawnProgress_ > 0.0f && drawnProgress_ < 1.0f) {
+        drawTransformation(view, projection, frustum, lod);
+    } else {
+        skeleton_->updateWorldTransforms();
+        updateJointParts();
+
+        // The skin is a single draw at full detail, only the rig as a whole
+        // can be culled. Its bones were set with the parts
+        if (!cullAvatar(frustum)) {
+            return;
+        }
+        Math::CullingStatistics::current().partsDrawn += shownParts_;
+
+        (skeleton_ == &humanSkeleton_ ? *humanSkin_ : *pigSkin_).draw(view, projection);
     }
 }
 
-void Animal::drawTransformation(glm::mat4 &view, glm::mat4 &projection) {
-    // Get the root joints for both forms
-    std::shared_ptr<Joint> sourceJoint = isHumanForm_ ? pigRootJoint_ : humanRootJoint_;
-    std::shared_ptr<Joint> targetJoint = isHumanForm_ ? humanRootJoint_ : pigRootJoint_;
-    
-    // Draw the transforming model using interpolation
-    drawTransformingJoint(sourceJoint, targetJoint, glm::mat4(1.0f), view, projection, transformationProgress_);
+std::unique_ptr<Model::SkinnedMesh> Animal::createSkin(const Skeleton &skeleton) {
+    PROGRAM_TRACE_SCOPE("loading", "Animal::createSkin");
+
+    if (skeleton.jointCount() > Model::SkinnedMesh::MaxBones) {
+        throw OpenGL::OpenGLException(
+            StringFormat::StringFormat("Animal: %d joints exceed the bone palette",
+                                       skeleton.jointCount())
+                .c_str());
+    }
+
+    // A joint's bone is its model matrix, the part keeps its own mesh space.
+    // The rig is drawn with the texture of its first part
+    Model::SkinData skin;
+    OpenGL::OpenGLTexture *texture = nullptr;
+    for (int joint = 0; joint < skeleton.jointCount(); joint++) {
+        Model::Mesh *model = skeleton.model(joint);
+        if (!model) {
+            continue;
+        }
+
+        auto path = shapePaths_.find(model->geometry().get());
+        if (path != shapePaths_.end()) {
+            Model::AppendRigidPart(shapes_[path->second], joint, skin);
+            texture = texture ? texture : model->texture();
+        }
+    }
+
+    return std::unique_ptr<Model::SkinnedMesh>(
+        new Model::SkinnedMesh(skin, *skinnedShader_, texture));
 }
 
-void Animal::drawTransformingJoint(
-    std::shared_ptr<Joint> sourceJoint, 
-    std::shared_ptr<Joint> targetJoint,
-    glm::mat4 parentTransform, 
-    glm::mat4 &view, 
-    glm::mat4 &projection,
-    float progress) {
-    
-    if (!sourceJoint || !targetJoint) {
+void Animal::resizeParts(size_t count, bool morphPairs) {
+    partModels_.resize(count);
+    partTransforms_.resize(count);
+    partSpheres_.resize(count);
+    morphParts_ = morphPairs;
+}
+
+void Animal::setPart(size_t part, const Model::Mesh *model, const glm::mat4 &transform) {
+    partModels_[part] = model;
+    partTransforms_[part] = transform;
+    partSpheres_[part] = model && !model->geometry()->bounds().empty()
+                             ? Math::TransformSphere(model->geometry()->bounds().sphere, transform)
+                             : glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+}
+
+int Animal::pick(const glm::vec3 &origin, const glm::vec3 &direction, float &distance) const {
+    // Parts nearest first, every hit clips the ray for the rest
+    int part = -1;
+    partTree_.raycast(origin, direction, distance, [&](int proxy, float) {
+        const std::uint32_t candidate = partTree_.userData(proxy);
+        const float hit = raycastMesh(*partModels_[candidate]->geometry(), partTransforms_[candidate],
+                                      origin, direction, distance);
+        if (hit >= 0.0f) {
+            distance = hit;
+            part = static_cast<int>(candidate);
+        }
+        return distance;
+    });
+
+    if (part < 0 || !morphParts_) {
+        return part;
+    }
+
+    const MorphCorrespondence::Pair &pair = morph_.pair(part);
+    const int joint = skeleton_ == &humanSkeleton_ ? pair.first : pair.second;
+    return joint == MorphCorrespondence::Missing ? -1 : joint;
+}
+
+float Animal::raycastMesh(const Model::Geometry &geometry, const glm::mat4 &model,
+                          const glm::vec3 &origin, const glm::vec3 &direction,
+                          float maxDistance) const {
+    auto triangles = triangles_.find(&geometry);
+    if (triangles == triangles_.end()) {
+        return -1.0f;
+    }
+
+    // In the mesh's own space, the ray's distances stay the same
+    const glm::mat4 inverse = glm::inverse(model);
+    const glm::vec3 localOrigin(inverse * glm::vec4(origin, 1.0f));
+    const glm::vec3 localDirection(inverse * glm::vec4(direction, 0.0f));
+
+    const Math::Bounds &bounds = geometry.bounds();
+    if (Math::DynamicBvh::RayDistance(localOrigin, 1.0f / localDirection, bounds.minimum,
+                                      bounds.maximum, maxDistance) < 0.0f) {
+        return -1.0f;
+    }
+
+    return triangles->second.raycast(localOrigin, localDirection, maxDistance);
+}
+
+void Animal::updateJointParts() {
+    // Only the joints whose model matrix changed since the parts were set
+    // move, a rig nobody touched skips the pass
+    const int joints = skeleton_->jointCount();
+    const bool all = morphParts_ || partSkeleton_ != skeleton_ ||
+                     partSpheres_.size() != static_cast<size_t>(joints);
+    if (!all && partRevision_ == skeleton_->revision()) {
         return;
     }
-    
-    glm::vec3 interpolatedOffset = glm::mix(sourceJoint->getOffset(), targetJoint->getOffset(), progress);
-    glm::vec3 interpolatedRotation = glm::mix(sourceJoint->getRotation(), targetJoint->getRotation(), progress);
-    glm::vec3 interpolatedSize = glm::mix(sourceJoint->getSize(), targetJoint->getSize(), progress);
-    
-    glm::mat4 localTransform = glm::mat4(1.0f);
-    localTransform = glm::translate(localTransform, interpolatedOffset);
-    
-    const float EPSILON = 0.0001f;
-    if (std::abs(interpolatedRotation.x) > EPSILON) {
-        localTransform = glm::rotate(localTransform, glm::radians(interpolatedRotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+
+    // A joint's bone is its model matrix
+    Model::SkinnedMesh &skin = skeleton_ == &humanSkeleton_ ? *humanSkin_ : *pigSkin_;
+    resizeParts(joints, false);
+    for (int joint = 0; joint < joints; joint++) {
+        if (all || skeleton_->modelRevision(joint) > partRevision_) {
+            setPart(joint, skeleton_->model(joint), skeleton_->modelMatrix(joint));
+            skin.setBone(joint, skeleton_->modelMatrix(joint));
+            if (!all) {
+                updatePartProxy(joint);
+            }
+        }
     }
-    if (std::abs(interpolatedRotation.y) > EPSILON) {
-        localTransform = glm::rotate(localTransform, glm::radians(interpolatedRotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    if (all) {
+        updatePartTree();
     }
-    if (std::abs(interpolatedRotation.z) > EPSILON) {
-        localTransform = glm::rotate(localTransform, glm::radians(interpolatedRotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    updatePartBounds();
+
+    partSkeleton_ = skeleton_;
+    partRevision_ = skeleton_->revision();
+}
+
+void Animal::updatePartProxy(size_t part) {
+    // Parts follow their spheres, only those which left their grown box are
+    // reinserted. Parts the current form does not draw leave the tree
+    int &proxy = partProxies_[part];
+    if (part >= partSpheres_.size() || partSpheres_[part].w < 0.0f) {
+        if (proxy != Math::DynamicBvh::Null) {
+            partTree_.remove(proxy);
+            proxy = Math::DynamicBvh::Null;
+        }
+        return;
     }
-    
-    glm::mat4 worldTransformNoScale = parentTransform * localTransform;
-    glm::mat4 worldTransform = glm::scale(worldTransformNoScale, interpolatedSize);
-    
-    // Draw the interpolated model
-    if (sourceJoint->getModel() && targetJoint->getModel()) {
-        auto model = progress < 0.5f ? sourceJoint->getModel() : targetJoint->getModel();
-        model->setModelMatrix(worldTransform);
-        model->draw(view, projection);
+
+    const glm::vec3 centre(partSpheres_[part]);
+    const glm::vec3 radius(partSpheres_[part].w);
+    if (proxy == Math::DynamicBvh::Null) {
+        proxy = partTree_.insert(centre - radius, centre + radius, static_cast<std::uint32_t>(part));
+    } else {
+        partTree_.move(proxy, centre - radius, centre + radius);
     }
-    
-    // Recursively draw children
-    // We assume both hierarchies have the same structure
-    size_t minChildCount = std::min(sourceJoint->getChildCount(), targetJoint->getChildCount());
-    
-    for (size_t i = 0; i < minChildCount; i++) {
-        auto sourceChild = sourceJoint->getChild(i);
-        auto targetChild = targetJoint->getChild(i);
-        
-        if (sourceChild && targetChild) {
-            drawTransformingJoint(
-                sourceJoint->getChildPtr(i),
-                targetJoint->getChildPtr(i),
-                worldTransformNoScale,
-                view,
-                projection,
-                progress
-            );
+}
+
+void Animal::updatePartTree() {
+    partProxies_.resize(std::max(partProxies_.size(), partSpheres_.size()), Math::DynamicBvh::Null);
+    for (size_t i = 0; i < partProxies_.size(); i++) {
+        updatePartProxy(i);
+    }
+}
+
+void Animal::updatePartBounds() {
+    avatarSphere_ = Math::EncloseSpheres(partSpheres_.data(), partSpheres_.size());
+    shownParts_ = 0;
+    for (const glm::vec4 &sphere : partSpheres_) {
+        shownParts_ += sphere.w >= 0.0f ? 1 : 0;
+    }
+}
+
+bool Animal::cullAvatar(const Math::Frustum &frustum) {
+    // Parts are only tested one by one once the whole avatar is in view
+    Math::CullingStatistics &statistics = Math::CullingStatistics::current();
+    if (frustum.intersects(avatarSphere_)) {
+        statistics.avatarsDrawn++;
+        return true;
+    }
+
+    statistics.avatarsCulled++;
+    statistics.partsCulled += shownParts_;
+    return false;
+}
+
+void Animal::drawTransformation(glm::mat4 &view, glm::mat4 &projection, const Math::Frustum &frustum,
+                                const Model::LodView &lod) {
+    // Weight of the pig rig, the morph runs towards the new form
+    const float weight = isHumanForm_ ? 1.0f - drawnProgress_ : drawnProgress_;
+    const size_t pairCount = morph_.size();
+
+    // Every pair is interpolated, none of it is cached
+    SkeletonStatistics &statistics = SkeletonStatistics::current();
+    statistics.localTransforms += static_cast<std::uint32_t>(pairCount);
+    statistics.worldTransforms += static_cast<std::uint32_t>(pairCount);
+
+    // Blend every pair, then compose the local transforms in one batch
+    morph_.blend(weight, morphOffsets_.data(), morphRotations_.data(), morphSizes_.data());
+    Math::ComposeEulerTransforms(morphOffsets_.data(), morphRotations_.data(), nullptr, pairCount, morphTransforms_.data());
+
+    // Pairs are stored parents first, a single pass resolves every transform
+    resizeParts(pairCount, true);
+    for (size_t i = 0; i < pairCount; i++) {
+        const MorphCorrespondence::Pair &pair = morph_.pair(i);
+
+        if (pair.parent != Skeleton::NoParent) {
+            morphTransforms_[i] = morphTransforms_[pair.parent] * morphTransforms_[i];
+        }
+        setPart(i, morph_.model(i, weight), glm::scale(morphTransforms_[i], morphSizes_[i]));
+    }
+    updatePartTree();
+    updatePartBounds();
+
+    if (!cullAvatar(frustum)) {
+        return;
+    }
+
+    // The avatar is at least partly in view, test its parts in one batch
+    partVisible_.resize(pairCount);
+    partLevels_.resize(pairCount, 0);
+    Math::CullSpheres(frustum, partSpheres_.data(), pairCount, partVisible_.data());
+
+    Math::CullingStatistics &culling = Math::CullingStatistics::current();
+    for (size_t i = 0; i < pairCount; i++) {
+        Model::Mesh *model = morph_.model(i, weight);
+        if (!model || partSpheres_[i].w < 0.0f) {
+            continue;
         }
+        if (!partVisible_[i]) {
+            culling.partsCulled++;
+            continue;
+        }
+        culling.partsDrawn++;
+
+        // Draw the interpolated model, as coarse as its size on screen allows
+        partLevels_[i] = Model::SelectLevel(*model->geometry(), partSpheres_[i], lod, partLevels_[i]);
+        model->setModelMatrix(partTransforms_[i]);
+        model->setMorphWeight(morph_.shapeWeight(i, weight));
+        model->setLevel(partLevels_[i]);
+        model->draw(view, projection);
+        model->setLevel(0);
     }
 }
 
 void Animal::updateTransformation(float deltaTime) {
+    PROGRAM_TRACE_SCOPE("animal", "Animal::updateTransformation");
+
     // Update transformation progress (assume complete transform takes 2 seconds)
     const float transformationSpeed = 0.5f; // 2 seconds for complete transformation
     
+    previousProgress_ = transformationProgress_;
     if (transformationProgress_ < 1.0f) {
         transformationProgress_ += deltaTime * transformationSpeed;
         
         // Clamp to 1.0
         if (transformationProgress_ >= 1.0f) {
             transformationProgress_ = 1.0f;
-            rootJoint_ = isHumanForm_ ? humanRootJoint_ : pigRootJoint_;
+            skeleton_ = isHumanForm_ ? &humanSkeleton_ : &pigSkeleton_;
         }
     }
+    drawnProgress_ = transformationProgress_;
 }
 
-std::shared_ptr<Joint> Animal::createBoneHierarchy() {
-    // Create individual models for each body part with different sizes and textures
-    
-    // Create torso (root)
-    auto torsoModel = createBodyPartModel("torso", glm::vec3(1.0f, 1.5f, 0.5f), texturePath);
-    auto torso = std::make_unique<Joint>("torso", glm::vec3(0.0f, 0.0f, 0.0f), torsoModel);
-    
-    // Create head
-    auto headModel = createBodyPartModel("head", glm::vec3(0.75f, 0.75f, 0.75f), texturePath);
-    auto head = std::make_unique<Joint>("head", glm::vec3(0.0f, 2.2f, 0.0f), headModel);
-    
-    // Create left arm parts
-    auto leftShoulderModel = createBodyPartModel("leftShoulder", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto leftShoulder = std::make_unique<Joint>("leftShoulder", glm::vec3(-1.2f, 1.0f, 0.0f), leftShoulderModel);
-    
-    auto leftArmModel = createBodyPartModel("leftArm", glm::vec3(0.25f, 0.8f, 0.25f), texturePath);
-    auto leftArm = std::make_unique<Joint>("leftArm", glm::vec3(0.0f, -0.8f, 0.0f), leftArmModel);
-    
-    auto leftHandModel = createBodyPartModel("leftHand", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto leftHand = std::make_unique<Joint>("leftHand", glm::vec3(0.0f, -1.0f, 0.0f), leftHandModel);
-    
-    // Create right arm parts
-    auto rightShoulderModel = createBodyPartModel("rightShoulder", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto rightShoulder = std::make_unique<Joint>("rightShoulder", glm::vec3(1.2f, 1.0f, 0.0f), rightShoulderModel);
-    
-    auto rightArmModel = createBodyPartModel("rightArm", glm::vec3(0.25f, 0.8f, 0.25f), texturePath);
-    auto rightArm = std::make_unique<Joint>("rightArm", glm::vec3(0.0f, -0.8f, 0.0f), rightArmModel);
-    
-    auto rightHandModel = createBodyPartModel("rightHand", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto rightHand = std::make_unique<Joint>("rightHand", glm::vec3(0.0f, -1.0f, 0.0f), rightHandModel);
-    
-    // Create left leg parts
-    auto leftHipModel = createBodyPartModel("leftHip", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto leftHip = std::make_unique<Joint>("leftHip", glm::vec3(-0.4f, -1.65f, 0.0f), leftHipModel);
-    
-    auto leftLegModel = createBodyPartModel("leftLeg", glm::vec3(0.25f, 1.0f, 0.25f), texturePath);
-    auto leftLeg = std::make_unique<Joint>("leftLeg", glm::vec3(0.0f, -1.2f, 0.0f), leftLegModel);
-    
-    auto leftFootModel = createBodyPartModel("leftFoot", glm::vec3(0.3f, 0.2f, 0.5f), texturePath);
-    auto leftFoot = std::make_unique<Joint>("leftFoot", glm::vec3(0.0f, -1.0f, 0.1f), leftFootModel);
-    
-    // Create right leg parts
-    auto rightHipModel = createBodyPartModel("rightHip", glm::vec3(0.3f, 0.3f, 0.3f), texturePath);
-    auto rightHip = std::make_unique<Joint>("rightHip", glm::vec3(0.4f, -1.65f, 0.0f), rightHipModel);
-    
-    auto rightLegModel = createBodyPartModel("rightLeg", glm::vec3(0.25f, 1.0f, 0.25f), texturePath);
-    auto rightLeg = std::make_unique<Joint>("rightLeg", glm::vec3(0.0f, -1.2f, 0.0f), rightLegModel);
-    
-    auto rightFootModel = createBodyPartModel("rightFoot", glm::vec3(0.3f, 0.2f, 0.5f), texturePath);
-    auto rightFoot = std::make_unique<Joint>("rightFoot", glm::vec3(0.0f, -1.0f, 0.1f), rightFootModel);
-    
-    // Build hierarchy (bottom-up)
-    leftArm->addChild(std::move(leftHand));
-    leftShoulder->addChild(std::move(leftArm));
-    
-    rightArm->addChild(std::move(rightHand));
-    rightShoulder->addChild(std::move(rightArm));
-    
-    leftLeg->addChild(std::move(leftFoot));
-    leftHip->addChild(std::move(leftLeg));
-    
-    rightLeg->addChild(std::move(rightFoot));
-    rightHip->addChild(std::move(rightLeg));
-    
-    // Add all to torso
-    torso->addChild(std::move(head));
-    torso->addChild(std::move(leftShoulder));
-    torso->addChild(std::move(rightShoulder));
-    torso->addChild(std::move(leftHip));
-    torso->addChild(std::move(rightHip));
-    
-    return torso;
+void Animal::createBoneHierarchy() {
+    // Create individual models for each body part with different sizes and textures,
+    // joints are added parents first (depth first)
+    Skeleton &skeleton = humanSkeleton_;
+
+    struct Part {
+        const char *name;
+        const char *parent;
+        glm::vec3 offset;
+        glm::vec3 size;
+    };
+
+    const Part parts[] = {
+        // Torso (root)
+        {"torso", nullptr, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.5f, 0.5f)},
+        {"head", "torso", glm::vec3(0.0f, 2.2f, 0.0f), glm::vec3(0.75f, 0.75f, 0.75f)},
+        // Left arm parts
+        {"leftShoulder", "torso", glm::vec3(-1.2f, 1.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        {"leftArm", "leftShoulder", glm::vec3(0.0f, -0.8f, 0.0f), glm::vec3(0.25f, 0.8f, 0.25f)},
+        {"leftHand", "leftArm", glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        // Right arm parts
+        {"rightShoulder", "torso", glm::vec3(1.2f, 1.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        {"rightArm", "rightShoulder", glm::vec3(0.0f, -0.8f, 0.0f), glm::vec3(0.25f, 0.8f, 0.25f)},
+        {"rightHand", "rightArm", glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        // Left leg parts
+        {"leftHip", "torso", glm::vec3(-0.4f, -1.65f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        {"leftLeg", "leftHip", glm::vec3(0.0f, -1.2f, 0.0f), glm::vec3(0.25f, 1.0f, 0.25f)},
+        {"leftFoot", "leftLeg", glm::vec3(0.0f, -1.0f, 0.1f), glm::vec3(0.3f, 0.2f, 0.5f)},
+        // Right leg parts
+        {"rightHip", "torso", glm::vec3(0.4f, -1.65f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f)},
+        {"rightLeg", "rightHip", glm::vec3(0.0f, -1.2f, 0.0f), glm::vec3(0.25f, 1.0f, 0.25f)},
+        {"rightFoot", "rightLeg", glm::vec3(0.0f, -1.0f, 0.1f), glm::vec3(0.3f, 0.2f, 0.5f)},
+    };
+
+    for (const Part &part : parts) {
+        auto model = createBodyPartModel(part.name, part.size, texturePath, cubeModelPath);
+        int parent = part.parent ? skeleton.find(part.parent) : Skeleton::NoParent;
+        skeleton.addJoint(part.name, parent, part.offset, part.size, model.get());
+    }
 }
 
 
-std::shared_ptr<Joint> Animal::createPigBoneHierarchy() {
+void Animal::createPigBoneHierarchy() {
     // Pig model will be on all fours with distinctive pig features
-    
-    // Create torso (root) - larger and longer for pig body
-    auto torsoModel = createBodyPartModel("pigTorso", glm::vec3(1.2f, 0.8f, 1.8f), pigTexturePath);
-    auto torso = std::make_shared<Joint>("pigTorso", glm::vec3(0.0f, 0.0f, 0.0f), torsoModel);
-    
-    // Create head - more elongated for pig snout
-    auto headModel = createBodyPartModel("pigHead", glm::vec3(0.9f, 0.6f, 1.0f), pigTexturePath);
-    auto head = std::make_shared<Joint>("pigHead", glm::vec3(0.0f, 0.6f, 1.4f), headModel);
-    head->setRotation(glm::vec3(0.0f, 0.0f, 0.0f)); // Looking forward
-    
-    // Create snout
-    auto snoutModel = createBodyPartModel("pigSnout", glm::vec3(0.5f, 0.3f, 0.6f), pigTexturePath);
-    auto snout = std::make_shared<Joint>("pigSnout", glm::vec3(0.0f, -0.1f, 0.7f), snoutModel);
-    
-    // Create ears
-    auto leftEarModel = createBodyPartModel("leftEar", glm::vec3(0.3f, 0.1f, 0.3f), pigTexturePath);
-    auto leftEar = std::make_shared<Joint>("leftEar", glm::vec3(-0.4f, 0.4f, 0.0f), leftEarModel);
-    leftEar->setRotation(glm::vec3(0.0f, 0.0f, -30.0f)); // Tilt outward
-    
-    auto rightEarModel = createBodyPartModel("rightEar", glm::vec3(0.3f, 0.1f, 0.3f), pigTexturePath);
-    auto rightEar = std::make_shared<Joint>("rightEar", glm::vec3(0.4f, 0.4f, 0.0f), rightEarModel);
-    rightEar->setRotation(glm::vec3(0.0f, 0.0f, 30.0f)); // Tilt outward
-    
-    // Create front legs
-    auto frontLeftLegModel = createBodyPartModel("frontLeftLeg", glm::vec3(0.25f, 0.6f, 0.25f), pigTexturePath);
-    auto frontLeftLeg = std::make_shared<Joint>("frontLeftLeg", glm::vec3(-0.5f, -0.7f, 0.8f), frontLeftLegModel);
-    
-    auto frontLeftFootModel = createBodyPartModel("frontLeftFoot", glm::vec3(0.3f, 0.2f, 0.3f), pigTexturePath);
-    auto frontLeftFoot = std::make_shared<Joint>("frontLeftFoot", glm::vec3(0.0f, -0.7f, 0.0f), frontLeftFootModel);
-    
-    auto frontRightLegModel = createBodyPartModel("frontRightLeg", glm::vec3(0.25f, 0.6f, 0.25f), pigTexturePath);
-    auto frontRightLeg = std::make_shared<Joint>("frontRightLeg", glm::vec3(0.5f, -0.7f, 0.8f), frontRightLegModel);
-    
-    auto frontRightFootModel = createBodyPartModel("frontRightFoot", glm::vec3(0.3f, 0.2f, 0.3f), pigTexturePath);
-    auto frontRightFoot = std::make_shared<Joint>("frontRightFoot", glm::vec3(0.0f, -0.7f, 0.0f), frontRightFootModel);
-    
-    // Create hind legs
-    auto hindLeftLegModel = createBodyPartModel("hindLeftLeg", glm::vec3(0.25f, 0.6f, 0.25f), pigTexturePath);
-    auto hindLeftLeg = std::make_shared<Joint>("hindLeftLeg", glm::vec3(-0.5f, -0.7f, -0.8f), hindLeftLegModel);
-    
-    auto hindLeftFootModel = createBodyPartModel("hindLeftFoot", glm::vec3(0.3f, 0.2f, 0.3f), pigTexturePath);
-    auto hindLeftFoot = std::make_shared<Joint>("hindLeftFoot", glm::vec3(0.0f, -0.7f, 0.0f), hindLeftFootModel);
-    
-    auto hindRightLegModel = createBodyPartModel("hindRightLeg", glm::vec3(0.25f, 0.6f, 0.25f), pigTexturePath);
-    auto hindRightLeg = std::make_shared<Joint>("hindRightLeg", glm::vec3(0.5f, -0.7f, -0.8f), hindRightLegModel);
-    
-    auto hindRightFootModel = createBodyPartModel("hindRightFoot", glm::vec3(0.3f, 0.2f, 0.3f), pigTexturePath);
-    auto hindRightFoot = std::make_shared<Joint>("hindRightFoot", glm::vec3(0.0f, -0.7f, 0.0f), hindRightFootModel);
-    
-    // Create tail - curly!
-    auto tailBaseModel = createBodyPartModel("tailBase", glm::vec3(0.15f, 0.15f, 0.15f), pigTexturePath);
-    auto tailBase = std::make_shared<Joint>("tailBase", glm::vec3(0.0f, 0.2f, -1.0f), tailBaseModel);
-    tailBase->setRotation(glm::vec3(0.0f, 0.0f, 0.0f));
-    
-    auto tailMidModel = createBodyPartModel("tailMid", glm::vec3(0.12f, 0.12f, 0.12f), pigTexturePath);
-    auto tailMid = std::make_shared<Joint>("tailMid", glm::vec3(0.0f, 0.2f, -0.1f), tailMidModel);
-    tailMid->setRotation(glm::vec3(0.0f, 0.0f, 45.0f));
-    
-    auto tailEndModel = createBodyPartModel("tailEnd", glm::vec3(0.1f, 0.1f, 0.1f), pigTexturePath);
-    auto tailEnd = std::make_shared<Joint>("tailEnd", glm::vec3(0.1f, 0.1f, 0.0f), tailEndModel);
-    tailEnd->setRotation(glm::vec3(0.0f, 0.0f, 45.0f));
-    
-    // Build hierarchy
-    // Head parts
-    head->addChild(snout);
-    head->addChild(leftEar);
-    head->addChild(rightEar);
-    
-    // Legs
-    frontLeftLeg->addChild(frontLeftFoot);
-    frontRightLeg->addChild(frontRightFoot);
-    hindLeftLeg->addChild(hindLeftFoot);
-    hindRightLeg->addChild(hindRightFoot);
-    
-    // Tail
-    tailMid->addChild(tailEnd);
-    tailBase->addChild(tailMid);
-    
-    // Add all to torso
-    torso->addChild(head);
-    torso->addChild(frontLeftLeg);
-    torso->addChild(frontRightLeg);
-    torso->addChild(hindLeftLeg);
-    torso->addChild(hindRightLeg);
-    torso->addChild(tailBase);
-    
-    return torso;
+    Skeleton &skeleton = pigSkeleton_;
+
+    struct Part {
+        const char *name;
+        const char *parent;
+        glm::vec3 offset;
+        glm::vec3 size;
+        glm::vec3 rotation;
+        bool round; // sphere instead of cube, same extents as the cube
+    };
+
+    const Part parts[] = {
+        // Torso (root) - larger and longer for pig body, round like the head
+        // and snout so the morph from the human's boxes shows
+        {"pigTorso", nullptr, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.2f, 0.8f, 1.8f), glm::vec3(0.0f), true},
+        // Head - more elongated for pig snout, looking forward
+        {"pigHead", "pigTorso", glm::vec3(0.0f, 0.6f, 1.4f), glm::vec3(0.9f, 0.6f, 1.0f), glm::vec3(0.0f), true},
+        {"pigSnout", "pigHead", glm::vec3(0.0f, -0.1f, 0.7f), glm::vec3(0.5f, 0.3f, 0.6f), glm::vec3(0.0f), true},
+        // Ears, tilted outward
+        {"leftEar", "pigHead", glm::vec3(-0.4f, 0.4f, 0.0f), glm::vec3(0.3f, 0.1f, 0.3f), glm::vec3(0.0f, 0.0f, -30.0f), false},
+        {"rightEar", "pigHead", glm::vec3(0.4f, 0.4f, 0.0f), glm::vec3(0.3f, 0.1f, 0.3f), glm::vec3(0.0f, 0.0f, 30.0f), false},
+        // Front legs
+        {"frontLeftLeg", "pigTorso", glm::vec3(-0.5f, -0.7f, 0.8f), glm::vec3(0.25f, 0.6f, 0.25f), glm::vec3(0.0f), false},
+        {"frontLeftFoot", "frontLeftLeg", glm::vec3(0.0f, -0.7f, 0.0f), glm::vec3(0.3f, 0.2f, 0.3f), glm::vec3(0.0f), false},
+        {"frontRightLeg", "pigTorso", glm::vec3(0.5f, -0.7f, 0.8f), glm::vec3(0.25f, 0.6f, 0.25f), glm::vec3(0.0f), false},
+        {"frontRightFoot", "frontRightLeg", glm::vec3(0.0f, -0.7f, 0.0f), glm::vec3(0.3f, 0.2f, 0.3f), glm::vec3(0.0f), false},
+        // Hind legs
+        {"hindLeftLeg", "pigTorso", glm::vec3(-0.5f, -0.7f, -0.8f), glm::vec3(0.25f, 0.6f, 0.25f), glm::vec3(0.0f), false},
+        {"hindLeftFoot", "hindLeftLeg", glm::vec3(0.0f, -0.7f, 0.0f), glm::vec3(0.3f, 0.2f, 0.3f), glm::vec3(0.0f), false},
+        {"hindRightLeg", "pigTorso", glm::vec3(0.5f, -0.7f, -0.8f), glm::vec3(0.25f, 0.6f, 0.25f), glm::vec3(0.0f), false},
+        {"hindRightFoot", "hindRightLeg", glm::vec3(0.0f, -0.7f, 0.0f), glm::vec3(0.3f, 0.2f, 0.3f), glm::vec3(0.0f), false},
+        // Tail - curly!
+        {"tailBase", "pigTorso", glm::vec3(0.0f, 0.2f, -1.0f), glm::vec3(0.15f, 0.15f, 0.15f), glm::vec3(0.0f), false},
+        {"tailMid", "tailBase", glm::vec3(0.0f, 0.2f, -0.1f), glm::vec3(0.12f, 0.12f, 0.12f), glm::vec3(0.0f, 0.0f, 45.0f), false},
+        {"tailEnd", "tailMid", glm::vec3(0.1f, 0.1f, 0.0f), glm::vec3(0.1f, 0.1f, 0.1f), glm::vec3(0.0f, 0.0f, 45.0f), false},
+    };
+
+    for (const Part &part : parts) {
+        // The sphere model is smaller than the cube, scale it up to the size
+        const glm::vec3 size = part.round ? part.size / sphereModelRadius : part.size;
+        auto model = createBodyPartModel(part.name, size, pigTexturePath,
+                                         part.round ? sphereModelPath : cubeModelPath);
+        int parent = part.parent ? skeleton.find(part.parent) : Skeleton::NoParent;
+        skeleton.addJoint(part.name, parent, part.offset, size, model.get(), part.rotation);
+    }
 }
 
 std::shared_ptr<Model::Mesh> Animal::createBodyPartModel(
     const std::string& name,
     const glm::vec3& size,
-    const std::string& texturePath) {
+    const std::string& texturePath,
+    const std::string& modelPath) {
     
     std::shared_ptr<Model::Mesh> model;
-    std::shared_ptr<OpenGL::OpenGLTexture> texture;
-    
-    if (!ModuleAdder::loadModel(cubeModelPath.c_str(), texturePath.c_str(),
-                              *(shaders_.front().get()), models_, textures_)) {
+
+    // Body parts are cubes or spheres, parts with the same model and texture
+    // share the geometry and texture of the first one and only differ in
+    // transform
+    const std::string key = modelPath + "|" + texturePath;
+    auto prototype = prototypes_.find(key);
+    if (prototype != prototypes_.end()) {
+        models_.push_back(std::make_shared<Model::Mesh>(
+            prototype->second->geometry(), *(shaders_.front().get()),
+            prototype->second->texture()));
+    } else if (ModuleAdder::loadMeshData(modelPath.c_str(), shapes_[modelPath], lodRatios)) {
+        const Model::MeshData &shape = shapes_[modelPath];
+        textures_.push_back(Model::TextureFactory::loadFromFile(texturePath.c_str()));
+        models_.push_back(std::make_shared<Model::Mesh>(
+            shape.positions, shape.normals, shape.textureCoordinates,
+            shape.indices, *(shaders_.front().get()), textures_.back().get()));
+        models_.back()->geometry()->setBounds(shape.bounds);
+        models_.back()->geometry()->setLevels(shape.levels);
+        triangles_[models_.back()->geometry().get()].build(
+            shape.positions.data(), shape.indices.data(), Model::BaseIndexCount(shape));
+        prototypes_[key] = models_.back();
+        shapePaths_[models_.back()->geometry().get()] = modelPath;
+    } else {
         throw OpenGL::OpenGLException(
             StringFormat::StringFormat(
                 "Animal: Failed to load model for body part %s",
@@ -319,7 +893,7 @@ Joint::Joint(const std::string& name, const glm::vec3& offset,
             std::shared_ptr<Model::Mesh> model)
     : name_(name), offset_(offset), model_(model)
 {
-    size_ = model->getScale();
+    size_ = model ? model->getScale() : glm::vec3(1.0f);
     rotation_ = glm::vec3(0.0f, 0.0f, 0.0f);
     children_.clear();
 }
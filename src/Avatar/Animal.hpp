@@ -3,8 +3,22 @@
 
 #include "OpenGL/OpenGLShaderProgram.hpp"
 #include "OpenGL/OpenGLTexture.hpp"
+#include "Model/LevelOfDetail.hpp"
 #include "Model/Mesh.hpp"
+#include "Model/MorphTarget.hpp"
+#include "Model/SkinnedMesh.hpp"
+#include "Avatar/AnimationClip.hpp"
+#include "Avatar/AnimationGraph.hpp"
+#include "Avatar/MorphCorrespondence.hpp"
+#include "Avatar/Skeleton.hpp"
+#include "Scene/Registry.hpp"
+#include "Utils/Math/DynamicBvh.hpp"
+#include "Utils/Math/Frustum.hpp"
+#include "Utils/Math/TriangleSet.hpp"
 
+#include <cstdint>
+#include <map>
+#include <utility>
 #include <vector>
 #include <string>
 #include <memory>
@@ -21,52 +35,198 @@ class Animal
         void updateTransformation(float deltaTime); 
         bool isTransforming() const { return transformationProgress_ > 0.0f && transformationProgress_ < 1.0f; }
 
-        void draw(glm::mat4 &view, glm::mat4 &projection);
+        // Morphing parts are drawn at the level of detail lod selects and
+        // culled one by one. At rest the rig is its skin, one draw at full
+        // detail which is culled only as a whole
+        void draw(glm::mat4 &view, glm::mat4 &projection,
+                  const Model::LodView &lod = Model::LodView());
+
+        // Play the animation graph of the current form on top of the joint
+        // edits: walking cross-fades from rest to the walk loop, gesturing
+        // layers a wave or tail wag on top. Joints edited while it plays
+        // keep their edit, once both stop and the fades end the rig rests in
+        // the pose it was edited to
+        void setWalking(bool walking);
+        bool isWalking() const { return walking_; }
+        void setGesturing(bool gesturing);
+        bool isGesturing() const { return gesturing_; }
+        void updateAnimation(float deltaTime);
+        // updateTransformation and updateAnimation advance the simulation by
+        // a fixed tick, interpolate poses the rig alpha of the way from the
+        // state before the last tick to the last one for the next draw
+        void interpolate(float alpha);
         void setPosition(const glm::vec3 &position);
         void setRotation(const glm::vec3 &rotation);
         void setScale(const glm::vec3 &scale);
 
-        std::shared_ptr<Joint> getRootJoint() const {
-            return rootJoint_;
+        // Skeleton of the current form
+        Skeleton &getSkeleton() {
+            return *skeleton_;
         }
+
+        // Rig templates, Crowd shares them and the meshes they reference
+        const Skeleton &getHumanSkeleton() const { return humanSkeleton_; }
+        const Skeleton &getPigSkeleton() const { return pigSkeleton_; }
+        // Human rig first, pig rig second
+        const MorphCorrespondence &getMorph() const { return morph_; }
+        // Animation graphs of the rigs, with a "locomotion" state machine of
+        // rest, idle and walk states and "gesture" and "breath" weights
+        const AnimationGraph &getHumanGraph() const { return humanGraph_; }
+        const AnimationGraph &getPigGraph() const { return pigGraph_; }
+        // Prefab of an avatar sharing the rigs: an entity placed at root with
+        // a Scene::Transform, a Scene::Bounds of radius around it and a
+        // Scene::AnimationState of both graphs, in human form
+        Scene::Entity spawn(Scene::Registry &registry, const glm::mat4 &root,
+                            float radius) const;
+        // World boxes of the parts of the last draw, the user data is the
+        // joint, or the morph pair while transforming
+        const Math::DynamicBvh &getPartTree() const { return partTree_; }
+        // Joint of the current form nearest along the ray from origin along
+        // direction, -1 if none is hit. The parts are placed as last drawn,
+        // distance is the farthest to look in and the hit out
+        int pick(const glm::vec3 &origin, const glm::vec3 &direction, float &distance) const;
+        // Distance to the nearest triangle of a part's mesh placed by model,
+        // negative on a miss. Morphing meshes are tested in their own shape
+        float raycastMesh(const Model::Geometry &geometry, const glm::mat4 &model,
+                          const glm::vec3 &origin, const glm::vec3 &direction,
+                          float maxDistance) const;
     private:
+
         std::vector<std::shared_ptr<Model::Mesh>> models_;
         std::vector<std::unique_ptr<OpenGL::OpenGLTexture>> textures_;
         std::vector<std::unique_ptr<OpenGL::OpenGLShaderProgram>> shaders_;
+        // First body part loaded per model and texture path, later parts share
+        // its geometry
+        std::map<std::string, std::shared_ptr<Model::Mesh>> prototypes_;
+        // CPU copy of every loaded model and the model each geometry was
+        // loaded from, for the shape morphs
+        std::map<std::string, Model::MeshData> shapes_;
+        std::map<const Model::Geometry *, std::string> shapePaths_;
+        // Shape morph meshes per drawn and target geometry, a geometry is
+        // loaded per model and texture
+        std::map<std::pair<const Model::Geometry *, const Model::Geometry *>,
+                 std::shared_ptr<Model::Mesh>> shapeMorphs_;
 
         std::string vertexShader = "Shader/BasicVertexShader.vs.glsl";
         std::string fragmentShader = "Shader/BasicFragmentShader.fs.glsl";
+        std::string skinnedVertexShader = "Shader/SkinnedVertexShader.vs.glsl";
         std::string texturePath = "resources/texture/uv.png";
         std::string pigTexturePath = "resources/texture/uv.png";
 
         std::string cubeModelPath = "resources/model/cube.obj";
+        std::string sphereModelPath = "resources/model/sphere.obj";
+        float sphereModelRadius = 0.7f;
+        // Levels of detail of every body part model, ratios of its triangles
+        std::vector<float> lodRatios = {0.5f, 0.25f, 0.125f};
 
-        // Root joint of the skeleton
-        std::shared_ptr<Joint> rootJoint_;  
+        // Skeleton of the current form, either humanSkeleton_ or pigSkeleton_
+        Skeleton *skeleton_;
+
+        Skeleton humanSkeleton_;
+        Skeleton pigSkeleton_;
+
+        // Every body part of a rig baked into one mesh, one bone per joint
+        OpenGL::OpenGLShaderProgram *skinnedShader_;
+        std::unique_ptr<Model::SkinnedMesh> humanSkin_;
+        std::unique_ptr<Model::SkinnedMesh> pigSkin_;
+
+        MorphCorrespondence morph_;
+        std::vector<glm::mat4> morphTransforms_;
+        std::vector<glm::vec3> morphOffsets_;
+        std::vector<glm::vec3> morphRotations_;
+        std::vector<glm::vec3> morphSizes_;
+
+        // Meshes and world transforms of the drawn parts, joints or morph
+        // pairs. Their bounding spheres are culled as one avatar first, then
+        // part by part
+        std::vector<const Model::Mesh *> partModels_;
+        std::vector<glm::mat4> partTransforms_;
+        std::vector<glm::vec4> partSpheres_;
+        bool morphParts_ = false;
+        std::vector<std::uint8_t> partVisible_;
+        std::vector<size_t> partLevels_; // level of detail drawn last
+        Math::DynamicBvh partTree_;
+        std::vector<int> partProxies_; // per part, DynamicBvh::Null if hidden
+        // Sphere around the parts and the number of them with a mesh
+        glm::vec4 avatarSphere_{0.0f, 0.0f, 0.0f, -1.0f};
+        std::uint32_t shownParts_ = 0;
+        // Skeleton and revision the joint parts were set from
+        const Skeleton *partSkeleton_ = nullptr;
+        std::uint64_t partRevision_ = 0;
+        // Ray cast copies of every mesh's triangles
+        std::map<const Model::Geometry *, Math::TriangleSet> triangles_;
+
+        // Authored clips of both rigs and the graphs blending them, played
+        // by this avatar through the instances
+        std::vector<std::unique_ptr<AnimationClip>> clips_;
+        AnimationGraph humanGraph_;
+        AnimationGraph pigGraph_;
+        AnimationGraph::Instance humanAnimation_;
+        AnimationGraph::Instance pigAnimation_;
+        // Index of the "gesture" weight in each graph's parameters
+        int humanGesture_ = 0;
+        int pigGesture_ = 0;
+        PosePool posePool_;
+        // Poses the graphs evaluate to at rest, the clips move from them
+        Pose humanRest_;
+        Pose pigRest_;
+        // Edited pose of posedSkeleton_ the clips move relative to
+        Pose referencePose_;
+        // The last two poses updateAnimation evaluated for posedSkeleton_,
+        // nullptr once the skeleton holds the last one. The skeleton holds
+        // drawnPose_ until a joint is edited
+        Pose previousPose_;
+        Pose currentPose_;
+        Pose drawnPose_;
+        const Skeleton *posedSkeleton_ = nullptr;
+        bool walking_;
+        bool gesturing_;
+        bool animating_;
 
-        std::shared_ptr<Joint> humanRootJoint_;  
-        std::shared_ptr<Joint> pigRootJoint_;  
-        
         bool isHumanForm_;
         float transformationProgress_; // 0.0f = source form, 1.0f = target form
+        float previousProgress_;       // before the last tick
+        float drawnProgress_;          // interpolated for draw
 
         void create();
         std::shared_ptr<Model::Mesh> createBodyPartModel(
             const std::string& name,
             const glm::vec3& size,
-            const std::string& texturePath);
-        std::shared_ptr<Joint> createBoneHierarchy();
-        std::shared_ptr<Joint> createPigBoneHierarchy();
+            const std::string& texturePath,
+            const std::string& modelPath);
+        void createBoneHierarchy();
+        void createPigBoneHierarchy();
+        void createMorph();
+        struct ClipMotion;
+        AnimationClip *createClip(const Skeleton &skeleton, const ClipMotion *motions,
+                                  size_t motionCount, float seconds, float bob);
+        // Returns the index of the graph's "gesture" parameter
+        int createAnimation(const Skeleton &skeleton, AnimationGraph &graph);
+        void capturePose(const Skeleton &skeleton, Pose &pose) const;
+        // Fold joint edits made since the last pose into referencePose_
+        void keepJointEdits();
+        void requestLocomotion(const std::string &state);
+        void advanceAnimation(AnimationGraph &graph, AnimationGraph::Instance &animation,
+                              int gestureParameter, float deltaTime);
+        std::unique_ptr<Model::SkinnedMesh> createSkin(const Skeleton &skeleton);
+        void createShapeMorphs();
+        Model::Mesh *createShapeMorph(Model::Mesh *drawn, Model::Mesh *target);
     
-        void drawTransformation(glm::mat4 &view, glm::mat4 &projection);
-        void drawTransformingJoint(std::shared_ptr<Joint> sourceJoint, 
-                                    std::shared_ptr<Joint> targetJoint,
-                                    glm::mat4 parentTransform, 
-                                    glm::mat4 &view, 
-                                    glm::mat4 &projection,
-                                    float progress);
+        void resizeParts(size_t count, bool morphPairs);
+        void setPart(size_t part, const Model::Mesh *model, const glm::mat4 &transform);
+        // Set the parts and skin bones of the joints which moved since the
+        // last call
+        void updateJointParts();
+        void updatePartProxy(size_t part);
+        void updatePartTree();
+        void updatePartBounds();
+        bool cullAvatar(const Math::Frustum &frustum);
+        void drawTransformation(glm::mat4 &view, glm::mat4 &projection, const Math::Frustum &frustum,
+                                const Model::LodView &lod);
 };
 
+// Pointer based joint tree. Animal renders through Skeleton, Joint is kept as
+// the reference the skeleton microbenchmark compares against.
 class Joint 
 {
     public:
@@ -79,7 +239,7 @@ class Joint
         std::shared_ptr<Joint> getChildPtr(size_t index);
         size_t getChildCount() const;
 
-        std::vector<std::shared_ptr<Joint>> getChildren() const {
+        const std::vector<std::shared_ptr<Joint>> &getChildren() const {
             return children_;
         }
 
@@ -104,7 +264,7 @@ class Joint
         inline std::shared_ptr<Model::Mesh> getModel() const{
             return model_;
         }
-        inline std::string getName() const {
+        inline const std::string &getName() const {
             return name_;
         }
     private:
@@ -0,0 +1,405 @@
+#include "AnimationClip.hpp"
+
+#include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/trigonometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Detail
+{
+
+// Range of the three smallest components of a unit quaternion
+constexpr float packedComponentRange{0.70710678f};
+constexpr float packedComponentScale{32767.0f};
+
+glm::quat eulerToQuaternion(const glm::vec3 &rotation) noexcept;
+glm::vec3 quaternionToEuler(const glm::quat &rotation) noexcept;
+void packQuaternion(const glm::quat &rotation, std::uint16_t *bits) noexcept;
+glm::quat unpackQuaternion(const std::uint16_t *bits) noexcept;
+glm::quat nlerp(const glm::quat &first, const glm::quat &second,
+                float weight) noexcept;
+float angleBetween(const glm::quat &first, const glm::quat &second) noexcept;
+template <typename Error>
+void reduceKeys(std::size_t frames, float tolerance, Error error,
+                std::vector<std::uint16_t> &keys);
+
+// Rotation X, then Y, then Z like Math::ComposeEulerTransform
+glm::quat eulerToQuaternion(const glm::vec3 &rotation) noexcept
+{
+    const glm::vec3 radians{glm::radians(rotation)};
+
+    return glm::angleAxis(radians.x, glm::vec3{1.0f, 0.0f, 0.0f}) *
+           glm::angleAxis(radians.y, glm::vec3{0.0f, 1.0f, 0.0f}) *
+           glm::angleAxis(radians.z, glm::vec3{0.0f, 0.0f, 1.0f});
+}
+
+// Inverse of eulerToQuaternion from the matrix Rx * Ry * Rz, whose row 0 is
+// (cos(y)cos(z), -cos(y)sin(z), sin(y))
+glm::vec3 quaternionToEuler(const glm::quat &rotation) noexcept
+{
+    const float w{rotation.w};
+    const float x{rotation.x};
+    const float y{rotation.y};
+    const float z{rotation.z};
+
+    const float r00{1.0f - 2.0f * (y * y + z * z)};
+    const float r01{2.0f * (x * y - w * z)};
+    const float r02{2.0f * (x * z + w * y)};
+    const float cosY{std::sqrt(r00 * r00 + r01 * r01)};
+
+    // atan2 keeps y accurate close to 90 degrees, where asin does not
+    glm::vec3 angles;
+    angles.y = std::atan2(r02, cosY);
+    if (cosY > 1.0e-6f)
+    {
+        angles.x = std::atan2(-2.0f * (y * z - w * x),
+                              1.0f - 2.0f * (x * x + y * y));
+        angles.z = std::atan2(-r01, r00);
+    }
+    else
+    {
+        // Gimbal lock, only X + Z or X - Z is defined
+        angles.x = std::atan2(2.0f * (y * z + w * x),
+                              1.0f - 2.0f * (x * x + z * z));
+        angles.z = 0.0f;
+    }
+
+    return glm::degrees(angles);
+}
+
+void packQuaternion(const glm::quat &rotation, std::uint16_t *bits) noexcept
+{
+    float components[]{rotation.x, rotation.y, rotation.z, rotation.w};
+
+    int largest{0};
+    for (int i = 1; i < 4; ++i)
+    {
+        if (std::abs(components[i]) > std::abs(components[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation, keep the largest component positive
+    const float sign{components[largest] < 0.0f ? -1.0f : 1.0f};
+
+    int packed{0};
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        const float normalized{(components[i] * sign + packedComponentRange) /
+                               (2.0f * packedComponentRange)};
+        bits[packed++] = static_cast<std::uint16_t>(std::lround(
+            std::min(std::max(normalized, 0.0f), 1.0f) *
+            packedComponentScale));
+    }
+
+    bits[0] |= static_cast<std::uint16_t>((largest & 1) << 15);
+    bits[1] |= static_cast<std::uint16_t>((largest >> 1) << 15);
+}
+
+glm::quat unpackQuaternion(const std::uint16_t *bits) noexcept
+{
+    const int largest{(bits[0] >> 15) | ((bits[1] >> 15) << 1)};
+
+    float components[4];
+    float sum{0.0f};
+    int packed{0};
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        components[i] =
+            static_cast<float>(bits[packed++] & 0x7FFF) / packedComponentScale *
+                (2.0f * packedComponentRange) -
+            packedComponentRange;
+        sum += components[i] * components[i];
+    }
+    components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+
+    return glm::quat{components[3], components[0], components[1],
+                     components[2]};
+}
+
+glm::quat nlerp(const glm::quat &first, const glm::quat &second,
+                float weight) noexcept
+{
+    // Blend along the shorter arc
+    const float sign{glm::dot(first, second) < 0.0f ? -1.0f : 1.0f};
+
+    return glm::normalize(first * (1.0f - weight) + second * (sign * weight));
+}
+
+float angleBetween(const glm::quat &first, const glm::quat &second) noexcept
+{
+    const float cosine{std::min(std::abs(glm::dot(first, second)), 1.0f)};
+
+    return glm::degrees(2.0f * std::acos(cosine));
+}
+
+// Greedy reduction, a key is only added where the segment from the last key
+// can no longer interpolate every frame it spans. error(first, last, frame)
+// is the error of frame interpolated between the keys first and last
+template <typename Error>
+void reduceKeys(std::size_t frames, float tolerance, Error error,
+                std::vector<std::uint16_t> &keys)
+{
+    keys.assign(1, 0);
+    if (frames < 2)
+    {
+        return;
+    }
+
+    std::size_t first{0};
+    for (std::size_t last = 2; last < frames; ++last)
+    {
+        for (std::size_t frame = first + 1; frame < last; ++frame)
+        {
+            if (error(first, last, frame) > tolerance)
+            {
+                first = last - 1;
+                keys.push_back(static_cast<std::uint16_t>(first));
+                break;
+            }
+        }
+    }
+    keys.push_back(static_cast<std::uint16_t>(frames - 1));
+
+    // A constant track keeps its first key only
+    if (keys.size() == 2 && error(0, 0, frames - 1) <= tolerance)
+    {
+        keys.pop_back();
+    }
+}
+
+} // namespace Detail
+
+void AnimationClip::build(const ClipSamples &samples,
+                          const Tolerance &tolerance)
+{
+    PROGRAM_TRACE_SCOPE("animation", "AnimationClip::build");
+
+    PROGRAM_ASSERT(samples.frameCount >= 1 && samples.frameCount <= 65536);
+    PROGRAM_ASSERT(samples.offsets.size() ==
+                   static_cast<std::size_t>(samples.frameCount) *
+                       static_cast<std::size_t>(samples.jointCount));
+
+    jointCount_ = samples.jointCount;
+    frameCount_ = samples.frameCount;
+    frameRate_ = samples.frameRate;
+
+    tracks_.assign(static_cast<std::size_t>(ChannelCount) * jointCount_,
+                   Track{0, 0});
+    vectorFrames_.clear();
+    vectorKeys_.clear();
+    rotationFrames_.clear();
+    rotationKeys_.clear();
+
+    for (int joint = 0; joint < jointCount_; ++joint)
+    {
+        tracks_[Offset * jointCount_ + joint] =
+            buildVectorTrack(samples.offsets, joint, tolerance.offset);
+        tracks_[Rotation * jointCount_ + joint] =
+            buildRotationTrack(samples.rotations, joint, tolerance.rotation);
+        tracks_[Size * jointCount_ + joint] =
+            buildVectorTrack(samples.sizes, joint, tolerance.size);
+    }
+}
+
+float AnimationClip::duration() const noexcept
+{
+    return frameCount_ > 1 ? static_cast<float>(frameCount_ - 1) / frameRate_
+                           : 0.0f;
+}
+
+std::size_t AnimationClip::keyCount() const noexcept
+{
+    return vectorKeys_.size() + rotationKeys_.size();
+}
+
+std::size_t AnimationClip::byteSize() const noexcept
+{
+    return sizeof(Track) * tracks_.size() +
+           sizeof(std::uint16_t) *
+               (vectorFrames_.size() + rotationFrames_.size()) +
+           sizeof(glm::vec3) * vectorKeys_.size() +
+           sizeof(PackedQuaternion) * rotationKeys_.size();
+}
+
+AnimationClip::Cursor AnimationClip::createCursor() const
+{
+    Cursor cursor;
+    cursor.keys.assign(tracks_.size(), 0);
+
+    return cursor;
+}
+
+void AnimationClip::sample(float time, Cursor &cursor, glm::vec3 *offsets,
+                           glm::vec3 *rotations,
+                           glm::vec3 *sizes) const noexcept
+{
+    PROGRAM_ASSERT(cursor.keys.size() == tracks_.size());
+
+    const float last{static_cast<float>(frameCount_ - 1)};
+    float frame{last > 0.0f ? std::fmod(time * frameRate_, last) : 0.0f};
+    if (frame < 0.0f)
+    {
+        frame += last;
+    }
+
+    // Going backwards rescans every track from its first key
+    if (frame < cursor.frame)
+    {
+        std::fill(cursor.keys.begin(), cursor.keys.end(), std::uint16_t{0});
+    }
+    cursor.frame = frame;
+
+    // Moves the cursor of a track to the key segment holding the frame and
+    // gets the weight of its second key
+    const auto seek = [frame](const Track &track, const std::uint16_t *frames,
+                              std::uint16_t &key) {
+        while (key + 2u < track.count && frames[key + 1u] <= frame)
+        {
+            ++key;
+        }
+
+        const float begin{static_cast<float>(frames[key])};
+        const float end{static_cast<float>(frames[key + 1u])};
+        return std::min(std::max((frame - begin) / (end - begin), 0.0f), 1.0f);
+    };
+
+    glm::vec3 *vectorOutputs[]{offsets, nullptr, sizes};
+    for (int channel : {Offset, Size})
+    {
+        const Track *tracks{tracks_.data() + channel * jointCount_};
+        std::uint16_t *keys{cursor.keys.data() + channel * jointCount_};
+        glm::vec3 *output{vectorOutputs[channel]};
+
+        for (int joint = 0; joint < jointCount_; ++joint)
+        {
+            const Track &track{tracks[joint]};
+            const glm::vec3 *values{vectorKeys_.data() + track.first};
+
+            if (track.count == 1)
+            {
+                output[joint] = values[0];
+                continue;
+            }
+
+            std::uint16_t &key{keys[joint]};
+            const float weight{
+                seek(track, vectorFrames_.data() + track.first, key)};
+            output[joint] = values[key] + (values[key + 1u] - values[key]) * weight;
+        }
+    }
+
+    const Track *tracks{tracks_.data() + Rotation * jointCount_};
+    std::uint16_t *keys{cursor.keys.data() + Rotation * jointCount_};
+    for (int joint = 0; joint < jointCount_; ++joint)
+    {
+        const Track &track{tracks[joint]};
+        const PackedQuaternion *values{rotationKeys_.data() + track.first};
+
+        if (track.count == 1)
+        {
+            rotations[joint] = Detail::quaternionToEuler(
+                Detail::unpackQuaternion(values[0].bits));
+            continue;
+        }
+
+        std::uint16_t &key{keys[joint]};
+        const float weight{
+            seek(track, rotationFrames_.data() + track.first, key)};
+        rotations[joint] = Detail::quaternionToEuler(
+            Detail::nlerp(Detail::unpackQuaternion(values[key].bits),
+                          Detail::unpackQuaternion(values[key + 1u].bits),
+                          weight));
+    }
+}
+
+AnimationClip::Track
+AnimationClip::buildVectorTrack(const std::vector<glm::vec3> &values,
+                                int joint, float tolerance)
+{
+    const std::size_t frames{static_cast<std::size_t>(frameCount_)};
+    const auto value = [&](std::size_t frame) -> const glm::vec3 & {
+        return values[frame * jointCount_ + joint];
+    };
+
+    std::vector<std::uint16_t> keys;
+    Detail::reduceKeys(
+        frames, tolerance,
+        [&](std::size_t first, std::size_t last, std::size_t frame) {
+            const float weight{
+                last > first ? static_cast<float>(frame - first) /
+                                   static_cast<float>(last - first)
+                             : 0.0f};
+            const glm::vec3 interpolated{value(first) +
+                                         (value(last) - value(first)) * weight};
+            const glm::vec3 difference{glm::abs(interpolated - value(frame))};
+            return std::max(difference.x, std::max(difference.y, difference.z));
+        },
+        keys);
+
+    const Track track{static_cast<std::uint32_t>(vectorKeys_.size()),
+                      static_cast<std::uint32_t>(keys.size())};
+    for (std::uint16_t key : keys)
+    {
+        vectorFrames_.push_back(key);
+        vectorKeys_.push_back(value(key));
+    }
+
+    return track;
+}
+
+AnimationClip::Track
+AnimationClip::buildRotationTrack(const std::vector<glm::vec3> &values,
+                                  int joint, float tolerance)
+{
+    const std::size_t frames{static_cast<std::size_t>(frameCount_)};
+
+    std::vector<glm::quat> quaternions(frames);
+    for (std::size_t frame = 0; frame < frames; ++frame)
+    {
+        quaternions[frame] =
+            Detail::eulerToQuaternion(values[frame * jointCount_ + joint]);
+    }
+
+    std::vector<std::uint16_t> keys;
+    Detail::reduceKeys(
+        frames, tolerance,
+        [&](std::size_t first, std::size_t last, std::size_t frame) {
+            const float weight{
+                last > first ? static_cast<float>(frame - first) /
+                                   static_cast<float>(last - first)
+                             : 0.0f};
+            return Detail::angleBetween(
+                Detail::nlerp(quaternions[first], quaternions[last], weight),
+                quaternions[frame]);
+        },
+        keys);
+
+    const Track track{static_cast<std::uint32_t>(rotationKeys_.size()),
+                      static_cast<std::uint32_t>(keys.size())};
+    for (std::uint16_t key : keys)
+    {
+        PackedQuaternion packed;
+        Detail::packQuaternion(quaternions[key], packed.bits);
+        rotationFrames_.push_back(key);
+        rotationKeys_.push_back(packed);
+    }
+
+    return track;
+}
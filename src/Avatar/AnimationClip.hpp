@@ -0,0 +1,135 @@
+#ifndef HOMEWORK01_AVATAR_ANIMATIONCLIP_HPP_
+#define HOMEWORK01_AVATAR_ANIMATIONCLIP_HPP_
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Uncompressed poses of every joint, sampled at a fixed frame rate.
+ *
+ * @details The pose of joint j at frame f is item f * jointCount + j of each
+ * array. Rotations are Euler angles in degrees like Skeleton.
+ */
+struct ClipSamples
+{
+    int jointCount = 0;
+    int frameCount = 0;
+    float frameRate = 30.0f;
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> sizes;
+};
+
+/**
+ * @brief Looping keyframe animation of a joint hierarchy, with compressed
+ * translation, rotation and scale tracks per joint.
+ *
+ * @details AnimationClip::build drops every frame a track can interpolate
+ * linearly within the tolerance, a constant track keeps a single key.
+ * Rotations are stored as quaternions packed to 48 bits, the three smallest
+ * components at 15 bits each plus the index of the largest, and blended with
+ * a normalized lerp.
+ *
+ * Playback keeps the current key of every track in an AnimationClip::Cursor.
+ * Sampling forward only steps the cursors past the keys crossed since the
+ * last sample, sequential playback is O(1) per track. Sampling backwards,
+ * e.g. when the clip loops, rescans from the first key.
+ */
+class AnimationClip
+{
+public:
+    /**
+     * @brief Largest error of a dropped frame, in joint units for offsets and
+     * sizes and in degrees for rotations.
+     */
+    struct Tolerance
+    {
+        float offset;
+        float rotation;
+        float size;
+    };
+
+    /**
+     * @brief Current key of every track, owned by one playing instance.
+     */
+    struct Cursor
+    {
+        std::vector<std::uint16_t> keys;
+        float frame = 0.0f;
+    };
+
+    /**
+     * @brief Compress \a samples, which must hold between 1 and 65536
+     * frames. A looping clip repeats its first frame as its last.
+     */
+    void build(const ClipSamples &samples,
+               const Tolerance &tolerance = Tolerance{0.001f, 0.1f, 0.001f});
+
+    int jointCount() const noexcept { return jointCount_; }
+    /**
+     * @brief Gets the length of one loop in seconds.
+     */
+    float duration() const noexcept;
+    /**
+     * @brief Gets the number of keys kept over every track.
+     */
+    std::size_t keyCount() const noexcept;
+    /**
+     * @brief Gets the memory of the tracks and keys in bytes.
+     */
+    std::size_t byteSize() const noexcept;
+
+    /**
+     * @brief Gets a cursor at the start of the clip.
+     */
+    Cursor createCursor() const;
+
+    /**
+     * @brief Sample every joint at \a time seconds, wrapped into the loop.
+     * Each output array holds AnimationClip::jointCount items.
+     */
+    void sample(float time, Cursor &cursor, glm::vec3 *offsets,
+                glm::vec3 *rotations, glm::vec3 *sizes) const noexcept;
+
+private:
+    enum Channel
+    {
+        Offset = 0,
+        Rotation = 1,
+        Size = 2,
+        ChannelCount = 3
+    };
+
+    // Keys of one channel of one joint, first indexes the channel's arrays
+    struct Track
+    {
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    struct PackedQuaternion
+    {
+        std::uint16_t bits[3];
+    };
+
+    Track buildVectorTrack(const std::vector<glm::vec3> &values, int joint,
+                           float tolerance);
+    Track buildRotationTrack(const std::vector<glm::vec3> &values, int joint,
+                             float tolerance);
+
+    int jointCount_ = 0;
+    int frameCount_ = 0;
+    float frameRate_ = 30.0f;
+
+    // Track of channel c of joint j at c * jointCount_ + j
+    std::vector<Track> tracks_;
+    std::vector<std::uint16_t> vectorFrames_;
+    std::vector<glm::vec3> vectorKeys_;
+    std::vector<std::uint16_t> rotationFrames_;
+    std::vector<PackedQuaternion> rotationKeys_;
+};
+
+#endif // HOMEWORK01_AVATAR_ANIMATIONCLIP_HPP_
@@ -0,0 +1,388 @@
+#include "AnimationGraph.hpp"
+
+#include "Utils/Global.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Detail
+{
+
+float graphWeight(const AnimationGraph::Instance &instance,
+                  int parameter) noexcept;
+void mixPoses(Pose &first, const Pose &second, float weight) noexcept;
+void addPoseDifference(Pose &base, const Pose &additive, const Pose &reference,
+                       float weight) noexcept;
+void maskPoses(Pose &base, const Pose &layer, const std::vector<float> &mask,
+               float weight) noexcept;
+
+float graphWeight(const AnimationGraph::Instance &instance,
+                  int parameter) noexcept
+{
+    return std::min(std::max(instance.parameters[parameter], 0.0f), 1.0f);
+}
+
+// Mixes second into first, the same linear mix as MorphCorrespondence::blend
+void mixPoses(Pose &first, const Pose &second, float weight) noexcept
+{
+    for (std::size_t joint = 0; joint < first.offsets.size(); ++joint)
+    {
+        first.offsets[joint] +=
+            (second.offsets[joint] - first.offsets[joint]) * weight;
+        first.rotations[joint] +=
+            (second.rotations[joint] - first.rotations[joint]) * weight;
+        first.sizes[joint] += (second.sizes[joint] - first.sizes[joint]) * weight;
+    }
+}
+
+void addPoseDifference(Pose &base, const Pose &additive, const Pose &reference,
+                       float weight) noexcept
+{
+    for (std::size_t joint = 0; joint < base.offsets.size(); ++joint)
+    {
+        base.offsets[joint] +=
+            (additive.offsets[joint] - reference.offsets[joint]) * weight;
+        base.rotations[joint] +=
+            (additive.rotations[joint] - reference.rotations[joint]) * weight;
+        base.sizes[joint] +=
+            (additive.sizes[joint] - reference.sizes[joint]) * weight;
+    }
+}
+
+void maskPoses(Pose &base, const Pose &layer, const std::vector<float> &mask,
+               float weight) noexcept
+{
+    for (std::size_t joint = 0; joint < base.offsets.size(); ++joint)
+    {
+        const float jointWeight{mask[joint] * weight};
+        if (jointWeight <= 0.0f)
+        {
+            continue;
+        }
+
+        base.offsets[joint] +=
+            (layer.offsets[joint] - base.offsets[joint]) * jointWeight;
+        base.rotations[joint] +=
+            (layer.rotations[joint] - base.rotations[joint]) * jointWeight;
+        base.sizes[joint] += (layer.sizes[joint] - base.sizes[joint]) * jointWeight;
+    }
+}
+
+} // namespace Detail
+
+Pose *PosePool::acquire(std::size_t joints)
+{
+    if (free_.empty())
+    {
+        poses_.emplace_back(new Pose{});
+        // Room to release every pose without growing the free list later
+        free_.reserve(poses_.size());
+        free_.push_back(poses_.back().get());
+    }
+
+    Pose *pose{free_.back()};
+    free_.pop_back();
+    pose->resize(joints);
+
+    return pose;
+}
+
+void PosePool::release(Pose *pose) noexcept
+{
+    PROGRAM_ASSERT(free_.size() < poses_.size());
+
+    free_.push_back(pose);
+}
+
+AnimationGraph::AnimationGraph(int jointCount) : jointCount_{jointCount} {}
+
+int AnimationGraph::addParameter(const std::string &name, float value)
+{
+    parameterNames_.push_back(name);
+    parameterValues_.push_back(value);
+
+    return static_cast<int>(parameterNames_.size()) - 1;
+}
+
+int AnimationGraph::findParameter(const std::string &name) const noexcept
+{
+    const auto found =
+        std::find(parameterNames_.begin(), parameterNames_.end(), name);
+
+    return found == parameterNames_.end()
+               ? None
+               : static_cast<int>(found - parameterNames_.begin());
+}
+
+int AnimationGraph::addClip(const AnimationClip &clip, float speed)
+{
+    if (clip.jointCount() != jointCount_)
+    {
+        std::cerr << "[Error] AnimationGraph: Clip of " << clip.jointCount()
+                  << " joints in a graph of " << jointCount_ << std::endl;
+        return None;
+    }
+
+    clips_.push_back(ClipPlayback{&clip, speed});
+
+    return addNode(NodeType::Clip, None, None, None,
+                   static_cast<int>(clips_.size()) - 1);
+}
+
+int AnimationGraph::addBlend(int first, int second, int weightParameter)
+{
+    return addNode(NodeType::Blend, first, second, weightParameter, None);
+}
+
+int AnimationGraph::addAdditive(int base, int additive, const Pose &reference,
+                                int weightParameter)
+{
+    references_.push_back(reference);
+
+    return addNode(NodeType::Additive, base, additive, weightParameter,
+                   static_cast<int>(references_.size()) - 1);
+}
+
+int AnimationGraph::addMask(int base, int layer,
+                            const std::vector<float> &jointWeights,
+                            int weightParameter)
+{
+    masks_.push_back(jointWeights);
+    masks_.back().resize(static_cast<std::size_t>(jointCount_), 0.0f);
+
+    return addNode(NodeType::Mask, base, layer, weightParameter,
+                   static_cast<int>(masks_.size()) - 1);
+}
+
+int AnimationGraph::addStateMachine(const std::string &name)
+{
+    machines_.push_back(Machine{});
+    machines_.back().name = name;
+    machines_.back().node =
+        addNode(NodeType::StateMachine, None, None, None,
+                static_cast<int>(machines_.size()) - 1);
+
+    return machines_.back().node;
+}
+
+int AnimationGraph::findStateMachine(const std::string &name) const noexcept
+{
+    for (const Machine &machine : machines_)
+    {
+        if (machine.name == name)
+        {
+            return machine.node;
+        }
+    }
+
+    return None;
+}
+
+int AnimationGraph::addState(int machine, const std::string &name, int node)
+{
+    PROGRAM_ASSERT(nodes_[machine].type == NodeType::StateMachine);
+
+    Machine &states{machines_[nodes_[machine].data]};
+    states.states.push_back(node);
+    states.names.push_back(name);
+
+    return static_cast<int>(states.states.size()) - 1;
+}
+
+void AnimationGraph::addTransition(int machine, int from, int to,
+                                   float duration)
+{
+    PROGRAM_ASSERT(nodes_[machine].type == NodeType::StateMachine);
+
+    machines_[nodes_[machine].data].transitions.push_back(
+        Transition{from, to, std::max(duration, 0.0f)});
+}
+
+int AnimationGraph::findState(int machine,
+                              const std::string &name) const noexcept
+{
+    const std::vector<std::string> &names{machines_[nodes_[machine].data].names};
+    const auto found = std::find(names.begin(), names.end(), name);
+
+    return found == names.end() ? None
+                                : static_cast<int>(found - names.begin());
+}
+
+AnimationGraph::Instance AnimationGraph::createInstance() const
+{
+    Instance instance;
+    instance.parameters = parameterValues_;
+    instance.times.assign(clips_.size(), 0.0f);
+    for (const ClipPlayback &playback : clips_)
+    {
+        instance.cursors.push_back(playback.clip->createCursor());
+    }
+    instance.machines.assign(machines_.size(),
+                             MachineState{0, None, 0.0f, 0.0f});
+
+    return instance;
+}
+
+bool AnimationGraph::requestState(Instance &instance, int machine,
+                                  int state) const
+{
+    const Machine &states{machines_[nodes_[machine].data]};
+    MachineState &current{instance.machines[nodes_[machine].data]};
+
+    if (current.state == state)
+    {
+        return true;
+    }
+
+    for (const Transition &transition : states.transitions)
+    {
+        if ((transition.from == current.state ||
+             transition.from == AnyState) &&
+            transition.to == state)
+        {
+            current.previous =
+                transition.duration > 0.0f ? current.state : None;
+            current.state = state;
+            current.elapsed = 0.0f;
+            current.duration = transition.duration;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool AnimationGraph::isTransitioning(const Instance &instance) const noexcept
+{
+    return std::any_of(
+        instance.machines.begin(), instance.machines.end(),
+        [](const MachineState &machine) { return machine.previous != None; });
+}
+
+void AnimationGraph::update(Instance &instance, float deltaTime) const noexcept
+{
+    // Clips keep playing while hidden, a state fades in where it would be
+    for (std::size_t clip = 0; clip < clips_.size(); ++clip)
+    {
+        const float duration{clips_[clip].clip->duration()};
+        float &time{instance.times[clip]};
+
+        time += deltaTime * clips_[clip].speed;
+        if (duration > 0.0f)
+        {
+            time = std::fmod(time, duration);
+        }
+    }
+
+    for (MachineState &machine : instance.machines)
+    {
+        if (machine.previous != None)
+        {
+            machine.elapsed += deltaTime;
+            if (machine.elapsed >= machine.duration)
+            {
+                machine.previous = None;
+            }
+        }
+    }
+}
+
+Pose *AnimationGraph::evaluate(Instance &instance, PosePool &pool) const
+{
+    PROGRAM_ASSERT(root_ != None);
+
+    return evaluateNode(root_, instance, pool);
+}
+
+int AnimationGraph::addNode(NodeType type, int first, int second,
+                            int parameter, int data)
+{
+    nodes_.push_back(Node{type, {first, second}, parameter, data});
+
+    return static_cast<int>(nodes_.size()) - 1;
+}
+
+Pose *AnimationGraph::evaluateNode(int node, Instance &instance,
+                                   PosePool &pool) const
+{
+    const Node &current{nodes_[node]};
+
+    switch (current.type)
+    {
+    case NodeType::Clip:
+        return evaluateClip(current, instance, pool);
+    case NodeType::StateMachine:
+        return evaluateMachine(current, instance, pool);
+    default:
+        break;
+    }
+
+    const float weight{Detail::graphWeight(instance, current.parameter)};
+    if (weight <= 0.0f)
+    {
+        return evaluateNode(current.inputs[0], instance, pool);
+    }
+    if (weight >= 1.0f && current.type == NodeType::Blend)
+    {
+        return evaluateNode(current.inputs[1], instance, pool);
+    }
+
+    Pose *base{evaluateNode(current.inputs[0], instance, pool)};
+    Pose *layer{evaluateNode(current.inputs[1], instance, pool)};
+
+    switch (current.type)
+    {
+    case NodeType::Blend:
+        Detail::mixPoses(*base, *layer, weight);
+        break;
+    case NodeType::Additive:
+        Detail::addPoseDifference(*base, *layer, references_[current.data],
+                                  weight);
+        break;
+    case NodeType::Mask:
+        Detail::maskPoses(*base, *layer, masks_[current.data], weight);
+        break;
+    default:
+        break;
+    }
+
+    pool.release(layer);
+
+    return base;
+}
+
+Pose *AnimationGraph::evaluateClip(const Node &node, Instance &instance,
+                                   PosePool &pool) const
+{
+    Pose *pose{pool.acquire(static_cast<std::size_t>(jointCount_))};
+
+    clips_[node.data].clip->sample(instance.times[node.data],
+                                   instance.cursors[node.data],
+                                   pose->offsets.data(), pose->rotations.data(),
+                                   pose->sizes.data());
+
+    return pose;
+}
+
+Pose *AnimationGraph::evaluateMachine(const Node &node, Instance &instance,
+                                      PosePool &pool) const
+{
+    const Machine &states{machines_[node.data]};
+    const MachineState &machine{instance.machines[node.data]};
+
+    PROGRAM_ASSERT(!states.states.empty());
+
+    Pose *pose{evaluateNode(states.states[machine.state], instance, pool)};
+    if (machine.previous == None)
+    {
+        return pose;
+    }
+
+    // Cross-fade from the state being left
+    Pose *previous{evaluateNode(states.states[machine.previous], instance, pool)};
+    Detail::mixPoses(*previous, *pose, machine.elapsed / machine.duration);
+    pool.release(pose);
+
+    return previous;
+}
@@ -0,0 +1,277 @@
+#ifndef HOMEWORK01_AVATAR_ANIMATIONGRAPH_HPP_
+#define HOMEWORK01_AVATAR_ANIMATIONGRAPH_HPP_
+
+#include "Avatar/AnimationClip.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Offset, rotation and size of every joint of a rig, rotations are
+ * Euler angles in degrees like Skeleton.
+ */
+struct Pose
+{
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> sizes;
+
+    void resize(std::size_t joints)
+    {
+        offsets.resize(joints);
+        rotations.resize(joints);
+        sizes.resize(joints);
+    }
+};
+
+/**
+ * @brief Free list of poses for the intermediate results of
+ * AnimationGraph::evaluate.
+ *
+ * @details Poses are only allocated while the pool is warming up, once it
+ * holds as many poses as the deepest evaluation needs every acquire reuses a
+ * released pose. A pose keeps its capacity when it is resized, a pool shared
+ * by rigs of different sizes stops allocating once its poses fit the largest.
+ * A pool must only be used by one thread at a time.
+ */
+class PosePool
+{
+public:
+    PosePool() = default;
+    PosePool(const PosePool &other) = delete;
+    PosePool &operator=(const PosePool &other) = delete;
+
+    /**
+     * @brief Gets a pose of \a joints joints with undefined contents.
+     */
+    Pose *acquire(std::size_t joints);
+    void release(Pose *pose) noexcept;
+
+    /**
+     * @brief Gets the number of poses allocated so far.
+     */
+    std::size_t capacity() const noexcept { return poses_.size(); }
+
+private:
+    std::vector<std::unique_ptr<Pose>> poses_;
+    std::vector<Pose *> free_;
+};
+
+/**
+ * @brief Blend tree of animation clips driving one rig, shared by every
+ * avatar playing it.
+ *
+ * @details The graph is a tree of nodes built bottom up, every add function
+ * returns the index of its node:
+ * - a clip node samples an AnimationClip, which must outlive the graph,
+ * - a blend node mixes two poses by a weight parameter,
+ * - an additive node adds the difference of a pose to a reference pose,
+ *   e.g. the rig's rest pose, scaled by a weight parameter,
+ * - a mask node mixes a layer over a base pose by a weight per joint, e.g.
+ *   only the arm of a gesture,
+ * - a state machine node plays one of its states and cross-fades to the
+ *   next state over the duration of the transition.
+ *
+ * Everything that changes while playing, parameters, clip times, cursors and
+ * the current states, lives in an AnimationGraph::Instance per avatar.
+ * AnimationGraph::update and AnimationGraph::evaluate only touch the
+ * instance and a PosePool, so the graphs of many avatars run concurrently
+ * with one pool per thread. Evaluation allocates nothing once the pool is
+ * warm. Inputs which a weight of zero or one hides are not evaluated.
+ *
+ * Poses are mixed linearly per joint like MorphCorrespondence::blend, the
+ * clips of one rig should keep their angles on the same side of +-180
+ * degrees.
+ */
+class AnimationGraph
+{
+public:
+    static constexpr int None = -1;
+    // Source state of a transition taken from whatever state is playing
+    static constexpr int AnyState = -1;
+
+    /**
+     * @brief Current state of one state machine node, see
+     * AnimationGraph::Instance.
+     */
+    struct MachineState
+    {
+        int state;
+        int previous; // state fading out, None outside a transition
+        float elapsed;
+        float duration;
+    };
+
+    /**
+     * @brief Playback state of one avatar, created by
+     * AnimationGraph::createInstance.
+     */
+    struct Instance
+    {
+        std::vector<float> parameters;
+        std::vector<float> times; // per clip node, seconds
+        std::vector<AnimationClip::Cursor> cursors;
+        std::vector<MachineState> machines;
+    };
+
+    explicit AnimationGraph(int jointCount = 0);
+
+    int jointCount() const noexcept { return jointCount_; }
+
+    /**
+     * @brief Add a weight parameter, instances start at \a value.
+     *
+     * @return Index of the parameter.
+     */
+    int addParameter(const std::string &name, float value = 0.0f);
+    /**
+     * @brief Gets the index of the parameter named \a name, None if there is
+     * none.
+     */
+    int findParameter(const std::string &name) const noexcept;
+
+    /**
+     * @brief Add a node playing \a clip at \a speed times its frame rate.
+     */
+    int addClip(const AnimationClip &clip, float speed = 1.0f);
+    /**
+     * @brief Add a node mixing \a second into \a first, a weight of 0 is
+     * \a first.
+     */
+    int addBlend(int first, int second, int weightParameter);
+    /**
+     * @brief Add a node adding \a additive minus \a reference to \a base.
+     */
+    int addAdditive(int base, int additive, const Pose &reference,
+                    int weightParameter);
+    /**
+     * @brief Add a node mixing \a layer over \a base, joint j by
+     * \a jointWeights[j] times the weight parameter.
+     */
+    int addMask(int base, int layer, const std::vector<float> &jointWeights,
+                int weightParameter);
+    /**
+     * @brief Add a state machine node without states, it starts in its first
+     * state.
+     */
+    int addStateMachine(const std::string &name);
+    /**
+     * @brief Gets the node of the state machine named \a name, None if there
+     * is none.
+     */
+    int findStateMachine(const std::string &name) const noexcept;
+    /**
+     * @brief Add a state to \a machine which plays \a node.
+     *
+     * @return Index of the state in the machine.
+     */
+    int addState(int machine, const std::string &name, int node);
+    /**
+     * @brief Allow \a machine to go from state \a from, or AnyState, to
+     * \a to, cross-fading over \a duration seconds.
+     */
+    void addTransition(int machine, int from, int to, float duration);
+    /**
+     * @brief Gets the index of the state named \a name, None if there is
+     * none.
+     */
+    int findState(int machine, const std::string &name) const noexcept;
+
+    /**
+     * @brief Set the node whose pose AnimationGraph::evaluate returns.
+     */
+    void setRoot(int node) noexcept { root_ = node; }
+
+    Instance createInstance() const;
+
+    /**
+     * @brief Start the transition of \a machine to \a state. A transition
+     * which is still fading is cut short.
+     *
+     * @return \c false if the machine has no transition from its current
+     * state to \a state.
+     */
+    bool requestState(Instance &instance, int machine, int state) const;
+    /**
+     * @brief Gets whether any state machine of \a instance is cross-fading.
+     */
+    bool isTransitioning(const Instance &instance) const noexcept;
+
+    /**
+     * @brief Advance the clips and transitions of \a instance by
+     * \a deltaTime seconds.
+     */
+    void update(Instance &instance, float deltaTime) const noexcept;
+    /**
+     * @brief Evaluate the root node for \a instance.
+     *
+     * @return Pose of AnimationGraph::jointCount joints, the caller releases
+     * it to \a pool.
+     */
+    Pose *evaluate(Instance &instance, PosePool &pool) const;
+
+private:
+    enum class NodeType
+    {
+        Clip,
+        Blend,
+        Additive,
+        Mask,
+        StateMachine
+    };
+
+    // data indexes clips_, references_, masks_ or machines_ by type
+    struct Node
+    {
+        NodeType type;
+        int inputs[2];
+        int parameter;
+        int data;
+    };
+
+    struct Transition
+    {
+        int from;
+        int to;
+        float duration;
+    };
+
+    struct Machine
+    {
+        std::string name;
+        int node;
+        std::vector<int> states; // node per state
+        std::vector<std::string> names;
+        std::vector<Transition> transitions;
+    };
+
+    struct ClipPlayback
+    {
+        const AnimationClip *clip;
+        float speed;
+    };
+
+    int addNode(NodeType type, int first, int second, int parameter, int data);
+    Pose *evaluateNode(int node, Instance &instance, PosePool &pool) const;
+    Pose *evaluateClip(const Node &node, Instance &instance,
+                       PosePool &pool) const;
+    Pose *evaluateMachine(const Node &node, Instance &instance,
+                          PosePool &pool) const;
+
+    int jointCount_;
+    int root_ = None;
+
+    std::vector<Node> nodes_;
+    std::vector<std::string> parameterNames_;
+    std::vector<float> parameterValues_;
+    std::vector<ClipPlayback> clips_;
+    std::vector<Pose> references_;
+    std::vector<std::vector<float>> masks_;
+    std::vector<Machine> machines_;
+};
+
+#endif // HOMEWORK01_AVATAR_ANIMATIONGRAPH_HPP_
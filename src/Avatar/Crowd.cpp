@@ -0,0 +1,1052 @@
+#include "Crowd.hpp"
+
+#include "OpenGL/OpenGLException.hpp"
+#include "OpenGL/OpenGLStatistics.hpp"
+#include "Utils/Math/Bounds.hpp"
+#include "Utils/Math/EulerTransform.hpp"
+#include "Utils/Model/ShaderAdder.hpp"
+#include "Utils/Parallel/JobSystem.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/gtc/constants.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace Detail
+{
+
+const char *const crowdVertexShader{"Shader/InstancedVertexShader.vs.glsl"};
+const char *const crowdFragmentShader{"Shader/BasicFragmentShader.fs.glsl"};
+const char *const boundsVertexShader{"Shader/BoundsVertexShader.vs.glsl"};
+const char *const boundsFragmentShader{"Shader/BoundsFragmentShader.fs.glsl"};
+
+// Avatars per parallelFor chunk
+constexpr std::size_t avatarsPerChunk{64};
+
+// The morph speed, the same two seconds Animal::updateTransformation takes,
+// and the fade of a gesture in and out
+constexpr float morphSpeed{0.5f};
+constexpr float gestureSpeed{3.0f};
+// Share of activities which walk and which gesture
+constexpr float walkChance{0.6f};
+constexpr float gestureChance{0.3f};
+// Growth of the rest pose bounds of a rig, room for the swings and sizes of
+// its clips
+constexpr float rigPadding{1.5f};
+// Growth of the rest pose box of a rig the occlusion queries draw, room for
+// the swings of its clips. It only has to hold the avatar as seen from
+// outside, not every pose the sphere above allows for
+constexpr float boxPadding{1.2f};
+// Growth of an avatar's box before the camera counts as inside it, room for
+// the near plane
+constexpr float nearMargin{0.5f};
+// Corners of the faces of the box from -1 to 1, two triangles each, counter
+// clockwise seen from outside
+constexpr float boxCorners[6][4][3]{
+    {{1, -1, -1}, {1, 1, -1}, {1, 1, 1}, {1, -1, 1}},
+    {{-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}, {-1, -1, -1}},
+    {{-1, 1, -1}, {-1, 1, 1}, {1, 1, 1}, {1, 1, -1}},
+    {{-1, -1, 1}, {-1, -1, -1}, {1, -1, -1}, {1, -1, 1}},
+    {{-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},
+    {{1, -1, -1}, {-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}}};
+constexpr GLsizei boxVertices{36};
+
+/**
+ * @brief Joint inputs of one avatar, reused by every avatar a thread poses.
+ */
+struct PoseScratch
+{
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> sizes;
+    std::vector<float> morphWeights; // of the shape morph meshes
+    std::vector<int> parents;
+    std::vector<const void *> drawn; // Crowd::RigJoint, nullptr if hidden
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::vec4> spheres; // world bounds of the drawn joints
+    std::vector<std::uint8_t> visible;
+
+    void resize(std::size_t joints)
+    {
+        offsets.resize(joints);
+        rotations.resize(joints);
+        sizes.resize(joints);
+        morphWeights.resize(joints);
+        parents.resize(joints);
+        drawn.resize(joints);
+        transforms.resize(joints);
+        spheres.resize(joints);
+        visible.resize(joints);
+    }
+};
+
+thread_local PoseScratch poseScratch;
+thread_local PosePool posePool;
+
+float random(std::uint32_t avatar, std::uint32_t stream) noexcept;
+void writeInstance(const glm::mat4 &world, const glm::vec3 &size,
+                   float morphWeight,
+                   Model::InstanceTransform &instance) noexcept;
+// The model matrix writeInstance packed
+glm::mat4 instanceMatrix(const Model::InstanceTransform &instance) noexcept;
+void addCulling(Math::CullingStatistics &total,
+                const Math::CullingStatistics &chunk) noexcept;
+
+// Uniform in [0, 1), hashed so every avatar is independent of the count
+float random(std::uint32_t avatar, std::uint32_t stream) noexcept
+{
+    std::uint32_t x{avatar * 0x9E3779B9u + stream * 0x85EBCA6Bu + 1u};
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+
+    return static_cast<float>(x >> 8) / 16777216.0f;
+}
+
+void writeInstance(const glm::mat4 &world, const glm::vec3 &size,
+                   float morphWeight,
+                   Model::InstanceTransform &instance) noexcept
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        instance.rows[row] =
+            glm::vec4{world[0][row] * size.x, world[1][row] * size.y,
+                      world[2][row] * size.z, world[3][row]};
+    }
+    instance.morphWeight = morphWeight;
+}
+
+glm::mat4 instanceMatrix(const Model::InstanceTransform &instance) noexcept
+{
+    glm::mat4 model{1.0f};
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            model[column][row] = instance.rows[row][column];
+        }
+    }
+
+    return model;
+}
+
+void addCulling(Math::CullingStatistics &total,
+                const Math::CullingStatistics &chunk) noexcept
+{
+    total.avatarsDrawn += chunk.avatarsDrawn;
+    total.avatarsCulled += chunk.avatarsCulled;
+    total.avatarsOccluded += chunk.avatarsOccluded;
+    total.partsDrawn += chunk.partsDrawn;
+    total.partsCulled += chunk.partsCulled;
+}
+
+} // namespace Detail
+
+Crowd::Crowd(const Animal &animal, int count,
+             Parallel::JobSystem &jobSystem)
+    : jobSystem_{&jobSystem}, animal_{&animal}, humanRig_{animal.getHumanSkeleton()},
+      pigRig_{animal.getPigSkeleton()}, morph_{animal.getMorph()},
+      humanGraph_{&animal.getHumanGraph()}, pigGraph_{&animal.getPigGraph()},
+      humanControls_{FindControls(*humanGraph_)},
+      pigControls_{FindControls(*pigGraph_)},
+      transforms_{registry_.pool<Scene::Transform>()},
+      bounds_{registry_.pool<Scene::Bounds>()},
+      animations_{registry_.pool<Scene::AnimationState>()},
+      behaviours_{registry_.pool<Behaviour>()}
+{
+    PROGRAM_TRACE_SCOPE("loading", "Crowd::Crowd");
+
+    if (!ShaderAdder::addShader(Detail::crowdVertexShader,
+                                Detail::crowdFragmentShader, nullptr,
+                                shaders_))
+    {
+        throw OpenGL::OpenGLException{"Crowd: Failed to create shader"};
+    }
+    boundsShader_ = ShaderAdder::addShader(Detail::boundsVertexShader,
+                                           Detail::boundsFragmentShader,
+                                           nullptr, shaders_);
+    if (!boundsShader_)
+    {
+        throw OpenGL::OpenGLException{"Crowd: Failed to create shader"};
+    }
+    createBox();
+
+    // The shared rigs never change, morph between their initial poses
+    morph_.capture(humanRig_, pigRig_);
+
+    createRigJoints(humanRig_, humanJoints_);
+    createRigJoints(pigRig_, pigJoints_);
+    createMorphJoints(0.0f, morphHumanJoints_);
+    createMorphJoints(1.0f, morphPigJoints_);
+    measureRig(humanRig_);
+    measureRig(pigRig_);
+    rigRadius_ *= Detail::rigPadding;
+    rigBoxMinimum_ *= Detail::boxPadding;
+    rigBoxMaximum_ *= Detail::boxPadding;
+
+    // Room for the largest joint list, an avatar draws one list at a time
+    slotsPerAvatar_.assign(batches_.size(), 0);
+    for (const auto *joints : {&humanJoints_, &pigJoints_, &morphHumanJoints_,
+                               &morphPigJoints_})
+    {
+        std::vector<std::size_t> used(batches_.size(), 0);
+        for (const RigJoint &joint : *joints)
+        {
+            if (joint.batch >= 0)
+            {
+                used[joint.batch] = std::max(used[joint.batch], joint.slot + 1);
+            }
+        }
+        for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+        {
+            slotsPerAvatar_[batch] =
+                std::max(slotsPerAvatar_[batch], used[batch]);
+        }
+    }
+
+    spawn(count);
+}
+
+Crowd::~Crowd() = default;
+
+void Crowd::setOcclusionCulling(bool enabled)
+{
+    occlusionCulling_ = enabled;
+
+    // Every avatar starts out visible, until its queries say otherwise
+    occluded_.assign(registry_.size(), 0);
+    hiddenResults_.assign(registry_.size(), 0);
+    if (enabled && occlusionQueries_.size() != registry_.size())
+    {
+        occlusionQueries_.clear();
+        occlusionQueries_.reserve(registry_.size());
+        for (std::size_t avatar = 0; avatar < registry_.size(); ++avatar)
+        {
+            occlusionQueries_.emplace_back(GL_ANY_SAMPLES_PASSED);
+        }
+    }
+}
+
+int Crowd::size() const noexcept
+{
+    return static_cast<int>(registry_.size());
+}
+
+float Crowd::radius() const noexcept { return radius_; }
+
+std::size_t Crowd::instanceCount() const noexcept
+{
+    std::size_t instances{0};
+    for (std::size_t slots : slotsPerAvatar_)
+    {
+        instances += slots * registry_.size();
+    }
+
+    return instances;
+}
+
+std::size_t Crowd::batchCount() const noexcept { return batches_.size(); }
+
+Crowd::GraphControls Crowd::FindControls(const AnimationGraph &graph) noexcept
+{
+    const int locomotion{graph.findStateMachine("locomotion")};
+
+    return GraphControls{locomotion, graph.findState(locomotion, "idle"),
+                         graph.findState(locomotion, "walk"),
+                         graph.findParameter("gesture"),
+                         graph.findParameter("breath")};
+}
+
+void Crowd::createRigJoints(const Skeleton &rig, std::vector<RigJoint> &joints)
+{
+    std::vector<std::size_t> slots(batches_.size(), 0);
+
+    for (int joint = 0; joint < rig.jointCount(); ++joint)
+    {
+        joints.push_back(
+            createRigJoint(rig.model(joint), slots));
+    }
+}
+
+void Crowd::createMorphJoints(float weight, std::vector<RigJoint> &joints)
+{
+    std::vector<std::size_t> slots(batches_.size(), 0);
+
+    for (std::size_t pair = 0; pair < morph_.size(); ++pair)
+    {
+        joints.push_back(createRigJoint(morph_.model(pair, weight), slots));
+    }
+}
+
+Crowd::RigJoint Crowd::createRigJoint(const Model::Mesh *mesh,
+                                      std::vector<std::size_t> &slots)
+{
+    RigJoint rigJoint{-1, 0};
+
+    if (mesh)
+    {
+        auto batch = std::find_if(
+            batches_.begin(), batches_.end(),
+            [mesh](const std::unique_ptr<Model::InstanceBatch> &batch) {
+                return batch->geometry() == mesh->geometry() &&
+                       batch->texture() == mesh->texture();
+            });
+        if (batch == batches_.end())
+        {
+            batches_.emplace_back(new Model::InstanceBatch{
+                mesh->geometry(), mesh->texture(), *shaders_.front()});
+            batch = batches_.end() - 1;
+            slots.push_back(0);
+        }
+
+        rigJoint.batch = static_cast<int>(batch - batches_.begin());
+        rigJoint.slot = slots[rigJoint.batch]++;
+    }
+
+    return rigJoint;
+}
+
+void Crowd::createBox()
+{
+    std::vector<glm::vec3> vertices;
+    for (const auto &face : Detail::boxCorners)
+    {
+        for (int corner : {0, 1, 2, 0, 2, 3})
+        {
+            vertices.push_back(
+                glm::vec3{face[corner][0], face[corner][1], face[corner][2]});
+        }
+    }
+
+    boxArray_.reset(new OpenGL::OpenGLVertexArrayObject{});
+    boxBuffer_.reset(new OpenGL::OpenGLBufferObject{
+        OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+        OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
+
+    boxArray_->bind();
+    boxBuffer_->bind();
+    boxBuffer_->allocateBufferData(
+        vertices.data(),
+        static_cast<GLsizeiptr>(sizeof(glm::vec3) * vertices.size()));
+    boundsShader_->enableAttributeArray(0);
+    boundsShader_->mapAttributePointer(0, 3, GL_FLOAT, GL_FALSE,
+                                       sizeof(glm::vec3), 0);
+    boxArray_->release();
+}
+
+void Crowd::measureRig(Skeleton &rig)
+{
+    // The rest pose around the root, every part inside its mesh's bounds
+    rig.updateWorldTransforms();
+
+    std::vector<glm::vec4> spheres;
+    for (int joint = 0; joint < rig.jointCount(); ++joint)
+    {
+        const Model::Mesh *mesh{rig.model(joint)};
+        if (mesh && !mesh->geometry()->bounds().empty())
+        {
+            const Math::Bounds &bounds{mesh->geometry()->bounds()};
+            spheres.push_back(
+                Math::TransformSphere(bounds.sphere, rig.modelMatrix(joint)));
+
+            // The box of the corners turned any way around the vertical
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                const glm::vec3 point{rig.modelMatrix(joint) *
+                                      glm::vec4{corner & 1 ? bounds.maximum.x
+                                                           : bounds.minimum.x,
+                                                corner & 2 ? bounds.maximum.y
+                                                           : bounds.minimum.y,
+                                                corner & 4 ? bounds.maximum.z
+                                                           : bounds.minimum.z,
+                                                1.0f}};
+                const float reach{glm::length(glm::vec2{point.x, point.z})};
+                rigBoxMinimum_ = glm::min(rigBoxMinimum_,
+                                          glm::vec3{-reach, point.y, -reach});
+                rigBoxMaximum_ = glm::max(rigBoxMaximum_,
+                                          glm::vec3{reach, point.y, reach});
+            }
+        }
+    }
+
+    const glm::vec4 enclosing{
+        Math::EncloseSpheres(spheres.data(), spheres.size())};
+    if (enclosing.w >= 0.0f)
+    {
+        rigRadius_ = std::max(rigRadius_, glm::length(glm::vec3{enclosing}) +
+                                              enclosing.w);
+    }
+}
+
+void Crowd::spawn(int count)
+{
+    const std::size_t avatars{static_cast<std::size_t>(std::max(count, 0))};
+    const int side{static_cast<int>(std::ceil(std::sqrt(avatars)))};
+    const float half{0.5f * static_cast<float>(side - 1)};
+
+    registry_.clear();
+    transforms_.reserve(avatars);
+    bounds_.reserve(avatars);
+    animations_.reserve(avatars);
+    behaviours_.reserve(avatars);
+    occluded_.assign(avatars, 0);
+    hiddenResults_.assign(avatars, 0);
+    occlusionQueries_.clear();
+    avatarTree_.clear();
+
+    for (std::size_t avatar = 0; avatar < avatars; ++avatar)
+    {
+        const auto id = static_cast<std::uint32_t>(avatar);
+        const glm::vec3 position{
+            (static_cast<float>(avatar % side) - half +
+             Detail::random(id, 0) * 0.3f) *
+                Spacing,
+            0.0f,
+            (static_cast<float>(avatar / side) - half +
+             Detail::random(id, 1) * 0.3f) *
+                Spacing};
+
+        const Scene::Entity entity{animal_->spawn(
+            registry_,
+            glm::rotate(glm::translate(glm::mat4{1.0f}, position),
+                        Detail::random(id, 2) * 2.0f * glm::pi<float>(),
+                        glm::vec3{0.0f, 1.0f, 0.0f}),
+            rigRadius_)};
+        avatarTree_.insert(position - glm::vec3{rigRadius_},
+                           position + glm::vec3{rigRadius_},
+                           static_cast<std::uint32_t>(avatar));
+        const float togglePeriod{4.0f + Detail::random(id, 4) * 6.0f};
+        registry_.emplace<Behaviour>(
+            entity, Behaviour{0.0f, 0, false, togglePeriod,
+                              togglePeriod * Detail::random(id, 5)});
+
+        // Out of step with each other, breathing all along
+        Scene::AnimationState &animation{animations_[avatar]};
+        animation.human.parameters[humanControls_.breath] = 1.0f;
+        animation.pig.parameters[pigControls_.breath] = 1.0f;
+        humanGraph_->update(animation.human, Detail::random(id, 3) * 4.0f);
+        pigGraph_->update(animation.pig, Detail::random(id, 3) * 4.0f);
+        chooseActivity(avatar);
+    }
+
+    radius_ = (half + 1.0f) * Spacing * glm::root_two<float>();
+
+    visible_.resize(batches_.size());
+    levels_.resize(batches_.size());
+    for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+    {
+        visible_[batch].assign(avatars * slotsPerAvatar_[batch], 0);
+        levels_[batch].assign(avatars * slotsPerAvatar_[batch], 0);
+    }
+}
+
+void Crowd::toggleForm()
+{
+    registry_.each<Scene::AnimationState>(
+        [](const Scene::Entity &, Scene::AnimationState &animation) {
+            animation.humanForm = !animation.humanForm;
+            animation.morphProgress = 0.0f;
+        });
+}
+
+void Crowd::simulate(const Request &request, Frame &frame)
+{
+    PROGRAM_TRACE_SCOPE("crowd", "Crowd::simulate");
+
+    std::atomic<std::uint32_t> transforms{0};
+    std::mutex cullingMutex;
+    const Math::Frustum frustum{request.projection * request.view};
+
+    for (std::uint32_t toggle = 0; toggle < request.toggles; ++toggle)
+    {
+        toggleForm();
+    }
+
+    // Slots are reused as they are, every avatar's range is rewritten below
+    frame.sequence = request.sequence;
+    frame.view = request.view;
+    frame.projection = request.projection;
+    frame.instances.resize(batches_.size());
+    frame.positions.resize(batches_.size());
+    frame.drawCounts.resize(batches_.size());
+    for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+    {
+        frame.instances[batch].resize(registry_.size() * slotsPerAvatar_[batch]);
+        frame.positions[batch].resize(frame.instances[batch].size());
+        frame.drawCounts[batch].resize(
+            batches_[batch]->geometry()->levelCount());
+    }
+    frame.forms.resize(registry_.size());
+    frame.inView.resize(registry_.size());
+    frame.culling = Math::CullingStatistics{};
+
+    jobSystem_->parallelFor(
+        registry_.size(), Detail::avatarsPerChunk,
+        [&](std::size_t begin, std::size_t end) {
+            Math::CullingStatistics chunk;
+            transforms.fetch_add(updateAvatars(begin, end, request, frustum,
+                                               frame, chunk),
+                                 std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock{cullingMutex};
+            Detail::addCulling(frame.culling, chunk);
+        });
+
+    compact(frame);
+    frame.transforms = transforms.load(std::memory_order_relaxed);
+}
+
+void Crowd::draw(const Frame &frame)
+{
+    PROGRAM_TRACE_SCOPE("crowd", "Crowd::draw");
+
+    if (frame.sequence == 0)
+    {
+        return;
+    }
+
+    const glm::mat4 viewProjection{frame.projection * frame.view};
+
+    Detail::addCulling(Math::CullingStatistics::current(), frame.culling);
+    // Every joint of every avatar is recomputed, none of it is cached
+    SkeletonStatistics &statistics{SkeletonStatistics::current()};
+    statistics.localTransforms += frame.transforms;
+    statistics.worldTransforms += frame.transforms;
+
+    for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+    {
+        batches_[batch]->draw(viewProjection, frame.instances[batch],
+                              frame.drawCounts[batch]);
+    }
+
+    if (occlusionCulling_)
+    {
+        queryOcclusion(frame, viewProjection);
+    }
+}
+
+void Crowd::collectOcclusion()
+{
+    PROGRAM_TRACE_SCOPE("crowd", "Crowd::collectOcclusion");
+
+    // Results of earlier frames which arrived, the others are not waited for
+    for (std::size_t avatar = 0; avatar < occlusionQueries_.size(); ++avatar)
+    {
+        OpenGL::OpenGLQuery &query{occlusionQueries_[avatar]};
+        if (!query.isResultAvailable())
+        {
+            continue;
+        }
+
+        // Hidden only after several results in a row, seen after one
+        if (query.result() != 0)
+        {
+            hiddenResults_[avatar] = 0;
+        }
+        else if (hiddenResults_[avatar] < OccludedResults)
+        {
+            ++hiddenResults_[avatar];
+        }
+        occluded_[avatar] = hiddenResults_[avatar] >= OccludedResults ? 1 : 0;
+    }
+}
+
+void Crowd::queryOcclusion(const Frame &frame,
+                           const glm::mat4 &viewProjection)
+{
+    PROGRAM_TRACE_SCOPE("crowd", "Crowd::queryOcclusion");
+
+    const glm::vec3 eye{glm::inverse(frame.view)[3]};
+    const glm::vec3 boxCentre{0.5f * (rigBoxMinimum_ + rigBoxMaximum_)};
+    const glm::vec3 boxHalfSize{0.5f * (rigBoxMaximum_ - rigBoxMinimum_)};
+
+    // The boxes are tested against the depth of the avatars drawn, without
+    // changing it or the colour
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    boundsShader_->use();
+    boxArray_->bind();
+
+    for (std::size_t avatar = 0; avatar < occlusionQueries_.size(); ++avatar)
+    {
+        OpenGL::OpenGLQuery &query{occlusionQueries_[avatar]};
+        if (!frame.inView[avatar])
+        {
+            // Once back in view it is drawn until queried again
+            occluded_[avatar] = 0;
+            hiddenResults_[avatar] = 0;
+            continue;
+        }
+        if (query.isPending())
+        {
+            continue;
+        }
+
+        const glm::vec3 centre{glm::vec3{transforms_[avatar].world[3]} +
+                               boxCentre};
+
+        // None of the faces of a box around the camera are drawn
+        if (glm::all(glm::lessThanEqual(glm::abs(eye - centre),
+                                        boxHalfSize +
+                                            glm::vec3{Detail::nearMargin})))
+        {
+            hiddenResults_[avatar] = 0;
+            occluded_[avatar] = 0;
+            continue;
+        }
+
+        boundsShader_->setValue<4, 4>(
+            "transform",
+            viewProjection *
+                glm::scale(glm::translate(glm::mat4{1.0f}, centre),
+                           boxHalfSize),
+            false);
+        query.begin();
+        glDrawArrays(GL_TRIANGLES, 0, Detail::boxVertices);
+        query.end();
+        ++OpenGL::OpenGLStatistics::current().drawCalls;
+    }
+
+    boxArray_->release();
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+std::uint32_t Crowd::updateAvatars(std::size_t begin, std::size_t end,
+                                   const Request &request,
+                                   const Math::Frustum &frustum, Frame &frame,
+                                   Math::CullingStatistics &culling)
+{
+    std::uint32_t transforms{0};
+
+    // The chunk's avatars in one batch of plane tests, straight from the
+    // packed bounds
+    static_assert(sizeof(Scene::Bounds) == sizeof(glm::vec4),
+                  "Scene::Bounds is a packed array of spheres");
+    Math::CullSpheres(frustum, &bounds_[begin].sphere, end - begin,
+                      frame.inView.data() + begin);
+
+    for (std::size_t avatar = begin; avatar < end; ++avatar)
+    {
+        advance(avatar, request.deltaTime);
+
+        if (!frame.inView[avatar])
+        {
+            ++culling.avatarsCulled;
+        }
+        else if (!request.occluded.empty() && request.occluded[avatar])
+        {
+            ++culling.avatarsOccluded;
+        }
+        else
+        {
+            ++culling.avatarsDrawn;
+            transforms += pose(avatar, frustum, request.lod, frame, culling);
+            continue;
+        }
+
+        for (const RigJoint &joint : drawnJoints(avatar))
+        {
+            culling.partsCulled += joint.batch >= 0 ? 1 : 0;
+        }
+        clear(avatar, frame);
+    }
+
+    return transforms;
+}
+
+void Crowd::advance(std::size_t avatar, float deltaTime)
+{
+    Behaviour &behaviour{behaviours_[avatar]};
+    Scene::AnimationState &animation{animations_[avatar]};
+
+    behaviour.activityTimer -= deltaTime;
+    if (behaviour.activityTimer <= 0.0f)
+    {
+        chooseActivity(avatar);
+    }
+
+    const float gestureStep{(behaviour.gesturing ? 1.0f : -1.0f) * deltaTime *
+                            Detail::gestureSpeed};
+    float &humanGesture{animation.human.parameters[humanControls_.gesture]};
+    float &pigGesture{animation.pig.parameters[pigControls_.gesture]};
+    humanGesture = std::min(std::max(humanGesture + gestureStep, 0.0f), 1.0f);
+    pigGesture = std::min(std::max(pigGesture + gestureStep, 0.0f), 1.0f);
+
+    // Both rigs play along, the avatar may morph at any time
+    humanGraph_->update(animation.human, deltaTime);
+    pigGraph_->update(animation.pig, deltaTime);
+
+    behaviour.toggleTimer -= deltaTime;
+    if (behaviour.toggleTimer <= 0.0f)
+    {
+        behaviour.toggleTimer += behaviour.togglePeriod;
+        animation.humanForm = !animation.humanForm;
+        animation.morphProgress = 0.0f;
+    }
+
+    float &progress{animation.morphProgress};
+    if (progress < 1.0f)
+    {
+        progress = std::min(progress + deltaTime * Detail::morphSpeed, 1.0f);
+    }
+}
+
+void Crowd::chooseActivity(std::size_t avatar)
+{
+    const auto id = static_cast<std::uint32_t>(avatar);
+    Behaviour &behaviour{behaviours_[avatar]};
+    const std::uint32_t stream{8u + 3u * behaviour.activities++};
+
+    behaviour.activityTimer += 3.0f + Detail::random(id, stream) * 5.0f;
+    behaviour.gesturing =
+        Detail::random(id, stream + 2u) < Detail::gestureChance;
+
+    Scene::AnimationState &animation{animations_[avatar]};
+    const bool walking{Detail::random(id, stream + 1u) < Detail::walkChance};
+    humanGraph_->requestState(animation.human, humanControls_.locomotion,
+                              walking ? humanControls_.walk : humanControls_.idle);
+    pigGraph_->requestState(animation.pig, pigControls_.locomotion,
+                            walking ? pigControls_.walk : pigControls_.idle);
+}
+
+Crowd::DrawnForm Crowd::drawnForm(std::size_t avatar) const
+{
+    const bool human{animations_[avatar].humanForm};
+    const float progress{animations_[avatar].morphProgress};
+
+    if (progress < 1.0f)
+    {
+        const float weight{human ? 1.0f - progress : progress};
+        return weight < 0.5f ? MorphHumanForm : MorphPigForm;
+    }
+
+    return human ? HumanForm : PigForm;
+}
+
+const std::vector<Crowd::RigJoint> &Crowd::formJoints(DrawnForm form) const
+{
+    switch (form)
+    {
+    case HumanForm:
+        return humanJoints_;
+    case PigForm:
+        return pigJoints_;
+    case MorphHumanForm:
+        return morphHumanJoints_;
+    default:
+        return morphPigJoints_;
+    }
+}
+
+const std::vector<Crowd::RigJoint> &
+Crowd::drawnJoints(std::size_t avatar) const
+{
+    return formJoints(drawnForm(avatar));
+}
+
+void Crowd::clear(std::size_t avatar, Frame &frame)
+{
+    for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+    {
+        const std::size_t first{avatar * slotsPerAvatar_[batch]};
+        std::memset(
+            static_cast<void *>(frame.instances[batch].data() + first), 0,
+            sizeof(Model::InstanceTransform) * slotsPerAvatar_[batch]);
+        std::memset(visible_[batch].data() + first, 0, slotsPerAvatar_[batch]);
+    }
+}
+
+Crowd::Pick Crowd::pick(const Frame &frame, const glm::vec3 &origin,
+                        const glm::vec3 &direction) const
+{
+    PROGRAM_TRACE_SCOPE("crowd", "Crowd::pick");
+
+    Pick nearest{-1, nullptr, -1, 1.0f};
+    if (frame.sequence == 0)
+    {
+        return nearest;
+    }
+
+    // Avatars nearest first, the joints of each placed as the frame draws
+    // them, every hit clips the ray for the rest
+    avatarTree_.raycast(origin, direction, nearest.distance, [&](int proxy,
+                                                                 float) {
+        const std::size_t avatar{avatarTree_.userData(proxy)};
+        const DrawnForm form{static_cast<DrawnForm>(frame.forms[avatar])};
+        const std::vector<RigJoint> &drawn{formJoints(form)};
+        const bool human{form == HumanForm || form == MorphHumanForm};
+        const bool morphing{form == MorphHumanForm || form == MorphPigForm};
+
+        for (std::size_t i = 0; i < drawn.size(); ++i)
+        {
+            const RigJoint &joint{drawn[i]};
+            if (joint.batch < 0)
+            {
+                continue;
+            }
+            const std::uint32_t position{
+                frame.positions[joint.batch]
+                               [avatar * slotsPerAvatar_[joint.batch] +
+                                joint.slot]};
+            if (position == Frame::Hidden)
+            {
+                continue;
+            }
+
+            const float distance{animal_->raycastMesh(
+                *batches_[joint.batch]->geometry(),
+                Detail::instanceMatrix(frame.instances[joint.batch][position]),
+                origin, direction, nearest.distance)};
+            if (distance < 0.0f)
+            {
+                continue;
+            }
+
+            const MorphCorrespondence::Pair *pair{
+                morphing ? &morph_.pair(i) : nullptr};
+            nearest.avatar = static_cast<int>(avatar);
+            nearest.rig = human ? &humanRig_ : &pigRig_;
+            nearest.joint = !pair ? static_cast<int>(i)
+                                  : human ? pair->first : pair->second;
+            nearest.distance = distance;
+        }
+
+        return nearest.distance;
+    });
+
+    return nearest;
+}
+
+std::size_t Crowd::resolve(std::size_t avatar)
+{
+    Detail::PoseScratch &scratch{Detail::poseScratch};
+    PosePool &pool{Detail::posePool};
+
+    Scene::AnimationState &animation{animations_[avatar]};
+    const bool human{animation.humanForm};
+    const float progress{animation.morphProgress};
+
+    std::size_t joints{0};
+    Pose *humanPose{nullptr};
+    Pose *pigPose{nullptr};
+    // The graph's pose or the blend of both in the scratch
+    const glm::vec3 *offsets{nullptr};
+    const glm::vec3 *rotations{nullptr};
+
+    if (progress < 1.0f)
+    {
+        // Blend the paired joints of both graphs' poses like
+        // Animal::drawTransformation blends the captured ones
+        const float weight{human ? 1.0f - progress : progress};
+        const std::vector<RigJoint> &morphJoints{drawnJoints(avatar)};
+
+        humanPose = humanGraph_->evaluate(animation.human, pool);
+        pigPose = pigGraph_->evaluate(animation.pig, pool);
+
+        joints = morph_.size();
+        scratch.resize(joints);
+        morph_.blend(weight, *humanPose, *pigPose, scratch.offsets.data(),
+                     scratch.rotations.data(), scratch.sizes.data());
+        offsets = scratch.offsets.data();
+        rotations = scratch.rotations.data();
+
+        for (std::size_t i = 0; i < joints; ++i)
+        {
+            scratch.morphWeights[i] = morph_.shapeWeight(i, weight);
+            scratch.parents[i] = morph_.pair(i).parent;
+            scratch.drawn[i] =
+                morphJoints[i].batch >= 0 ? &morphJoints[i] : nullptr;
+        }
+    }
+    else
+    {
+        const Skeleton &rig{human ? humanRig_ : pigRig_};
+        const std::vector<RigJoint> &rigJoints{drawnJoints(avatar)};
+        Pose *&pose{human ? humanPose : pigPose};
+
+        pose = human ? humanGraph_->evaluate(animation.human, pool)
+                     : pigGraph_->evaluate(animation.pig, pool);
+
+        joints = static_cast<std::size_t>(rig.jointCount());
+        scratch.resize(joints);
+        offsets = pose->offsets.data();
+        rotations = pose->rotations.data();
+        std::copy(pose->sizes.begin(), pose->sizes.begin() + joints,
+                  scratch.sizes.begin());
+
+        for (std::size_t i = 0; i < joints; ++i)
+        {
+            const int joint{static_cast<int>(i)};
+
+            scratch.morphWeights[i] = 0.0f;
+            scratch.parents[i] = rig.parent(joint);
+            scratch.drawn[i] = rigJoints[i].batch >= 0 ? &rigJoints[i] : nullptr;
+        }
+    }
+
+    Math::ComposeEulerTransforms(offsets, rotations, nullptr, joints,
+                                 scratch.transforms.data());
+
+    // Joints are stored parents first, one pass resolves the world transforms
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+        const int parent{scratch.parents[i]};
+
+        scratch.transforms[i] =
+            (parent == Skeleton::NoParent ? transforms_[avatar].world
+                                          : scratch.transforms[parent]) *
+            scratch.transforms[i];
+    }
+
+    for (Pose *pose : {humanPose, pigPose})
+    {
+        if (pose)
+        {
+            pool.release(pose);
+        }
+    }
+
+    return joints;
+}
+
+std::uint32_t Crowd::pose(std::size_t avatar, const Math::Frustum &frustum,
+                          const Model::LodView &lod, Frame &frame,
+                          Math::CullingStatistics &culling)
+{
+    Detail::PoseScratch &scratch{Detail::poseScratch};
+    const std::size_t joints{resolve(avatar)};
+    const glm::vec3 *sizes{scratch.sizes.data()};
+
+    // Clear the avatar's instances, the current form may use fewer
+    clear(avatar, frame);
+    frame.forms[avatar] = drawnForm(avatar);
+
+    // A mesh without bounds is never culled
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+        if (const auto *drawn = static_cast<const RigJoint *>(scratch.drawn[i]))
+        {
+            const Math::Bounds &bounds{
+                batches_[drawn->batch]->geometry()->bounds()};
+            scratch.spheres[i] =
+                bounds.empty()
+                    ? glm::vec4{0.0f, 0.0f, 0.0f,
+                                std::numeric_limits<float>::infinity()}
+                    : Math::TransformSphere(
+                          bounds.sphere,
+                          glm::scale(scratch.transforms[i], sizes[i]));
+        }
+    }
+
+    Math::CullSpheres(frustum, scratch.spheres.data(), joints,
+                      scratch.visible.data());
+
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+        const auto *drawn = static_cast<const RigJoint *>(scratch.drawn[i]);
+        if (!drawn)
+        {
+            continue;
+        }
+        if (!scratch.visible[i])
+        {
+            ++culling.partsCulled;
+            continue;
+        }
+
+        const std::size_t slot{avatar * slotsPerAvatar_[drawn->batch] +
+                               drawn->slot};
+        Detail::writeInstance(scratch.transforms[i], sizes[i],
+                              scratch.morphWeights[i],
+                              frame.instances[drawn->batch][slot]);
+
+        // As coarse as the part's size on screen allows
+        std::uint8_t &level{levels_[drawn->batch][slot]};
+        level = static_cast<std::uint8_t>(
+            Model::SelectLevel(*batches_[drawn->batch]->geometry(),
+                               scratch.spheres[i], lod, level));
+        visible_[drawn->batch][slot] = static_cast<std::uint8_t>(level + 1);
+        ++culling.partsDrawn;
+    }
+
+    return static_cast<std::uint32_t>(joints);
+}
+
+void Crowd::compact(Frame &frame)
+{
+    // Visible instances to the front, in order, grouped by level of detail.
+    // The avatar ranges are all rewritten by the next simulate
+    for (std::size_t batch = 0; batch < batches_.size(); ++batch)
+    {
+        std::vector<Model::InstanceTransform> &instances{
+            frame.instances[batch]};
+        const std::vector<std::uint8_t> &visible{visible_[batch]};
+        std::vector<std::uint32_t> &positions{frame.positions[batch]};
+        std::vector<std::size_t> &counts{frame.drawCounts[batch]};
+
+        std::fill(counts.begin(), counts.end(), 0);
+        std::size_t count{0};
+        for (std::size_t instance = 0; instance < instances.size(); ++instance)
+        {
+            if (visible[instance])
+            {
+                ++counts[visible[instance] - 1];
+                ++count;
+            }
+        }
+
+        if (counts.front() == count)
+        {
+            // Every instance in full, compacted in place
+            count = 0;
+            for (std::size_t instance = 0; instance < instances.size();
+                 ++instance)
+            {
+                if (visible[instance])
+                {
+                    positions[instance] = static_cast<std::uint32_t>(count);
+                    instances[count++] = instances[instance];
+                }
+                else
+                {
+                    positions[instance] = Frame::Hidden;
+                }
+            }
+            continue;
+        }
+
+        std::vector<std::size_t> &offsets{levelOffsets_};
+        offsets.assign(counts.size(), 0);
+        for (std::size_t level = 1; level < counts.size(); ++level)
+        {
+            offsets[level] = offsets[level - 1] + counts[level - 1];
+        }
+
+        sorted_.resize(instances.size());
+        for (std::size_t instance = 0; instance < instances.size(); ++instance)
+        {
+            if (visible[instance])
+            {
+                std::size_t &offset{offsets[visible[instance] - 1]};
+                positions[instance] = static_cast<std::uint32_t>(offset);
+                sorted_[offset++] = instances[instance];
+            }
+            else
+            {
+                positions[instance] = Frame::Hidden;
+            }
+        }
+        instances.swap(sorted_);
+    }
+}
@@ -0,0 +1,328 @@
+#ifndef HOMEWORK01_AVATAR_CROWD_HPP_
+#define HOMEWORK01_AVATAR_CROWD_HPP_
+
+#include "Avatar/Animal.hpp"
+#include "Avatar/AnimationGraph.hpp"
+#include "Avatar/MorphCorrespondence.hpp"
+#include "Avatar/Skeleton.hpp"
+#include "Model/InstanceBatch.hpp"
+#include "Model/LevelOfDetail.hpp"
+#include "OpenGL/OpenGLBufferObject.hpp"
+#include "OpenGL/OpenGLQuery.hpp"
+#include "OpenGL/OpenGLShaderProgram.hpp"
+#include "OpenGL/OpenGLVertexArrayObject.hpp"
+#include "Scene/Components.hpp"
+#include "Scene/Registry.hpp"
+#include "Utils/Math/DynamicBvh.hpp"
+#include "Utils/Math/Frustum.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Parallel
+{
+class JobSystem;
+} // namespace Parallel
+
+/**
+ * @brief Herd of avatars sharing the rigs and GPU resources of one Animal.
+ *
+ * @details Avatars are entities of the crowd's Scene::Registry spawned by
+ * Animal::spawn, they only store their own state: placement, bounds, form,
+ * morph progress and an instance of the animation graph of each rig, see
+ * Animal::getHumanGraph, and what they do next. Avatars idle, walk and
+ * gesture at random. Their graphs are evaluated and their joint transforms
+ * recomputed every frame, in parallel over the avatars on a
+ * Parallel::JobSystem with a PosePool per thread, and written straight into
+ * the instance arrays of a Crowd::Frame. While morphing both graphs are
+ * evaluated and blended through the MorphCorrespondence.
+ *
+ * Crowd::simulate touches no GL state, it may run on another thread than the
+ * one which draws, see CrowdSimulation. It owns the avatars' components and
+ * writes only the frame it is given, Crowd::draw reads only its frame and
+ * the GL objects. Everything else but Crowd::pick must not run concurrently
+ * with Crowd::simulate.
+ *
+ * Joint meshes with the same geometry and texture are drawn by one
+ * Model::InstanceBatch, the whole herd takes a few draw calls.
+ *
+ * Every avatar owns a fixed range of instances in each batch, large enough
+ * for either form and the morph, so the parallel update writes without any
+ * synchronization. Instances an avatar does not use are zeroed.
+ *
+ * Avatars are culled against the view frustum by a sphere around their root
+ * which contains either rig in any pose. Culled avatars keep playing but are
+ * not posed, the joints of the others are culled by the bounds of their
+ * meshes. Only the visible instances are moved to the front of each batch
+ * and drawn, grouped by the level of detail Model::SelectLevel picks for the
+ * size of the joint on screen, one draw call per level used. The same
+ * spheres' boxes make the tree ray and overlap queries start from, see
+ * Crowd::avatarTree. Crowd::pick tests the meshes' triangles of only the
+ * avatars the tree finds along the ray, placed as a frame drew them.
+ *
+ * With occlusion culling on, a box of every avatar in view is drawn after
+ * the herd, colour and depth writes off, inside a GL_ANY_SAMPLES_PASSED
+ * query. Crowd::collectOcclusion reads the results which have arrived,
+ * without waiting for the others, and the next requests skip an avatar once
+ * Crowd::OccludedResults results in a row found it hidden. It is drawn again
+ * from the first result which sees it, and whenever it enters the view.
+ */
+class Crowd
+{
+public:
+    // Distance between neighbouring avatars on the spawn grid
+    static constexpr float Spacing = 6.0f;
+    // Occlusion query results in a row which must find an avatar hidden
+    // before it is skipped, against popping on the edges of its occluders
+    static constexpr std::uint8_t OccludedResults = 3;
+
+    /**
+     * @brief Spawn \a count avatars on a grid around the origin, with the rigs
+     * and meshes of \a animal, which must outlive the crowd.
+     */
+    explicit Crowd(const Animal &animal, int count,
+                   Parallel::JobSystem &jobSystem);
+    ~Crowd();
+
+    Crowd(const Crowd &other) = delete;
+    Crowd &operator=(const Crowd &other) = delete;
+
+    int size() const noexcept;
+    /**
+     * @brief Gets the radius around the origin which contains every avatar.
+     */
+    float radius() const noexcept;
+    std::size_t instanceCount() const noexcept;
+    std::size_t batchCount() const noexcept;
+    /**
+     * @brief Gets a box around every avatar which contains it in any pose,
+     * the user data is the avatar.
+     */
+    const Math::DynamicBvh &avatarTree() const noexcept { return avatarTree_; }
+
+    /**
+     * @brief Input of a Crowd::simulate, gathered by the thread which draws.
+     */
+    struct Request
+    {
+        std::uint64_t sequence = 0;
+        float deltaTime = 0.0f;
+        // Camera the avatars are culled and their levels of detail picked for
+        glm::mat4 view;
+        glm::mat4 projection;
+        Model::LodView lod;
+        std::uint32_t toggles = 0; // Crowd::toggleForm calls to make first
+        // Per avatar, see Crowd::occluded, empty without occlusion culling
+        std::vector<std::uint8_t> occluded;
+    };
+
+    /**
+     * @brief The crowd as one Crowd::simulate posed it, everything
+     * Crowd::draw reads.
+     */
+    struct Frame
+    {
+        static constexpr std::uint32_t Hidden = 0xffffffffu;
+
+        std::uint64_t sequence = 0; // of the request, 0 if never simulated
+        glm::mat4 view;
+        glm::mat4 projection;
+        // Per batch the visible instances sorted by level of detail, and per
+        // batch and level how many of them are drawn at that level
+        std::vector<std::vector<Model::InstanceTransform>> instances;
+        std::vector<std::vector<std::size_t>> drawCounts;
+        // Per batch and slot of an avatar the index of its instance in
+        // instances, Crowd::Frame::Hidden if it is not drawn
+        std::vector<std::vector<std::uint32_t>> positions;
+        std::vector<std::uint8_t> forms;  // per avatar, the joints drawn
+        std::vector<std::uint8_t> inView; // per avatar
+        Math::CullingStatistics culling;
+        std::uint32_t transforms = 0; // joint transforms recomputed
+    };
+
+    // Joint hit by a ray, avatar is -1 if none is
+    struct Pick
+    {
+        int avatar;
+        const Skeleton *rig; // of the form the avatar looks like
+        int joint;           // of rig, -1 for a morph part it lacks
+        float distance;      // in units of the ray's direction
+    };
+
+    /**
+     * @brief Gets the nearest joint the segment from \a origin to
+     * \a origin + \a direction hits, the avatars placed as \a frame draws
+     * them.
+     *
+     * @details Reads only the frame and what the crowd never changes after
+     * it is spawned, it may run while Crowd::simulate poses the next frame.
+     */
+    Pick pick(const Frame &frame, const glm::vec3 &origin,
+              const glm::vec3 &direction) const;
+
+    /**
+     * @brief Start the morph of every avatar, like Animal::toggleForm.
+     */
+    void toggleForm();
+
+    /**
+     * @brief Skip avatars hidden behind others, see the class description.
+     * Every avatar is visible again after a change.
+     */
+    void setOcclusionCulling(bool enabled);
+    bool occlusionCulling() const noexcept { return occlusionCulling_; }
+    /**
+     * @brief Read the occlusion query results which arrived since the last
+     * call, for the next Request::occluded.
+     */
+    void collectOcclusion();
+    // Per avatar, 1 if the next simulate should skip it
+    const std::vector<std::uint8_t> &occluded() const noexcept
+    {
+        return occluded_;
+    }
+
+    /**
+     * @brief Advance every avatar by the request's time and resolve the
+     * joint transforms of those in its view into \a frame, every part at the
+     * level of detail its LodView selects.
+     *
+     * @details Every instance of \a frame is rewritten, it may hold any
+     * earlier frame.
+     */
+    void simulate(const Request &request, Frame &frame);
+    /**
+     * @brief Draw \a frame from its own camera, with the frame's statistics
+     * added to the current ones. A frame never simulated draws nothing.
+     */
+    void draw(const Frame &frame);
+
+private:
+    // Where a rig joint is drawn, batch is -1 for joints without a mesh
+    struct RigJoint
+    {
+        int batch;
+        std::size_t slot; // offset inside the avatar's range of the batch
+    };
+
+    // Nodes and parameters of a rig's graph the avatars drive
+    struct GraphControls
+    {
+        int locomotion;
+        int idle;
+        int walk;
+        int gesture;
+        int breath;
+    };
+
+    // Joints an avatar is drawn with, Crowd::Frame::forms
+    enum DrawnForm : std::uint8_t
+    {
+        HumanForm,
+        PigForm,
+        MorphHumanForm, // pairs, closer to the human
+        MorphPigForm
+    };
+
+    // What an avatar does next, a component of its entity
+    struct Behaviour
+    {
+        float activityTimer;
+        std::uint32_t activities; // chosen so far
+        bool gesturing;
+        float togglePeriod;
+        float toggleTimer;
+    };
+
+    static GraphControls FindControls(const AnimationGraph &graph) noexcept;
+
+    void createRigJoints(const Skeleton &rig, std::vector<RigJoint> &joints);
+    // Joints a morph draws at \a weight, see MorphCorrespondence::model
+    void createMorphJoints(float weight, std::vector<RigJoint> &joints);
+    RigJoint createRigJoint(const Model::Mesh *mesh,
+                            std::vector<std::size_t> &slots);
+    void createBox();
+    void measureRig(Skeleton &rig);
+    void spawn(int count);
+
+    std::uint32_t updateAvatars(std::size_t begin, std::size_t end,
+                                const Request &request,
+                                const Math::Frustum &frustum, Frame &frame,
+                                Math::CullingStatistics &culling);
+    void advance(std::size_t avatar, float deltaTime);
+    void chooseActivity(std::size_t avatar);
+    // Joints the avatar draws in its current form or morph
+    DrawnForm drawnForm(std::size_t avatar) const;
+    const std::vector<RigJoint> &formJoints(DrawnForm form) const;
+    const std::vector<RigJoint> &drawnJoints(std::size_t avatar) const;
+    void clear(std::size_t avatar, Frame &frame);
+    // Evaluate the avatar's graphs into the thread's PoseScratch and resolve
+    // the world transforms, returns the number of joints
+    std::size_t resolve(std::size_t avatar);
+    std::uint32_t pose(std::size_t avatar, const Math::Frustum &frustum,
+                       const Model::LodView &lod, Frame &frame,
+                       Math::CullingStatistics &culling);
+    void compact(Frame &frame);
+    void queryOcclusion(const Frame &frame, const glm::mat4 &viewProjection);
+
+    Parallel::JobSystem *jobSystem_;
+    const Animal *animal_; // ray casts against its meshes
+
+    // Shared rig templates
+    Skeleton humanRig_;
+    Skeleton pigRig_;
+    std::vector<RigJoint> humanJoints_;
+    std::vector<RigJoint> pigJoints_;
+    MorphCorrespondence morph_;
+    std::vector<RigJoint> morphHumanJoints_; // per morph pair
+    std::vector<RigJoint> morphPigJoints_;
+    const AnimationGraph *humanGraph_;
+    const AnimationGraph *pigGraph_;
+    GraphControls humanControls_;
+    GraphControls pigControls_;
+
+    std::vector<std::unique_ptr<OpenGL::OpenGLShaderProgram>> shaders_;
+    OpenGL::OpenGLShaderProgram *boundsShader_ = nullptr;
+    // Box from -1 to 1 the occlusion queries draw
+    std::unique_ptr<OpenGL::OpenGLVertexArrayObject> boxArray_;
+    std::unique_ptr<OpenGL::OpenGLBufferObject> boxBuffer_;
+    std::vector<std::unique_ptr<Model::InstanceBatch>> batches_;
+    std::vector<std::size_t> slotsPerAvatar_; // per batch
+    // Per batch and instance the level of detail plus one, 0 if hidden
+    std::vector<std::vector<std::uint8_t>> visible_;
+    // Per batch and instance the level of detail chosen last
+    std::vector<std::vector<std::uint8_t>> levels_;
+    // Instances sorted by level while compacting, and the next of each level
+    std::vector<Model::InstanceTransform> sorted_;
+    std::vector<std::size_t> levelOffsets_;
+
+    // Avatars are spawned in order and never destroyed, an avatar's
+    // components sit at its index of every pool's packed array
+    Scene::Registry registry_;
+    Scene::ComponentPool<Scene::Transform> &transforms_;
+    Scene::ComponentPool<Scene::Bounds> &bounds_;
+    Scene::ComponentPool<Scene::AnimationState> &animations_;
+    Scene::ComponentPool<Behaviour> &behaviours_;
+
+    // Per avatar occlusion state, of the thread which draws
+    std::vector<OpenGL::OpenGLQuery> occlusionQueries_; // empty while off
+    std::vector<std::uint8_t> occluded_;
+    std::vector<std::uint8_t> hiddenResults_; // in a row, up to OccludedResults
+    Math::DynamicBvh avatarTree_;
+
+    float radius_ = 0.0f;
+    float rigRadius_ = 0.0f; // around the root, of either rig in any pose
+    // Around the root, of either rig turned any way, drawn by the queries
+    glm::vec3 rigBoxMinimum_{0.0f};
+    glm::vec3 rigBoxMaximum_{0.0f};
+    bool occlusionCulling_ = false;
+};
+
+#endif // HOMEWORK01_AVATAR_CROWD_HPP_
@@ -0,0 +1,123 @@
+#include "CrowdSimulation.hpp"
+
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include <utility>
+
+CrowdSimulation::CrowdSimulation()
+{
+    thread_ = std::thread{&CrowdSimulation::run, this};
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    wake_.wait(lock, [this] { return ready_; });
+}
+
+CrowdSimulation::~CrowdSimulation()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    thread_.join();
+}
+
+void CrowdSimulation::setCrowd(Crowd *crowd)
+{
+    std::lock_guard<std::mutex> lock{crowdMutex_};
+    crowd_ = crowd;
+}
+
+const Crowd::Frame &CrowdSimulation::acquire(bool wait)
+{
+    PROGRAM_TRACE_SCOPE("crowd", "CrowdSimulation::acquire");
+
+    if (wait)
+    {
+        // The simulation of one frame rarely takes long, spin rather than
+        // sleep
+        while (published_.load(std::memory_order_acquire) < submitted_)
+        {
+            std::this_thread::yield();
+        }
+    }
+    frames_.update();
+
+    return frames_.front();
+}
+
+void CrowdSimulation::submit(float deltaTime, const glm::mat4 &view,
+                             const glm::mat4 &projection,
+                             const Model::LodView &lod)
+{
+    PROGRAM_TRACE_SCOPE("crowd", "CrowdSimulation::submit");
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        // A request the thread did not take yet is caught up by this one
+        if (!hasPending_)
+        {
+            pending_.deltaTime = 0.0f;
+            pending_.toggles = 0;
+        }
+        pending_.sequence = ++submitted_;
+        pending_.deltaTime += deltaTime;
+        pending_.view = view;
+        pending_.projection = projection;
+        pending_.lod = lod;
+        pending_.toggles += toggles_;
+        if (crowd_ && crowd_->occlusionCulling())
+        {
+            pending_.occluded = crowd_->occluded();
+        }
+        else
+        {
+            pending_.occluded.clear();
+        }
+        hasPending_ = true;
+    }
+    toggles_ = 0;
+    wake_.notify_one();
+}
+
+void CrowdSimulation::run()
+{
+    // Thread 0 of the job system is this thread
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        jobSystem_.reset(new Parallel::JobSystem{});
+        ready_ = true;
+    }
+    wake_.notify_all();
+
+    Crowd::Request request;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            wake_.wait(lock, [this] { return hasPending_ || stopping_; });
+            if (stopping_)
+            {
+                break;
+            }
+
+            // Keep both buffers, the next request reuses their storage
+            std::swap(request, pending_);
+            hasPending_ = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{crowdMutex_};
+            if (crowd_)
+            {
+                crowd_->simulate(request, frames_.back());
+            }
+        }
+        frames_.publish();
+        published_.store(request.sequence, std::memory_order_release);
+    }
+
+    jobSystem_.reset();
+}
@@ -0,0 +1,104 @@
+#ifndef HOMEWORK01_AVATAR_CROWDSIMULATION_HPP_
+#define HOMEWORK01_AVATAR_CROWDSIMULATION_HPP_
+
+#include "Avatar/Crowd.hpp"
+#include "Model/LevelOfDetail.hpp"
+#include "Utils/Parallel/JobSystem.hpp"
+#include "Utils/Parallel/TripleBuffer.hpp"
+
+#include "glm/mat4x4.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Runs Crowd::simulate on a thread of its own, overlapped with the
+ * thread which draws.
+ *
+ * @details Every frame the drawing thread takes the newest Crowd::Frame with
+ * CrowdSimulation::acquire, submits the request for the next one and draws
+ * the frame it took while the simulation thread poses the next. Frames are
+ * handed over through a Parallel::TripleBuffer, the camera they were culled
+ * for travels with them, so what is drawn is always consistent. The drawn
+ * frame trails the requests by a frame, the first one draws no crowd.
+ *
+ * Requests submitted while the thread is still busy are merged, their times
+ * and form toggles add up, only the newest camera is kept. Without waiting
+ * in CrowdSimulation::acquire the frames drawn therefore depend on timing,
+ * with it every frame answers the request of the frame before.
+ *
+ * The thread creates the Parallel::JobSystem the crowd's avatars are updated
+ * on and takes part in it as its thread 0. The avatars belong to the thread
+ * while it runs, the drawing thread reads the crowd only through frames, e.g.
+ * for Crowd::pick.
+ */
+class CrowdSimulation
+{
+public:
+    /**
+     * @brief Start the thread, returns once its job system exists.
+     */
+    CrowdSimulation();
+    ~CrowdSimulation();
+
+    CrowdSimulation(const CrowdSimulation &other) = delete;
+    CrowdSimulation &operator=(const CrowdSimulation &other) = delete;
+
+    // Of the simulation thread, for the crowd
+    Parallel::JobSystem &jobSystem() noexcept { return *jobSystem_; }
+    /**
+     * @brief Simulate \a crowd from the next request on, nullptr for none.
+     * The crowd must stay alive until it is replaced.
+     */
+    void setCrowd(Crowd *crowd);
+
+    /**
+     * @brief Gets the newest frame, valid until the next call.
+     *
+     * @details With \a wait it blocks until the last request's frame is
+     * published. A frame of sequence 0 was never simulated.
+     */
+    const Crowd::Frame &acquire(bool wait);
+    // The frame the last CrowdSimulation::acquire returned
+    const Crowd::Frame &frame() const noexcept { return frames_.front(); }
+    /**
+     * @brief Ask for the crowd advanced by \a deltaTime seconds and posed
+     * for the camera of \a view and \a projection.
+     */
+    void submit(float deltaTime, const glm::mat4 &view,
+                const glm::mat4 &projection, const Model::LodView &lod);
+    /**
+     * @brief Crowd::toggleForm with the next request.
+     */
+    void toggleForm() noexcept { ++toggles_; }
+
+private:
+    void run();
+
+    std::thread thread_;
+    std::unique_ptr<Parallel::JobSystem> jobSystem_; // created by thread_
+    Crowd *crowd_ = nullptr;
+    Parallel::TripleBuffer<Crowd::Frame> frames_;
+    std::atomic<std::uint64_t> published_{0}; // sequence of the newest
+
+    // Requests to the thread, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    Crowd::Request pending_;
+    bool hasPending_ = false;
+    bool ready_ = false;
+    bool stopping_ = false;
+
+    // Of the drawing thread
+    std::uint64_t submitted_ = 0;
+    std::uint32_t toggles_ = 0;
+
+    // Held by the thread while it simulates
+    std::mutex crowdMutex_;
+};
+
+#endif // HOMEWORK01_AVATAR_CROWDSIMULATION_HPP_
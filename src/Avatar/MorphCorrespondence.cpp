@@ -0,0 +1,213 @@
+#include "MorphCorrespondence.hpp"
+
+#include "Avatar/AnimationGraph.hpp"
+
+#include <iostream>
+
+namespace Detail
+{
+
+void storeMorphPose(std::vector<float> &pose, std::size_t pairCount,
+                    std::size_t pair, const glm::vec3 &offset,
+                    const glm::vec3 &rotation, const glm::vec3 &size);
+void mixMorphChannel(const float *first, const float *second, float weight,
+                     std::size_t count, float *out) noexcept;
+
+void storeMorphPose(std::vector<float> &pose, std::size_t pairCount,
+                    std::size_t pair, const glm::vec3 &offset,
+                    const glm::vec3 &rotation, const glm::vec3 &size)
+{
+    const glm::vec3 *channels[]{&offset, &rotation, &size};
+
+    for (std::size_t channel = 0; channel < 3; ++channel)
+    {
+        float *out{pose.data() + (channel * pairCount + pair) * 3};
+        out[0] = channels[channel]->x;
+        out[1] = channels[channel]->y;
+        out[2] = channels[channel]->z;
+    }
+}
+
+void mixMorphChannel(const float *first, const float *second, float weight,
+                     std::size_t count, float *out) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        out[i] = first[i] + (second[i] - first[i]) * weight;
+    }
+}
+
+} // namespace Detail
+
+void MorphCorrespondence::build(const Skeleton &first, const Skeleton &second,
+                                const NamePair *names, std::size_t nameCount)
+{
+    pairs_.clear();
+
+    std::vector<int> secondOfFirst(first.jointCount(), Missing);
+    std::vector<int> firstOfSecond(second.jointCount(), Missing);
+
+    for (std::size_t i = 0; i < nameCount; ++i)
+    {
+        const int firstJoint{first.find(names[i].first)};
+        const int secondJoint{second.find(names[i].second)};
+
+        if (firstJoint < 0 || secondJoint < 0)
+        {
+            std::cerr << "[Error] MorphCorrespondence: Unknown joint pair "
+                      << names[i].first << ", " << names[i].second
+                      << std::endl;
+            continue;
+        }
+
+        secondOfFirst[firstJoint] = secondJoint;
+        firstOfSecond[secondJoint] = firstJoint;
+    }
+
+    // The first rig's hierarchy, matched or despawning
+    std::vector<int> pairOfSecond(second.jointCount(), Skeleton::NoParent);
+    std::vector<int> pairOfFirst(first.jointCount(), Skeleton::NoParent);
+    for (int joint = 0; joint < first.jointCount(); ++joint)
+    {
+        const int parent{first.parent(joint)};
+        const int pair{addPair(joint, secondOfFirst[joint],
+                               parent == Skeleton::NoParent
+                                   ? Skeleton::NoParent
+                                   : pairOfFirst[parent])};
+
+        pairOfFirst[joint] = pair;
+        if (secondOfFirst[joint] != Missing)
+        {
+            pairOfSecond[secondOfFirst[joint]] = pair;
+        }
+    }
+
+    // Then the joints only the second rig has, e.g. the pig's tail
+    for (int joint = 0; joint < second.jointCount(); ++joint)
+    {
+        if (firstOfSecond[joint] == Missing)
+        {
+            const int parent{second.parent(joint)};
+            pairOfSecond[joint] = addPair(Missing, joint,
+                                          parent == Skeleton::NoParent
+                                              ? Skeleton::NoParent
+                                              : pairOfSecond[parent]);
+        }
+    }
+
+    shapeModels_.assign(pairs_.size(), nullptr);
+    shapeTargetIsFirst_.assign(pairs_.size(), 0);
+
+    capture(first, second);
+}
+
+void MorphCorrespondence::capture(const Skeleton &first, const Skeleton &second)
+{
+    const std::size_t count{pairs_.size()};
+
+    firstPose_.assign(ChannelCount * count * 3, 0.0f);
+    secondPose_.assign(ChannelCount * count * 3, 0.0f);
+    firstModels_.assign(count, nullptr);
+    secondModels_.assign(count, nullptr);
+    firstNames_.assign(count, std::string{});
+    secondNames_.assign(count, std::string{});
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Pair &pair{pairs_[i]};
+
+        // A missing side takes the present joint's pose at zero size
+        const Skeleton &firstRig{pair.first != Missing ? first : second};
+        const int firstJoint{pair.first != Missing ? pair.first : pair.second};
+        const Skeleton &secondRig{pair.second != Missing ? second : first};
+        const int secondJoint{pair.second != Missing ? pair.second
+                                                     : pair.first};
+
+        Detail::storeMorphPose(firstPose_, count, i, firstRig.offset(firstJoint),
+                               firstRig.rotation(firstJoint),
+                               pair.first != Missing ? firstRig.size(firstJoint)
+                                                     : glm::vec3{0.0f});
+        Detail::storeMorphPose(secondPose_, count, i,
+                               secondRig.offset(secondJoint),
+                               secondRig.rotation(secondJoint),
+                               pair.second != Missing
+                                   ? secondRig.size(secondJoint)
+                                   : glm::vec3{0.0f});
+
+        firstModels_[i] = firstRig.model(firstJoint);
+        secondModels_[i] = secondRig.model(secondJoint);
+        firstNames_[i] = firstRig.name(firstJoint);
+        secondNames_[i] = secondRig.name(secondJoint);
+    }
+}
+
+const std::string &MorphCorrespondence::name(std::size_t pair,
+                                             float weight) const noexcept
+{
+    return weight < 0.5f ? firstNames_[pair] : secondNames_[pair];
+}
+
+void MorphCorrespondence::setShapeMorph(std::size_t pair, Model::Mesh *mesh,
+                                        bool targetIsFirst)
+{
+    shapeModels_[pair] = mesh;
+    shapeTargetIsFirst_[pair] = targetIsFirst ? 1 : 0;
+}
+
+void MorphCorrespondence::blend(float weight, glm::vec3 *offsets,
+                                glm::vec3 *rotations,
+                                glm::vec3 *sizes) const noexcept
+{
+    const std::size_t floats{pairs_.size() * 3};
+    glm::vec3 *channels[]{offsets, rotations, sizes};
+
+    for (std::size_t channel = 0; channel < ChannelCount; ++channel)
+    {
+        // glm::vec3 is three packed floats, see Math::ComposeEulerTransforms
+        Detail::mixMorphChannel(firstPose_.data() + channel * floats,
+                                secondPose_.data() + channel * floats, weight,
+                                floats, &channels[channel]->x);
+    }
+}
+
+void MorphCorrespondence::blend(float weight, const Pose &first,
+                                const Pose &second, glm::vec3 *offsets,
+                                glm::vec3 *rotations,
+                                glm::vec3 *sizes) const noexcept
+{
+    for (std::size_t i = 0; i < pairs_.size(); ++i)
+    {
+        const Pair &pair{pairs_[i]};
+
+        // A missing side takes the present joint's pose at zero size
+        const Pose &firstPose{pair.first != Missing ? first : second};
+        const int firstJoint{pair.first != Missing ? pair.first : pair.second};
+        const Pose &secondPose{pair.second != Missing ? second : first};
+        const int secondJoint{pair.second != Missing ? pair.second
+                                                     : pair.first};
+
+        const glm::vec3 firstSize{pair.first != Missing
+                                      ? firstPose.sizes[firstJoint]
+                                      : glm::vec3{0.0f}};
+        const glm::vec3 secondSize{pair.second != Missing
+                                       ? secondPose.sizes[secondJoint]
+                                       : glm::vec3{0.0f}};
+
+        offsets[i] = firstPose.offsets[firstJoint] +
+                     (secondPose.offsets[secondJoint] -
+                      firstPose.offsets[firstJoint]) *
+                         weight;
+        rotations[i] = firstPose.rotations[firstJoint] +
+                       (secondPose.rotations[secondJoint] -
+                        firstPose.rotations[firstJoint]) *
+                           weight;
+        sizes[i] = firstSize + (secondSize - firstSize) * weight;
+    }
+}
+
+int MorphCorrespondence::addPair(int first, int second, int parent)
+{
+    pairs_.push_back(Pair{first, second, parent});
+
+    return static_cast<int>(pairs_.size()) - 1;
+}
@@ -0,0 +1,151 @@
+#ifndef HOMEWORK01_AVATAR_MORPHCORRESPONDENCE_HPP_
+#define HOMEWORK01_AVATAR_MORPHCORRESPONDENCE_HPP_
+
+#include "Avatar/Skeleton.hpp"
+#include "Model/Mesh.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Pose;
+
+/**
+ * @brief Joint pairing between two rigs, flattened for the morph from one to
+ * the other.
+ *
+ * @details The pairs are built once from a table of joint names. A joint
+ * found in only one rig still gets a pair, its other side is
+ * MorphCorrespondence::Missing: it spawns from zero size at its own offset
+ * and rotation while morphing towards its rig, and despawns back to zero
+ * size while morphing away from it. Pairs are stored parents first and
+ * follow the hierarchy of the first rig, the second rig's unmatched joints
+ * are appended under the pairs of their parents.
+ *
+ * MorphCorrespondence::capture copies both end poses into contiguous arrays,
+ * so MorphCorrespondence::blend is a single loop of linear mixes.
+ *
+ * A pair whose two meshes have different shapes can be given a shape morph,
+ * see MorphCorrespondence::setShapeMorph, it then draws one mesh blending
+ * between both shapes on the GPU instead of swapping meshes halfway.
+ */
+class MorphCorrespondence
+{
+public:
+    static constexpr int Missing = -1;
+
+    struct Pair
+    {
+        int first;  // joint of the first rig or Missing
+        int second; // joint of the second rig or Missing
+        int parent; // pair index, Skeleton::NoParent for roots
+    };
+
+    struct NamePair
+    {
+        const char *first;
+        const char *second;
+    };
+
+    /**
+     * @brief Pair the joints of \a first and \a second named together in
+     * \a names and capture their poses.
+     */
+    void build(const Skeleton &first, const Skeleton &second,
+               const NamePair *names, std::size_t nameCount);
+
+    /**
+     * @brief Copy the current offsets, rotations, sizes and meshes of both
+     * rigs into the end poses.
+     */
+    void capture(const Skeleton &first, const Skeleton &second);
+
+    std::size_t size() const noexcept { return pairs_.size(); }
+    const Pair &pair(std::size_t pair) const noexcept { return pairs_[pair]; }
+
+    /**
+     * @brief Gets the name of \a pair's joint in the rig it is drawn from at
+     * \a weight.
+     */
+    const std::string &name(std::size_t pair, float weight) const noexcept;
+    /**
+     * @brief Gets the mesh \a pair draws at \a weight: its shape morph mesh
+     * if it has one, else the first rig's below one half. Spawned and
+     * despawned pairs always draw their own joint's.
+     */
+    Model::Mesh *model(std::size_t pair, float weight) const noexcept
+    {
+        if (shapeModels_[pair])
+        {
+            return shapeModels_[pair];
+        }
+
+        return weight < 0.5f ? firstModels_[pair] : secondModels_[pair];
+    }
+
+    /**
+     * @brief Draw \a pair with \a mesh during the morph. Its base shape is
+     * the mesh of one rig, its morph target the shape of the other rig's
+     * mesh, the first rig's if \a targetIsFirst. Kept by
+     * MorphCorrespondence::capture.
+     */
+    void setShapeMorph(std::size_t pair, Model::Mesh *mesh, bool targetIsFirst);
+    /**
+     * @brief Gets the morph weight \a pair's shape morph mesh is drawn with at
+     * \a weight, 0 without a shape morph.
+     */
+    float shapeWeight(std::size_t pair, float weight) const noexcept
+    {
+        if (!shapeModels_[pair])
+        {
+            return 0.0f;
+        }
+
+        return shapeTargetIsFirst_[pair] ? 1.0f - weight : weight;
+    }
+
+    /**
+     * @brief Blend the end poses of every pair, \a weight 0 is the first rig
+     * and 1 the second. Each output array holds MorphCorrespondence::size
+     * items.
+     */
+    void blend(float weight, glm::vec3 *offsets, glm::vec3 *rotations,
+               glm::vec3 *sizes) const noexcept;
+    /**
+     * @brief Blend \a first and \a second, poses of the first and second
+     * rig, e.g. evaluated by an AnimationGraph, instead of the captured end
+     * poses. Missing sides are handled like MorphCorrespondence::capture.
+     */
+    void blend(float weight, const Pose &first, const Pose &second,
+               glm::vec3 *offsets, glm::vec3 *rotations,
+               glm::vec3 *sizes) const noexcept;
+
+private:
+    enum Channel
+    {
+        Offset = 0,
+        Rotation = 1,
+        Size = 2,
+        ChannelCount = 3
+    };
+
+    int addPair(int first, int second, int parent);
+
+    std::vector<Pair> pairs_;
+
+    // Channel c of pair p starts at (c * size() + p) * 3, the blend only
+    // mixes two float arrays
+    std::vector<float> firstPose_;
+    std::vector<float> secondPose_;
+    std::vector<Model::Mesh *> firstModels_;
+    std::vector<Model::Mesh *> secondModels_;
+    std::vector<std::string> firstNames_;
+    std::vector<std::string> secondNames_;
+    std::vector<Model::Mesh *> shapeModels_; // nullptr without a shape morph
+    std::vector<std::uint8_t> shapeTargetIsFirst_;
+};
+
+#endif // HOMEWORK01_AVATAR_MORPHCORRESPONDENCE_HPP_
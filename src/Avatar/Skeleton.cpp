@@ -0,0 +1,253 @@
+#include "Skeleton.hpp"
+
+#include "Utils/Global.hpp"
+#include "Utils/Math/EulerTransform.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+
+namespace Detail
+{
+
+SkeletonStatistics skeletonStatistics;
+
+} // namespace Detail
+
+SkeletonStatistics &SkeletonStatistics::current() noexcept
+{
+    return Detail::skeletonStatistics;
+}
+
+void SkeletonStatistics::reset() noexcept { Detail::skeletonStatistics = {}; }
+
+int Skeleton::addJoint(const std::string &name, int parent,
+                       const glm::vec3 &offset, const glm::vec3 &size,
+                       Model::Mesh *model, const glm::vec3 &rotation)
+{
+    PROGRAM_ASSERT(parent >= NoParent && parent < jointCount());
+
+    parents_.push_back(parent);
+    offsets_.push_back(offset);
+    rotations_.push_back(rotation);
+    sizes_.push_back(size);
+    localTransforms_.push_back(glm::mat4{1.0f});
+    worldTransforms_.push_back(glm::mat4{1.0f});
+    modelMatrices_.push_back(glm::mat4{1.0f});
+    dirty_.push_back(LocalDirty | WorldDirty | ModelDirty);
+    modelRevisions_.push_back(0);
+    models_.push_back(model);
+    names_.push_back(name);
+
+    anyDirty_ = true;
+
+    return jointCount() - 1;
+}
+
+int Skeleton::jointCount() const noexcept
+{
+    return static_cast<int>(parents_.size());
+}
+
+int Skeleton::find(const std::string &name) const noexcept
+{
+    for (int joint = 0; joint < jointCount(); ++joint)
+    {
+        if (names_[joint] == name)
+        {
+            return joint;
+        }
+    }
+
+    return -1;
+}
+
+std::vector<int> Skeleton::children(int joint) const
+{
+    std::vector<int> result;
+
+    for (int child = joint + 1; child < jointCount(); ++child)
+    {
+        if (parents_[child] == joint)
+        {
+            result.push_back(child);
+        }
+    }
+
+    return result;
+}
+
+void Skeleton::setOffset(int joint, const glm::vec3 &offset) noexcept
+{
+    if (offsets_[joint] != offset)
+    {
+        offsets_[joint] = offset;
+        markDirty(joint, LocalDirty);
+    }
+}
+
+void Skeleton::setRotation(int joint, const glm::vec3 &rotation) noexcept
+{
+    if (rotations_[joint] != rotation)
+    {
+        rotations_[joint] = rotation;
+        markDirty(joint, LocalDirty);
+    }
+}
+
+void Skeleton::setSize(int joint, const glm::vec3 &size) noexcept
+{
+    if (sizes_[joint] != size)
+    {
+        sizes_[joint] = size;
+        markDirty(joint, ModelDirty);
+    }
+}
+
+void Skeleton::setPose(const glm::vec3 *offsets, const glm::vec3 *rotations,
+                       const glm::vec3 *sizes) noexcept
+{
+    for (int joint = 0; joint < jointCount(); ++joint)
+    {
+        setOffset(joint, offsets[joint]);
+        setRotation(joint, rotations[joint]);
+        setSize(joint, sizes[joint]);
+    }
+}
+
+void Skeleton::markDirty(int joint, std::uint8_t flags) noexcept
+{
+    dirty_[joint] |= flags;
+    anyDirty_ = true;
+}
+
+void Skeleton::invalidate() noexcept
+{
+    std::fill(dirty_.begin(), dirty_.end(),
+              std::uint8_t{LocalDirty | WorldDirty | ModelDirty});
+    anyDirty_ = true;
+}
+
+void Skeleton::updateWorldTransforms(const glm::mat4 &root)
+{
+    if (root != root_)
+    {
+        root_ = root;
+        for (int joint = 0; joint < jointCount(); ++joint)
+        {
+            if (parents_[joint] == NoParent)
+            {
+                dirty_[joint] |= WorldDirty;
+            }
+        }
+        anyDirty_ = true;
+    }
+
+    if (!anyDirty_)
+    {
+        return;
+    }
+
+    SkeletonStatistics &statistics{SkeletonStatistics::current()};
+    const int count{jointCount()};
+    ++revision_;
+
+    updateLocalTransforms();
+
+    for (int joint = 0; joint < count; ++joint)
+    {
+        const int parent{parents_[joint]};
+        std::uint8_t dirty{dirty_[joint]};
+
+        // Parents come first, their flags are final by now
+        if (parent != NoParent && (dirty_[parent] & WorldDirty))
+        {
+            dirty |= WorldDirty;
+        }
+
+        if (dirty & LocalDirty)
+        {
+            dirty |= WorldDirty;
+            ++statistics.localTransforms;
+        }
+
+        if (dirty & WorldDirty)
+        {
+            worldTransforms_[joint] =
+                (parent == NoParent ? root_ : worldTransforms_[parent]) *
+                localTransforms_[joint];
+            dirty |= ModelDirty;
+            ++statistics.worldTransforms;
+        }
+
+        if (dirty & ModelDirty)
+        {
+            modelMatrices_[joint] =
+                glm::scale(worldTransforms_[joint], sizes_[joint]);
+            modelRevisions_[joint] = revision_;
+        }
+
+        dirty_[joint] = dirty;
+    }
+
+    std::fill(dirty_.begin(), dirty_.end(), std::uint8_t{0});
+    anyDirty_ = false;
+}
+
+void Skeleton::updateLocalTransforms()
+{
+    const std::size_t count{parents_.size()};
+
+    batchJoints_.clear();
+    for (std::size_t joint = 0; joint < count; ++joint)
+    {
+        if (dirty_[joint] & LocalDirty)
+        {
+            batchJoints_.push_back(static_cast<int>(joint));
+        }
+    }
+
+    if (batchJoints_.size() == count)
+    {
+        Math::ComposeEulerTransforms(offsets_.data(), rotations_.data(),
+                                     nullptr, count, localTransforms_.data());
+        return;
+    }
+
+    // Gather the edited joints so the kernel still sees whole batches
+    const std::size_t edited{batchJoints_.size()};
+    batchOffsets_.resize(edited);
+    batchRotations_.resize(edited);
+    batchTransforms_.resize(edited);
+    for (std::size_t i = 0; i < edited; ++i)
+    {
+        batchOffsets_[i] = offsets_[batchJoints_[i]];
+        batchRotations_[i] = rotations_[batchJoints_[i]];
+    }
+
+    Math::ComposeEulerTransforms(batchOffsets_.data(), batchRotations_.data(),
+                                 nullptr, edited, batchTransforms_.data());
+
+    for (std::size_t i = 0; i < edited; ++i)
+    {
+        localTransforms_[batchJoints_[i]] = batchTransforms_[i];
+    }
+}
+
+void Skeleton::draw(glm::mat4 &view, glm::mat4 &projection)
+{
+    for (int joint = 0; joint < jointCount(); ++joint)
+    {
+        if (models_[joint])
+        {
+            models_[joint]->setModelMatrix(modelMatrices_[joint]);
+            models_[joint]->draw(view, projection);
+        }
+    }
+}
+
+glm::mat4 Skeleton::LocalTransform(const glm::vec3 &offset,
+                                   const glm::vec3 &rotation) noexcept
+{
+    return Math::ComposeEulerTransform(offset, rotation);
+}
@@ -0,0 +1,187 @@
+#ifndef HOMEWORK01_AVATAR_SKELETON_HPP_
+#define HOMEWORK01_AVATAR_SKELETON_HPP_
+
+#include "Model/Mesh.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Counters of the joint transforms recomputed by Skeleton.
+ */
+struct SkeletonStatistics
+{
+    std::uint32_t localTransforms = 0;
+    std::uint32_t worldTransforms = 0;
+
+    /**
+     * @brief Gets the counters of the current frame.
+     */
+    static SkeletonStatistics &current() noexcept;
+    /**
+     * @brief Reset the counters of the current frame.
+     */
+    static void reset() noexcept;
+};
+
+/**
+ * @brief Joint hierarchy flattened into structure-of-arrays.
+ *
+ * @details Joints are stored parent before child, a joint's parent always has
+ * a smaller index. World transforms are therefore resolved by a single linear
+ * pass over the arrays, without recursion or pointer chasing. Rotations are
+ * Euler angles in degrees applied in X, Y, Z order after the offset, the size
+ * only scales the joint's own mesh and is not inherited by its children.
+ *
+ * Local transforms are composed in batches by Math::ComposeEulerTransforms.
+ * Transforms are cached. Changing the offset or rotation of a joint marks its
+ * subtree dirty, changing its size marks only its own mesh, and
+ * Skeleton::updateWorldTransforms recomputes nothing else. A skeleton which
+ * is not edited costs a single branch per update.
+ *
+ * Every update which recomputes anything is a new Skeleton::revision, each
+ * joint records the revision its model matrix last changed in. Whatever is
+ * derived from the model matrices refreshes the joints newer than the
+ * revision it saw, and nothing while the revision stays the same.
+ */
+class Skeleton
+{
+public:
+    static constexpr int NoParent = -1;
+
+    /**
+     * @brief Append a joint under \a parent, which must already exist or be
+     * Skeleton::NoParent.
+     *
+     * @return Index of the new joint.
+     */
+    int addJoint(const std::string &name, int parent, const glm::vec3 &offset,
+                 const glm::vec3 &size, Model::Mesh *model = nullptr,
+                 const glm::vec3 &rotation = glm::vec3{0.0f});
+
+    int jointCount() const noexcept;
+    /**
+     * @brief Gets the index of the joint named \a name, -1 if there is none.
+     */
+    int find(const std::string &name) const noexcept;
+    /**
+     * @brief Gets the direct children of \a joint in index order.
+     */
+    std::vector<int> children(int joint) const;
+
+    int parent(int joint) const noexcept { return parents_[joint]; }
+    const std::string &name(int joint) const noexcept { return names_[joint]; }
+    const glm::vec3 &offset(int joint) const noexcept
+    {
+        return offsets_[joint];
+    }
+    const glm::vec3 &rotation(int joint) const noexcept
+    {
+        return rotations_[joint];
+    }
+    const glm::vec3 &size(int joint) const noexcept { return sizes_[joint]; }
+    Model::Mesh *model(int joint) const noexcept { return models_[joint]; }
+
+    void setOffset(int joint, const glm::vec3 &offset) noexcept;
+    void setRotation(int joint, const glm::vec3 &rotation) noexcept;
+    void setSize(int joint, const glm::vec3 &size) noexcept;
+    /**
+     * @brief Set the offset, rotation and size of every joint, e.g. sampled
+     * by AnimationClip::sample. Each array holds Skeleton::jointCount items,
+     * joints which did not move stay cached.
+     */
+    void setPose(const glm::vec3 *offsets, const glm::vec3 *rotations,
+                 const glm::vec3 *sizes) noexcept;
+
+    /**
+     * @brief Mark every joint dirty, the next update recomputes everything.
+     */
+    void invalidate() noexcept;
+
+    /**
+     * @brief Resolve the world transforms below \a root which are out of
+     * date, parents first. A different \a root than the last call marks
+     * every joint dirty.
+     */
+    void updateWorldTransforms(const glm::mat4 &root = glm::mat4{1.0f});
+    /**
+     * @brief Gets the number of updates which recomputed any transform.
+     */
+    std::uint64_t revision() const noexcept { return revision_; }
+    /**
+     * @brief Gets the revision in which the model matrix of \a joint last
+     * changed.
+     */
+    std::uint64_t modelRevision(int joint) const noexcept
+    {
+        return modelRevisions_[joint];
+    }
+    /**
+     * @brief Gets the world transform of \a joint without its size, the frame
+     * its children are placed in.
+     */
+    const glm::mat4 &worldTransform(int joint) const noexcept
+    {
+        return worldTransforms_[joint];
+    }
+    /**
+     * @brief Gets the world transform of \a joint scaled by its size.
+     */
+    const glm::mat4 &modelMatrix(int joint) const noexcept
+    {
+        return modelMatrices_[joint];
+    }
+
+    /**
+     * @brief Draw the mesh of every joint with the last resolved transforms.
+     */
+    void draw(glm::mat4 &view, glm::mat4 &projection);
+
+    /**
+     * @brief Gets the transform of a joint relative to its parent.
+     */
+    static glm::mat4 LocalTransform(const glm::vec3 &offset,
+                                    const glm::vec3 &rotation) noexcept;
+
+private:
+    enum DirtyFlag : std::uint8_t
+    {
+        LocalDirty = 1 << 0, // offset or rotation changed
+        WorldDirty = 1 << 1, // an ancestor moved
+        ModelDirty = 1 << 2  // size changed
+    };
+
+    void markDirty(int joint, std::uint8_t flags) noexcept;
+    /**
+     * @brief Recompute the local transform of every joint marked LocalDirty.
+     */
+    void updateLocalTransforms();
+
+    std::vector<int> parents_;
+    std::vector<glm::vec3> offsets_;
+    std::vector<glm::vec3> rotations_;
+    std::vector<glm::vec3> sizes_;
+    std::vector<glm::mat4> localTransforms_;
+    std::vector<glm::mat4> worldTransforms_;
+    std::vector<glm::mat4> modelMatrices_;
+    std::vector<std::uint8_t> dirty_;
+    std::vector<std::uint64_t> modelRevisions_;
+    std::vector<Model::Mesh *> models_;
+    std::vector<std::string> names_;
+
+    // Scratch of updateLocalTransforms, kept to avoid allocating per update
+    std::vector<int> batchJoints_;
+    std::vector<glm::vec3> batchOffsets_;
+    std::vector<glm::vec3> batchRotations_;
+    std::vector<glm::mat4> batchTransforms_;
+
+    glm::mat4 root_{1.0f};
+    bool anyDirty_ = false;
+    std::uint64_t revision_ = 0;
+};
+
+#endif // HOMEWORK01_AVATAR_SKELETON_HPP_
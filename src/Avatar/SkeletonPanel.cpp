@@ -0,0 +1,211 @@
+#include "SkeletonPanel.hpp"
+
+#include "glm/gtc/type_ptr.hpp"
+#include "glm/vec3.hpp"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <cstdint>
+
+void SkeletonPanel::draw(Skeleton &skeleton)
+{
+    if (&skeleton != skeleton_ || skeleton.jointCount() != jointCount_)
+    {
+        rebuild(skeleton);
+    }
+    if (selected_ >= jointCount_)
+    {
+        selected_ = -1;
+    }
+
+    const bool scroll = scrollToSelected_ && selected_ >= 0;
+    scrollToSelected_ = false;
+    if (scroll)
+    {
+        for (int joint = skeleton.parent(selected_);
+             joint != Skeleton::NoParent; joint = skeleton.parent(joint))
+        {
+            if (!open_[joint])
+            {
+                open_[joint] = 1;
+                rowsDirty_ = true;
+            }
+        }
+    }
+    if (rowsDirty_)
+    {
+        updateRows();
+    }
+
+    const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    const int rowCount = static_cast<int>(rows_.size());
+    ImGui::BeginChild("Joints",
+                      ImVec2{0.0f, rowHeight * std::min(rowCount, VisibleRows) +
+                                       ImGui::GetStyle().WindowPadding.y * 2.0f},
+                      true);
+    if (scroll)
+    {
+        // Centred, applied by ImGui on the next frame
+        const int row = static_cast<int>(
+            std::find(rows_.begin(), rows_.end(), selected_) - rows_.begin());
+        ImGui::SetScrollY(std::max(0.0f, (row - VisibleRows / 2) * rowHeight));
+    }
+    // Opening or closing a node changes the rows from the next frame on
+    ImGuiListClipper clipper{rowCount, rowHeight};
+    while (clipper.Step())
+    {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+        {
+            drawRow(skeleton, rows_[row]);
+        }
+    }
+    ImGui::EndChild();
+
+    drawSelected(skeleton);
+}
+
+void SkeletonPanel::select(int joint) noexcept
+{
+    selected_ = joint;
+    scrollToSelected_ = joint >= 0;
+}
+
+void SkeletonPanel::rebuild(const Skeleton &skeleton)
+{
+    skeleton_ = &skeleton;
+    jointCount_ = skeleton.jointCount();
+    firstChildren_.assign(jointCount_, -1);
+    nextSiblings_.assign(jointCount_, -1);
+    depths_.assign(jointCount_, 0);
+    open_.assign(jointCount_, 0);
+    firstRoot_ = -1;
+
+    // Prepended backwards, so siblings are listed in index order
+    for (int joint = jointCount_ - 1; joint >= 0; --joint)
+    {
+        const int parent = skeleton.parent(joint);
+        int &first =
+            parent == Skeleton::NoParent ? firstRoot_ : firstChildren_[parent];
+        nextSiblings_[joint] = first;
+        first = joint;
+    }
+    // Parents come first, their depth is already known
+    for (int joint = 0; joint < jointCount_; ++joint)
+    {
+        const int parent = skeleton.parent(joint);
+        if (parent == Skeleton::NoParent)
+        {
+            open_[joint] = 1;
+        }
+        else
+        {
+            depths_[joint] = depths_[parent] + 1;
+        }
+    }
+
+    rowsDirty_ = true;
+}
+
+void SkeletonPanel::updateRows()
+{
+    rows_.clear();
+    stack_.clear();
+    if (firstRoot_ >= 0)
+    {
+        stack_.push_back(firstRoot_);
+    }
+
+    // Depth first, a joint's children before its next sibling
+    while (!stack_.empty())
+    {
+        const int joint = stack_.back();
+        stack_.pop_back();
+        rows_.push_back(joint);
+
+        if (nextSiblings_[joint] >= 0)
+        {
+            stack_.push_back(nextSiblings_[joint]);
+        }
+        if (open_[joint] && firstChildren_[joint] >= 0)
+        {
+            stack_.push_back(firstChildren_[joint]);
+        }
+    }
+
+    rowsDirty_ = false;
+}
+
+void SkeletonPanel::drawRow(const Skeleton &skeleton, int joint)
+{
+    const bool leaf = firstChildren_[joint] < 0;
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                               ImGuiTreeNodeFlags_OpenOnArrow |
+                               ImGuiTreeNodeFlags_OpenOnDoubleClick |
+                               ImGuiTreeNodeFlags_SpanAvailWidth;
+    if (leaf)
+    {
+        flags |= ImGuiTreeNodeFlags_Leaf;
+    }
+    if (joint == selected_)
+    {
+        flags |= ImGuiTreeNodeFlags_Selected;
+    }
+
+    // Rows are not nested, a zero indent would mean the default one
+    const float indent = depths_[joint] * ImGui::GetStyle().IndentSpacing;
+    if (indent > 0.0f)
+    {
+        ImGui::Indent(indent);
+    }
+
+    // The open state is kept here, ImGui's only reports the clicks
+    ImGui::SetNextItemOpen(open_[joint] != 0);
+    const bool open = ImGui::TreeNodeEx(
+        reinterpret_cast<void *>(static_cast<std::intptr_t>(joint)), flags,
+        "%s", skeleton.name(joint).c_str());
+    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+    {
+        selected_ = joint;
+    }
+    if (!leaf && open != (open_[joint] != 0))
+    {
+        open_[joint] = open;
+        rowsDirty_ = true;
+    }
+
+    if (indent > 0.0f)
+    {
+        ImGui::Unindent(indent);
+    }
+}
+
+void SkeletonPanel::drawSelected(Skeleton &skeleton)
+{
+    if (selected_ < 0)
+    {
+        return;
+    }
+
+    glm::vec3 offset = skeleton.offset(selected_);
+    glm::vec3 rotation = skeleton.rotation(selected_);
+    glm::vec3 size = skeleton.size(selected_);
+
+    // Unique per joint without building a label
+    ImGui::PushID(selected_);
+    ImGui::Text("%s", skeleton.name(selected_).c_str());
+    if (ImGui::SliderFloat3("Position", glm::value_ptr(offset), -10.0f, 10.0f))
+    {
+        skeleton.setOffset(selected_, offset);
+    }
+    if (ImGui::SliderFloat3("Rotation", glm::value_ptr(rotation), -180.0f,
+                            180.0f))
+    {
+        skeleton.setRotation(selected_, rotation);
+    }
+    if (ImGui::SliderFloat3("Scale", glm::value_ptr(size), 0.1f, 5.0f))
+    {
+        skeleton.setSize(selected_, size);
+    }
+    ImGui::PopID();
+}
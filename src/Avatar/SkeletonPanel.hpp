@@ -0,0 +1,73 @@
+#ifndef HOMEWORK01_AVATAR_SKELETONPANEL_HPP_
+#define HOMEWORK01_AVATAR_SKELETONPANEL_HPP_
+
+#include "Avatar/Skeleton.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief ImGui panel of a Skeleton: a collapsible tree of its joints and the
+ * sliders of the joint selected in it.
+ *
+ * @details Rows are one line each, the joints of the open nodes flattened in
+ * tree order. ImGuiListClipper submits only the rows scrolled into view and
+ * a closed node's subtree has no rows, so a frame costs the visible lines,
+ * not the skeleton. Widgets are identified by joint index and labelled with
+ * the skeleton's own names, no string is built.
+ *
+ * The tree is indexed once per skeleton and the rows are rebuilt only when a
+ * node is opened or closed, into vectors which keep their capacity. Drawing
+ * an unchanged panel therefore allocates nothing.
+ */
+class SkeletonPanel
+{
+public:
+    // Rows shown before the tree scrolls
+    static constexpr int VisibleRows = 12;
+
+    /**
+     * @brief Draw the panel into the current ImGui window, the sliders edit
+     * \a skeleton directly.
+     */
+    void draw(Skeleton &skeleton);
+
+    // Joint selected in the tree or by SkeletonPanel::select, -1 if none
+    int selected() const noexcept { return selected_; }
+    /**
+     * @brief Select \a joint, -1 for none. Its ancestors are opened and the
+     * tree scrolls to it on the next draw.
+     */
+    void select(int joint) noexcept;
+
+private:
+    /**
+     * @brief Index the children and depths of \a skeleton's joints, only its
+     * roots open.
+     */
+    void rebuild(const Skeleton &skeleton);
+    /**
+     * @brief Flatten the joints whose ancestors are all open into rows_.
+     */
+    void updateRows();
+    void drawRow(const Skeleton &skeleton, int joint);
+    void drawSelected(Skeleton &skeleton);
+
+    const Skeleton *skeleton_ = nullptr;
+    int jointCount_ = 0;
+    // Per joint, -1 for none
+    std::vector<int> firstChildren_;
+    std::vector<int> nextSiblings_;
+    std::vector<int> depths_;
+    std::vector<std::uint8_t> open_; // per joint
+    int firstRoot_ = -1;
+
+    std::vector<int> rows_;  // joints, in tree order
+    std::vector<int> stack_; // scratch of updateRows
+    bool rowsDirty_ = true;
+
+    int selected_ = -1;
+    bool scrollToSelected_ = false;
+};
+
+#endif // HOMEWORK01_AVATAR_SKELETONPANEL_HPP_
@@ -0,0 +1,327 @@
+#include "MicroBenchmark.hpp"
+
+#include "Utils/Math/DynamicBvh.hpp"
+#include "Utils/Math/Frustum.hpp"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// Queries per timed call of the ray and overlap cases
+constexpr std::size_t bvhQueries{64};
+
+/**
+ * @brief Boxes of a herd and its props on the ground around the origin, as
+ * dense as the crowd's spawn grid for any count.
+ */
+struct BvhScene
+{
+    float extent; // half the side of the ground
+    std::vector<glm::vec3> centres;
+    std::vector<glm::vec3> halfSizes;
+    std::vector<int> proxies;
+    Math::Frustum frustum;
+    std::vector<glm::vec3> rayOrigins;
+    std::vector<glm::vec3> rayDirections;
+    std::vector<glm::vec3> overlapCentres;
+};
+
+BvhScene makeBvhScene(std::size_t count, std::uint32_t seed);
+void insertBvhScene(BvhScene &scene, Math::DynamicBvh &tree);
+// Move every box along its own circle, a step of frame \a frame
+void moveBvhScene(BvhScene &scene, Math::DynamicBvh &tree, int frame);
+std::size_t countFrustumMismatches(const BvhScene &scene,
+                                   const Math::DynamicBvh &tree);
+float nearestTreeHit(const Math::DynamicBvh &tree, const glm::vec3 &origin,
+                     const glm::vec3 &direction);
+float nearestLinearHit(const BvhScene &scene, const Math::DynamicBvh &tree,
+                       const glm::vec3 &origin, const glm::vec3 &direction);
+std::size_t countOverlaps(const Math::DynamicBvh &tree,
+                          const glm::vec3 &centre);
+std::size_t countLinearOverlaps(const BvhScene &scene,
+                                const Math::DynamicBvh &tree,
+                                const glm::vec3 &centre);
+
+BvhScene makeBvhScene(std::size_t count, std::uint32_t seed)
+{
+    Random random{seed};
+
+    BvhScene scene;
+    scene.extent = 3.0f * std::sqrt(static_cast<float>(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        scene.centres.push_back(
+            glm::vec3{random.uniform(-scene.extent, scene.extent),
+                      random.uniform(0.0f, 3.0f),
+                      random.uniform(-scene.extent, scene.extent)});
+        scene.halfSizes.push_back(glm::vec3{random.uniform(0.3f, 2.0f),
+                                            random.uniform(0.3f, 2.0f),
+                                            random.uniform(0.3f, 2.0f)});
+    }
+
+    // The benchmark camera, on the edge of the herd looking across it
+    const glm::vec3 eye{0.0f, 0.3f * scene.extent, 1.2f * scene.extent};
+    const glm::mat4 view{
+        glm::lookAt(eye, glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f})};
+    const glm::mat4 projection{glm::perspective(
+        glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 3.0f * scene.extent)};
+    scene.frustum = Math::Frustum{projection * view};
+
+    // Picking rays from the camera through the ground, overlap queries of
+    // the size of an avatar
+    for (std::size_t i = 0; i < bvhQueries; ++i)
+    {
+        const glm::vec3 target{random.uniform(-scene.extent, scene.extent),
+                               0.0f,
+                               random.uniform(-scene.extent, scene.extent)};
+        scene.rayOrigins.push_back(eye);
+        scene.rayDirections.push_back(glm::normalize(target - eye));
+        scene.overlapCentres.push_back(target);
+    }
+
+    return scene;
+}
+
+void insertBvhScene(BvhScene &scene, Math::DynamicBvh &tree)
+{
+    tree.clear();
+    scene.proxies.clear();
+    for (std::size_t i = 0; i < scene.centres.size(); ++i)
+    {
+        scene.proxies.push_back(
+            tree.insert(scene.centres[i] - scene.halfSizes[i],
+                        scene.centres[i] + scene.halfSizes[i],
+                        static_cast<std::uint32_t>(i)));
+    }
+}
+
+void moveBvhScene(BvhScene &scene, Math::DynamicBvh &tree, int frame)
+{
+    for (std::size_t i = 0; i < scene.centres.size(); ++i)
+    {
+        const float angle{0.05f * static_cast<float>(frame) +
+                          static_cast<float>(i)};
+        const glm::vec3 centre{scene.centres[i] +
+                               glm::vec3{std::cos(angle), 0.0f,
+                                         std::sin(angle)} *
+                                   0.2f};
+        tree.move(scene.proxies[i], centre - scene.halfSizes[i],
+                  centre + scene.halfSizes[i]);
+    }
+}
+
+std::size_t countFrustumMismatches(const BvhScene &scene,
+                                   const Math::DynamicBvh &tree)
+{
+    std::vector<std::uint8_t> found(scene.proxies.size(), 0);
+    tree.queryFrustum(scene.frustum,
+                      [&](int proxy) { found[tree.userData(proxy)] = 1; });
+
+    std::size_t mismatches{0};
+    for (std::size_t i = 0; i < scene.proxies.size(); ++i)
+    {
+        const int proxy{scene.proxies[i]};
+        const bool inside{
+            scene.frustum.contains(tree.minimum(proxy), tree.maximum(proxy)) !=
+            Math::Frustum::Containment::Outside};
+        mismatches += inside != (found[i] != 0) ? 1 : 0;
+    }
+
+    return mismatches;
+}
+
+float nearestTreeHit(const Math::DynamicBvh &tree, const glm::vec3 &origin,
+                     const glm::vec3 &direction)
+{
+    float nearest{-1.0f};
+    tree.raycast(origin, direction, 1.0e6f, [&](int, float distance) {
+        nearest = distance;
+        return distance;
+    });
+
+    return nearest;
+}
+
+float nearestLinearHit(const BvhScene &scene, const Math::DynamicBvh &tree,
+                       const glm::vec3 &origin, const glm::vec3 &direction)
+{
+    const glm::vec3 inverseDirection{1.0f / direction};
+
+    float nearest{-1.0f};
+    for (int proxy : scene.proxies)
+    {
+        const float distance{Math::DynamicBvh::RayDistance(
+            origin, inverseDirection, tree.minimum(proxy),
+            tree.maximum(proxy), 1.0e6f)};
+        if (distance >= 0.0f && (nearest < 0.0f || distance < nearest))
+        {
+            nearest = distance;
+        }
+    }
+
+    return nearest;
+}
+
+std::size_t countOverlaps(const Math::DynamicBvh &tree,
+                          const glm::vec3 &centre)
+{
+    std::size_t overlaps{0};
+    tree.queryOverlap(centre - glm::vec3{3.0f}, centre + glm::vec3{3.0f},
+                      [&](int) { ++overlaps; });
+
+    return overlaps;
+}
+
+std::size_t countLinearOverlaps(const BvhScene &scene,
+                                const Math::DynamicBvh &tree,
+                                const glm::vec3 &centre)
+{
+    std::size_t overlaps{0};
+    for (int proxy : scene.proxies)
+    {
+        overlaps += glm::all(glm::lessThanEqual(tree.minimum(proxy),
+                                                centre + glm::vec3{3.0f})) &&
+                            glm::all(glm::greaterThanEqual(
+                                tree.maximum(proxy), centre - glm::vec3{3.0f}))
+                        ? 1
+                        : 0;
+    }
+
+    return overlaps;
+}
+
+} // namespace Detail
+
+void RunBvhSuite(MicroBenchmark &benchmark)
+{
+    for (std::size_t count : {1000, 10000, 100000})
+    {
+        Detail::BvhScene scene{Detail::makeBvhScene(count, 17u)};
+        Math::DynamicBvh tree;
+        Detail::insertBvhScene(scene, tree);
+
+        const std::string suffix{"/" + std::to_string(count)};
+
+        // Every query finds what a walk over all proxies finds, before and
+        // after the boxes moved
+        const auto checkQueries = [&](const std::string &state) {
+            double rayError{0.0};
+            std::size_t overlapErrors{0};
+            for (std::size_t i = 0; i < Detail::bvhQueries; ++i)
+            {
+                rayError = std::max(
+                    rayError,
+                    static_cast<double>(std::abs(
+                        Detail::nearestTreeHit(tree, scene.rayOrigins[i],
+                                               scene.rayDirections[i]) -
+                        Detail::nearestLinearHit(scene, tree,
+                                                 scene.rayOrigins[i],
+                                                 scene.rayDirections[i]))));
+                overlapErrors +=
+                    Detail::countOverlaps(tree, scene.overlapCentres[i]) !=
+                            Detail::countLinearOverlaps(
+                                scene, tree, scene.overlapCentres[i])
+                        ? 1
+                        : 0;
+            }
+
+            benchmark.check("valid-" + state + suffix,
+                            tree.validate() ? 0.0 : 1.0, 0.0);
+            benchmark.check(
+                "frustum-" + state + suffix,
+                static_cast<double>(Detail::countFrustumMismatches(scene, tree)),
+                0.0);
+            benchmark.check("raycast-" + state + suffix, rayError, 0.0);
+            benchmark.check("overlap-" + state + suffix,
+                            static_cast<double>(overlapErrors), 0.0);
+        };
+        checkQueries("built");
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            Detail::moveBvhScene(scene, tree, frame);
+        }
+        checkQueries("moved");
+
+        // Rotations keep the tree about log2 of the proxies high
+        benchmark.check(
+            "height" + suffix,
+            std::max(0.0, tree.height() -
+                              2.0 * std::log2(static_cast<double>(count))),
+            0.0);
+
+        Math::DynamicBvh built;
+        benchmark.run("insert" + suffix, count, [&] {
+            Detail::insertBvhScene(scene, built);
+            DoNotOptimize(built.height());
+        });
+
+        int frame{30};
+        benchmark.run("refit" + suffix, count, [&] {
+            Detail::moveBvhScene(scene, tree, frame++);
+            DoNotOptimize(tree.height());
+        });
+
+        // The crowd's culling before the tree, every bounding sphere tested
+        std::vector<glm::vec4> spheres;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            spheres.push_back(glm::vec4{scene.centres[i],
+                                        glm::length(scene.halfSizes[i])});
+        }
+        std::vector<std::uint8_t> visible(count);
+        benchmark.run("frustum-linear" + suffix, count, [&] {
+            Math::CullSpheres(scene.frustum, spheres.data(), count,
+                              visible.data());
+            DoNotOptimize(visible.back());
+        });
+        benchmark.run("frustum-tree" + suffix, count, [&] {
+            std::size_t found{0};
+            tree.queryFrustum(scene.frustum, [&](int) { ++found; });
+            DoNotOptimize(found);
+        });
+
+        benchmark.run("raycast-linear" + suffix, Detail::bvhQueries, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::bvhQueries; ++i)
+            {
+                distance += Detail::nearestLinearHit(
+                    scene, tree, scene.rayOrigins[i], scene.rayDirections[i]);
+            }
+            DoNotOptimize(distance);
+        });
+        benchmark.run("raycast-tree" + suffix, Detail::bvhQueries, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::bvhQueries; ++i)
+            {
+                distance += Detail::nearestTreeHit(tree, scene.rayOrigins[i],
+                                                   scene.rayDirections[i]);
+            }
+            DoNotOptimize(distance);
+        });
+        benchmark.run("overlap-tree" + suffix, Detail::bvhQueries, [&] {
+            std::size_t overlaps{0};
+            for (std::size_t i = 0; i < Detail::bvhQueries; ++i)
+            {
+                overlaps += Detail::countOverlaps(tree, scene.overlapCentres[i]);
+            }
+            DoNotOptimize(overlaps);
+        });
+    }
+}
+
+} // namespace Benchmark
@@ -0,0 +1,241 @@
+#include "MicroBenchmark.hpp"
+
+#include "Avatar/AnimationClip.hpp"
+#include "Utils/Math/EulerTransform.hpp"
+
+#include "glm/gtc/constants.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// Ten seconds at 30 frames per second, the last frame repeats the first
+constexpr int clipFrames{301};
+constexpr float clipFrameRate{30.0f};
+
+// Clip error against the samples: offsets in joint units, rotations as the
+// largest element difference of the rotation matrices, about radians
+constexpr double clipOffsetTolerance{0.0011};
+constexpr double clipRotationTolerance{0.003};
+
+ClipSamples makeClipSamples(int joints, std::uint32_t seed);
+double maximumOffsetError(const std::vector<glm::vec3> &offsets,
+                          const glm::vec3 *references);
+double maximumRotationError(const std::vector<glm::vec3> &rotations,
+                            const glm::vec3 *references);
+void reportClip(const std::string &name, const ClipSamples &samples,
+                const AnimationClip &clip);
+void reportThroughput(const std::string &name, const MicroResult &result);
+
+// Looping motion like authored clips: every rotation sways, a third of the
+// joints also translate, a few hold still and sizes never change
+ClipSamples makeClipSamples(int joints, std::uint32_t seed)
+{
+    Random random{seed};
+
+    ClipSamples samples;
+    samples.jointCount = joints;
+    samples.frameCount = clipFrames;
+    samples.frameRate = clipFrameRate;
+
+    struct Motion
+    {
+        glm::vec3 offset;
+        glm::vec3 rotation;
+        glm::vec3 size;
+        glm::vec3 amplitude; // degrees
+        float travel;        // joint units
+        float harmonic;      // cycles per loop
+        float phase;
+    };
+
+    std::vector<Motion> motions;
+    for (int joint = 0; joint < joints; ++joint)
+    {
+        const bool still{joint % 7 == 0};
+        motions.push_back(Motion{
+            glm::vec3{random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f),
+                      random.uniform(-1.0f, 1.0f)},
+            glm::vec3{random.uniform(-90.0f, 90.0f),
+                      random.uniform(-90.0f, 90.0f),
+                      random.uniform(-90.0f, 90.0f)},
+            glm::vec3{random.uniform(0.1f, 1.0f)},
+            still ? glm::vec3{0.0f}
+                  : glm::vec3{random.uniform(5.0f, 40.0f),
+                              random.uniform(0.0f, 15.0f),
+                              random.uniform(0.0f, 10.0f)},
+            joint % 3 == 0 && !still ? random.uniform(0.05f, 0.3f) : 0.0f,
+            static_cast<float>(1 + random.next() % 8),
+            random.uniform(0.0f, 2.0f * glm::pi<float>())});
+    }
+
+    for (int frame = 0; frame < clipFrames; ++frame)
+    {
+        const float loop{2.0f * glm::pi<float>() * static_cast<float>(frame) /
+                         static_cast<float>(clipFrames - 1)};
+
+        for (const Motion &motion : motions)
+        {
+            const float wave{std::sin(loop * motion.harmonic + motion.phase)};
+
+            samples.offsets.push_back(motion.offset +
+                                      glm::vec3{0.0f, motion.travel * wave, 0.0f});
+            samples.rotations.push_back(motion.rotation + motion.amplitude * wave);
+            samples.sizes.push_back(motion.size);
+        }
+    }
+
+    return samples;
+}
+
+double maximumOffsetError(const std::vector<glm::vec3> &offsets,
+                          const glm::vec3 *references)
+{
+    double error{0.0};
+    for (std::size_t i = 0; i < offsets.size(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            error = std::max(
+                error,
+                static_cast<double>(std::abs(offsets[i][axis] - references[i][axis])));
+        }
+    }
+
+    return error;
+}
+
+double maximumRotationError(const std::vector<glm::vec3> &rotations,
+                            const glm::vec3 *references)
+{
+    double error{0.0};
+    for (std::size_t i = 0; i < rotations.size(); ++i)
+    {
+        const glm::mat4 sampled{
+            Math::ComposeEulerTransform(glm::vec3{0.0f}, rotations[i])};
+        const glm::mat4 reference{
+            Math::ComposeEulerTransform(glm::vec3{0.0f}, references[i])};
+
+        for (int column = 0; column < 3; ++column)
+        {
+            for (int row = 0; row < 3; ++row)
+            {
+                error = std::max(error, static_cast<double>(std::abs(
+                                            sampled[column][row] -
+                                            reference[column][row])));
+            }
+        }
+    }
+
+    return error;
+}
+
+void reportClip(const std::string &name, const ClipSamples &samples,
+                const AnimationClip &clip)
+{
+    const std::size_t rawBytes{sizeof(glm::vec3) *
+                               (samples.offsets.size() +
+                                samples.rotations.size() +
+                                samples.sizes.size())};
+    const std::size_t rawKeys{samples.offsets.size() * 3};
+
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "[Microbenchmark] %-10s %-32s %8zu bytes (raw %zu, %.1fx), "
+                  "%zu of %zu keys",
+                  "clips", name.c_str(), clip.byteSize(), rawBytes,
+                  static_cast<double>(rawBytes) /
+                      static_cast<double>(clip.byteSize()),
+                  clip.keyCount(), rawKeys);
+    std::cout << line << std::endl;
+}
+
+void reportThroughput(const std::string &name, const MicroResult &result)
+{
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "[Microbenchmark] %-10s %-32s %8.1f joints/us", "clips",
+                  name.c_str(),
+                  static_cast<double>(result.items) / result.median * 1.0e3);
+    std::cout << line << std::endl;
+}
+
+} // namespace Detail
+
+void RunClipSuite(MicroBenchmark &benchmark)
+{
+    for (int joints : {16, 64, 512})
+    {
+        const ClipSamples samples{Detail::makeClipSamples(joints, 13u)};
+        const std::size_t items{static_cast<std::size_t>(joints)};
+        const std::string suffix{"/" + std::to_string(joints)};
+
+        AnimationClip clip;
+        clip.build(samples);
+        Detail::reportClip("memory" + suffix, samples, clip);
+
+        std::vector<glm::vec3> offsets(items);
+        std::vector<glm::vec3> rotations(items);
+        std::vector<glm::vec3> sizes(items);
+
+        // Every source frame, played forwards
+        AnimationClip::Cursor cursor{clip.createCursor()};
+        double offsetError{0.0};
+        double rotationError{0.0};
+        for (int frame = 0; frame + 1 < Detail::clipFrames; ++frame)
+        {
+            clip.sample(static_cast<float>(frame) / Detail::clipFrameRate,
+                        cursor, offsets.data(), rotations.data(),
+                        sizes.data());
+
+            const std::size_t first{static_cast<std::size_t>(frame) * items};
+            offsetError = std::max(
+                offsetError, std::max(Detail::maximumOffsetError(
+                                          offsets, &samples.offsets[first]),
+                                      Detail::maximumOffsetError(
+                                          sizes, &samples.sizes[first])));
+            rotationError = std::max(
+                rotationError, Detail::maximumRotationError(
+                                   rotations, &samples.rotations[first]));
+        }
+        benchmark.check("offset-error" + suffix, offsetError,
+                        Detail::clipOffsetTolerance);
+        benchmark.check("rotation-error" + suffix, rotationError,
+                        Detail::clipRotationTolerance);
+
+        // Playback at 60 frames per second, the cursors step at most a key
+        float time{0.0f};
+        Detail::reportThroughput(
+            "sample-sequential" + suffix,
+            benchmark.run("sample-sequential" + suffix, items, [&] {
+                time += 1.0f / 60.0f;
+                clip.sample(time, cursor, offsets.data(), rotations.data(),
+                            sizes.data());
+                DoNotOptimize(rotations.back());
+            }));
+
+        // Random access, most samples rescan from the first key
+        Random random{17u};
+        Detail::reportThroughput(
+            "sample-random" + suffix,
+            benchmark.run("sample-random" + suffix, items, [&] {
+                clip.sample(random.uniform(0.0f, clip.duration()), cursor,
+                            offsets.data(), rotations.data(), sizes.data());
+                DoNotOptimize(rotations.back());
+            }));
+    }
+}
+
+} // namespace Benchmark
@@ -0,0 +1,116 @@
+#include "MicroBenchmark.hpp"
+
+#include "Utils/Math/Frustum.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+Math::Frustum makeCullingFrustum();
+std::vector<glm::vec4> makeCullingSpheres(std::size_t count,
+                                          std::uint32_t seed);
+std::size_t countMismatches(const std::vector<std::uint8_t> &first,
+                            const std::vector<std::uint8_t> &second);
+
+// The crowd camera, looking down on the herd from one side
+Math::Frustum makeCullingFrustum()
+{
+    const glm::mat4 view{glm::lookAt(glm::vec3{0.0f, 30.0f, 120.0f},
+                                     glm::vec3{0.0f}, glm::vec3{0, 1, 0})};
+    const glm::mat4 projection{
+        glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 300.0f)};
+
+    return Math::Frustum{projection * view};
+}
+
+// Avatars and parts spread all around the camera, about a third are in view
+std::vector<glm::vec4> makeCullingSpheres(std::size_t count,
+                                          std::uint32_t seed)
+{
+    Random random{seed};
+
+    std::vector<glm::vec4> spheres;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        spheres.push_back(glm::vec4{random.uniform(-200.0f, 200.0f),
+                                    random.uniform(-20.0f, 40.0f),
+                                    random.uniform(-200.0f, 200.0f),
+                                    random.uniform(0.1f, 8.0f)});
+    }
+
+    return spheres;
+}
+
+std::size_t countMismatches(const std::vector<std::uint8_t> &first,
+                            const std::vector<std::uint8_t> &second)
+{
+    std::size_t mismatches{0};
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        mismatches += first[i] != second[i] ? 1 : 0;
+    }
+
+    return mismatches;
+}
+
+} // namespace Detail
+
+void RunCullingSuite(MicroBenchmark &benchmark)
+{
+    const std::string path{Math::CullSpheresPath()};
+    const Math::Frustum frustum{Detail::makeCullingFrustum()};
+
+    // Both paths agree on every sphere, an odd count also runs the scalar
+    // remainder. Spheres touching a plane test the shared summation order
+    {
+        const std::size_t count{100003};
+        std::vector<glm::vec4> spheres{Detail::makeCullingSpheres(count, 3u)};
+        for (std::size_t i = 0; i < count; i += 7)
+        {
+            const glm::vec4 &plane{frustum.plane(static_cast<int>(i % 6))};
+            const glm::vec3 centre{spheres[i]};
+            spheres[i].w = -(glm::dot(glm::vec3{plane}, centre) + plane.w);
+        }
+
+        std::vector<std::uint8_t> scalar(count);
+        std::vector<std::uint8_t> batched(count);
+        Math::CullSpheresScalar(frustum, spheres.data(), count, scalar.data());
+        Math::CullSpheres(frustum, spheres.data(), count, batched.data());
+        benchmark.check(path + "-vs-scalar",
+                        static_cast<double>(
+                            Detail::countMismatches(batched, scalar)),
+                        0.0);
+    }
+
+    for (std::size_t count : {64, 4096, 65536})
+    {
+        const std::vector<glm::vec4> spheres{
+            Detail::makeCullingSpheres(count, 5u)};
+        std::vector<std::uint8_t> visible(count);
+
+        const std::string suffix{"/" + std::to_string(count)};
+
+        benchmark.run("scalar" + suffix, count, [&] {
+            Math::CullSpheresScalar(frustum, spheres.data(), count,
+                                    visible.data());
+            DoNotOptimize(visible.back());
+        });
+        benchmark.run(path + suffix, count, [&] {
+            Math::CullSpheres(frustum, spheres.data(), count, visible.data());
+            DoNotOptimize(visible.back());
+        });
+    }
+}
+
+} // namespace Benchmark
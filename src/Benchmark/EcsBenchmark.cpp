@@ -0,0 +1,222 @@
+#include "MicroBenchmark.hpp"
+
+#include "Scene/Components.hpp"
+#include "Scene/Registry.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+/**
+ * @brief A scene node reached through a pointer, laid out like the Animal's
+ * Joint objects.
+ */
+struct EcsNode
+{
+    std::string name;
+    glm::vec3 offset;
+    glm::vec3 rotation;
+    glm::vec3 size;
+    Scene::Transform transform;
+    std::vector<EcsNode *> children;
+};
+
+/**
+ * @brief The same props three ways: a plain array, entities of a registry
+ * and heap nodes visited in a shuffled order.
+ */
+struct EcsScene
+{
+    std::vector<Scene::Transform> array;
+    Scene::Registry registry;
+    std::vector<std::unique_ptr<EcsNode>> nodes; // allocation order
+    std::vector<EcsNode *> order;                // visiting order
+};
+
+void moveTransform(Scene::Transform &transform, const glm::vec4 &step) noexcept;
+void fillEcsScene(std::size_t count, std::uint32_t seed, EcsScene &scene);
+// Sum of the transforms' x translations, in creation order
+double sumArray(const EcsScene &scene);
+double sumRegistry(EcsScene &scene);
+double sumNodes(const EcsScene &scene);
+
+// The moving system of every representation, one column read and written
+void moveTransform(Scene::Transform &transform, const glm::vec4 &step) noexcept
+{
+    transform.world[3] += step;
+}
+
+void fillEcsScene(std::size_t count, std::uint32_t seed, EcsScene &scene)
+{
+    Random random{seed};
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const glm::vec3 position{random.uniform(-100.0f, 100.0f), 0.0f,
+                                 random.uniform(-100.0f, 100.0f)};
+        Scene::Transform transform{glm::mat4{1.0f}};
+        transform.world[3] = glm::vec4{position, 1.0f};
+
+        scene.array.push_back(transform);
+
+        const Scene::Entity entity{scene.registry.create()};
+        scene.registry.emplace<Scene::Transform>(entity, transform);
+        scene.registry.emplace<Scene::Bounds>(
+            entity, Scene::Bounds{glm::vec4{position, 1.0f}});
+        scene.registry.emplace<Scene::MeshRef>(entity,
+                                               Scene::MeshRef{nullptr, 0});
+        scene.registry.emplace<Scene::Material>(
+            entity, Scene::Material{nullptr, nullptr, glm::vec4{1.0f}});
+
+        scene.nodes.emplace_back(new EcsNode{"prop" + std::to_string(i),
+                                             position, glm::vec3{0.0f},
+                                             glm::vec3{1.0f}, transform,
+                                             std::vector<EcsNode *>{}});
+        scene.order.push_back(scene.nodes.back().get());
+    }
+
+    // Nodes are reached in no particular order of their addresses
+    for (std::size_t i = scene.order.size(); i > 1; --i)
+    {
+        std::swap(scene.order[i - 1], scene.order[random.next() % i]);
+    }
+}
+
+double sumArray(const EcsScene &scene)
+{
+    double sum{0.0};
+    for (const Scene::Transform &transform : scene.array)
+    {
+        sum += transform.world[3].x;
+    }
+
+    return sum;
+}
+
+double sumRegistry(EcsScene &scene)
+{
+    double sum{0.0};
+    scene.registry.each<Scene::Transform>(
+        [&sum](const Scene::Entity &, const Scene::Transform &transform) {
+            sum += transform.world[3].x;
+        });
+
+    return sum;
+}
+
+double sumNodes(const EcsScene &scene)
+{
+    double sum{0.0};
+    for (const auto &node : scene.nodes)
+    {
+        sum += node->transform.world[3].x;
+    }
+
+    return sum;
+}
+
+} // namespace Detail
+
+void RunEcsSuite(MicroBenchmark &benchmark)
+{
+    const glm::vec4 step{0.25f, 0.0f, -0.125f, 0.0f};
+
+    for (std::size_t count : {10000, 100000})
+    {
+        Detail::EcsScene scene;
+        Detail::fillEcsScene(count, 37u, scene);
+        const std::string suffix{"/" + std::to_string(count)};
+
+        // One step of every representation moves every prop alike
+        for (Scene::Transform &transform : scene.array)
+        {
+            Detail::moveTransform(transform, step);
+        }
+        scene.registry.each<Scene::Transform>(
+            [&step](const Scene::Entity &, Scene::Transform &transform) {
+                Detail::moveTransform(transform, step);
+            });
+        for (Detail::EcsNode *node : scene.order)
+        {
+            Detail::moveTransform(node->transform, step);
+        }
+        benchmark.check("registry-vs-array" + suffix,
+                        std::abs(Detail::sumRegistry(scene) -
+                                 Detail::sumArray(scene)),
+                        0.0);
+        benchmark.check("pointers-vs-array" + suffix,
+                        std::abs(Detail::sumNodes(scene) -
+                                 Detail::sumArray(scene)),
+                        0.0);
+
+        benchmark.run("array" + suffix, count, [&] {
+            for (Scene::Transform &transform : scene.array)
+            {
+                Detail::moveTransform(transform, step);
+            }
+            DoNotOptimize(scene.array.front());
+        });
+        benchmark.run("registry-each" + suffix, count, [&] {
+            scene.registry.each<Scene::Transform>(
+                [&step](const Scene::Entity &, Scene::Transform &transform) {
+                    Detail::moveTransform(transform, step);
+                });
+            DoNotOptimize(scene.registry.pool<Scene::Transform>()[0]);
+        });
+        benchmark.run("pointers" + suffix, count, [&] {
+            for (Detail::EcsNode *node : scene.order)
+            {
+                Detail::moveTransform(node->transform, step);
+            }
+            DoNotOptimize(scene.order.front()->transform);
+        });
+        // A system of two components, the second looked up per entity
+        benchmark.run("registry-each-bounds" + suffix, count, [&] {
+            scene.registry.each<Scene::Bounds, Scene::Transform>(
+                [](const Scene::Entity &, Scene::Bounds &bounds,
+                   const Scene::Transform &transform) {
+                    bounds.sphere = glm::vec4{glm::vec3{transform.world[3]},
+                                              bounds.sphere.w};
+                });
+            DoNotOptimize(scene.registry.pool<Scene::Bounds>()[0]);
+        });
+
+        // Destroying and creating entities keeps the pools packed
+        Random random{41u};
+        for (std::size_t i = 0; i < count / 4; ++i)
+        {
+            const Scene::Entity entity{
+                scene.registry.pool<Scene::Transform>().entity(
+                    random.next() %
+                    scene.registry.pool<Scene::Transform>().size())};
+            scene.registry.destroy(entity);
+            const Scene::Entity created{scene.registry.create()};
+            scene.registry.emplace<Scene::Transform>(
+                created, Scene::Transform{glm::mat4{1.0f}});
+        }
+        std::size_t visited{0};
+        scene.registry.each<Scene::Transform>(
+            [&visited](const Scene::Entity &, Scene::Transform &) {
+                ++visited;
+            });
+        benchmark.check("registry-churn-visits" + suffix,
+                        std::abs(static_cast<double>(visited) -
+                                 static_cast<double>(scene.registry.size())),
+                        0.0);
+    }
+}
+
+} // namespace Benchmark
@@ -0,0 +1,244 @@
+#include "FrameBenchmark.hpp"
+
+#include "glm/gtc/constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+struct Summary
+{
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double drawCalls = 0.0;
+    double triangles = 0.0;
+    double stateChanges = 0.0;
+    double worldTransforms = 0.0;
+    double occludedFraction = 0.0; // of all the avatars in view
+};
+
+double percentile(const std::vector<double> &sorted, double fraction);
+Summary summarize(const std::vector<FrameSample> &samples);
+bool endsWith(const std::string &text, const std::string &suffix);
+
+// Nearest-rank percentile of an ascending sequence
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+
+    const auto rank = static_cast<std::size_t>(
+        std::ceil(fraction * static_cast<double>(sorted.size())));
+
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+Summary summarize(const std::vector<FrameSample> &samples)
+{
+    Summary summary;
+
+    if (samples.empty())
+    {
+        return summary;
+    }
+
+    std::vector<double> times;
+    times.reserve(samples.size());
+    double inView{0.0};
+    double occluded{0.0};
+    for (const auto &sample : samples)
+    {
+        times.push_back(sample.milliseconds);
+        summary.mean += sample.milliseconds;
+        summary.drawCalls += sample.drawCalls;
+        summary.triangles += sample.triangles;
+        summary.stateChanges += sample.stateChanges;
+        summary.worldTransforms += sample.worldTransforms;
+        inView += sample.avatarsInView;
+        occluded += sample.avatarsOccluded;
+    }
+    summary.occludedFraction = inView > 0.0 ? occluded / inView : 0.0;
+
+    const auto count = static_cast<double>(samples.size());
+    summary.mean /= count;
+    summary.drawCalls /= count;
+    summary.triangles /= count;
+    summary.stateChanges /= count;
+    summary.worldTransforms /= count;
+
+    std::sort(times.begin(), times.end());
+    summary.p50 = percentile(times, 0.50);
+    summary.p95 = percentile(times, 0.95);
+    summary.p99 = percentile(times, 0.99);
+    summary.max = times.back();
+
+    return summary;
+}
+
+bool endsWith(const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+               0;
+}
+
+} // namespace Detail
+
+FrameBenchmark::FrameBenchmark(int frames, float timestep)
+    : frames_{frames}, timestep_{timestep}
+{
+    samples_.reserve(static_cast<std::size_t>(frames));
+}
+
+int FrameBenchmark::totalFrames() const noexcept
+{
+    return WarmupFrames + frames_;
+}
+
+float FrameBenchmark::timestep() const noexcept { return timestep_; }
+
+glm::vec3 FrameBenchmark::cameraPosition(int frame,
+                                         float radius) const noexcept
+{
+    // One revolution every ten seconds of simulated time
+    const float angle{static_cast<float>(frame) * timestep_ * 0.2f *
+                      glm::pi<float>()};
+
+    return glm::vec3{radius * std::cos(angle), 0.4f * radius,
+                     radius * std::sin(angle)};
+}
+
+bool FrameBenchmark::shouldToggleForm(int frame) const noexcept
+{
+    return frame % ToggleFormPeriod == WarmupFrames;
+}
+
+void FrameBenchmark::beginFrame() noexcept
+{
+    frameBegin_ = std::chrono::steady_clock::now();
+}
+
+void FrameBenchmark::endFrame(int frame,
+                              const OpenGL::OpenGLStatistics &statistics,
+                              const SkeletonStatistics &skeletonStatistics,
+                              const Math::CullingStatistics &cullingStatistics)
+{
+    if (frame < WarmupFrames)
+    {
+        return;
+    }
+
+    samples_.push_back(FrameSample{
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - frameBegin_)
+            .count(),
+        statistics.drawCalls, statistics.triangles, statistics.stateChanges(),
+        skeletonStatistics.worldTransforms,
+        cullingStatistics.avatarsDrawn + cullingStatistics.avatarsOccluded,
+        cullingStatistics.avatarsOccluded});
+}
+
+bool FrameBenchmark::writeReport(const std::string &path) const
+{
+    const Detail::Summary summary{Detail::summarize(samples_)};
+
+    std::cout << "[Benchmark] " << samples_.size() << " frames, mean "
+              << summary.mean << " ms, p50 " << summary.p50 << " ms, p95 "
+              << summary.p95 << " ms, p99 " << summary.p99 << " ms, max "
+              << summary.max << " ms, " << summary.drawCalls
+              << " draw calls/frame, " << summary.triangles
+              << " triangles/frame, " << summary.stateChanges
+              << " state changes/frame, " << summary.worldTransforms
+              << " transforms/frame, " << 100.0 * summary.occludedFraction
+              << "% of avatars in view occluded" << std::endl;
+
+    const bool written{Detail::endsWith(path, ".json") ? writeJson(path)
+                                                       : writeCsv(path)};
+    if (!written)
+    {
+        std::cerr << "[Error] Failed to write benchmark report " << path
+                  << std::endl;
+    }
+
+    return written;
+}
+
+bool FrameBenchmark::writeJson(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    const Detail::Summary summary{Detail::summarize(samples_)};
+
+    out << "{\n"
+        << "  \"frames\": " << samples_.size() << ",\n"
+        << "  \"timestep\": " << timestep_ << ",\n"
+        << "  \"frame_ms\": {\"mean\": " << summary.mean
+        << ", \"p50\": " << summary.p50 << ", \"p95\": " << summary.p95
+        << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max
+        << "},\n"
+        << "  \"draw_calls_per_frame\": " << summary.drawCalls << ",\n"
+        << "  \"triangles_per_frame\": " << summary.triangles << ",\n"
+        << "  \"state_changes_per_frame\": " << summary.stateChanges << ",\n"
+        << "  \"transforms_per_frame\": " << summary.worldTransforms << ",\n"
+        << "  \"occluded_fraction\": " << summary.occludedFraction << ",\n"
+        << "  \"sample_columns\": [\"frame_ms\", \"draw_calls\", "
+           "\"triangles\", \"state_changes\", \"transforms\", "
+           "\"avatars_in_view\", \"avatars_occluded\"],\n"
+        << "  \"samples\": [";
+
+    for (std::size_t i = 0; i < samples_.size(); ++i)
+    {
+        out << (i ? "," : "") << "\n    [" << samples_[i].milliseconds << ", "
+            << samples_[i].drawCalls << ", " << samples_[i].triangles << ", "
+            << samples_[i].stateChanges
+            << ", " << samples_[i].worldTransforms << ", "
+            << samples_[i].avatarsInView << ", "
+            << samples_[i].avatarsOccluded << "]";
+    }
+
+    out << "\n  ]\n}\n";
+
+    return out.good();
+}
+
+bool FrameBenchmark::writeCsv(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    const Detail::Summary summary{Detail::summarize(samples_)};
+
+    out << "frames,timestep,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,"
+           "draw_calls_per_frame,triangles_per_frame,state_changes_per_frame,"
+           "transforms_per_frame,occluded_fraction\n"
+        << samples_.size() << "," << timestep_ << "," << summary.mean << ","
+        << summary.p50 << "," << summary.p95 << "," << summary.p99 << ","
+        << summary.max << "," << summary.drawCalls << ","
+        << summary.triangles << "," << summary.stateChanges << "," << summary.worldTransforms << ","
+        << summary.occludedFraction << "\n";
+
+    return out.good();
+}
+
+} // namespace Benchmark
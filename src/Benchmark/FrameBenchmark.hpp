@@ -0,0 +1,91 @@
+#ifndef HOMEWORK01_BENCHMARK_FRAMEBENCHMARK_HPP_
+#define HOMEWORK01_BENCHMARK_FRAMEBENCHMARK_HPP_
+
+#include "Avatar/Skeleton.hpp"
+#include "OpenGL/OpenGLStatistics.hpp"
+#include "Utils/Math/Frustum.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+/**
+ * @brief Measurements of one benchmark frame.
+ */
+struct FrameSample
+{
+    double milliseconds;
+    std::uint32_t drawCalls;
+    std::uint32_t triangles;
+    std::uint32_t stateChanges;
+    std::uint32_t worldTransforms;
+    std::uint32_t avatarsInView; // drawn or occluded
+    std::uint32_t avatarsOccluded;
+};
+
+/**
+ * @brief Deterministic frame benchmark of the Homework03 scene.
+ *
+ * @details The scene is driven by a script instead of input and wall clock:
+ * the camera orbits the avatar, Animal::toggleForm fires on fixed frames and
+ * every frame advances the simulation by the same timestep. The first
+ * warm-up frames are rendered but not measured. Frame times are reported as
+ * mean, p50, p95, p99 and max together with draw calls, triangles, state
+ * changes, recomputed joint transforms and the share of avatars in view
+ * which were skipped as occluded per frame.
+ */
+class FrameBenchmark
+{
+public:
+    static constexpr int WarmupFrames = 10;
+    static constexpr int ToggleFormPeriod = 180;
+
+    explicit FrameBenchmark(int frames, float timestep);
+
+    /**
+     * @brief Gets the number of frames to render, warm-up included.
+     */
+    int totalFrames() const noexcept;
+    float timestep() const noexcept;
+
+    /**
+     * @brief Gets the scripted camera position at \a frame, orbiting at
+     * \a radius, the camera always looks at the origin.
+     */
+    glm::vec3 cameraPosition(int frame, float radius = 10.0f) const noexcept;
+    /**
+     * @brief Gets whether the scripted Animal::toggleForm fires at \a frame.
+     */
+    bool shouldToggleForm(int frame) const noexcept;
+
+    void beginFrame() noexcept;
+    void endFrame(int frame, const OpenGL::OpenGLStatistics &statistics,
+                  const SkeletonStatistics &skeletonStatistics,
+                  const Math::CullingStatistics &cullingStatistics);
+
+    /**
+     * @brief Print the summary and write the report to \a path, as JSON if
+     * the extension is \c .json and as CSV otherwise.
+     */
+    bool writeReport(const std::string &path) const;
+
+private:
+    bool writeJson(const std::string &path) const;
+    bool writeCsv(const std::string &path) const;
+
+    int frames_;
+    float timestep_;
+
+    std::chrono::steady_clock::time_point frameBegin_;
+    std::vector<FrameSample> samples_;
+};
+
+} // namespace Benchmark
+
+#endif // HOMEWORK01_BENCHMARK_FRAMEBENCHMARK_HPP_
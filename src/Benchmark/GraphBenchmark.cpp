@@ -0,0 +1,287 @@
+#include "MicroBenchmark.hpp"
+
+#include "Avatar/AnimationGraph.hpp"
+#include "Utils/Parallel/JobSystem.hpp"
+
+#include "glm/gtc/constants.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// A rig about twice the size of the pig's, two seconds loops at 30 frames per
+// second
+constexpr int graphJoints{32};
+constexpr int graphFrames{61};
+constexpr std::size_t graphAvatars{1024};
+constexpr std::size_t graphAvatarGrain{16};
+constexpr float graphTimestep{1.0f / 60.0f};
+
+/**
+ * @brief Clips and graph of the benchmark rig: idle and walk in a state
+ * machine, a gesture masked to the upper half of the joints and breathing
+ * added on top, like Animal's graphs.
+ */
+struct GraphRig
+{
+    std::vector<std::unique_ptr<AnimationClip>> clips;
+    AnimationGraph graph{graphJoints};
+    int locomotion;
+    int gesture;
+    int breath;
+};
+
+const AnimationClip &makeGraphClip(GraphRig &rig, std::uint32_t seed,
+                                   float amplitude);
+void buildGraphRig(GraphRig &rig);
+void driveAvatar(const GraphRig &rig, AnimationGraph::Instance &instance,
+                 std::size_t avatar, int frame);
+void evaluateAvatar(const GraphRig &rig, AnimationGraph::Instance &instance,
+                    PosePool &pool, glm::vec3 *output);
+double maximumPoseDifference(const std::vector<glm::vec3> &first,
+                             const std::vector<glm::vec3> &second);
+
+// Every joint sways around its own rest pose, the same for every clip
+const AnimationClip &makeGraphClip(GraphRig &rig, std::uint32_t seed,
+                                   float amplitude)
+{
+    Random rest{7u};
+    Random random{seed};
+
+    ClipSamples samples;
+    samples.jointCount = graphJoints;
+    samples.frameCount = graphFrames;
+
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> swings;
+    for (int joint = 0; joint < graphJoints; ++joint)
+    {
+        offsets.push_back(glm::vec3{rest.uniform(-1.0f, 1.0f),
+                                    rest.uniform(-1.0f, 1.0f),
+                                    rest.uniform(-1.0f, 1.0f)});
+        rotations.push_back(glm::vec3{rest.uniform(-45.0f, 45.0f),
+                                      rest.uniform(-45.0f, 45.0f),
+                                      rest.uniform(-45.0f, 45.0f)});
+        swings.push_back(glm::vec3{random.uniform(0.0f, amplitude),
+                                   random.uniform(0.0f, amplitude),
+                                   random.uniform(0.0f, amplitude)});
+    }
+
+    for (int frame = 0; frame < graphFrames; ++frame)
+    {
+        const float wave{std::sin(2.0f * glm::pi<float>() *
+                                  static_cast<float>(frame) /
+                                  static_cast<float>(graphFrames - 1))};
+
+        for (int joint = 0; joint < graphJoints; ++joint)
+        {
+            samples.offsets.push_back(offsets[joint]);
+            samples.rotations.push_back(rotations[joint] + swings[joint] * wave);
+            samples.sizes.push_back(glm::vec3{1.0f + 0.05f * wave});
+        }
+    }
+
+    rig.clips.emplace_back(new AnimationClip{});
+    rig.clips.back()->build(samples);
+
+    return *rig.clips.back();
+}
+
+void buildGraphRig(GraphRig &rig)
+{
+    AnimationGraph &graph{rig.graph};
+
+    rig.gesture = graph.addParameter("gesture");
+    rig.breath = graph.addParameter("breath");
+
+    rig.locomotion = graph.addStateMachine("locomotion");
+    graph.addState(rig.locomotion, "idle",
+                   graph.addClip(makeGraphClip(rig, 11u, 5.0f)));
+    graph.addState(rig.locomotion, "walk",
+                   graph.addClip(makeGraphClip(rig, 12u, 30.0f)));
+    graph.addTransition(rig.locomotion, AnimationGraph::AnyState, 0, 0.3f);
+    graph.addTransition(rig.locomotion, AnimationGraph::AnyState, 1, 0.3f);
+
+    std::vector<float> mask(graphJoints, 0.0f);
+    std::fill(mask.begin() + graphJoints / 2, mask.end(), 1.0f);
+    const int layered{graph.addMask(
+        rig.locomotion, graph.addClip(makeGraphClip(rig, 13u, 60.0f), 1.5f),
+        mask, rig.gesture)};
+
+    // The first frame of the breath clip is its rest pose
+    const AnimationClip &breath{makeGraphClip(rig, 14u, 2.0f)};
+    AnimationClip::Cursor cursor{breath.createCursor()};
+    Pose reference;
+    reference.resize(graphJoints);
+    breath.sample(0.0f, cursor, reference.offsets.data(),
+                  reference.rotations.data(), reference.sizes.data());
+
+    graph.setRoot(graph.addAdditive(layered, graph.addClip(breath, 0.5f),
+                                    reference, rig.breath));
+}
+
+// Every avatar switches between idle and walk and raises its gesture on its
+// own schedule, a few of them are cross-fading in any frame
+void driveAvatar(const GraphRig &rig, AnimationGraph::Instance &instance,
+                 std::size_t avatar, int frame)
+{
+    const int period{60 + static_cast<int>(avatar % 37)};
+    if (frame % period == 0)
+    {
+        rig.graph.requestState(instance, rig.locomotion,
+                               (frame / period + static_cast<int>(avatar)) % 2);
+    }
+
+    instance.parameters[rig.gesture] =
+        0.5f + 0.5f * std::sin(static_cast<float>(frame + avatar) * 0.05f);
+    rig.graph.update(instance, graphTimestep);
+}
+
+void evaluateAvatar(const GraphRig &rig, AnimationGraph::Instance &instance,
+                    PosePool &pool, glm::vec3 *output)
+{
+    Pose *pose{rig.graph.evaluate(instance, pool)};
+
+    std::copy(pose->offsets.begin(), pose->offsets.end(), output);
+    std::copy(pose->rotations.begin(), pose->rotations.end(),
+              output + graphJoints);
+    std::copy(pose->sizes.begin(), pose->sizes.end(), output + 2 * graphJoints);
+
+    pool.release(pose);
+}
+
+double maximumPoseDifference(const std::vector<glm::vec3> &first,
+                             const std::vector<glm::vec3> &second)
+{
+    double error{0.0};
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            error = std::max(error, static_cast<double>(std::abs(
+                                        first[i][axis] - second[i][axis])));
+        }
+    }
+
+    return error;
+}
+
+} // namespace Detail
+
+void RunGraphSuite(MicroBenchmark &benchmark)
+{
+    Detail::GraphRig rig;
+    Detail::buildGraphRig(rig);
+
+    const std::size_t avatars{Detail::graphAvatars};
+    const std::size_t poseSize{3 * Detail::graphJoints};
+    const std::size_t items{avatars * Detail::graphJoints};
+
+    // A settled idle avatar without layers is its idle clip
+    {
+        AnimationGraph::Instance instance{rig.graph.createInstance()};
+        PosePool pool;
+        rig.graph.update(instance, 0.4f);
+
+        std::vector<glm::vec3> graphPose(poseSize);
+        Detail::evaluateAvatar(rig, instance, pool, graphPose.data());
+
+        std::vector<glm::vec3> clipPose(poseSize);
+        AnimationClip::Cursor cursor{rig.clips.front()->createCursor()};
+        rig.clips.front()->sample(0.4f, cursor, clipPose.data(),
+                                  clipPose.data() + Detail::graphJoints,
+                                  clipPose.data() + 2 * Detail::graphJoints);
+
+        benchmark.check("idle-is-clip",
+                        Detail::maximumPoseDifference(graphPose, clipPose),
+                        0.0);
+    }
+
+    std::vector<AnimationGraph::Instance> serial(avatars,
+                                                 rig.graph.createInstance());
+    std::vector<AnimationGraph::Instance> parallel(serial);
+    for (std::size_t avatar = 0; avatar < avatars; ++avatar)
+    {
+        serial[avatar].parameters[rig.breath] = 1.0f;
+        parallel[avatar].parameters[rig.breath] = 1.0f;
+    }
+
+    // Two seconds of playback, every layer and transition is exercised and
+    // the pool stops growing after the first evaluation
+    PosePool serialPool;
+    std::vector<glm::vec3> serialPoses(avatars * poseSize);
+    std::size_t warmCapacity{0};
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        for (std::size_t avatar = 0; avatar < avatars; ++avatar)
+        {
+            Detail::driveAvatar(rig, serial[avatar], avatar, frame);
+            Detail::evaluateAvatar(rig, serial[avatar], serialPool,
+                                   &serialPoses[avatar * poseSize]);
+        }
+        warmCapacity = frame == 0 ? serialPool.capacity() : warmCapacity;
+    }
+    benchmark.check("pool-growth",
+                    static_cast<double>(serialPool.capacity() - warmCapacity),
+                    0.0);
+
+    // The same playback over every thread, one pool each
+    const unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+    Parallel::JobSystem system{threads - 1};
+    std::vector<glm::vec3> parallelPoses(avatars * poseSize);
+
+    const auto playParallel = [&](int frame) {
+        system.parallelFor(
+            avatars, Detail::graphAvatarGrain,
+            [&](std::size_t begin, std::size_t end) {
+                thread_local PosePool pool;
+                for (std::size_t avatar = begin; avatar < end; ++avatar)
+                {
+                    Detail::driveAvatar(rig, parallel[avatar], avatar, frame);
+                    Detail::evaluateAvatar(rig, parallel[avatar], pool,
+                                           &parallelPoses[avatar * poseSize]);
+                }
+            });
+    };
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        playParallel(frame);
+    }
+    benchmark.check("parallel-matches-serial",
+                    Detail::maximumPoseDifference(serialPoses, parallelPoses),
+                    0.0);
+
+    int frame{120};
+    benchmark.run("evaluate-serial/" + std::to_string(avatars), items, [&] {
+        for (std::size_t avatar = 0; avatar < avatars; ++avatar)
+        {
+            Detail::driveAvatar(rig, serial[avatar], avatar, frame);
+            Detail::evaluateAvatar(rig, serial[avatar], serialPool,
+                                   &serialPoses[avatar * poseSize]);
+        }
+        ++frame;
+        DoNotOptimize(serialPoses.back());
+    });
+
+    frame = 120;
+    benchmark.run("evaluate-parallel/" + std::to_string(avatars) + "/" +
+                      std::to_string(system.threadCount()) + "t",
+                  items, [&] {
+                      playParallel(frame++);
+                      DoNotOptimize(parallelPoses.back());
+                  });
+}
+
+} // namespace Benchmark
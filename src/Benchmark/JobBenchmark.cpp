@@ -0,0 +1,359 @@
+#include "MicroBenchmark.hpp"
+
+#include "Utils/Math/EulerTransform.hpp"
+#include "Utils/Parallel/JobSystem.hpp"
+#include "Utils/Parallel/TripleBuffer.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+constexpr std::size_t scalingJoints{262144};
+constexpr std::size_t scalingJointGrain{512};
+constexpr std::size_t fineItems{1 << 20};
+constexpr std::size_t fineGrain{256};
+// Dependency workload, parents each wait on their own children
+constexpr std::size_t parentJobs{64};
+constexpr std::size_t childJobs{16};
+constexpr std::size_t jointsPerChild{256};
+// Values a producer hands a consumer through a TripleBuffer
+constexpr std::uint64_t snapshots{200000};
+
+// Every word holds the sequence, a torn read mixes two
+using Snapshot = std::array<std::uint64_t, 32>;
+
+struct JointInputs
+{
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::mat4> transforms;
+};
+
+struct Family
+{
+    Parallel::JobSystem *system;
+    JointInputs *inputs;
+    std::vector<Parallel::Job> *children; // childJobs per parent
+};
+
+std::vector<unsigned> threadCounts();
+JointInputs makeJointInputs(std::size_t count, std::uint32_t seed);
+void composeJoints(JointInputs &inputs, std::size_t begin, std::size_t end);
+void runChild(const Parallel::Job &job);
+void runParent(const Parallel::Job &job);
+void reportScaling(const std::string &name, const std::vector<unsigned> &threads,
+                   const std::vector<double> &times);
+void handOffSnapshots(std::size_t &torn, std::size_t &reversed,
+                      std::uint64_t &last);
+
+// 1, 2, 4, ... up to and including the hardware threads
+std::vector<unsigned> threadCounts()
+{
+    const unsigned hardware{std::max(1u, std::thread::hardware_concurrency())};
+
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2)
+    {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+
+    return counts;
+}
+
+JointInputs makeJointInputs(std::size_t count, std::uint32_t seed)
+{
+    Random random{seed};
+
+    JointInputs inputs;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        inputs.offsets.push_back(glm::vec3{random.uniform(-10.0f, 10.0f),
+                                           random.uniform(-10.0f, 10.0f),
+                                           random.uniform(-10.0f, 10.0f)});
+        inputs.rotations.push_back(glm::vec3{random.uniform(-180.0f, 180.0f),
+                                             random.uniform(-180.0f, 180.0f),
+                                             random.uniform(-180.0f, 180.0f)});
+    }
+    inputs.transforms.resize(count);
+
+    return inputs;
+}
+
+void composeJoints(JointInputs &inputs, std::size_t begin, std::size_t end)
+{
+    Math::ComposeEulerTransforms(inputs.offsets.data() + begin,
+                                 inputs.rotations.data() + begin, nullptr,
+                                 end - begin, inputs.transforms.data() + begin);
+}
+
+void runChild(const Parallel::Job &job)
+{
+    const Family &family{*static_cast<const Family *>(job.data)};
+
+    composeJoints(*family.inputs, job.begin, job.end);
+}
+
+void runParent(const Parallel::Job &job)
+{
+    const Family &family{*static_cast<const Family *>(job.data)};
+    Parallel::JobCounter counter;
+
+    for (std::size_t child = 0; child < childJobs; ++child)
+    {
+        Parallel::Job &childJob{(*family.children)[job.begin * childJobs + child]};
+        const std::size_t first{(job.begin * childJobs + child) * jointsPerChild};
+
+        childJob.function = runChild;
+        childJob.data = &family;
+        childJob.begin = first;
+        childJob.end = first + jointsPerChild;
+        family.system->run(childJob, counter);
+    }
+
+    // Finish the parent only after its children, other jobs run meanwhile
+    family.system->wait(counter);
+}
+
+void reportScaling(const std::string &name, const std::vector<unsigned> &threads,
+                   const std::vector<double> &times)
+{
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        const double speedup{times.front() / times[i]};
+
+        char line[160];
+        std::snprintf(line, sizeof(line),
+                      "[Microbenchmark] %-10s %-32s %6.2fx speedup, %5.1f%% "
+                      "efficiency",
+                      "jobs", (name + "/" + std::to_string(threads[i]) + "t")
+                                  .c_str(),
+                      speedup, 100.0 * speedup / threads[i]);
+        std::cout << line << std::endl;
+    }
+}
+
+// Publish Detail::snapshots values from a thread while this one reads them
+void handOffSnapshots(std::size_t &torn, std::size_t &reversed,
+                      std::uint64_t &last)
+{
+    Parallel::TripleBuffer<Snapshot> buffer;
+    std::atomic<bool> done{false};
+    torn = 0;
+    reversed = 0;
+    last = 0;
+
+    std::thread producer{[&] {
+        for (std::uint64_t sequence = 1; sequence <= snapshots; ++sequence)
+        {
+            buffer.back().fill(sequence);
+            buffer.publish();
+        }
+        done.store(true, std::memory_order_release);
+    }};
+
+    for (;;)
+    {
+        // The flag first, a publish before it is taken by this update
+        const bool finished{done.load(std::memory_order_acquire)};
+        if (buffer.update())
+        {
+            const Snapshot &snapshot{buffer.front()};
+            const std::uint64_t sequence{snapshot.front()};
+            torn += static_cast<std::size_t>(std::count(
+                snapshot.begin(), snapshot.end(), sequence)) != snapshot.size();
+            reversed += sequence <= last;
+            last = sequence;
+        }
+        else if (finished)
+        {
+            break;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+}
+
+} // namespace Detail
+
+void RunJobSuite(MicroBenchmark &benchmark)
+{
+    const std::vector<unsigned> threads{Detail::threadCounts()};
+
+    // Correctness first, every index exactly once and every child before its
+    // parent returns. At least four threads so stealing is exercised even
+    // on a machine with fewer cores
+    std::vector<unsigned> checkThreads{threads};
+    if (checkThreads.back() < 4)
+    {
+        checkThreads.push_back(4);
+    }
+
+    for (unsigned count : checkThreads)
+    {
+        Parallel::JobSystem system{count - 1};
+        const std::string suffix{"/" + std::to_string(count) + "t"};
+
+        const std::size_t items{1000003};
+        std::vector<std::uint8_t> visits(items, 0);
+        system.parallelFor(items, 7, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                ++visits[i];
+            }
+        });
+
+        std::size_t wrong{0};
+        for (std::uint8_t visit : visits)
+        {
+            wrong += visit != 1;
+        }
+        benchmark.check("parallel-for-coverage" + suffix,
+                        static_cast<double>(wrong), 0.0);
+
+        Detail::JointInputs inputs{Detail::makeJointInputs(
+            Detail::parentJobs * Detail::childJobs * Detail::jointsPerChild,
+            13u)};
+        std::vector<glm::mat4> references(inputs.transforms.size());
+        Math::ComposeEulerTransforms(inputs.offsets.data(),
+                                     inputs.rotations.data(), nullptr,
+                                     references.size(), references.data());
+
+        std::vector<Parallel::Job> parents(Detail::parentJobs);
+        std::vector<Parallel::Job> children(Detail::parentJobs *
+                                            Detail::childJobs);
+        const Detail::Family family{&system, &inputs, &children};
+        Parallel::JobCounter counter;
+        for (std::size_t parent = 0; parent < Detail::parentJobs; ++parent)
+        {
+            parents[parent].function = Detail::runParent;
+            parents[parent].data = &family;
+            parents[parent].begin = parent;
+            system.run(parents[parent], counter);
+        }
+        system.wait(counter);
+
+        std::size_t mismatches{0};
+        for (std::size_t i = 0; i < references.size(); ++i)
+        {
+            mismatches += inputs.transforms[i] != references[i];
+        }
+        benchmark.check("dependencies" + suffix,
+                        static_cast<double>(mismatches), 0.0);
+    }
+
+    // Values handed between threads arrive whole, newer and the last one
+    std::size_t torn{0};
+    std::size_t reversed{0};
+    std::uint64_t last{0};
+    Detail::handOffSnapshots(torn, reversed, last);
+    benchmark.check("triple-buffer-torn", static_cast<double>(torn), 0.0);
+    benchmark.check("triple-buffer-order", static_cast<double>(reversed), 0.0);
+    benchmark.check("triple-buffer-last",
+                    static_cast<double>(Detail::snapshots - last), 0.0);
+
+    Detail::JointInputs joints{
+        Detail::makeJointInputs(Detail::scalingJoints, 17u)};
+    std::vector<float> values(Detail::fineItems, 1.0f);
+
+    std::vector<double> transformTimes;
+    std::vector<double> fineTimes;
+    std::vector<double> dependencyTimes;
+
+    for (unsigned count : threads)
+    {
+        Parallel::JobSystem system{count - 1};
+        const std::string suffix{"/" + std::to_string(count) + "t"};
+
+        transformTimes.push_back(
+            benchmark
+                .run("transforms" + suffix, Detail::scalingJoints,
+                     [&] {
+                         system.parallelFor(
+                             Detail::scalingJoints, Detail::scalingJointGrain,
+                             [&](std::size_t begin, std::size_t end) {
+                                 Detail::composeJoints(joints, begin, end);
+                             });
+                         DoNotOptimize(joints.transforms.back());
+                     })
+                .median);
+
+        // Little work per item, measures the scheduling overhead
+        fineTimes.push_back(
+            benchmark
+                .run("fine-grained" + suffix, Detail::fineItems,
+                     [&] {
+                         system.parallelFor(
+                             Detail::fineItems, Detail::fineGrain,
+                             [&](std::size_t begin, std::size_t end) {
+                                 for (std::size_t i = begin; i < end; ++i)
+                                 {
+                                     values[i] = std::sqrt(values[i] + 1.0f);
+                                 }
+                             });
+                         DoNotOptimize(values.back());
+                     })
+                .median);
+
+        Detail::JointInputs inputs{Detail::makeJointInputs(
+            Detail::parentJobs * Detail::childJobs * Detail::jointsPerChild,
+            19u)};
+        std::vector<Parallel::Job> parents(Detail::parentJobs);
+        std::vector<Parallel::Job> children(Detail::parentJobs *
+                                            Detail::childJobs);
+        const Detail::Family family{&system, &inputs, &children};
+
+        dependencyTimes.push_back(
+            benchmark
+                .run("dependencies" + suffix, inputs.transforms.size(),
+                     [&] {
+                         Parallel::JobCounter counter;
+                         for (std::size_t parent = 0;
+                              parent < Detail::parentJobs; ++parent)
+                         {
+                             parents[parent].function = Detail::runParent;
+                             parents[parent].data = &family;
+                             parents[parent].begin = parent;
+                             system.run(parents[parent], counter);
+                         }
+                         system.wait(counter);
+                         DoNotOptimize(inputs.transforms.back());
+                     })
+                .median);
+    }
+
+    // One publish and one update, the cost of handing over a frame
+    Parallel::TripleBuffer<Detail::Snapshot> buffer;
+    benchmark.run("triple-buffer-handoff", 1, [&] {
+        buffer.back().front() += 1;
+        buffer.publish();
+        buffer.update();
+        DoNotOptimize(buffer.front());
+    });
+
+    Detail::reportScaling("transforms", threads, transformTimes);
+    Detail::reportScaling("fine-grained", threads, fineTimes);
+    Detail::reportScaling("dependencies", threads, dependencyTimes);
+}
+
+} // namespace Benchmark
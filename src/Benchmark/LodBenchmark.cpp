@@ -0,0 +1,183 @@
+#include "MicroBenchmark.hpp"
+
+#include "Model/LevelOfDetail.hpp"
+#include "Model/MorphTarget.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/gtc/constants.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// Ratios the Animal's parts are loaded with
+const std::vector<float> lodRatios{0.5f, 0.25f, 0.125f};
+
+// Unit UV sphere of \a rings by \a segments quads, the seam and the poles
+// split like an importer would
+Model::MeshData makeLodSphere(int rings, int segments);
+glm::vec3 lodVertex(const Model::MeshData &mesh, std::size_t index) noexcept;
+// Triangles of \a level facing against their vertices' normals
+std::size_t flippedTriangles(const Model::MeshData &mesh,
+                             const Model::LodLevel &level) noexcept;
+// Furthest a triangle centre of \a level lies inside the unit sphere
+float sphereSag(const Model::MeshData &mesh,
+                const Model::LodLevel &level) noexcept;
+
+Model::MeshData makeLodSphere(int rings, int segments)
+{
+    Model::MeshData mesh;
+    for (int ring = 0; ring <= rings; ++ring)
+    {
+        const float v{static_cast<float>(ring) / static_cast<float>(rings)};
+        const float polar{glm::pi<float>() * v};
+        for (int segment = 0; segment <= segments; ++segment)
+        {
+            const float u{static_cast<float>(segment) /
+                          static_cast<float>(segments)};
+            const float azimuth{glm::two_pi<float>() * u};
+            const glm::vec3 position{std::sin(polar) * std::cos(azimuth),
+                                     std::cos(polar),
+                                     std::sin(polar) * std::sin(azimuth)};
+            mesh.positions.insert(mesh.positions.end(),
+                                  {position.x, position.y, position.z});
+            mesh.normals.insert(mesh.normals.end(),
+                                {position.x, position.y, position.z});
+            mesh.textureCoordinates.insert(mesh.textureCoordinates.end(),
+                                           {u, v});
+        }
+    }
+
+    const Model::Geometry::IndexType row{
+        static_cast<Model::Geometry::IndexType>(segments + 1)};
+    for (int ring = 0; ring < rings; ++ring)
+    {
+        for (int segment = 0; segment < segments; ++segment)
+        {
+            const Model::Geometry::IndexType corner{
+                static_cast<Model::Geometry::IndexType>(ring) * row +
+                static_cast<Model::Geometry::IndexType>(segment)};
+            // The pole rows' quads are a single triangle
+            if (ring > 0)
+            {
+                mesh.indices.insert(mesh.indices.end(),
+                                    {corner, corner + 1, corner + row});
+            }
+            if (ring < rings - 1)
+            {
+                mesh.indices.insert(mesh.indices.end(),
+                                    {corner + 1, corner + row + 1,
+                                     corner + row});
+            }
+        }
+    }
+
+    mesh.bounds = Math::ComputeBounds(mesh.positions.data(),
+                                      mesh.positions.size() / 3);
+
+    return mesh;
+}
+
+glm::vec3 lodVertex(const Model::MeshData &mesh, std::size_t index) noexcept
+{
+    return glm::vec3{mesh.positions[3 * index], mesh.positions[3 * index + 1],
+                     mesh.positions[3 * index + 2]};
+}
+
+std::size_t flippedTriangles(const Model::MeshData &mesh,
+                             const Model::LodLevel &level) noexcept
+{
+    std::size_t flipped{0};
+    const std::size_t end{
+        static_cast<std::size_t>(level.firstIndex + level.indexCount)};
+    for (std::size_t i = static_cast<std::size_t>(level.firstIndex); i < end;
+         i += 3)
+    {
+        const glm::vec3 a{lodVertex(mesh, mesh.indices[i])};
+        const glm::vec3 b{lodVertex(mesh, mesh.indices[i + 1])};
+        const glm::vec3 c{lodVertex(mesh, mesh.indices[i + 2])};
+        // The sphere's normals are its positions
+        flipped += glm::dot(glm::cross(b - a, c - a), a + b + c) <= 0.0f;
+    }
+
+    return flipped;
+}
+
+float sphereSag(const Model::MeshData &mesh,
+                const Model::LodLevel &level) noexcept
+{
+    float sag{0.0f};
+    const std::size_t end{
+        static_cast<std::size_t>(level.firstIndex + level.indexCount)};
+    for (std::size_t i = static_cast<std::size_t>(level.firstIndex); i < end;
+         i += 3)
+    {
+        const glm::vec3 centre{(lodVertex(mesh, mesh.indices[i]) +
+                                lodVertex(mesh, mesh.indices[i + 1]) +
+                                lodVertex(mesh, mesh.indices[i + 2])) /
+                               3.0f};
+        sag = std::max(sag, 1.0f - glm::length(centre));
+    }
+
+    return sag;
+}
+
+} // namespace Detail
+
+void RunLodSuite(MicroBenchmark &benchmark)
+{
+    for (int rings : {16, 48})
+    {
+        const Model::MeshData sphere{
+            Detail::makeLodSphere(rings, rings * 3 / 2)};
+        const std::size_t triangles{sphere.indices.size() / 3};
+        const std::string suffix{"/" + std::to_string(triangles)};
+
+        Model::MeshData simplified{sphere};
+        Model::BuildLevelsOfDetail(simplified, Detail::lodRatios);
+
+        // Every ratio is reached, errors ascend with the levels and bound
+        // how far the surface sinks below the full mesh, no triangle turns
+        // over
+        const float fullSag{
+            Detail::sphereSag(simplified, simplified.levels.front())};
+        std::size_t unordered{0};
+        std::size_t flipped{0};
+        double unbounded{0.0};
+        for (std::size_t level = 1; level < simplified.levels.size(); ++level)
+        {
+            const Model::LodLevel &current{simplified.levels[level]};
+            unordered += current.error < simplified.levels[level - 1].error;
+            flipped += Detail::flippedTriangles(simplified, current);
+            unbounded = std::max(
+                unbounded,
+                static_cast<double>(Detail::sphereSag(simplified, current) -
+                                    fullSag - current.error));
+        }
+        benchmark.check("lod-levels" + suffix,
+                        static_cast<double>(Detail::lodRatios.size() + 1) -
+                            static_cast<double>(simplified.levels.size()),
+                        0.0);
+        benchmark.check("lod-error-order" + suffix,
+                        static_cast<double>(unordered), 0.0);
+        benchmark.check("lod-flipped" + suffix, static_cast<double>(flipped),
+                        0.0);
+        benchmark.check("lod-error-bound" + suffix, unbounded, 0.0);
+
+        benchmark.run("build-lod" + suffix, triangles, [&] {
+            Model::MeshData mesh{sphere};
+            Model::BuildLevelsOfDetail(mesh, Detail::lodRatios);
+            DoNotOptimize(mesh.indices.size());
+        });
+    }
+}
+
+} // namespace Benchmark
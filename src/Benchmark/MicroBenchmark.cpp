@@ -0,0 +1,166 @@
+#include "MicroBenchmark.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+struct Suite
+{
+    const char *name;
+    void (*run)(MicroBenchmark &benchmark);
+};
+
+const Suite suites[]{
+    {"skeleton", RunSkeletonSuite},
+    {"transform", RunTransformSuite},
+    {"jobs", RunJobSuite},
+    {"clips", RunClipSuite},
+    {"graphs", RunGraphSuite},
+    {"culling", RunCullingSuite},
+    {"bvh", RunBvhSuite},
+    {"picking", RunPickingSuite},
+    {"lod", RunLodSuite},
+    {"ecs", RunEcsSuite},
+};
+
+bool hasSuffix(const std::string &text, const std::string &suffix);
+
+bool hasSuffix(const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+               0;
+}
+
+} // namespace Detail
+
+void MicroBenchmark::setSuite(const std::string &suite) { suite_ = suite; }
+
+bool MicroBenchmark::check(const std::string &name, double error,
+                           double tolerance)
+{
+    const bool passed{error <= tolerance};
+
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "[Microbenchmark] %-10s %-32s error %9.3g (tolerance %g) %s",
+                  suite_.c_str(), name.c_str(), error, tolerance,
+                  passed ? "ok" : "FAILED");
+    (passed ? std::cout : std::cerr) << line << std::endl;
+
+    if (!passed)
+    {
+        ++failures_;
+    }
+
+    return passed;
+}
+
+const std::vector<MicroResult> &MicroBenchmark::results() const noexcept
+{
+    return results_;
+}
+
+int MicroBenchmark::failures() const noexcept { return failures_; }
+
+const MicroResult &MicroBenchmark::addResult(const std::string &name,
+                                             std::size_t items,
+                                             std::size_t iterations,
+                                             std::vector<double> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    results_.push_back(MicroResult{suite_, name, items, iterations,
+                                   samples[samples.size() / 2],
+                                   samples.front()});
+
+    const MicroResult &result{results_.back()};
+
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "[Microbenchmark] %-10s %-32s %12.1f ns %10.2f ns/item",
+                  result.suite.c_str(), result.name.c_str(), result.median,
+                  result.median / static_cast<double>(
+                                      result.items ? result.items : 1));
+    std::cout << line << std::endl;
+
+    return result;
+}
+
+bool MicroBenchmark::writeReport(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    if (Detail::hasSuffix(path, ".json"))
+    {
+        out << "{\n  \"results\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i)
+        {
+            const MicroResult &result{results_[i]};
+
+            out << (i ? "," : "") << "\n    {\"suite\": \"" << result.suite
+                << "\", \"name\": \"" << result.name
+                << "\", \"items\": " << result.items
+                << ", \"iterations\": " << result.iterations
+                << ", \"median_ns\": " << result.median
+                << ", \"min_ns\": " << result.minimum << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+    else
+    {
+        out << "suite,name,items,iterations,median_ns,min_ns\n";
+        for (const auto &result : results_)
+        {
+            out << result.suite << "," << result.name << "," << result.items
+                << "," << result.iterations << "," << result.median << ","
+                << result.minimum << "\n";
+        }
+    }
+
+    return out.good();
+}
+
+bool RunMicroBenchmarks(const std::string &suite, const std::string &output)
+{
+    MicroBenchmark benchmark;
+    bool found{false};
+
+    for (const auto &entry : Detail::suites)
+    {
+        if (suite == "all" || suite == entry.name)
+        {
+            benchmark.setSuite(entry.name);
+            entry.run(benchmark);
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        std::cerr << "[Error] Unknown microbenchmark suite " << suite
+                  << std::endl;
+        return false;
+    }
+
+    if (!benchmark.writeReport(output))
+    {
+        std::cerr << "[Error] Failed to write benchmark report " << output
+                  << std::endl;
+    }
+
+    return benchmark.failures() == 0;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,177 @@
+#ifndef HOMEWORK01_BENCHMARK_MICROBENCHMARK_HPP_
+#define HOMEWORK01_BENCHMARK_MICROBENCHMARK_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+/**
+ * @brief Timing of one microbenchmark case.
+ */
+struct MicroResult
+{
+    std::string suite;
+    std::string name;
+    std::size_t items;      // work items per iteration, e.g. joints
+    std::size_t iterations; // iterations per sample
+    double median;          // nanoseconds per iteration
+    double minimum;         // nanoseconds per iteration
+};
+
+/**
+ * @brief Keep \a value alive so the computation producing it is not optimized
+ * away.
+ */
+template <typename T> inline void DoNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Deterministic linear congruential generator for benchmark data, the
+ * same seed gives the same data on every platform.
+ */
+class Random
+{
+public:
+    explicit Random(std::uint32_t seed) noexcept : state_{seed} {}
+
+    std::uint32_t next() noexcept
+    {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_ >> 8;
+    }
+
+    float uniform(float min, float max) noexcept
+    {
+        return min + (max - min) * static_cast<float>(next() & 0xFFFF) /
+                         65535.0f;
+    }
+
+private:
+    std::uint32_t state_;
+};
+
+/**
+ * @brief Minimal CPU microbenchmark harness, no OpenGL context is needed.
+ *
+ * @details Every case is calibrated until a sample lasts at least
+ * MinimumSampleMilliseconds, then Samples samples are timed and the median
+ * and minimum time per iteration are reported.
+ */
+class MicroBenchmark
+{
+public:
+    static constexpr int Samples = 15;
+    static constexpr double MinimumSampleMilliseconds = 5.0;
+
+    /**
+     * @brief Set the suite name recorded with the following cases.
+     */
+    void setSuite(const std::string &suite);
+
+    /**
+     * @brief Time \a body, which processes \a items work items per call.
+     */
+    template <typename Function>
+    const MicroResult &run(const std::string &name, std::size_t items,
+                           Function &&body);
+
+    /**
+     * @brief Record a correctness check, \a error must not exceed
+     * \a tolerance.
+     *
+     * @return \c true if the check passed.
+     */
+    bool check(const std::string &name, double error, double tolerance);
+
+    const std::vector<MicroResult> &results() const noexcept;
+    /**
+     * @brief Gets the number of failed checks.
+     */
+    int failures() const noexcept;
+
+    /**
+     * @brief Write the results to \a path, as JSON if the extension is
+     * \c .json and as CSV otherwise.
+     */
+    bool writeReport(const std::string &path) const;
+
+private:
+    const MicroResult &addResult(const std::string &name, std::size_t items,
+                                 std::size_t iterations,
+                                 std::vector<double> &samples);
+
+    std::string suite_;
+    std::vector<MicroResult> results_;
+    int failures_ = 0;
+};
+
+template <typename Function>
+const MicroResult &MicroBenchmark::run(const std::string &name,
+                                       std::size_t items, Function &&body)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto measure = [&body](std::size_t iterations) {
+        const Clock::time_point begin{Clock::now()};
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin)
+            .count();
+    };
+
+    std::size_t iterations{1};
+    while (measure(iterations) < MinimumSampleMilliseconds * 1.0e6 &&
+           iterations < (std::size_t{1} << 30))
+    {
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(Samples);
+    for (int sample = 0; sample < Samples; ++sample)
+    {
+        samples.push_back(measure(iterations) /
+                          static_cast<double>(iterations));
+    }
+
+    return addResult(name, items, iterations, samples);
+}
+
+/**
+ * @brief Run the suite named \a suite, or every suite for \c all, and write
+ * the report to \a output.
+ *
+ * @return \c false if there is no such suite or a check failed.
+ */
+bool RunMicroBenchmarks(const std::string &suite, const std::string &output);
+
+// Suites, one translation unit each
+void RunBvhSuite(MicroBenchmark &benchmark);
+void RunClipSuite(MicroBenchmark &benchmark);
+void RunCullingSuite(MicroBenchmark &benchmark);
+void RunEcsSuite(MicroBenchmark &benchmark);
+void RunGraphSuite(MicroBenchmark &benchmark);
+void RunJobSuite(MicroBenchmark &benchmark);
+void RunLodSuite(MicroBenchmark &benchmark);
+void RunPickingSuite(MicroBenchmark &benchmark);
+void RunSkeletonSuite(MicroBenchmark &benchmark);
+void RunTransformSuite(MicroBenchmark &benchmark);
+
+} // namespace Benchmark
+
+#endif // HOMEWORK01_BENCHMARK_MICROBENCHMARK_HPP_
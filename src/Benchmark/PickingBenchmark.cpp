@@ -0,0 +1,321 @@
+#include "MicroBenchmark.hpp"
+
+#include "Utils/Math/DynamicBvh.hpp"
+#include "Utils/Math/TriangleSet.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/gtc/constants.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// Rays per timed call of the scene picks
+constexpr std::size_t pickRays{64};
+// Parts of an avatar of the scene, about those of either rig
+constexpr std::size_t pickParts{20};
+
+/**
+ * @brief Avatars of sphere parts on the crowd's spawn grid, every part a
+ * sphere around its centre, the same mesh scaled.
+ */
+struct PickScene
+{
+    Math::TriangleSet mesh; // unit sphere
+    std::vector<glm::vec4> parts; // per avatar and part, centre and radius
+    Math::DynamicBvh avatars;
+    std::vector<glm::vec3> rayOrigins;
+    std::vector<glm::vec3> rayDirections;
+};
+
+// Unit sphere of \a rings by \a segments quads, two triangles each
+void buildSphere(int rings, int segments, Math::TriangleSet &mesh);
+Math::TriangleSet makeRandomTriangles(std::size_t count, std::uint32_t seed);
+PickScene makePickScene(std::size_t avatars, std::uint32_t seed);
+// Distance to the part's mesh like Animal::raycastMesh, the ray in the
+// sphere's own space
+float raycastPart(const PickScene &scene, const glm::vec4 &part,
+                  const glm::vec3 &origin, const glm::vec3 &direction,
+                  float maxDistance);
+float pickTree(const PickScene &scene, const glm::vec3 &origin,
+               const glm::vec3 &direction);
+float pickLinear(const PickScene &scene, const glm::vec3 &origin,
+                 const glm::vec3 &direction);
+
+void buildSphere(int rings, int segments, Math::TriangleSet &mesh)
+{
+    std::vector<float> positions;
+    for (int ring = 0; ring <= rings; ++ring)
+    {
+        const float polar{glm::pi<float>() * static_cast<float>(ring) /
+                          static_cast<float>(rings)};
+        for (int segment = 0; segment <= segments; ++segment)
+        {
+            const float azimuth{glm::two_pi<float>() *
+                                static_cast<float>(segment) /
+                                static_cast<float>(segments)};
+            positions.push_back(std::sin(polar) * std::cos(azimuth));
+            positions.push_back(std::cos(polar));
+            positions.push_back(std::sin(polar) * std::sin(azimuth));
+        }
+    }
+
+    std::vector<unsigned int> indices;
+    const unsigned int row{static_cast<unsigned int>(segments + 1)};
+    for (unsigned int ring = 0; ring < static_cast<unsigned int>(rings); ++ring)
+    {
+        for (unsigned int segment = 0;
+             segment < static_cast<unsigned int>(segments); ++segment)
+        {
+            const unsigned int corner{ring * row + segment};
+            indices.insert(indices.end(), {corner, corner + row, corner + 1,
+                                           corner + 1, corner + row,
+                                           corner + row + 1});
+        }
+    }
+
+    mesh.build(positions.data(), indices.data(), indices.size());
+}
+
+// Small triangles scattered in a unit cube, so the rays hit a few of them
+Math::TriangleSet makeRandomTriangles(std::size_t count, std::uint32_t seed)
+{
+    Random random{seed};
+
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    for (std::size_t triangle = 0; triangle < count; ++triangle)
+    {
+        const glm::vec3 corner{random.uniform(-1.0f, 1.0f),
+                               random.uniform(-1.0f, 1.0f),
+                               random.uniform(-1.0f, 1.0f)};
+        for (int vertex = 0; vertex < 3; ++vertex)
+        {
+            indices.push_back(static_cast<unsigned int>(positions.size() / 3));
+            positions.push_back(corner.x + random.uniform(-0.2f, 0.2f));
+            positions.push_back(corner.y + random.uniform(-0.2f, 0.2f));
+            positions.push_back(corner.z + random.uniform(-0.2f, 0.2f));
+        }
+    }
+
+    Math::TriangleSet triangles;
+    triangles.build(positions.data(), indices.data(), indices.size());
+
+    return triangles;
+}
+
+PickScene makePickScene(std::size_t avatars, std::uint32_t seed)
+{
+    Random random{seed};
+
+    PickScene scene;
+    buildSphere(8, 12, scene.mesh);
+
+    // The crowd's grid and rig radius, parts stacked up around the root
+    const float spacing{6.0f};
+    const float rigRadius{2.5f};
+    const int side{static_cast<int>(
+        std::ceil(std::sqrt(static_cast<float>(avatars))))};
+    const float extent{0.5f * spacing * static_cast<float>(side - 1)};
+    for (std::size_t avatar = 0; avatar < avatars; ++avatar)
+    {
+        const glm::vec3 root{
+            spacing * static_cast<float>(avatar % side) - extent, 0.0f,
+            spacing * static_cast<float>(avatar / side) - extent};
+        for (std::size_t part = 0; part < pickParts; ++part)
+        {
+            scene.parts.push_back(glm::vec4{
+                root + glm::vec3{random.uniform(-1.0f, 1.0f),
+                                 random.uniform(0.5f, 3.0f),
+                                 random.uniform(-1.0f, 1.0f)},
+                random.uniform(0.1f, 0.6f)});
+        }
+        scene.avatars.insert(
+            root + glm::vec3{-rigRadius, -rigRadius, -rigRadius},
+            root + glm::vec3{rigRadius, rigRadius + 2.0f, rigRadius},
+            static_cast<std::uint32_t>(avatar));
+    }
+
+    // Segments from the benchmark camera through the far side of the herd,
+    // as the window unprojects the cursor
+    const glm::vec3 eye{0.0f, 0.3f * extent, 1.2f * extent};
+    for (std::size_t i = 0; i < pickRays; ++i)
+    {
+        const glm::vec3 target{random.uniform(-extent, extent),
+                               random.uniform(0.0f, 3.0f),
+                               random.uniform(-extent, extent)};
+        scene.rayOrigins.push_back(eye);
+        scene.rayDirections.push_back(3.0f * (target - eye));
+    }
+
+    return scene;
+}
+
+float raycastPart(const PickScene &scene, const glm::vec4 &part,
+                  const glm::vec3 &origin, const glm::vec3 &direction,
+                  float maxDistance)
+{
+    const glm::vec3 localOrigin{(origin - glm::vec3{part}) / part.w};
+    const glm::vec3 localDirection{direction / part.w};
+
+    if (Math::DynamicBvh::RayDistance(localOrigin, 1.0f / localDirection,
+                                      glm::vec3{-1.0f}, glm::vec3{1.0f},
+                                      maxDistance) < 0.0f)
+    {
+        return -1.0f;
+    }
+
+    return scene.mesh.raycast(localOrigin, localDirection, maxDistance);
+}
+
+float pickTree(const PickScene &scene, const glm::vec3 &origin,
+               const glm::vec3 &direction)
+{
+    float nearest{1.0f};
+    bool hit{false};
+    scene.avatars.raycast(origin, direction, nearest, [&](int proxy, float) {
+        const std::size_t first{scene.avatars.userData(proxy) * pickParts};
+        for (std::size_t part = first; part < first + pickParts; ++part)
+        {
+            const float distance{raycastPart(scene, scene.parts[part], origin,
+                                             direction, nearest)};
+            if (distance >= 0.0f)
+            {
+                nearest = distance;
+                hit = true;
+            }
+        }
+
+        return nearest;
+    });
+
+    return hit ? nearest : -1.0f;
+}
+
+float pickLinear(const PickScene &scene, const glm::vec3 &origin,
+                 const glm::vec3 &direction)
+{
+    float nearest{1.0f};
+    bool hit{false};
+    for (const glm::vec4 &part : scene.parts)
+    {
+        const float distance{
+            raycastPart(scene, part, origin, direction, nearest)};
+        if (distance >= 0.0f)
+        {
+            nearest = distance;
+            hit = true;
+        }
+    }
+
+    return hit ? nearest : -1.0f;
+}
+
+} // namespace Detail
+
+void RunPickingSuite(MicroBenchmark &benchmark)
+{
+    const std::string path{Math::TriangleSetPath()};
+
+    for (std::size_t count : {64, 1024, 16384})
+    {
+        const Math::TriangleSet triangles{
+            Detail::makeRandomTriangles(count, 23u)};
+        Random random{29u};
+        std::vector<glm::vec3> origins;
+        std::vector<glm::vec3> directions;
+        for (std::size_t i = 0; i < Detail::pickRays; ++i)
+        {
+            origins.push_back(glm::vec3{random.uniform(-1.5f, 1.5f),
+                                        random.uniform(-1.5f, 1.5f), 3.0f});
+            directions.push_back(glm::vec3{random.uniform(-0.5f, 0.5f),
+                                           random.uniform(-0.5f, 0.5f),
+                                           -1.0f});
+        }
+
+        const std::string suffix{"/" + std::to_string(count)};
+
+        // Both kernels round alike, they agree exactly on every ray
+        std::size_t mismatches{0};
+        for (std::size_t i = 0; i < Detail::pickRays; ++i)
+        {
+            mismatches += triangles.raycast(origins[i], directions[i], 1.0e6f) !=
+                                  triangles.raycastScalar(origins[i],
+                                                          directions[i], 1.0e6f)
+                              ? 1
+                              : 0;
+        }
+        benchmark.check(path + "-vs-scalar" + suffix,
+                        static_cast<double>(mismatches), 0.0);
+
+        benchmark.run("scalar" + suffix, count * Detail::pickRays, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::pickRays; ++i)
+            {
+                distance += triangles.raycastScalar(origins[i], directions[i],
+                                                    1.0e6f);
+            }
+            DoNotOptimize(distance);
+        });
+        benchmark.run(path + suffix, count * Detail::pickRays, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::pickRays; ++i)
+            {
+                distance +=
+                    triangles.raycast(origins[i], directions[i], 1.0e6f);
+            }
+            DoNotOptimize(distance);
+        });
+    }
+
+    // Clicks into a crowd: the avatar tree finds the candidates, their parts'
+    // boxes and triangles the joint
+    for (std::size_t avatars : {500, 2000})
+    {
+        const Detail::PickScene scene{Detail::makePickScene(avatars, 31u)};
+        const std::string suffix{"/" + std::to_string(avatars)};
+
+        double error{0.0};
+        for (std::size_t i = 0; i < Detail::pickRays; ++i)
+        {
+            error = std::max(
+                error, static_cast<double>(std::abs(
+                           Detail::pickTree(scene, scene.rayOrigins[i],
+                                            scene.rayDirections[i]) -
+                           Detail::pickLinear(scene, scene.rayOrigins[i],
+                                              scene.rayDirections[i]))));
+        }
+        benchmark.check("pick-tree-vs-linear" + suffix, error, 0.0);
+
+        benchmark.run("pick-linear" + suffix, Detail::pickRays, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::pickRays; ++i)
+            {
+                distance += Detail::pickLinear(scene, scene.rayOrigins[i],
+                                               scene.rayDirections[i]);
+            }
+            DoNotOptimize(distance);
+        });
+        benchmark.run("pick-tree" + suffix, Detail::pickRays, [&] {
+            float distance{0.0f};
+            for (std::size_t i = 0; i < Detail::pickRays; ++i)
+            {
+                distance += Detail::pickTree(scene, scene.rayOrigins[i],
+                                             scene.rayDirections[i]);
+            }
+            DoNotOptimize(distance);
+        });
+    }
+}
+
+} // namespace Benchmark
@@ -0,0 +1,170 @@
+#include "MicroBenchmark.hpp"
+
+#include "Avatar/Animal.hpp"
+#include "Avatar/Skeleton.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+/**
+ * @brief Random joint hierarchy shared by the tree and the flat form, joints
+ * are in depth first order.
+ */
+struct Topology
+{
+    std::vector<int> parents;
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> sizes;
+};
+
+Topology makeTopology(int joints, std::uint32_t seed);
+std::shared_ptr<Joint> makeTree(const Topology &topology);
+void makeSkeleton(const Topology &topology, Skeleton &skeleton);
+
+Topology makeTopology(int joints, std::uint32_t seed)
+{
+    Random random{seed};
+
+    // Random recursive tree, expected depth grows with log(joints)
+    std::vector<std::vector<int>> children(static_cast<std::size_t>(joints));
+    for (int joint = 1; joint < joints; ++joint)
+    {
+        children[random.next() % static_cast<std::uint32_t>(joint)].push_back(
+            joint);
+    }
+
+    Topology topology;
+    std::vector<std::pair<int, int>> stack{{0, Skeleton::NoParent}};
+    while (!stack.empty())
+    {
+        const std::pair<int, int> entry{stack.back()};
+        stack.pop_back();
+
+        const int index{static_cast<int>(topology.parents.size())};
+        topology.parents.push_back(entry.second);
+        topology.offsets.push_back(glm::vec3{random.uniform(-1.0f, 1.0f),
+                                             random.uniform(-1.0f, 1.0f),
+                                             random.uniform(-1.0f, 1.0f)});
+        topology.rotations.push_back(glm::vec3{
+            random.uniform(-90.0f, 90.0f), random.uniform(-90.0f, 90.0f),
+            random.uniform(-90.0f, 90.0f)});
+        topology.sizes.push_back(glm::vec3{random.uniform(0.1f, 1.0f)});
+
+        const auto &jointChildren = children[entry.first];
+        for (auto child = jointChildren.rbegin();
+             child != jointChildren.rend(); ++child)
+        {
+            stack.emplace_back(*child, index);
+        }
+    }
+
+    return topology;
+}
+
+std::shared_ptr<Joint> makeTree(const Topology &topology)
+{
+    std::vector<std::shared_ptr<Joint>> joints;
+    joints.reserve(topology.parents.size());
+
+    for (std::size_t i = 0; i < topology.parents.size(); ++i)
+    {
+        joints.push_back(std::make_shared<Joint>(
+            "joint" + std::to_string(i), topology.offsets[i], nullptr));
+        joints.back()->setRotation(topology.rotations[i]);
+        joints.back()->setSize(topology.sizes[i]);
+
+        if (topology.parents[i] != Skeleton::NoParent)
+        {
+            joints[topology.parents[i]]->addChild(joints.back());
+        }
+    }
+
+    return joints.front();
+}
+
+void makeSkeleton(const Topology &topology, Skeleton &skeleton)
+{
+    for (std::size_t i = 0; i < topology.parents.size(); ++i)
+    {
+        skeleton.addJoint("joint" + std::to_string(i), topology.parents[i],
+                          topology.offsets[i], topology.sizes[i], nullptr,
+                          topology.rotations[i]);
+    }
+}
+
+} // namespace Detail
+
+void RunSkeletonSuite(MicroBenchmark &benchmark)
+{
+    for (int joints : {30, 300, 30000})
+    {
+        const Detail::Topology topology{Detail::makeTopology(joints, 7u)};
+        const std::shared_ptr<Joint> tree{Detail::makeTree(topology)};
+
+        Skeleton skeleton;
+        Detail::makeSkeleton(topology, skeleton);
+
+        glm::mat4 view{1.0f};
+        glm::mat4 projection{1.0f};
+        const std::size_t items{static_cast<std::size_t>(joints)};
+        const std::string suffix{"/" + std::to_string(joints)};
+
+        // Joints without a mesh only resolve their transforms
+        benchmark.run("tree" + suffix, items, [&] {
+            tree->draw(glm::mat4{1.0f}, view, projection);
+        });
+        benchmark.run("flat" + suffix, items, [&] {
+            skeleton.invalidate();
+            skeleton.updateWorldTransforms();
+            DoNotOptimize(skeleton.worldTransform(joints - 1));
+        });
+
+        // Dirty tracking, nothing edited and one joint edited per update
+        benchmark.run("flat-static" + suffix, items, [&] {
+            skeleton.updateWorldTransforms();
+            DoNotOptimize(skeleton.worldTransform(joints - 1));
+        });
+
+        // Only the edited joint is newer than the revision seen before it
+        const std::uint64_t seen{skeleton.revision()};
+        skeleton.updateWorldTransforms();
+        benchmark.check("revision-static" + suffix,
+                        static_cast<double>(skeleton.revision() - seen), 0.0);
+        skeleton.setSize(joints - 1, glm::vec3{2.0f});
+        skeleton.updateWorldTransforms();
+        int newer{0};
+        for (int joint = 0; joint < joints; ++joint)
+        {
+            newer += skeleton.modelRevision(joint) > seen ? 1 : 0;
+        }
+        benchmark.check("revision-edit-one" + suffix, std::abs(newer - 1.0),
+                        0.0);
+
+        Random random{11u};
+        float angle{0.0f};
+        benchmark.run("flat-edit-one" + suffix, items, [&] {
+            const int joint{
+                static_cast<int>(random.next() % static_cast<std::uint32_t>(
+                                                     joints))};
+            angle += 1.0f;
+            skeleton.setRotation(joint, glm::vec3{angle, 0.0f, 0.0f});
+            skeleton.updateWorldTransforms();
+            DoNotOptimize(skeleton.worldTransform(joints - 1));
+        });
+    }
+}
+
+} // namespace Benchmark
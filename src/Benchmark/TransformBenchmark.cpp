@@ -0,0 +1,204 @@
+#include "MicroBenchmark.hpp"
+
+#include "Utils/Math/EulerTransform.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+
+namespace Detail
+{
+
+// Largest absolute difference of any matrix element from the glm path
+constexpr double transformTolerance{1.0e-5};
+
+struct TransformInputs
+{
+    std::vector<glm::vec3> offsets;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+};
+
+TransformInputs makeTransformInputs(std::size_t count, std::uint32_t seed);
+glm::mat4 referenceTransform(const glm::vec3 &offset,
+                             const glm::vec3 &rotation,
+                             const glm::vec3 &scale);
+double maximumError(const std::vector<glm::mat4> &transforms,
+                    const std::vector<glm::mat4> &references);
+
+TransformInputs makeTransformInputs(std::size_t count, std::uint32_t seed)
+{
+    Random random{seed};
+
+    // Quadrant boundaries and angles Joint skips
+    const float special[]{0.0f,   0.00005f, -0.00005f, 45.0f, 90.0f,
+                          -90.0f, 135.0f,   180.0f,    -180.0f, 270.0f,
+                          360.0f, -360.0f};
+    constexpr std::size_t specialCount{sizeof(special) / sizeof(special[0])};
+
+    TransformInputs inputs;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        inputs.offsets.push_back(glm::vec3{random.uniform(-10.0f, 10.0f),
+                                           random.uniform(-10.0f, 10.0f),
+                                           random.uniform(-10.0f, 10.0f)});
+        if (i < specialCount * 3)
+        {
+            glm::vec3 rotation{random.uniform(-180.0f, 180.0f)};
+            rotation[static_cast<int>(i % 3)] = special[i / 3];
+            inputs.rotations.push_back(rotation);
+        }
+        else
+        {
+            inputs.rotations.push_back(glm::vec3{
+                random.uniform(-360.0f, 360.0f),
+                random.uniform(-360.0f, 360.0f),
+                random.uniform(-360.0f, 360.0f)});
+        }
+        inputs.scales.push_back(glm::vec3{random.uniform(0.1f, 3.0f),
+                                          random.uniform(0.1f, 3.0f),
+                                          random.uniform(0.1f, 3.0f)});
+    }
+
+    return inputs;
+}
+
+glm::mat4 referenceTransform(const glm::vec3 &offset,
+                             const glm::vec3 &rotation,
+                             const glm::vec3 &scale)
+{
+    // What Joint::getLocalTransform and Joint::draw do
+    glm::mat4 transform{glm::translate(glm::mat4{1.0f}, offset)};
+
+    if (std::abs(rotation.x) > 0.0001f)
+    {
+        transform = glm::rotate(transform, glm::radians(rotation.x),
+                                glm::vec3{1.0f, 0.0f, 0.0f});
+    }
+    if (std::abs(rotation.y) > 0.0001f)
+    {
+        transform = glm::rotate(transform, glm::radians(rotation.y),
+                                glm::vec3{0.0f, 1.0f, 0.0f});
+    }
+    if (std::abs(rotation.z) > 0.0001f)
+    {
+        transform = glm::rotate(transform, glm::radians(rotation.z),
+                                glm::vec3{0.0f, 0.0f, 1.0f});
+    }
+
+    return glm::scale(transform, scale);
+}
+
+double maximumError(const std::vector<glm::mat4> &transforms,
+                    const std::vector<glm::mat4> &references)
+{
+    double error{0.0};
+
+    for (std::size_t i = 0; i < transforms.size(); ++i)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                error = std::max(
+                    error, static_cast<double>(std::abs(
+                               transforms[i][column][row] -
+                               references[i][column][row])));
+            }
+        }
+    }
+
+    return error;
+}
+
+} // namespace Detail
+
+void RunTransformSuite(MicroBenchmark &benchmark)
+{
+    const std::string path{Math::EulerTransformPath()};
+
+    // Correctness first, an odd count also runs the scalar remainder
+    {
+        const std::size_t count{100003};
+        const Detail::TransformInputs inputs{
+            Detail::makeTransformInputs(count, 5u)};
+
+        std::vector<glm::mat4> references(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            references[i] = Detail::referenceTransform(
+                inputs.offsets[i], inputs.rotations[i], inputs.scales[i]);
+        }
+
+        std::vector<glm::mat4> transforms(count);
+        Math::ComposeEulerTransformsScalar(
+            inputs.offsets.data(), inputs.rotations.data(),
+            inputs.scales.data(), count, transforms.data());
+        benchmark.check("scalar-vs-glm",
+                        Detail::maximumError(transforms, references),
+                        Detail::transformTolerance);
+
+        Math::ComposeEulerTransforms(inputs.offsets.data(),
+                                     inputs.rotations.data(),
+                                     inputs.scales.data(), count,
+                                     transforms.data());
+        benchmark.check(path + "-vs-glm",
+                        Detail::maximumError(transforms, references),
+                        Detail::transformTolerance);
+
+        // Unit scales, the form Skeleton uses
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            references[i] = Detail::referenceTransform(
+                inputs.offsets[i], inputs.rotations[i], glm::vec3{1.0f});
+        }
+        Math::ComposeEulerTransforms(inputs.offsets.data(),
+                                     inputs.rotations.data(), nullptr, count,
+                                     transforms.data());
+        benchmark.check(path + "-unscaled-vs-glm",
+                        Detail::maximumError(transforms, references),
+                        Detail::transformTolerance);
+    }
+
+    for (std::size_t count : {16, 1024, 65536})
+    {
+        const Detail::TransformInputs inputs{
+            Detail::makeTransformInputs(count, 9u)};
+        std::vector<glm::mat4> transforms(count);
+
+        const std::string suffix{"/" + std::to_string(count)};
+
+        benchmark.run("glm" + suffix, count, [&] {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                transforms[i] = Detail::referenceTransform(
+                    inputs.offsets[i], inputs.rotations[i], inputs.scales[i]);
+            }
+            DoNotOptimize(transforms.back());
+        });
+        benchmark.run("scalar" + suffix, count, [&] {
+            Math::ComposeEulerTransformsScalar(
+                inputs.offsets.data(), inputs.rotations.data(),
+                inputs.scales.data(), count, transforms.data());
+            DoNotOptimize(transforms.back());
+        });
+        benchmark.run(path + suffix, count, [&] {
+            Math::ComposeEulerTransforms(inputs.offsets.data(),
+                                         inputs.rotations.data(),
+                                         inputs.scales.data(), count,
+                                         transforms.data());
+            DoNotOptimize(transforms.back());
+        });
+    }
+}
+
+} // namespace Benchmark
@@ -0,0 +1,272 @@
+#include "FrameCapture.hpp"
+
+#include "Utils/FileIO/FileOut.hpp"
+#include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace Capture
+{
+
+namespace Detail
+{
+
+constexpr int channels{4};
+// Upper bound of a blocking wait in FrameCapture::finish
+constexpr GLuint64 finishTimeout{1000000000};
+
+} // namespace Detail
+
+FrameCapture::Slot::Slot()
+    : buffer{OpenGL::OpenGLBufferObject::PixelPackBuffer,
+             OpenGL::OpenGLBufferObject::StreamRead},
+      capacity{0}, fence{nullptr}, frame{0}, width{0}, height{0}
+{
+}
+
+FrameCapture::FrameCapture(const std::string &prefix, Format format,
+                           unsigned int workers)
+    : prefix_{prefix}, format_{format}, slots_{}, next_{0}, busyWorkers_{0},
+      stopping_{false}, captured_{0}, dropped_{0}, written_{0}
+{
+    for (unsigned int i = 0; i < (workers > 0 ? workers : 1); ++i)
+    {
+        workers_.emplace_back(&FrameCapture::workerMain, this);
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    jobReady_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+
+    std::cout << "[Capture] Wrote " << writtenCount() << " of "
+              << capturedCount() << " frames, dropped " << droppedCount()
+              << std::endl;
+}
+
+bool FrameCapture::capture(int frame, int width, int height)
+{
+    PROGRAM_TRACE_SCOPE("capture", "FrameCapture::capture");
+
+    Slot &slot{slots_[next_]};
+
+    if (slot.fence && !retire(slot, 0))
+    {
+        // Every buffer is still in flight, waiting here is the stall we avoid
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const GLsizeiptr size{static_cast<GLsizeiptr>(width) * height *
+                          Detail::channels};
+
+    slot.buffer.bind();
+    if (slot.capacity < size)
+    {
+        slot.buffer.allocateBufferData(nullptr, size);
+        slot.capacity = size;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    slot.buffer.release();
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = frame;
+    slot.width = width;
+    slot.height = height;
+
+    next_ = (next_ + 1) % slots_.size();
+    ++captured_;
+
+    return true;
+}
+
+void FrameCapture::poll()
+{
+    PROGRAM_TRACE_SCOPE("capture", "FrameCapture::poll");
+
+    for (auto &slot : slots_)
+    {
+        if (slot.fence)
+        {
+            retire(slot, 0);
+        }
+    }
+}
+
+void FrameCapture::finish()
+{
+    for (auto &slot : slots_)
+    {
+        while (slot.fence && !retire(slot, Detail::finishTimeout))
+        {
+        }
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    jobDone_.wait(lock, [this] { return jobs_.empty() && busyWorkers_ == 0; });
+}
+
+std::size_t FrameCapture::capturedCount() const noexcept { return captured_; }
+
+std::size_t FrameCapture::droppedCount() const noexcept
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+std::size_t FrameCapture::writtenCount() const noexcept
+{
+    return written_.load(std::memory_order_relaxed);
+}
+
+bool FrameCapture::retire(Slot &slot, GLuint64 timeout)
+{
+    PROGRAM_ASSERT(slot.fence);
+
+    const GLenum status{
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout)};
+
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+
+    PROGRAM_TRACE_SCOPE("capture", "FrameCapture::retire");
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    if (status == GL_WAIT_FAILED)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Job job;
+    job.frame = slot.frame;
+    job.width = slot.width;
+    job.height = slot.height;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        if (jobs_.size() >= MaxQueuedFrames)
+        {
+            // The disk can't keep up, keep the render thread going
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (!freePixels_.empty())
+        {
+            job.pixels = std::move(freePixels_.back());
+            freePixels_.pop_back();
+        }
+    }
+
+    const std::size_t size{static_cast<std::size_t>(slot.width) *
+                           slot.height * Detail::channels};
+    job.pixels.resize(size);
+
+    slot.buffer.bind();
+    const void *mapped{slot.buffer.mapRange(
+        0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT)};
+    const bool copied{mapped != nullptr};
+    if (copied)
+    {
+        std::memcpy(job.pixels.data(), mapped, size);
+    }
+    const bool intact{slot.buffer.unmap()};
+    slot.buffer.release();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        if (!copied || !intact)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            freePixels_.push_back(std::move(job.pixels));
+            return true;
+        }
+
+        jobs_.push_back(std::move(job));
+    }
+    jobReady_.notify_one();
+
+    return true;
+}
+
+void FrameCapture::workerMain()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    for (;;)
+    {
+        jobReady_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+
+        if (jobs_.empty())
+        {
+            return;
+        }
+
+        Job job{std::move(jobs_.front())};
+        jobs_.pop_front();
+        ++busyWorkers_;
+        lock.unlock();
+
+        bool succeeded{false};
+        const std::string path{fileName(job.frame)};
+        {
+            PROGRAM_TRACE_SCOPE("capture", "FrameCapture::write");
+
+            succeeded =
+                format_ == Png
+                    ? FileIO::WriteImagePng(path.c_str(), job.width,
+                                            job.height, Detail::channels,
+                                            job.pixels.data(), true)
+                    : FileIO::WriteImageRaw(path.c_str(), job.width,
+                                            job.height, Detail::channels,
+                                            job.pixels.data(), true);
+        }
+
+        if (succeeded)
+        {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            std::cerr << "[Error] Failed to write capture " << path
+                      << std::endl;
+        }
+
+        lock.lock();
+        freePixels_.push_back(std::move(job.pixels));
+        --busyWorkers_;
+        jobDone_.notify_all();
+    }
+}
+
+std::string FrameCapture::fileName(int frame) const
+{
+    char number[16];
+    std::snprintf(number, sizeof(number), "%06d", frame);
+
+    return prefix_ + number + (format_ == Png ? ".png" : ".raw");
+}
+
+} // namespace Capture
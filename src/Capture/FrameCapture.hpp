@@ -0,0 +1,147 @@
+#ifndef HOMEWORK01_CAPTURE_FRAMECAPTURE_HPP_
+#define HOMEWORK01_CAPTURE_FRAMECAPTURE_HPP_
+
+#include "OpenGL/OpenGLBufferObject.hpp"
+
+#include "glad/glad.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Capture
+{
+
+/**
+ * \brief Reads frames back without stalling the render thread and writes them
+ * to disk on worker threads.
+ *
+ * \details FrameCapture::capture issues glReadPixels into one of RingSize
+ * pixel pack buffers and fences it. FrameCapture::poll maps the buffers whose
+ * fence has signaled, usually a frame or two later, and hands a copy of the
+ * pixels to the workers which flip, encode and write them. When every buffer
+ * is still in flight, or the workers fall MaxQueuedFrames behind, the frame is
+ * dropped instead of waiting.
+ *
+ * \par Warning:
+ * Except for the worker threads this class is not thread safe, use it under
+ * the thread which owns the OpenGL context and destroy it before the context.
+ */
+class FrameCapture
+{
+public:
+    /**
+     * \brief This enum represents the file format of captured frames.
+     */
+    enum Format
+    {
+        /**
+         * \brief Uncompressed RGBA PNG.
+         */
+        Png,
+        /**
+         * \brief Headless RGBA bytes, top row first.
+         */
+        Raw
+    };
+
+    static constexpr std::size_t RingSize = 3;
+    static constexpr std::size_t MaxQueuedFrames = 8;
+
+    /**
+     * \brief Initializes a new instance of the FrameCapture class, frames are
+     * written to \a prefix followed by the zero padded frame number.
+     *
+     * \exception OpenGLException Pixel pack buffer failed to instantiate.
+     */
+    explicit FrameCapture(const std::string &prefix, Format format,
+                          unsigned int workers = 2);
+    /**
+     * \brief Finish every pending frame and join the workers.
+     */
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture &other) = delete;
+    FrameCapture &operator=(const FrameCapture &other) = delete;
+
+    /**
+     * \brief Queue the read back of the \a width x \a height color buffer of
+     * the current read framebuffer as frame \a frame.
+     *
+     * \return \c false if the frame was dropped.
+     */
+    bool capture(int frame, int width, int height);
+    /**
+     * \brief Hand every read back that has completed to the workers, never
+     * waits for the GPU.
+     */
+    void poll();
+    /**
+     * \brief Wait until every queued frame is on disk.
+     */
+    void finish();
+
+    std::size_t capturedCount() const noexcept;
+    std::size_t droppedCount() const noexcept;
+    std::size_t writtenCount() const noexcept;
+
+private:
+    struct Slot
+    {
+        Slot();
+
+        OpenGL::OpenGLBufferObject buffer;
+        GLsizeiptr capacity;
+        GLsync fence;
+        int frame;
+        int width;
+        int height;
+    };
+
+    struct Job
+    {
+        std::vector<unsigned char> pixels;
+        int frame;
+        int width;
+        int height;
+    };
+
+    /**
+     * \brief Map \a slot and queue its pixels once its fence signaled within
+     * \a timeout nanoseconds.
+     *
+     * \return \c false if the read back is still in flight.
+     */
+    bool retire(Slot &slot, GLuint64 timeout);
+    void workerMain();
+    std::string fileName(int frame) const;
+
+    std::string prefix_;
+    Format format_;
+
+    std::array<Slot, RingSize> slots_;
+    std::size_t next_;
+
+    std::mutex mutex_;
+    std::condition_variable jobReady_;
+    std::condition_variable jobDone_;
+    std::deque<Job> jobs_;
+    std::vector<std::vector<unsigned char>> freePixels_;
+    std::size_t busyWorkers_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    std::size_t captured_;
+    std::atomic<std::size_t> dropped_;
+    std::atomic<std::size_t> written_;
+};
+
+} // namespace Capture
+
+#endif // HOMEWORK01_CAPTURE_FRAMECAPTURE_HPP_
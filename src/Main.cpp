@@ -1,5 +1,9 @@
 #include "OpenGLWindow.hpp"
 
+#include "Benchmark/MicroBenchmark.hpp"
+#include "Utils/CommandLine/CommandLine.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
 #include "glm/vec2.hpp"
 
 #include <iostream>
@@ -9,12 +13,39 @@
 
 int main(int argc, char *argv[])
 {
+    CommandLine::Options options;
+    std::string error;
+
+    if (!CommandLine::Parse(argc, argv, options, error))
+    {
+        std::cerr << "[Error]" << error << std::endl;
+        CommandLine::PrintUsage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (!options.microbenchmark.empty())
+    {
+        // CPU only, no window or context is created
+        exit(Benchmark::RunMicroBenchmarks(options.microbenchmark,
+                                           options.benchmarkOutput)
+                 ? EXIT_SUCCESS
+                 : EXIT_FAILURE);
+    }
+
+    if (!options.traceFile.empty())
+    {
+        // Start before the window so asset loading ends up in the trace
+        Profiler::TraceRecorder::instance().requestCapture(
+            options.traceFrames, options.traceFile);
+    }
+
     std::unique_ptr<OpenGLWindow> window{nullptr};
 
     try
     {
-        window.reset(new OpenGLWindow{glm::ivec2{800, 600}, "Homework01",
-                                      glm::ivec2{3, 3}});
+        window.reset(new OpenGLWindow{
+            glm::ivec2{options.width, options.height}, "Homework01",
+            glm::ivec2{3, 3}, options.headless});
     }
     catch (std::runtime_error &e)
     {
@@ -22,6 +53,32 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    window->setTraceFrames(options.traceFrames);
+    window->setLevelOfDetail(options.lodError);
+    window->setSimulation(options.tick, options.maxTicks);
+
+    if (options.crowd > 0)
+    {
+        window->setCrowd(options.crowd, options.occlusion);
+    }
+
+    if (options.benchmark)
+    {
+        window->setBenchmark(options.frames > 0 ? options.frames : 600,
+                             options.timestep, options.benchmarkOutput);
+    }
+    else
+    {
+        window->setFrameLimit(options.headless && options.frames == 0
+                                  ? 300
+                                  : options.frames);
+    }
+    if (!options.capturePrefix.empty())
+    {
+        window->setCapture(options.capturePrefix,
+                           options.captureRaw ? Capture::FrameCapture::Raw
+                                              : Capture::FrameCapture::Png);
+    }
     window->startRender();
 
     return 0;
@@ -0,0 +1,196 @@
+#include "Geometry.hpp"
+
+#include "OpenGL/OpenGLStatistics.hpp"
+#include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+namespace Model
+{
+
+Geometry::Geometry(const std::vector<float> &positions,
+                   const std::vector<float> &normals,
+                   const std::vector<float> &textureCoordinates,
+                   const std::vector<IndexType> &indices,
+                   ShaderProgramType &shaderProgram)
+    : vertexArrayObject_{nullptr},
+      vertexBufferObject_{{nullptr, nullptr, nullptr}},
+      elementBufferObject_{nullptr}, morphBufferObject_{{nullptr, nullptr}},
+      levels_{{0, static_cast<GLsizei>(indices.size()), 0.0f}},
+      vertexCount_{positions.size() / 3}
+{
+    create(positions, normals, textureCoordinates, indices, shaderProgram);
+}
+
+Geometry::Geometry(Geometry &&other) noexcept = default;
+
+Geometry &Geometry::operator=(Geometry &&other) noexcept = default;
+
+Geometry::~Geometry() { tidy(); }
+
+void Geometry::create(const std::vector<float> &positions,
+                      const std::vector<float> &normals,
+                      const std::vector<float> &textureCoordinates,
+                      const std::vector<IndexType> &indices,
+                      ShaderProgramType &shaderProgram)
+{
+    PROGRAM_TRACE_SCOPE("upload", "Geometry::create");
+
+    vertexArrayObject_.reset(new VertexArrayObjectType{});
+    for (auto &object : vertexBufferObject_)
+    {
+        object.reset(new BufferObjectType{
+            OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+            OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
+    }
+    elementBufferObject_.reset(new BufferObjectType{
+        OpenGL::OpenGLBufferObject::Type::ElementArrayBuffer,
+        OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
+
+    vertexArrayObject_->bind();
+
+    vertexBufferObject_[0]->bind();
+    vertexBufferObject_[0]->allocateBufferData(
+        positions.data(), sizeof(float) * positions.size());
+    vertexBufferObject_[1]->bind();
+    vertexBufferObject_[1]->allocateBufferData(
+        normals.data(), sizeof(float) * normals.size());
+    vertexBufferObject_[2]->bind();
+    vertexBufferObject_[2]->allocateBufferData(
+        textureCoordinates.data(), sizeof(float) * textureCoordinates.size());
+
+    elementBufferObject_->bind();
+    elementBufferObject_->allocateBufferData(
+        indices.data(), sizeof(IndexType) * indices.size());
+
+    bindVertexBuffers(shaderProgram);
+
+    vertexArrayObject_->release();
+}
+
+void Geometry::setMorphTarget(const std::vector<float> &positions,
+                              const std::vector<float> &normals,
+                              ShaderProgramType &shaderProgram)
+{
+    PROGRAM_TRACE_SCOPE("upload", "Geometry::setMorphTarget");
+
+    PROGRAM_ASSERT(positions.size() == vertexCount_ * 3 &&
+                   normals.size() == vertexCount_ * 3);
+
+    const std::vector<float> *streams[]{&positions, &normals};
+    for (std::size_t i = 0; i < morphBufferObject_.size(); ++i)
+    {
+        morphBufferObject_[i].reset(new BufferObjectType{
+            OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+            OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
+        morphBufferObject_[i]->bind();
+        morphBufferObject_[i]->allocateBufferData(
+            streams[i]->data(), sizeof(float) * streams[i]->size());
+    }
+
+    vertexArrayObject_->bind();
+    bindVertexBuffers(shaderProgram);
+    vertexArrayObject_->release();
+
+    // Any weight draws between the two shapes, both lie inside the merged
+    // bounds
+    if (!bounds_.empty())
+    {
+        bounds_ = Math::MergeBounds(
+            bounds_, Math::ComputeBounds(positions.data(), vertexCount_));
+    }
+}
+
+bool Geometry::hasMorphTarget() const noexcept
+{
+    return morphBufferObject_[0] != nullptr;
+}
+
+void Geometry::setBounds(const Math::Bounds &bounds) noexcept
+{
+    bounds_ = bounds;
+}
+
+const Math::Bounds &Geometry::bounds() const noexcept { return bounds_; }
+
+void Geometry::setLevels(const std::vector<LodLevel> &levels)
+{
+    if (levels.empty())
+    {
+        return;
+    }
+
+    levels_ = levels;
+}
+
+std::size_t Geometry::levelCount() const noexcept { return levels_.size(); }
+
+const LodLevel &Geometry::level(std::size_t level) const noexcept
+{
+    return levels_[level];
+}
+
+void Geometry::draw(std::size_t level)
+{
+    const LodLevel &range{levels_[level]};
+
+    vertexArrayObject_->bind();
+    glDrawElements(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+                   reinterpret_cast<const void *>(
+                       sizeof(IndexType) *
+                       static_cast<std::size_t>(range.firstIndex)));
+    OpenGL::OpenGLStatistics &statistics{OpenGL::OpenGLStatistics::current()};
+    ++statistics.drawCalls;
+    statistics.triangles += static_cast<std::uint32_t>(range.indexCount / 3);
+    vertexArrayObject_->release();
+}
+
+void Geometry::bindVertexBuffers(ShaderProgramType &shaderProgram)
+{
+    // Position, normal and texture coordinate, tightly packed
+    const GLint sizes[]{3, 3, 2};
+
+    for (GLuint index = 0; index < 3; ++index)
+    {
+        vertexBufferObject_[index]->bind();
+        shaderProgram.enableAttributeArray(index);
+        shaderProgram.mapAttributePointer(index, sizes[index], GL_FLOAT,
+                                          GL_FALSE, sizes[index] * sizeof(float),
+                                          0);
+    }
+
+    // The morph target, or the base shape again
+    const GLuint morphAttributes[]{MorphPositionAttribute, MorphNormalAttribute};
+    for (GLuint index = 0; index < 2; ++index)
+    {
+        (hasMorphTarget() ? morphBufferObject_[index] : vertexBufferObject_[index])
+            ->bind();
+        shaderProgram.enableAttributeArray(morphAttributes[index]);
+        shaderProgram.mapAttributePointer(morphAttributes[index], 3, GL_FLOAT,
+                                          GL_FALSE, 3 * sizeof(float), 0);
+    }
+
+    elementBufferObject_->bind();
+}
+
+GLsizei Geometry::indicesCount() const noexcept
+{
+    return levels_.front().indexCount;
+}
+
+std::size_t Geometry::vertexCount() const noexcept { return vertexCount_; }
+
+void Geometry::tidy() noexcept
+{
+    elementBufferObject_.reset();
+    for (auto &object : morphBufferObject_)
+    {
+        object.reset();
+    }
+    for (auto &object : vertexBufferObject_)
+    {
+        object.reset();
+    }
+    vertexArrayObject_.reset();
+}
+
+} // namespace Model
@@ -0,0 +1,143 @@
+#ifndef HOMEWORK01_MODEL_GEOMETRY_HPP_
+#define HOMEWORK01_MODEL_GEOMETRY_HPP_
+
+#include "OpenGL/OpenGLBufferObject.hpp"
+#include "OpenGL/OpenGLShaderProgram.hpp"
+#include "OpenGL/OpenGLVertexArrayObject.hpp"
+#include "Utils/Math/Bounds.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Model
+{
+
+/**
+ * @brief A level of detail of a Geometry, a range of its index buffer.
+ *
+ * @details The error bounds how far the level's surface lies from the full
+ * mesh, in mesh units, see Model::BuildLevelsOfDetail.
+ */
+struct LodLevel
+{
+    GLsizei firstIndex;
+    GLsizei indexCount;
+    float error;
+};
+
+/**
+ * @brief Vertex and index buffers of a triangle mesh uploaded to the GPU.
+ *
+ * @details Geometry holds no per-instance state, any number of Mesh can draw
+ * the same Geometry with their own transform and texture.
+ */
+class Geometry
+{
+public:
+    using IndexType = unsigned int;
+    using ShaderProgramType = OpenGL::OpenGLShaderProgram;
+
+    // Locations of the morph target stream, see Geometry::setMorphTarget
+    static constexpr GLuint MorphPositionAttribute = 6;
+    static constexpr GLuint MorphNormalAttribute = 7;
+
+    /**
+     * @brief Upload the vertex attributes and \a indices, attributes are
+     * bound to locations 0 (position), 1 (normal) and 2 (texture coordinate)
+     * of \a shaderProgram.
+     */
+    explicit Geometry(const std::vector<float> &positions,
+                      const std::vector<float> &normals,
+                      const std::vector<float> &textureCoordinates,
+                      const std::vector<IndexType> &indices,
+                      ShaderProgramType &shaderProgram);
+
+    Geometry(Geometry &&other) noexcept;
+    Geometry &operator=(Geometry &&other) noexcept;
+    ~Geometry();
+
+    Geometry(const Geometry &other) = delete;
+    Geometry &operator=(const Geometry &other) = delete;
+
+    /**
+     * @brief Upload a morph target, the positions and normals the shader
+     * blends towards by its morph weight. \a positions and \a normals hold
+     * one item per vertex, e.g. from Model::ResampleMorphTarget.
+     *
+     * @details Without a morph target the base position and normal are bound
+     * to the morph locations as well, so any weight draws the base shape.
+     * Vertex array objects made by bindVertexBuffers before the call, e.g. an
+     * InstanceBatch's, keep the old binding.
+     */
+    void setMorphTarget(const std::vector<float> &positions,
+                        const std::vector<float> &normals,
+                        ShaderProgramType &shaderProgram);
+    bool hasMorphTarget() const noexcept;
+
+    /**
+     * @brief Set the bounds of the vertices, computed when the mesh is
+     * imported, see ModuleAdder::loadMeshData. A morph target set later
+     * grows them to contain its shape as well.
+     */
+    void setBounds(const Math::Bounds &bounds) noexcept;
+    /**
+     * @brief Gets the bounds in mesh space, empty if none were set.
+     */
+    const Math::Bounds &bounds() const noexcept;
+
+    /**
+     * @brief Set the levels of detail, ranges of the indices the geometry
+     * was created with, the full mesh first and errors ascending. Without
+     * levels the whole index buffer is the only level.
+     */
+    void setLevels(const std::vector<LodLevel> &levels);
+    std::size_t levelCount() const noexcept;
+    const LodLevel &level(std::size_t level) const noexcept;
+
+    /**
+     * @brief Issue the draw call of \a level, the program must already be in
+     * use.
+     */
+    void draw(std::size_t level = 0);
+
+    /**
+     * @brief Attach the vertex and index buffers to the vertex array object
+     * which is currently bound, with the attribute locations of the
+     * constructor. Lets another vertex array object, e.g. of an
+     * InstanceBatch, draw this geometry.
+     */
+    void bindVertexBuffers(ShaderProgramType &shaderProgram);
+
+    /**
+     * @brief Gets the indices of the full mesh, the first level.
+     */
+    GLsizei indicesCount() const noexcept;
+    std::size_t vertexCount() const noexcept;
+
+private:
+    using VertexArrayObjectType = OpenGL::OpenGLVertexArrayObject;
+    using BufferObjectType = OpenGL::OpenGLBufferObject;
+
+    void create(const std::vector<float> &positions,
+                const std::vector<float> &normals,
+                const std::vector<float> &textureCoordinates,
+                const std::vector<IndexType> &indices,
+                ShaderProgramType &shaderProgram);
+    void tidy() noexcept;
+
+    std::unique_ptr<VertexArrayObjectType> vertexArrayObject_;
+    std::array<std::unique_ptr<BufferObjectType>, 3> vertexBufferObject_;
+    std::unique_ptr<BufferObjectType> elementBufferObject_;
+    // Position and normal of the morph target, empty without one
+    std::array<std::unique_ptr<BufferObjectType>, 2> morphBufferObject_;
+
+    std::vector<LodLevel> levels_;
+    std::size_t vertexCount_;
+    Math::Bounds bounds_;
+};
+
+} // namespace Model
+
+#endif // HOMEWORK01_MODEL_GEOMETRY_HPP_
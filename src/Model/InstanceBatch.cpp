@@ -0,0 +1,171 @@
+#include "InstanceBatch.hpp"
+
+#include "OpenGL/OpenGLStatistics.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace Model
+{
+
+InstanceBatch::InstanceBatch(std::shared_ptr<Geometry> geometry,
+                             TextureType *texture,
+                             ShaderProgramType &shaderProgram)
+    : geometry_{std::move(geometry)}, texture_{texture},
+      shaderProgram_{&shaderProgram},
+      vertexArrayObject_{new OpenGL::OpenGLVertexArrayObject{}},
+      instanceBuffer_{new OpenGL::OpenGLBufferObject{
+          OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+          OpenGL::OpenGLBufferObject::UsagePattern::StreamDraw}}
+{
+    vertexArrayObject_->bind();
+
+    geometry_->bindVertexBuffers(shaderProgram);
+
+    instanceBuffer_->bind();
+    for (GLuint row = 0; row < 3; ++row)
+    {
+        shaderProgram.enableAttributeArray(FirstAttribute + row);
+        shaderProgram.setAttributeDivisor(FirstAttribute + row, 1);
+    }
+    shaderProgram.enableAttributeArray(MorphWeightAttribute);
+    shaderProgram.setAttributeDivisor(MorphWeightAttribute, 1);
+    mapInstances(0);
+
+    vertexArrayObject_->release();
+}
+
+InstanceBatch::~InstanceBatch() = default;
+
+void InstanceBatch::draw(const glm::mat4 &viewProjection)
+{
+    draw(viewProjection, instances_.size());
+}
+
+void InstanceBatch::draw(const glm::mat4 &viewProjection, std::size_t count)
+{
+    PROGRAM_TRACE_SCOPE("render", "InstanceBatch::draw");
+
+    count = std::min(count, instances_.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    upload(viewProjection, instances_.data(), count);
+
+    vertexArrayObject_->bind();
+    drawLevel(0, count);
+    vertexArrayObject_->release();
+}
+
+void InstanceBatch::draw(const glm::mat4 &viewProjection,
+                         const std::vector<std::size_t> &levelCounts)
+{
+    draw(viewProjection, instances_, levelCounts);
+}
+
+void InstanceBatch::draw(const glm::mat4 &viewProjection,
+                         const std::vector<InstanceTransform> &instances,
+                         const std::vector<std::size_t> &levelCounts)
+{
+    PROGRAM_TRACE_SCOPE("render", "InstanceBatch::draw");
+
+    std::size_t total{0};
+    for (std::size_t count : levelCounts)
+    {
+        total += count;
+    }
+    total = std::min(total, instances.size());
+    if (total == 0)
+    {
+        return;
+    }
+
+    upload(viewProjection, instances.data(), total);
+
+    // The vertex array object maps the first instance between draws
+    vertexArrayObject_->bind();
+    std::size_t first{0};
+    bool moved{false};
+    const std::size_t levels{
+        std::min(levelCounts.size(), geometry_->levelCount())};
+    for (std::size_t level = 0; level < levels && first < total; ++level)
+    {
+        const std::size_t count{std::min(levelCounts[level], total - first)};
+        if (count == 0)
+        {
+            continue;
+        }
+
+        if (first > 0)
+        {
+            mapInstances(first);
+            moved = true;
+        }
+        drawLevel(level, count);
+        first += count;
+    }
+    if (moved)
+    {
+        mapInstances(0);
+    }
+    vertexArrayObject_->release();
+}
+
+void InstanceBatch::upload(const glm::mat4 &viewProjection,
+                           const InstanceTransform *instances,
+                           std::size_t count)
+{
+    if (texture_)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        texture_->bind();
+    }
+
+    shaderProgram_->use();
+    shaderProgram_->setValue<4, 4>("viewProjection", viewProjection, false);
+
+    // Orphan the previous storage, the driver may still be reading it
+    instanceBuffer_->bind();
+    instanceBuffer_->allocateBufferData(
+        instances,
+        static_cast<GLsizeiptr>(sizeof(InstanceTransform) * count));
+}
+
+void InstanceBatch::drawLevel(std::size_t level, std::size_t count)
+{
+    const LodLevel &range{geometry_->level(level)};
+
+    glDrawElementsInstanced(
+        GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+        reinterpret_cast<const void *>(
+            sizeof(Geometry::IndexType) *
+            static_cast<std::size_t>(range.firstIndex)),
+        static_cast<GLsizei>(count));
+    OpenGL::OpenGLStatistics &statistics{OpenGL::OpenGLStatistics::current()};
+    ++statistics.drawCalls;
+    statistics.triangles += static_cast<std::uint32_t>(
+        static_cast<std::size_t>(range.indexCount / 3) * count);
+}
+
+void InstanceBatch::mapInstances(std::size_t first)
+{
+    const std::size_t offset{sizeof(InstanceTransform) * first};
+
+    instanceBuffer_->bind();
+    for (GLuint row = 0; row < 3; ++row)
+    {
+        shaderProgram_->mapAttributePointer(
+            FirstAttribute + row, 4, GL_FLOAT, GL_FALSE,
+            sizeof(InstanceTransform),
+            static_cast<int>(offset + row * sizeof(glm::vec4)));
+    }
+    shaderProgram_->mapAttributePointer(
+        MorphWeightAttribute, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform),
+        static_cast<int>(offset + offsetof(InstanceTransform, morphWeight)));
+}
+
+} // namespace Model
@@ -0,0 +1,117 @@
+#ifndef HOMEWORK01_MODEL_INSTANCEBATCH_HPP_
+#define HOMEWORK01_MODEL_INSTANCEBATCH_HPP_
+
+#include "Model/Geometry.hpp"
+#include "OpenGL/OpenGLBufferObject.hpp"
+#include "OpenGL/OpenGLShaderProgram.hpp"
+#include "OpenGL/OpenGLTexture.hpp"
+#include "OpenGL/OpenGLVertexArrayObject.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Model
+{
+
+/**
+ * @brief Model matrix of one instance, the rows of its upper 3x4 block, and
+ * its weight towards the morph target of the geometry.
+ */
+struct InstanceTransform
+{
+    glm::vec4 rows[3];
+    float morphWeight;
+};
+
+/**
+ * @brief Draws many copies of one Geometry with one texture in a single
+ * instanced draw call.
+ *
+ * @details The caller fills InstanceBatch::instances, every draw uploads the
+ * whole array, or its first count instances, and issues one
+ * glDrawElementsInstanced. The instance transform is bound to attribute
+ * locations FirstAttribute to FirstAttribute + 2, see
+ * Shader/InstancedVertexShader.vs.glsl, the morph weight to
+ * InstanceBatch::MorphWeightAttribute. An all zero transform collapses the
+ * instance to a point, it costs vertex work but no fragments.
+ */
+class InstanceBatch
+{
+public:
+    using TextureType = OpenGL::OpenGLTexture;
+    using ShaderProgramType = OpenGL::OpenGLShaderProgram;
+
+    static constexpr GLuint FirstAttribute = 3;
+    static constexpr GLuint MorphWeightAttribute = 8;
+
+    explicit InstanceBatch(std::shared_ptr<Geometry> geometry,
+                           TextureType *texture,
+                           ShaderProgramType &shaderProgram);
+    ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch &other) = delete;
+    InstanceBatch &operator=(const InstanceBatch &other) = delete;
+
+    const std::shared_ptr<Geometry> &geometry() const noexcept
+    {
+        return geometry_;
+    }
+    TextureType *texture() const noexcept { return texture_; }
+
+    /**
+     * @brief Gets the instances drawn by the next InstanceBatch::draw.
+     */
+    std::vector<InstanceTransform> &instances() noexcept { return instances_; }
+
+    /**
+     * @brief Upload the instances and draw them.
+     */
+    void draw(const glm::mat4 &viewProjection);
+    /**
+     * @brief Upload and draw only the first \a count instances.
+     */
+    void draw(const glm::mat4 &viewProjection, std::size_t count);
+    /**
+     * @brief Upload the first instances, sorted by level of detail, and draw
+     * the next \a levelCounts[level] of them at each level of the geometry.
+     *
+     * @details One upload and one draw call per level in use, the instance
+     * attributes are pointed at each level's first instance within the same
+     * buffer and vertex array object.
+     */
+    void draw(const glm::mat4 &viewProjection,
+              const std::vector<std::size_t> &levelCounts);
+    /**
+     * @brief Draw like above, but from \a instances instead of
+     * InstanceBatch::instances, e.g. a frame another thread filled.
+     */
+    void draw(const glm::mat4 &viewProjection,
+              const std::vector<InstanceTransform> &instances,
+              const std::vector<std::size_t> &levelCounts);
+
+private:
+    // Bind the texture and program and upload \a count of \a instances
+    void upload(const glm::mat4 &viewProjection,
+                const InstanceTransform *instances, std::size_t count);
+    // Draw \a count instances from the mapped one at \a level
+    void drawLevel(std::size_t level, std::size_t count);
+    // Point the instance attributes at \a first in the instance buffer
+    void mapInstances(std::size_t first);
+
+    std::shared_ptr<Geometry> geometry_;
+    TextureType *texture_;
+    ShaderProgramType *shaderProgram_;
+
+    std::unique_ptr<OpenGL::OpenGLVertexArrayObject> vertexArrayObject_;
+    std::unique_ptr<OpenGL::OpenGLBufferObject> instanceBuffer_;
+
+    std::vector<InstanceTransform> instances_;
+};
+
+} // namespace Model
+
+#endif // HOMEWORK01_MODEL_INSTANCEBATCH_HPP_
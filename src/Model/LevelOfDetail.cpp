@@ -0,0 +1,784 @@
+#include "LevelOfDetail.hpp"
+
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace Model
+{
+
+namespace Detail
+{
+
+// Coarser levels have to stay this much within the threshold
+constexpr float lodHysteresis{0.25f};
+// Spheres around the eye are measured from this close
+constexpr float lodNearest{0.01f};
+// Normals and triangles turned further by a collapse reject it, cos 60
+constexpr float collapseNormalLimit{0.5f};
+
+/**
+ * @brief Symmetric 4x4 matrix of summed squared distances to planes, the
+ * upper triangle row by row.
+ */
+struct Quadric
+{
+    double a[10];
+};
+
+/**
+ * @brief Collapse of the position \a from onto \a to at the cost of the
+ * summed quadric at \a to, stale once either position changed.
+ */
+struct Collapse
+{
+    double cost;
+    std::uint32_t from;
+    std::uint32_t to;
+    std::uint32_t fromVersion;
+    std::uint32_t toVersion;
+
+    bool operator>(const Collapse &other) const noexcept
+    {
+        return cost > other.cost;
+    }
+};
+
+/**
+ * @brief Triangles of a mesh collapsing edge by edge, see
+ * Model::BuildLevelsOfDetail.
+ *
+ * @details Vertices with equal attributes are welded first. Vertices at the
+ * same position are the wedges of that position, the collapses move
+ * positions and every wedge of the position removed goes to the wedge of the
+ * kept position it shares a triangle with on the collapsed edge. A wedge
+ * without one would take attributes from across a seam, so such a collapse
+ * is skipped, seams only shorten along themselves.
+ */
+class EdgeCollapser
+{
+public:
+    explicit EdgeCollapser(const MeshData &mesh);
+
+    // Collapse until at most \a triangles are left or nothing can collapse,
+    // returns false in the latter case
+    bool collapseTo(std::size_t triangles);
+    void appendTriangles(std::vector<Geometry::IndexType> &indices) const;
+
+    std::size_t triangleCount() const noexcept { return liveTriangles_; }
+    // Square root of the largest quadric error collapsed so far
+    float error() const noexcept;
+
+private:
+    using Attributes = std::array<float, 8>;
+
+    Attributes attributes(std::uint32_t vertex) const noexcept;
+    // Map every vertex to the lowest one whose first \a compared attributes
+    // are equal
+    std::vector<std::uint32_t> weld(std::size_t compared) const;
+    void addEdgePlanes();
+
+    glm::vec3 position(std::uint32_t vertex) const noexcept;
+    glm::vec3 normal(std::uint32_t vertex) const noexcept;
+    std::uint32_t cornerPosition(std::size_t corner) const noexcept
+    {
+        return positions_[corners_[corner]];
+    }
+    bool hasCorner(std::uint32_t triangle, std::uint32_t position) const noexcept;
+    glm::vec3 faceNormal(std::uint32_t triangle) const noexcept;
+    glm::vec3 faceNormal(std::uint32_t triangle, std::uint32_t moved,
+                         const glm::vec3 &position) const noexcept;
+
+    void pushCollapses(std::uint32_t position);
+    void pushCollapse(std::uint32_t from, std::uint32_t to);
+    // Fills wedgeMap_ for EdgeCollapser::apply
+    bool valid(const Collapse &collapse);
+    void apply(const Collapse &collapse);
+    // Drop collapsed triangles from the position's list
+    void compactTriangles(std::uint32_t position);
+
+    const MeshData &mesh_;
+    bool hasNormals_;
+    bool hasTextureCoordinates_;
+    // Per corner the welded vertex, the wedge
+    std::vector<Geometry::IndexType> corners_;
+    std::vector<std::uint8_t> triangleRemoved_;
+    // Per vertex its position, the lowest vertex there, the rest are indexed
+    // by position
+    std::vector<std::uint32_t> positions_;
+    std::vector<std::vector<std::uint32_t>> positionTriangles_;
+    std::vector<Quadric> quadrics_;
+    std::vector<std::uint8_t> locked_;
+    std::vector<std::uint8_t> positionRemoved_;
+    std::vector<std::uint32_t> versions_;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+        collapses_;
+    std::size_t liveTriangles_;
+    double maxCost_;
+
+    // Scratch of EdgeCollapser::valid
+    std::vector<std::uint32_t> neighbours_;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> wedgeMap_;
+};
+
+void addPlane(Quadric &quadric, const glm::dvec4 &plane) noexcept;
+double evaluateQuadric(const Quadric &first, const Quadric &second,
+                       const glm::vec3 &point) noexcept;
+glm::dvec4 planeThrough(const glm::vec3 &point, const glm::vec3 &normal);
+
+void addPlane(Quadric &quadric, const glm::dvec4 &plane) noexcept
+{
+    int entry{0};
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = row; column < 4; ++column)
+        {
+            quadric.a[entry++] += plane[row] * plane[column];
+        }
+    }
+}
+
+// Squared distances of \a point to the planes of both quadrics
+double evaluateQuadric(const Quadric &first, const Quadric &second,
+                       const glm::vec3 &point) noexcept
+{
+    const double p[]{point.x, point.y, point.z, 1.0};
+
+    double sum{0.0};
+    int entry{0};
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = row; column < 4; ++column)
+        {
+            const double a{first.a[entry] + second.a[entry]};
+            sum += (row == column ? 1.0 : 2.0) * a * p[row] * p[column];
+            ++entry;
+        }
+    }
+
+    return std::max(sum, 0.0);
+}
+
+// Plane through \a point with the unit length of \a normal
+glm::dvec4 planeThrough(const glm::vec3 &point, const glm::vec3 &normal)
+{
+    const glm::dvec3 unit{glm::normalize(glm::dvec3{normal})};
+
+    return glm::dvec4{unit, -glm::dot(unit, glm::dvec3{point})};
+}
+
+EdgeCollapser::EdgeCollapser(const MeshData &mesh)
+    : mesh_{mesh}, hasNormals_{mesh.normals.size() == mesh.positions.size()},
+      hasTextureCoordinates_{mesh.textureCoordinates.size() / 2 ==
+                             mesh.positions.size() / 3},
+      corners_{mesh.indices.begin(),
+               mesh.indices.begin() +
+                   static_cast<std::ptrdiff_t>(BaseIndexCount(mesh) / 3 * 3)},
+      triangleRemoved_(corners_.size() / 3, 0),
+      positionTriangles_(mesh.positions.size() / 3),
+      quadrics_(mesh.positions.size() / 3, Quadric{}),
+      locked_(mesh.positions.size() / 3, 0),
+      positionRemoved_(mesh.positions.size() / 3, 0),
+      versions_(mesh.positions.size() / 3, 0),
+      liveTriangles_{corners_.size() / 3}, maxCost_{0.0}
+{
+    // Vertices the importer split though their attributes are equal are
+    // welded, only real seams keep several wedges
+    const std::vector<std::uint32_t> wedges{weld(8)};
+    for (Geometry::IndexType &corner : corners_)
+    {
+        corner = wedges[corner];
+    }
+    positions_ = weld(3);
+
+    // Edges of one triangle are borders, edges of more are not manifold,
+    // their positions stay
+    std::unordered_map<std::uint64_t, std::uint32_t> edgeTriangles;
+    for (std::size_t triangle = 0; triangle < liveTriangles_; ++triangle)
+    {
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint64_t a{cornerPosition(triangle * 3 + corner)};
+            const std::uint64_t b{
+                cornerPosition(triangle * 3 + (corner + 1) % 3)};
+            ++edgeTriangles[std::min(a, b) << 32 | std::max(a, b)];
+        }
+    }
+    for (const auto &edge : edgeTriangles)
+    {
+        if (edge.second != 2)
+        {
+            locked_[edge.first >> 32] = 1;
+            locked_[edge.first & 0xffffffffu] = 1;
+        }
+    }
+
+    // Planes of unit normals, the quadric's error is a squared distance
+    for (std::uint32_t triangle = 0; triangle < liveTriangles_; ++triangle)
+    {
+        const glm::vec3 cross{faceNormal(triangle)};
+
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            positionTriangles_[cornerPosition(triangle * 3 + corner)].push_back(
+                triangle);
+        }
+        if (glm::dot(cross, cross) == 0.0f)
+        {
+            continue;
+        }
+
+        const glm::dvec4 plane{
+            planeThrough(position(cornerPosition(triangle * 3)), cross)};
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            addPlane(quadrics_[cornerPosition(triangle * 3 + corner)], plane);
+        }
+    }
+    addEdgePlanes();
+
+    for (std::uint32_t vertex = 0; vertex < positions_.size(); ++vertex)
+    {
+        if (positions_[vertex] == vertex && !locked_[vertex])
+        {
+            pushCollapses(vertex);
+        }
+    }
+}
+
+EdgeCollapser::Attributes
+EdgeCollapser::attributes(std::uint32_t vertex) const noexcept
+{
+    Attributes values{};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        values[axis] = mesh_.positions[vertex * 3 + axis];
+        values[3 + axis] = hasNormals_ ? mesh_.normals[vertex * 3 + axis] : 0.0f;
+    }
+    for (std::size_t axis = 0; axis < 2; ++axis)
+    {
+        values[6 + axis] = hasTextureCoordinates_
+                               ? mesh_.textureCoordinates[vertex * 2 + axis]
+                               : 0.0f;
+    }
+
+    return values;
+}
+
+std::vector<std::uint32_t> EdgeCollapser::weld(std::size_t compared) const
+{
+    const std::size_t vertices{mesh_.positions.size() / 3};
+    const auto equal = [&](std::uint32_t first, std::uint32_t second) {
+        const Attributes a{attributes(first)};
+        const Attributes b{attributes(second)};
+        return std::equal(a.begin(), a.begin() + compared, b.begin());
+    };
+
+    std::vector<std::uint32_t> order(vertices);
+    for (std::uint32_t vertex = 0; vertex < vertices; ++vertex)
+    {
+        order[vertex] = vertex;
+    }
+    // Equal attributes sort next to each other, lowest vertex first
+    std::sort(order.begin(), order.end(),
+              [&](std::uint32_t first, std::uint32_t second) {
+                  const Attributes a{attributes(first)};
+                  const Attributes b{attributes(second)};
+                  const bool less{std::lexicographical_compare(
+                      a.begin(), a.begin() + compared, b.begin(),
+                      b.begin() + compared)};
+                  return less || (!std::lexicographical_compare(
+                                      b.begin(), b.begin() + compared,
+                                      a.begin(), a.begin() + compared) &&
+                                  first < second);
+              });
+
+    std::vector<std::uint32_t> welded(vertices);
+    for (std::size_t i = 0; i < vertices; ++i)
+    {
+        welded[order[i]] = i > 0 && equal(order[i], order[i - 1])
+                               ? welded[order[i - 1]]
+                               : order[i];
+    }
+
+    return welded;
+}
+
+void EdgeCollapser::addEdgePlanes()
+{
+    // A seam edge's two triangles have different wedges at either end. Planes
+    // through it upright on both faces keep the seam from sliding sideways
+    std::unordered_map<std::uint64_t, std::uint32_t> firstTriangle;
+    for (std::uint32_t triangle = 0; triangle < liveTriangles_; ++triangle)
+    {
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::size_t next{(corner + 1) % 3};
+            const std::uint64_t a{cornerPosition(triangle * 3 + corner)};
+            const std::uint64_t b{cornerPosition(triangle * 3 + next)};
+            const std::uint64_t key{std::min(a, b) << 32 | std::max(a, b)};
+
+            auto found = firstTriangle.find(key);
+            if (found == firstTriangle.end())
+            {
+                firstTriangle.emplace(key, triangle);
+                continue;
+            }
+
+            const std::uint32_t other{found->second};
+            const auto wedgeAt = [&](std::uint32_t face, std::uint64_t at) {
+                for (std::size_t i = 0; i < 3; ++i)
+                {
+                    if (cornerPosition(face * 3 + i) == at)
+                    {
+                        return corners_[face * 3 + i];
+                    }
+                }
+                return corners_[face * 3];
+            };
+            if (wedgeAt(triangle, a) == wedgeAt(other, a) &&
+                wedgeAt(triangle, b) == wedgeAt(other, b))
+            {
+                continue;
+            }
+
+            const glm::vec3 start{position(static_cast<std::uint32_t>(a))};
+            const glm::vec3 edge{position(static_cast<std::uint32_t>(b)) -
+                                 start};
+            for (std::uint32_t face : {triangle, other})
+            {
+                const glm::vec3 upright{glm::cross(
+                    edge, faceNormal(face))};
+                if (glm::dot(upright, upright) > 0.0f)
+                {
+                    const glm::dvec4 plane{planeThrough(start, upright)};
+                    addPlane(quadrics_[a], plane);
+                    addPlane(quadrics_[b], plane);
+                }
+            }
+        }
+    }
+}
+
+bool EdgeCollapser::collapseTo(std::size_t triangles)
+{
+    while (liveTriangles_ > triangles)
+    {
+        if (collapses_.empty())
+        {
+            return false;
+        }
+
+        const Collapse collapse{collapses_.top()};
+        collapses_.pop();
+        if (valid(collapse))
+        {
+            apply(collapse);
+        }
+    }
+
+    return true;
+}
+
+void EdgeCollapser::appendTriangles(
+    std::vector<Geometry::IndexType> &indices) const
+{
+    for (std::size_t triangle = 0; triangle < triangleRemoved_.size();
+         ++triangle)
+    {
+        if (!triangleRemoved_[triangle])
+        {
+            indices.insert(indices.end(), corners_.begin() + triangle * 3,
+                           corners_.begin() + triangle * 3 + 3);
+        }
+    }
+}
+
+float EdgeCollapser::error() const noexcept
+{
+    return static_cast<float>(std::sqrt(maxCost_));
+}
+
+glm::vec3 EdgeCollapser::position(std::uint32_t vertex) const noexcept
+{
+    return glm::vec3{mesh_.positions[vertex * 3], mesh_.positions[vertex * 3 + 1],
+                     mesh_.positions[vertex * 3 + 2]};
+}
+
+glm::vec3 EdgeCollapser::normal(std::uint32_t vertex) const noexcept
+{
+    return glm::vec3{mesh_.normals[vertex * 3], mesh_.normals[vertex * 3 + 1],
+                     mesh_.normals[vertex * 3 + 2]};
+}
+
+bool EdgeCollapser::hasCorner(std::uint32_t triangle,
+                              std::uint32_t position) const noexcept
+{
+    return cornerPosition(triangle * 3) == position ||
+           cornerPosition(triangle * 3 + 1) == position ||
+           cornerPosition(triangle * 3 + 2) == position;
+}
+
+// Unnormalized, longer for larger triangles
+glm::vec3 EdgeCollapser::faceNormal(std::uint32_t triangle) const noexcept
+{
+    const glm::vec3 a{position(cornerPosition(triangle * 3))};
+
+    return glm::cross(position(cornerPosition(triangle * 3 + 1)) - a,
+                      position(cornerPosition(triangle * 3 + 2)) - a);
+}
+
+// With the corner at \a moved placed at \a position
+glm::vec3 EdgeCollapser::faceNormal(std::uint32_t triangle,
+                                    std::uint32_t moved,
+                                    const glm::vec3 &position) const noexcept
+{
+    glm::vec3 points[3];
+    for (std::size_t corner = 0; corner < 3; ++corner)
+    {
+        const std::uint32_t at{cornerPosition(triangle * 3 + corner)};
+        points[corner] = at == moved ? position : this->position(at);
+    }
+
+    return glm::cross(points[1] - points[0], points[2] - points[0]);
+}
+
+void EdgeCollapser::pushCollapses(std::uint32_t position)
+{
+    for (std::uint32_t triangle : positionTriangles_[position])
+    {
+        if (triangleRemoved_[triangle])
+        {
+            continue;
+        }
+
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t other{cornerPosition(triangle * 3 + corner)};
+            if (other != position)
+            {
+                pushCollapse(position, other);
+                pushCollapse(other, position);
+            }
+        }
+    }
+}
+
+void EdgeCollapser::pushCollapse(std::uint32_t from, std::uint32_t to)
+{
+    if (locked_[from])
+    {
+        return;
+    }
+
+    collapses_.push(Collapse{
+        evaluateQuadric(quadrics_[from], quadrics_[to], position(to)), from,
+        to, versions_[from], versions_[to]});
+}
+
+bool EdgeCollapser::valid(const Collapse &collapse)
+{
+    const std::uint32_t from{collapse.from};
+    const std::uint32_t to{collapse.to};
+
+    if (positionRemoved_[from] || positionRemoved_[to] ||
+        versions_[from] != collapse.fromVersion ||
+        versions_[to] != collapse.toVersion)
+    {
+        return false;
+    }
+
+    // The edge's triangles pair the wedges of both ends, each wedge of the
+    // removed position must find exactly one
+    wedgeMap_.clear();
+    std::size_t edgeTriangles{0};
+    for (std::uint32_t triangle : positionTriangles_[from])
+    {
+        if (triangleRemoved_[triangle] || !hasCorner(triangle, to))
+        {
+            continue;
+        }
+
+        ++edgeTriangles;
+        std::uint32_t wedgeFrom{0};
+        std::uint32_t wedgeTo{0};
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t at{cornerPosition(triangle * 3 + corner)};
+            wedgeFrom = at == from ? corners_[triangle * 3 + corner] : wedgeFrom;
+            wedgeTo = at == to ? corners_[triangle * 3 + corner] : wedgeTo;
+        }
+
+        auto mapped = std::find_if(
+            wedgeMap_.begin(), wedgeMap_.end(),
+            [wedgeFrom](const std::pair<std::uint32_t, std::uint32_t> &pair) {
+                return pair.first == wedgeFrom;
+            });
+        if (mapped == wedgeMap_.end())
+        {
+            wedgeMap_.emplace_back(wedgeFrom, wedgeTo);
+        }
+        else if (mapped->second != wedgeTo)
+        {
+            return false;
+        }
+    }
+    if (edgeTriangles != 2)
+    {
+        return false;
+    }
+    for (const auto &pair : wedgeMap_)
+    {
+        if (hasNormals_ &&
+            glm::dot(normal(pair.first), normal(pair.second)) <
+                collapseNormalLimit)
+        {
+            return false;
+        }
+    }
+
+    // The edge's two triangles share the only common neighbours, more would
+    // pinch the surface
+    neighbours_.clear();
+    for (std::uint32_t triangle : positionTriangles_[from])
+    {
+        if (triangleRemoved_[triangle])
+        {
+            continue;
+        }
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t at{cornerPosition(triangle * 3 + corner)};
+            if (at != from && at != to)
+            {
+                neighbours_.push_back(at);
+            }
+        }
+    }
+    std::sort(neighbours_.begin(), neighbours_.end());
+    neighbours_.erase(std::unique(neighbours_.begin(), neighbours_.end()),
+                      neighbours_.end());
+
+    std::size_t shared{0};
+    for (std::uint32_t triangle : positionTriangles_[to])
+    {
+        if (triangleRemoved_[triangle])
+        {
+            continue;
+        }
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t at{cornerPosition(triangle * 3 + corner)};
+            auto found =
+                std::lower_bound(neighbours_.begin(), neighbours_.end(), at);
+            if (found != neighbours_.end() && *found == at)
+            {
+                // Counted once, the neighbour is taken off the list
+                neighbours_.erase(found);
+                ++shared;
+            }
+        }
+    }
+    if (shared != 2)
+    {
+        return false;
+    }
+
+    // The triangles which stay keep their wedge's attributes, and must not
+    // fold over or turn too far, from their last shape or, step by step, from
+    // the normals of their corners
+    const glm::vec3 target{position(to)};
+    for (std::uint32_t triangle : positionTriangles_[from])
+    {
+        if (triangleRemoved_[triangle] || hasCorner(triangle, to))
+        {
+            continue;
+        }
+
+        const glm::vec3 before{faceNormal(triangle)};
+        const glm::vec3 after{faceNormal(triangle, from, target)};
+        const float lengths{glm::length(before) * glm::length(after)};
+        if (lengths == 0.0f ||
+            glm::dot(before, after) < collapseNormalLimit * lengths)
+        {
+            return false;
+        }
+
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            std::uint32_t wedge{corners_[triangle * 3 + corner]};
+            if (cornerPosition(triangle * 3 + corner) == from)
+            {
+                auto mapped = std::find_if(
+                    wedgeMap_.begin(), wedgeMap_.end(),
+                    [wedge](const std::pair<std::uint32_t, std::uint32_t> &pair) {
+                        return pair.first == wedge;
+                    });
+                if (mapped == wedgeMap_.end())
+                {
+                    return false;
+                }
+                wedge = mapped->second;
+            }
+
+            if (hasNormals_ &&
+                glm::dot(after, normal(wedge)) <
+                    collapseNormalLimit * glm::length(after) *
+                        glm::length(normal(wedge)))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void EdgeCollapser::apply(const Collapse &collapse)
+{
+    const std::uint32_t from{collapse.from};
+    const std::uint32_t to{collapse.to};
+
+    for (std::uint32_t triangle : positionTriangles_[from])
+    {
+        if (triangleRemoved_[triangle])
+        {
+            continue;
+        }
+        if (hasCorner(triangle, to))
+        {
+            triangleRemoved_[triangle] = 1;
+            --liveTriangles_;
+            continue;
+        }
+
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            Geometry::IndexType &wedge{corners_[triangle * 3 + corner]};
+            for (const auto &pair : wedgeMap_)
+            {
+                wedge = wedge == pair.first ? pair.second : wedge;
+            }
+        }
+        positionTriangles_[to].push_back(triangle);
+    }
+
+    for (int entry = 0; entry < 10; ++entry)
+    {
+        quadrics_[to].a[entry] += quadrics_[from].a[entry];
+    }
+    maxCost_ = std::max(maxCost_, collapse.cost);
+
+    positionRemoved_[from] = 1;
+    positionTriangles_[from].clear();
+    compactTriangles(to);
+    ++versions_[to];
+    pushCollapses(to);
+}
+
+void EdgeCollapser::compactTriangles(std::uint32_t position)
+{
+    std::vector<std::uint32_t> &triangles{positionTriangles_[position]};
+    triangles.erase(std::remove_if(triangles.begin(), triangles.end(),
+                                   [this](std::uint32_t triangle) {
+                                       return triangleRemoved_[triangle] != 0;
+                                   }),
+                    triangles.end());
+}
+
+} // namespace Detail
+
+LodView MakeLodView(const glm::mat4 &view, const glm::mat4 &projection,
+                    float viewportHeight, float threshold) noexcept
+{
+    LodView lod;
+    lod.eye = glm::vec3{glm::inverse(view)[3]};
+    lod.pixelScale = 0.5f * viewportHeight * projection[1][1];
+    lod.threshold = threshold;
+
+    return lod;
+}
+
+std::size_t SelectLevel(const Geometry &geometry, const glm::vec4 &sphere,
+                        const LodView &view, std::size_t current) noexcept
+{
+    const Math::Bounds &bounds{geometry.bounds()};
+    if (view.threshold <= 0.0f || geometry.levelCount() < 2 ||
+        bounds.empty() || bounds.sphere.w <= 0.0f)
+    {
+        return 0;
+    }
+
+    // Pixels per mesh unit at the near side of the sphere
+    const float distance{
+        std::max(glm::length(glm::vec3{sphere} - view.eye) - sphere.w,
+                 Detail::lodNearest)};
+    const float scale{sphere.w / bounds.sphere.w * view.pixelScale / distance};
+
+    // Errors ascend with the levels, the first one too large ends the search
+    std::size_t level{0};
+    for (std::size_t next = 1; next < geometry.levelCount(); ++next)
+    {
+        const float limit{next > current
+                              ? view.threshold * (1.0f - Detail::lodHysteresis)
+                              : view.threshold};
+        if (geometry.level(next).error * scale > limit)
+        {
+            break;
+        }
+        level = next;
+    }
+
+    return level;
+}
+
+void BuildLevelsOfDetail(MeshData &mesh, const std::vector<float> &ratios)
+{
+    PROGRAM_TRACE_SCOPE("loading", "Model::BuildLevelsOfDetail");
+
+    mesh.indices.resize(BaseIndexCount(mesh));
+    mesh.levels.assign(
+        1, LodLevel{0, static_cast<GLsizei>(mesh.indices.size()), 0.0f});
+
+    std::vector<float> sorted{ratios};
+    std::sort(sorted.begin(), sorted.end(), std::greater<float>());
+
+    // Every level continues the collapses of the one before
+    Detail::EdgeCollapser collapser{mesh};
+    const std::size_t triangles{collapser.triangleCount()};
+    for (float ratio : sorted)
+    {
+        const std::size_t target{static_cast<std::size_t>(
+            std::ceil(std::max(ratio, 0.0f) * static_cast<float>(triangles)))};
+        const bool reached{collapser.collapseTo(target)};
+
+        const LodLevel &previous{mesh.levels.back()};
+        if (collapser.triangleCount() * 3 <
+            static_cast<std::size_t>(previous.indexCount))
+        {
+            const std::size_t first{mesh.indices.size()};
+            collapser.appendTriangles(mesh.indices);
+            mesh.levels.push_back(
+                LodLevel{static_cast<GLsizei>(first),
+                         static_cast<GLsizei>(mesh.indices.size() - first),
+                         collapser.error()});
+        }
+        if (!reached)
+        {
+            break;
+        }
+    }
+}
+
+} // namespace Model
@@ -0,0 +1,67 @@
+#ifndef HOMEWORK01_MODEL_LEVELOFDETAIL_HPP_
+#define HOMEWORK01_MODEL_LEVELOFDETAIL_HPP_
+
+#include "Model/Geometry.hpp"
+#include "Model/MorphTarget.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Model
+{
+
+/**
+ * @brief The camera as the level of detail selection sees it.
+ */
+struct LodView
+{
+    glm::vec3 eye{0.0f};
+    // Pixels one unit spans at a distance of one, half the viewport height
+    // times the projection's vertical scale
+    float pixelScale = 0.0f;
+    // Largest error drawn in pixels, 0 draws every geometry in full
+    float threshold = 0.0f;
+};
+
+/**
+ * @brief Gets the LodView of the camera of \a view and \a projection drawing
+ * into a viewport \a viewportHeight pixels high.
+ */
+LodView MakeLodView(const glm::mat4 &view, const glm::mat4 &projection,
+                    float viewportHeight, float threshold) noexcept;
+
+/**
+ * @brief Gets the coarsest level of \a geometry whose error, projected at the
+ * near side of \a sphere, the geometry's bounding sphere in world space,
+ * stays within the threshold of \a view.
+ *
+ * @details A level coarser than \a current, the level chosen last, has to
+ * stay within a quarter less than the threshold, so a geometry at the edge
+ * of a level does not swap meshes every frame.
+ */
+std::size_t SelectLevel(const Geometry &geometry, const glm::vec4 &sphere,
+                        const LodView &view, std::size_t current) noexcept;
+
+/**
+ * @brief Append a level of detail of \a mesh for every ratio of its
+ * triangles in \a ratios, largest first, and fill MeshData::levels.
+ *
+ * @details Edges are collapsed cheapest first by the quadric error metric,
+ * one end onto the other, so every level indexes the vertices of the full
+ * mesh and shares its vertex buffers. Vertices on edges of a single
+ * triangle, the borders and the UV and normal seams where the importer split
+ * vertices, are never removed, and a collapse which would turn a vertex's
+ * normal or a triangle by more than 60 degrees is skipped. The error of a
+ * level is the square root of the largest quadric error collapsed so far, it
+ * bounds the distance of the kept vertices from the planes of the full
+ * mesh's triangles. Ratios the collapses cannot reach add no level.
+ */
+void BuildLevelsOfDetail(MeshData &mesh, const std::vector<float> &ratios);
+
+} // namespace Model
+
+#endif // HOMEWORK01_MODEL_LEVELOFDETAIL_HPP_
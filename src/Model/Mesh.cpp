@@ -1,6 +1,7 @@
 #include "Mesh.hpp"
 
 #include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 
 #include <glm/gtx/matrix_decompose.hpp>
 
@@ -8,9 +9,8 @@ namespace Model
 {
 
 Mesh::Mesh() noexcept
-    : shaderProgram_{nullptr}, texture_{nullptr}, vertexArrayObject_{nullptr},
-      vertexBufferObject_{{nullptr, nullptr, nullptr}},
-      elementBufferObject_{nullptr}, indicesCount_{0}, model_{1}
+    : geometry_{nullptr}, shaderProgram_{nullptr}, texture_{nullptr},
+      model_{1}
 {
 }
 
@@ -19,70 +19,25 @@ Mesh::Mesh(const std::vector<float> &positions,
            const std::vector<float> &textureCoordinates,
            const std::vector<IndexType> &indices,
            ShaderProgramType &shaderProgram, TextureType *texture)
-    : shaderProgram_{&shaderProgram}, texture_{texture},
-      vertexArrayObject_{nullptr},
-      vertexBufferObject_{{nullptr, nullptr, nullptr}},
-      elementBufferObject_{nullptr},
-      indicesCount_{static_cast<GLsizei>(indices.size())}, model_{1}
+    : geometry_{std::make_shared<Geometry>(positions, normals,
+                                           textureCoordinates, indices,
+                                           shaderProgram)},
+      shaderProgram_{&shaderProgram}, texture_{texture}, model_{1}
 {
-    create(positions, normals, textureCoordinates, indices);
 }
 
-Mesh::Mesh(Mesh &&other) noexcept = default;
-
-Mesh &Mesh::operator=(Mesh &&other) noexcept = default;
-
-Mesh::~Mesh() noexcept { tidy(); }
-
-void Mesh::vertexBufferObjectSetup(BufferObjectType &object,
-                                   const std::vector<float> &data,
-                                   ShaderProgramType &program, GLuint index,
-                                   GLint size, GLenum type,
-                                   GLboolean normalized, GLsizei stride,
-                                   int offset)
+Mesh::Mesh(std::shared_ptr<Geometry> geometry,
+           ShaderProgramType &shaderProgram, TextureType *texture) noexcept
+    : geometry_{std::move(geometry)}, shaderProgram_{&shaderProgram},
+      texture_{texture}, model_{1}
 {
-    object.bind();
-    object.allocateBufferData(data.data(), sizeof(float) * data.size());
-
-    program.enableAttributeArray(index);
-    program.mapAttributePointer(index, size, type, normalized, stride, offset);
 }
 
-void Mesh::create(const std::vector<float> &positions,
-                  const std::vector<float> &normals,
-                  const std::vector<float> &textureCoordinates,
-                  const std::vector<IndexType> &indices)
-{
-    vertexArrayObject_.reset(new VertexArrayObjectType{});
-    for (auto &object : vertexBufferObject_)
-    {
-        object.reset(new BufferObjectType{
-            OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
-            OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
-    }
-    elementBufferObject_.reset(new BufferObjectType{
-        OpenGL::OpenGLBufferObject::Type::ElementArrayBuffer,
-        OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw});
-
-    vertexArrayObject_->bind();
-
-    vertexBufferObjectSetup(*(vertexBufferObject_[0]), positions,
-                            *shaderProgram_, 0, 3, GL_FLOAT, GL_FALSE,
-                            3 * sizeof(float), 0);
-
-    vertexBufferObjectSetup(*(vertexBufferObject_[1]), normals, *shaderProgram_,
-                            1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
-
-    vertexBufferObjectSetup(*(vertexBufferObject_[2]), textureCoordinates,
-                            *shaderProgram_, 2, 2, GL_FLOAT, GL_FALSE,
-                            2 * sizeof(float), 0);
+Mesh::Mesh(Mesh &&other) noexcept = default;
 
-    elementBufferObject_->bind();
-    elementBufferObject_->allocateBufferData(
-        indices.data(), sizeof(IndexType) * indices.size());
+Mesh &Mesh::operator=(Mesh &&other) noexcept = default;
 
-    vertexArrayObject_->release();
-}
+Mesh::~Mesh() = default;
 
 void Mesh::draw(glm::mat4 &view, glm::mat4 &projection)
 {
@@ -97,10 +52,9 @@ void Mesh::draw(glm::mat4 &view, glm::mat4 &projection)
     glm::mat4 mvp{projection * view * model_};
 
     shaderProgram_->setValue<4, 4>("mvp", mvp, false);
+    shaderProgram_->setValue("morphWeight", morphWeight_);
 
-    vertexArrayObject_->bind();
-    glDrawElements(GL_TRIANGLES, indicesCount_, GL_UNSIGNED_INT, 0);
-    vertexArrayObject_->release();
+    geometry_->draw(level_);
 
     if (!(texture_))
     {
@@ -108,55 +62,88 @@ void Mesh::draw(glm::mat4 &view, glm::mat4 &projection)
     }
 }
 
-void Mesh::tidy() noexcept
+void Mesh::setModelMatrix(const glm::mat4 &model) noexcept
 {
-    elementBufferObject_.reset();
-    for (auto &object : vertexBufferObject_)
-    {
-        object.reset();
-    }
-    vertexArrayObject_.reset();
+    model_ = model;
+    decomposed_ = false;
 }
 
-void Mesh::setModelMatrix(glm::mat4 & model)
+void Mesh::decompose() const
 {
-    model_ = model;
+    PROGRAM_TRACE_SCOPE("model", "Mesh::decompose");
 
     glm::vec3 skew;
     glm::vec4 perspective;
-    glm::decompose(model, scale_, rotation_, position_, skew, perspective);
+    glm::decompose(model_, scale_, rotation_, position_, skew, perspective);
+
+    decomposed_ = true;
+}
+
+glm::vec3 Mesh::getPosition() const
+{
+    if (!decomposed_)
+    {
+        decompose();
+    }
+    return position_;
 }
 
-glm::vec3 Mesh::getPosition() { return position_; }
 void Mesh::setPosition(glm::vec3 &position)
 {
+    if (!decomposed_)
+    {
+        decompose();
+    }
     position_ = position;
     updateModelMatrix();
 }
 
-glm::quat Mesh::getRotation() { return rotation_; }
-glm::vec3 Mesh::getRotationEuler() { return glm::eulerAngles(rotation_); }
+glm::quat Mesh::getRotation() const
+{
+    if (!decomposed_)
+    {
+        decompose();
+    }
+    return rotation_;
+}
 
-void Mesh::setRotation(const glm::quat &rot)
+glm::vec3 Mesh::getRotationEuler() const
 {
-    rotation_ = rot;
-    updateModelMatrix();
+    return glm::eulerAngles(getRotation());
 }
 
-void Mesh::setRotation(const glm::vec3 &rot)
+void Mesh::setRotation(const glm::quat &rot)
 {
-    rotation_ = glm::quat(rot);
+    if (!decomposed_)
+    {
+        decompose();
+    }
+    rotation_ = rot;
     updateModelMatrix();
 }
 
+void Mesh::setRotation(const glm::vec3 &rot) { setRotation(glm::quat(rot)); }
+
 void Mesh::setRotationDeg(const glm::vec3 &rot)
 {
     setRotation(glm::radians(rot));
 }
 
-glm::vec3 Mesh::getScale() { return scale_; }
+glm::vec3 Mesh::getScale() const
+{
+    if (!decomposed_)
+    {
+        decompose();
+    }
+    return scale_;
+}
+
 void Mesh::setScale(glm::vec3 &scale)
 {
+    if (!decomposed_)
+    {
+        decompose();
+    }
     scale_ = scale;
     updateModelMatrix();
 }
@@ -165,8 +152,7 @@ void Mesh::rotate(float angleDegrees, const glm::vec3 &axis)
 {
     glm::quat deltaRotation =
         glm::angleAxis(glm::radians(angleDegrees), glm::normalize(axis));
-    rotation_ = deltaRotation * rotation_;
-    updateModelMatrix();
+    setRotation(deltaRotation * getRotation());
 }
 
 void Mesh::updateModelMatrix()
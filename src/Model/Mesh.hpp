@@ -1,24 +1,32 @@
 #ifndef HOMEWORK01_MODEL_MESH_HPP_
 #define HOMEWORK01_MODEL_MESH_HPP_
 
-#include "OpenGL/OpenGLBufferObject.hpp"
+#include "Model/Geometry.hpp"
 #include "OpenGL/OpenGLShaderProgram.hpp"
 #include "OpenGL/OpenGLTexture.hpp"
-#include "OpenGL/OpenGLVertexArrayObject.hpp"
 
+#include "glm/gtc/quaternion.hpp"
 #include "glm/mat4x4.hpp"
 
-#include <array>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
 namespace Model
 {
 
+/**
+ * @brief An instance of a Geometry with its own transform and texture.
+ *
+ * @details The model matrix is the only transform the render path reads,
+ * setModelMatrix is a plain store. Position, rotation and scale are
+ * decomposed from it lazily, the first time an editor getter asks for them
+ * after the matrix changed.
+ */
 class Mesh
 {
 public:
-    using IndexType = unsigned int;
+    using IndexType = Geometry::IndexType;
     using TextureType = OpenGL::OpenGLTexture;
     using ShaderProgramType = OpenGL::OpenGLShaderProgram;
 
@@ -29,6 +37,12 @@ public:
                   const std::vector<IndexType> &indices,
                   ShaderProgramType &shaderProgram,
                   TextureType *texture = nullptr);
+    /**
+     * @brief Initializes a new instance which draws the shared \a geometry.
+     */
+    explicit Mesh(std::shared_ptr<Geometry> geometry,
+                  ShaderProgramType &shaderProgram,
+                  TextureType *texture = nullptr) noexcept;
 
     Mesh(Mesh &&other) noexcept;
     Mesh &operator=(Mesh &&other) noexcept;
@@ -39,18 +53,33 @@ public:
 
     void draw(glm::mat4 &view, glm::mat4 &projection);
 
-    inline glm::mat4 modelMatrix(){
-        return model_;
+    inline const glm::mat4 &modelMatrix() const noexcept { return model_; }
+    void setModelMatrix(const glm::mat4 &model) noexcept;
+
+    inline const std::shared_ptr<Geometry> &geometry() const noexcept
+    {
+        return geometry_;
     }
-    void setModelMatrix(glm::mat4 &model);
+    inline TextureType *texture() const noexcept { return texture_; }
+
+    /**
+     * @brief Set how far the geometry is blended towards its morph target,
+     * see Geometry::setMorphTarget. 0 draws the base shape.
+     */
+    inline void setMorphWeight(float weight) noexcept { morphWeight_ = weight; }
+    /**
+     * @brief Set the level of detail of the geometry the next draw uses, see
+     * Model::SelectLevel. 0 draws the full mesh.
+     */
+    inline void setLevel(std::size_t level) noexcept { level_ = level; }
 
-    glm::vec3 getPosition();
+    glm::vec3 getPosition() const;
 
-    glm::quat getRotation();
+    glm::quat getRotation() const;
 
-    glm::vec3 getRotationEuler();
+    glm::vec3 getRotationEuler() const;
 
-    glm::vec3 getScale();
+    glm::vec3 getScale() const;
 
     void setPosition(glm::vec3 &position);
 
@@ -67,37 +96,21 @@ public:
     void rotate(float angleDegrees, const glm::vec3 &axis);
 
 private:
-    using VertexArrayObjectType = OpenGL::OpenGLVertexArrayObject;
-    using BufferObjectType = OpenGL::OpenGLBufferObject;
-
-    void create(const std::vector<float> &positions,
-                const std::vector<float> &normals,
-                const std::vector<float> &textureCoordinates,
-                const std::vector<IndexType> &indices);
-    void tidy() noexcept;
-
-    static void vertexBufferObjectSetup(BufferObjectType &object,
-                                        const std::vector<float> &data,
-                                        ShaderProgramType &program,
-                                        GLuint index, GLint size, GLenum type,
-                                        GLboolean normalized, GLsizei stride,
-                                        int offset);
-
+    std::shared_ptr<Geometry> geometry_;
     ShaderProgramType *shaderProgram_;
     TextureType *texture_;
 
-    std::unique_ptr<VertexArrayObjectType> vertexArrayObject_;
-    std::array<std::unique_ptr<BufferObjectType>, 3> vertexBufferObject_;
-    std::unique_ptr<BufferObjectType> elementBufferObject_;
-
-    GLsizei indicesCount_;
-
     glm::mat4 model_;
+    float morphWeight_ = 0.0f;
+    std::size_t level_ = 0;
 
-    glm::vec3 position_ = glm::vec3(0.0f);
-    glm::quat rotation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-    glm::vec3 scale_ = glm::vec3(1.0f);
+    // Editable TRS, valid only while decomposed_ is set
+    mutable glm::vec3 position_ = glm::vec3(0.0f);
+    mutable glm::quat rotation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    mutable glm::vec3 scale_ = glm::vec3(1.0f);
+    mutable bool decomposed_ = true;
 
+    void decompose() const;
     void updateModelMatrix();
 };
 
@@ -0,0 +1,197 @@
+#include "MorphTarget.hpp"
+
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/vec3.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Model
+{
+
+namespace Detail
+{
+
+glm::vec3 vertex(const std::vector<float> &attribute, std::size_t index);
+glm::vec3 boundsCentre(const std::vector<float> &positions);
+bool intersectTriangle(const glm::vec3 &origin, const glm::vec3 &direction,
+                       const glm::vec3 &a, const glm::vec3 &b,
+                       const glm::vec3 &c, float &distance, float &u,
+                       float &v);
+
+glm::vec3 vertex(const std::vector<float> &attribute, std::size_t index)
+{
+    return glm::vec3{attribute[index * 3], attribute[index * 3 + 1],
+                     attribute[index * 3 + 2]};
+}
+
+glm::vec3 boundsCentre(const std::vector<float> &positions)
+{
+    glm::vec3 minimum{std::numeric_limits<float>::max()};
+    glm::vec3 maximum{-std::numeric_limits<float>::max()};
+
+    for (std::size_t i = 0; i < positions.size() / 3; ++i)
+    {
+        minimum = glm::min(minimum, vertex(positions, i));
+        maximum = glm::max(maximum, vertex(positions, i));
+    }
+
+    return positions.empty() ? glm::vec3{0.0f} : (minimum + maximum) * 0.5f;
+}
+
+// Moller-Trumbore, \a distance along \a direction and the barycentric
+// coordinates of b and c
+bool intersectTriangle(const glm::vec3 &origin, const glm::vec3 &direction,
+                       const glm::vec3 &a, const glm::vec3 &b,
+                       const glm::vec3 &c, float &distance, float &u, float &v)
+{
+    const float epsilon{1.0e-7f};
+
+    const glm::vec3 edge1{b - a};
+    const glm::vec3 edge2{c - a};
+    const glm::vec3 p{glm::cross(direction, edge2)};
+    const float determinant{glm::dot(edge1, p)};
+
+    if (std::abs(determinant) < epsilon)
+    {
+        return false;
+    }
+
+    const float inverse{1.0f / determinant};
+    const glm::vec3 s{origin - a};
+    u = glm::dot(s, p) * inverse;
+    if (u < -epsilon || u > 1.0f + epsilon)
+    {
+        return false;
+    }
+
+    const glm::vec3 q{glm::cross(s, edge1)};
+    v = glm::dot(direction, q) * inverse;
+    if (v < -epsilon || u + v > 1.0f + epsilon)
+    {
+        return false;
+    }
+
+    distance = glm::dot(edge2, q) * inverse;
+    return distance > 0.0f;
+}
+
+} // namespace Detail
+
+void ComputeNormals(MeshData &mesh)
+{
+    if (mesh.normals.size() == mesh.positions.size())
+    {
+        return;
+    }
+
+    mesh.normals.assign(mesh.positions.size(), 0.0f);
+
+    for (std::size_t i = 0; i + 2 < BaseIndexCount(mesh); i += 3)
+    {
+        const Geometry::IndexType corners[]{mesh.indices[i], mesh.indices[i + 1],
+                                            mesh.indices[i + 2]};
+        // Unnormalized, longer for larger triangles
+        const glm::vec3 normal{glm::cross(
+            Detail::vertex(mesh.positions, corners[1]) -
+                Detail::vertex(mesh.positions, corners[0]),
+            Detail::vertex(mesh.positions, corners[2]) -
+                Detail::vertex(mesh.positions, corners[0]))};
+
+        for (Geometry::IndexType corner : corners)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                mesh.normals[corner * 3 + axis] += normal[axis];
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < mesh.normals.size() / 3; ++i)
+    {
+        const glm::vec3 normal{Detail::vertex(mesh.normals, i)};
+        const float length{glm::length(normal)};
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            mesh.normals[i * 3 + axis] = length > 0.0f ? normal[axis] / length
+                                                       : 0.0f;
+        }
+    }
+}
+
+void ResampleMorphTarget(const MeshData &source, const MeshData &target,
+                         std::vector<float> &positions,
+                         std::vector<float> &normals)
+{
+    PROGRAM_TRACE_SCOPE("loading", "Model::ResampleMorphTarget");
+
+    const glm::vec3 sourceCentre{Detail::boundsCentre(source.positions)};
+    const glm::vec3 targetCentre{Detail::boundsCentre(target.positions)};
+    const bool hasNormals{target.normals.size() == target.positions.size()};
+
+    positions = source.positions;
+    normals = source.normals;
+    normals.resize(positions.size(), 0.0f);
+
+    for (std::size_t i = 0; i < source.positions.size() / 3; ++i)
+    {
+        const glm::vec3 direction{Detail::vertex(source.positions, i) -
+                                  sourceCentre};
+        if (glm::dot(direction, direction) == 0.0f)
+        {
+            continue;
+        }
+
+        // Nearest hit, the only one for a star shaped target
+        float nearest{std::numeric_limits<float>::max()};
+        glm::vec3 normal{0.0f};
+        for (std::size_t j = 0; j + 2 < BaseIndexCount(target); j += 3)
+        {
+            const Geometry::IndexType a{target.indices[j]};
+            const Geometry::IndexType b{target.indices[j + 1]};
+            const Geometry::IndexType c{target.indices[j + 2]};
+            float distance{0.0f};
+            float u{0.0f};
+            float v{0.0f};
+
+            if (Detail::intersectTriangle(
+                    targetCentre, direction, Detail::vertex(target.positions, a),
+                    Detail::vertex(target.positions, b),
+                    Detail::vertex(target.positions, c), distance, u, v) &&
+                distance < nearest)
+            {
+                nearest = distance;
+                normal = hasNormals
+                             ? Detail::vertex(target.normals, a) *
+                                       (1.0f - u - v) +
+                                   Detail::vertex(target.normals, b) * u +
+                                   Detail::vertex(target.normals, c) * v
+                             : glm::cross(Detail::vertex(target.positions, b) -
+                                              Detail::vertex(target.positions, a),
+                                          Detail::vertex(target.positions, c) -
+                                              Detail::vertex(target.positions, a));
+            }
+        }
+
+        if (nearest == std::numeric_limits<float>::max())
+        {
+            continue;
+        }
+
+        const glm::vec3 position{targetCentre + direction * nearest};
+        const float length{glm::length(normal)};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            positions[i * 3 + axis] = position[axis];
+            if (length > 0.0f)
+            {
+                normals[i * 3 + axis] = normal[axis] / length;
+            }
+        }
+    }
+}
+
+} // namespace Model
@@ -0,0 +1,63 @@
+#ifndef HOMEWORK01_MODEL_MORPHTARGET_HPP_
+#define HOMEWORK01_MODEL_MORPHTARGET_HPP_
+
+#include "Model/Geometry.hpp"
+#include "Utils/Math/Bounds.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Model
+{
+
+/**
+ * @brief Vertex attributes and indices of a triangle mesh kept on the CPU,
+ * tightly packed like the Geometry constructor expects them.
+ *
+ * @details With levels of detail the indices hold every level one after the
+ * other, the full mesh first, see Model::BuildLevelsOfDetail.
+ */
+struct MeshData
+{
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> textureCoordinates;
+    std::vector<Geometry::IndexType> indices;
+    std::vector<LodLevel> levels; // empty for the full mesh only
+    Math::Bounds bounds;
+};
+
+/**
+ * @brief Gets the indices of the full mesh, the leading ones of
+ * MeshData::indices.
+ */
+inline std::size_t BaseIndexCount(const MeshData &mesh) noexcept
+{
+    return mesh.levels.empty()
+               ? mesh.indices.size()
+               : static_cast<std::size_t>(mesh.levels.front().indexCount);
+}
+
+/**
+ * @brief Fill in area weighted vertex normals if \a mesh has none.
+ */
+void ComputeNormals(MeshData &mesh);
+
+/**
+ * @brief Resample the surface of \a target at the vertices of \a source, the
+ * morph target stream of a Geometry with the topology of \a source.
+ *
+ * @details Every vertex is projected along the ray from the centre of the
+ * bounds of \a source through it onto \a target, which is placed at the
+ * same centre. The normal is interpolated from the hit triangle. Both meshes
+ * must be star shaped around their centres, like the cube and sphere body
+ * parts; a vertex whose ray misses \a target keeps its own position and
+ * normal.
+ */
+void ResampleMorphTarget(const MeshData &source, const MeshData &target,
+                         std::vector<float> &positions,
+                         std::vector<float> &normals);
+
+} // namespace Model
+
+#endif // HOMEWORK01_MODEL_MORPHTARGET_HPP_
@@ -0,0 +1,153 @@
+#include "SkinnedMesh.hpp"
+
+#include "OpenGL/OpenGLException.hpp"
+#include "OpenGL/OpenGLStatistics.hpp"
+#include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+namespace Model
+{
+
+namespace Detail
+{
+
+void uploadBoneStream(OpenGL::OpenGLBufferObject &buffer,
+                      const std::vector<float> &stream);
+
+void uploadBoneStream(OpenGL::OpenGLBufferObject &buffer,
+                      const std::vector<float> &stream)
+{
+    buffer.bind();
+    buffer.allocateBufferData(
+        stream.data(), static_cast<GLsizeiptr>(sizeof(float) * stream.size()));
+}
+
+} // namespace Detail
+
+void AppendRigidPart(const MeshData &part, int bone, SkinData &skin)
+{
+    MeshData &mesh{skin.mesh};
+    const std::size_t first{mesh.positions.size() / 3};
+    const std::size_t vertices{part.positions.size() / 3};
+
+    mesh.positions.insert(mesh.positions.end(), part.positions.begin(),
+                          part.positions.end());
+    mesh.normals.insert(mesh.normals.end(), part.normals.begin(),
+                        part.normals.end());
+    mesh.textureCoordinates.insert(mesh.textureCoordinates.end(),
+                                   part.textureCoordinates.begin(),
+                                   part.textureCoordinates.end());
+    // Parts without normals or texture coordinates get zeros
+    mesh.normals.resize(mesh.positions.size(), 0.0f);
+    mesh.textureCoordinates.resize((first + vertices) * 2, 0.0f);
+
+    // The full mesh, the skin has no levels of detail
+    for (std::size_t i = 0; i < BaseIndexCount(part); ++i)
+    {
+        mesh.indices.push_back(static_cast<Geometry::IndexType>(first) +
+                               part.indices[i]);
+    }
+
+    for (std::size_t i = 0; i < vertices; ++i)
+    {
+        for (int influence = 0; influence < SkinnedMesh::Influences;
+             ++influence)
+        {
+            skin.boneIndices.push_back(
+                influence == 0 ? static_cast<float>(bone) : 0.0f);
+            skin.boneWeights.push_back(influence == 0 ? 1.0f : 0.0f);
+        }
+    }
+}
+
+SkinnedMesh::SkinnedMesh(const SkinData &skin,
+                         ShaderProgramType &shaderProgram, TextureType *texture)
+    : geometry_{std::make_shared<Geometry>(
+          skin.mesh.positions, skin.mesh.normals, skin.mesh.textureCoordinates,
+          skin.mesh.indices, shaderProgram)},
+      shaderProgram_{&shaderProgram}, texture_{texture},
+      vertexArrayObject_{new OpenGL::OpenGLVertexArrayObject{}},
+      boneIndexBuffer_{new OpenGL::OpenGLBufferObject{
+          OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+          OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw}},
+      boneWeightBuffer_{new OpenGL::OpenGLBufferObject{
+          OpenGL::OpenGLBufferObject::Type::ArrayBuffer,
+          OpenGL::OpenGLBufferObject::UsagePattern::StaticDraw}},
+      paletteBuffer_{new OpenGL::OpenGLBufferObject{
+          OpenGL::OpenGLBufferObject::Type::UniformBuffer,
+          OpenGL::OpenGLBufferObject::UsagePattern::DynamicDraw}},
+      palette_(MaxBones, glm::mat4{1.0f}), paletteDirty_{true}
+{
+    if (!shaderProgram.setUniformBlockBinding("Palette", PaletteBinding))
+    {
+        throw OpenGL::OpenGLException{
+            "SkinnedMesh: Shader has no Palette uniform block"};
+    }
+
+    vertexArrayObject_->bind();
+
+    geometry_->bindVertexBuffers(shaderProgram);
+
+    const GLuint attributes[]{BoneIndicesAttribute, BoneWeightsAttribute};
+    OpenGL::OpenGLBufferObject *buffers[]{boneIndexBuffer_.get(),
+                                          boneWeightBuffer_.get()};
+    const std::vector<float> *streams[]{&skin.boneIndices, &skin.boneWeights};
+    for (int i = 0; i < 2; ++i)
+    {
+        Detail::uploadBoneStream(*buffers[i], *streams[i]);
+        shaderProgram.enableAttributeArray(attributes[i]);
+        shaderProgram.mapAttributePointer(attributes[i], Influences, GL_FLOAT,
+                                          GL_FALSE, Influences * sizeof(float),
+                                          0);
+    }
+
+    vertexArrayObject_->release();
+}
+
+SkinnedMesh::~SkinnedMesh() = default;
+
+void SkinnedMesh::setBone(int bone, const glm::mat4 &transform) noexcept
+{
+    if (palette_[bone] != transform)
+    {
+        palette_[bone] = transform;
+        paletteDirty_ = true;
+    }
+}
+
+void SkinnedMesh::draw(const glm::mat4 &view, const glm::mat4 &projection)
+{
+    PROGRAM_TRACE_SCOPE("render", "SkinnedMesh::draw");
+
+    PROGRAM_ASSERT(palette_.size() == static_cast<std::size_t>(MaxBones));
+
+    if (texture_)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        texture_->bind();
+    }
+
+    shaderProgram_->use();
+    shaderProgram_->setValue<4, 4>("viewProjection", projection * view, false);
+
+    // Orphan the previous palette, the driver may still be reading it
+    if (paletteDirty_)
+    {
+        paletteBuffer_->bind();
+        paletteBuffer_->allocateBufferData(
+            palette_.data(),
+            static_cast<GLsizeiptr>(sizeof(glm::mat4) * palette_.size()));
+        paletteDirty_ = false;
+    }
+    paletteBuffer_->bindBase(PaletteBinding);
+
+    vertexArrayObject_->bind();
+    glDrawElements(GL_TRIANGLES, geometry_->indicesCount(), GL_UNSIGNED_INT, 0);
+    OpenGL::OpenGLStatistics &statistics{OpenGL::OpenGLStatistics::current()};
+    ++statistics.drawCalls;
+    statistics.triangles +=
+        static_cast<std::uint32_t>(geometry_->indicesCount() / 3);
+    vertexArrayObject_->release();
+}
+
+} // namespace Model
@@ -0,0 +1,103 @@
+#ifndef HOMEWORK01_MODEL_SKINNEDMESH_HPP_
+#define HOMEWORK01_MODEL_SKINNEDMESH_HPP_
+
+#include "Model/Geometry.hpp"
+#include "Model/MorphTarget.hpp"
+#include "OpenGL/OpenGLBufferObject.hpp"
+#include "OpenGL/OpenGLShaderProgram.hpp"
+#include "OpenGL/OpenGLTexture.hpp"
+#include "OpenGL/OpenGLVertexArrayObject.hpp"
+
+#include "glm/mat4x4.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Model
+{
+
+/**
+ * @brief Vertices of a skinned mesh, MeshData plus SkinnedMesh::Influences
+ * bone indices and weights per vertex.
+ */
+struct SkinData
+{
+    MeshData mesh;
+    std::vector<float> boneIndices;
+    std::vector<float> boneWeights;
+};
+
+/**
+ * @brief Append \a part to \a skin, every vertex fully bound to \a bone.
+ */
+void AppendRigidPart(const MeshData &part, int bone, SkinData &skin);
+
+/**
+ * @brief A mesh deformed by a palette of bone matrices, drawn in one call.
+ *
+ * @details Every vertex blends the transforms of up to
+ * SkinnedMesh::Influences bones, bound to attribute locations
+ * BoneIndicesAttribute and BoneWeightsAttribute, see
+ * Shader/SkinnedVertexShader.vs.glsl. The palette lives in a uniform buffer
+ * at binding PaletteBinding, SkinnedMesh::draw uploads it only after
+ * SkinnedMesh::setBone changed a bone. The skin is the full mesh and one
+ * draw, it has no levels of detail and is culled only as a whole.
+ * Positions are in the space every bone matrix maps from, for a part baked
+ * by AppendRigidPart the space of the part's own mesh.
+ */
+class SkinnedMesh
+{
+public:
+    using TextureType = OpenGL::OpenGLTexture;
+    using ShaderProgramType = OpenGL::OpenGLShaderProgram;
+
+    static constexpr int Influences = 4;
+    static constexpr int MaxBones = 64;
+    static constexpr GLuint BoneIndicesAttribute = 3;
+    static constexpr GLuint BoneWeightsAttribute = 4;
+    static constexpr GLuint PaletteBinding = 0;
+
+    /**
+     * @brief Upload \a skin drawn with \a texture by \a shaderProgram, a
+     * program built from Shader/SkinnedVertexShader.vs.glsl.
+     *
+     * @exception OpenGL::OpenGLException The shader has no palette block.
+     */
+    explicit SkinnedMesh(const SkinData &skin, ShaderProgramType &shaderProgram,
+                         TextureType *texture = nullptr);
+    ~SkinnedMesh();
+
+    SkinnedMesh(const SkinnedMesh &other) = delete;
+    SkinnedMesh &operator=(const SkinnedMesh &other) = delete;
+
+    /**
+     * @brief Gets the bone matrices, SkinnedMesh::MaxBones of them.
+     */
+    const std::vector<glm::mat4> &palette() const noexcept { return palette_; }
+    /**
+     * @brief Set the matrix of \a bone for the next SkinnedMesh::draw.
+     */
+    void setBone(int bone, const glm::mat4 &transform) noexcept;
+
+    /**
+     * @brief Upload the palette if a bone changed and draw every vertex.
+     */
+    void draw(const glm::mat4 &view, const glm::mat4 &projection);
+
+private:
+    std::shared_ptr<Geometry> geometry_;
+    ShaderProgramType *shaderProgram_;
+    TextureType *texture_;
+
+    std::unique_ptr<OpenGL::OpenGLVertexArrayObject> vertexArrayObject_;
+    std::unique_ptr<OpenGL::OpenGLBufferObject> boneIndexBuffer_;
+    std::unique_ptr<OpenGL::OpenGLBufferObject> boneWeightBuffer_;
+    std::unique_ptr<OpenGL::OpenGLBufferObject> paletteBuffer_;
+
+    std::vector<glm::mat4> palette_;
+    bool paletteDirty_;
+};
+
+} // namespace Model
+
+#endif // HOMEWORK01_MODEL_SKINNEDMESH_HPP_
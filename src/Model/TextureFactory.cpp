@@ -1,6 +1,7 @@
 #include "TextureFactory.hpp"
 
 #include "Utils/Compilers.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 
 PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_DISABLE_DOUBLEPROMOTION
@@ -38,6 +39,8 @@ GLenum rgbFormat(int channels) noexcept
 std::unique_ptr<OpenGL::OpenGLTexture>
 TextureFactory::loadFromFile(const char *fileName)
 {
+    PROGRAM_TRACE_SCOPE("loading", "TextureFactory::loadFromFile");
+
     int width, height, channels;
     stbi_set_flip_vertically_on_load(true);
     unsigned char *data{stbi_load(fileName, &width, &height, &channels, 0)};
@@ -3,9 +3,14 @@
 
 #include "OpenGLBufferObject.hpp"
 #include "OpenGLException.hpp"
+#include "OpenGLFramebuffer.hpp"
+#include "OpenGLHeadlessContext.hpp"
 #include "OpenGLModelObject.hpp"
+#include "OpenGLRenderTargetPool.hpp"
+#include "OpenGLRenderbuffer.hpp"
 #include "OpenGLShader.hpp"
 #include "OpenGLShaderProgram.hpp"
+#include "OpenGLStatistics.hpp"
 #include "OpenGLTexture.hpp"
 #include "OpenGLVertexArrayObject.hpp"
 
@@ -1,8 +1,10 @@
 #include "OpenGLBufferObject.hpp"
 
 #include "OpenGLException.hpp"
+#include "OpenGLStatistics.hpp"
 
 #include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 
 namespace OpenGL
 {
@@ -64,6 +66,8 @@ OpenGLBufferObject::~OpenGLBufferObject()
 void OpenGLBufferObject::allocateBufferData(const void *data,
                                             GLsizeiptr size) noexcept
 {
+    PROGRAM_TRACE_SCOPE("upload", "OpenGLBufferObject::allocateBufferData");
+
     PROGRAM_ASSERT(Detail::isCreated(id_));
 
     glBufferData(static_cast<GLenum>(type_), size, data,
@@ -74,9 +78,20 @@ void OpenGLBufferObject::bind() noexcept
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
 
+    ++OpenGLStatistics::current().bufferBinds;
+
     glBindBuffer(static_cast<GLenum>(type_), id_);
 }
 
+void OpenGLBufferObject::bindBase(GLuint index) noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    ++OpenGLStatistics::current().bufferBinds;
+
+    glBindBufferBase(static_cast<GLenum>(type_), index, id_);
+}
+
 void OpenGLBufferObject::create()
 {
     PROGRAM_ASSERT(!Detail::isCreated(id_));
@@ -91,6 +106,15 @@ void OpenGLBufferObject::create()
 
 GLuint OpenGLBufferObject::id() const noexcept { return id_; }
 
+void *OpenGLBufferObject::mapRange(GLintptr offset, GLsizeiptr length,
+                                   GLbitfield access) noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    return glMapBufferRange(static_cast<GLenum>(type_), offset, length,
+                            access);
+}
+
 void OpenGLBufferObject::release() noexcept
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
@@ -98,6 +122,13 @@ void OpenGLBufferObject::release() noexcept
     glBindBuffer(static_cast<GLenum>(type_), 0);
 }
 
+bool OpenGLBufferObject::unmap() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    return glUnmapBuffer(static_cast<GLenum>(type_)) == GL_TRUE;
+}
+
 void OpenGLBufferObject::tidy() noexcept
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
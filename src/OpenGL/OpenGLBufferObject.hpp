@@ -30,7 +30,15 @@ public:
         /**
          * \brief Index buffer object
          */
-        ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER
+        ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER,
+        /**
+         * \brief Pixel read-back target of glReadPixels
+         */
+        PixelPackBuffer = GL_PIXEL_PACK_BUFFER,
+        /**
+         * \brief Storage of a uniform block
+         */
+        UniformBuffer = GL_UNIFORM_BUFFER
     };
 
     /**
@@ -133,6 +141,33 @@ public:
      */
     void allocateBufferData(const void *data, GLsizeiptr size) noexcept;
 
+    /**
+     * \brief Map \a length bytes of the data storage starting from \a offset
+     * into the client address space.
+     *
+     * \par Note:
+     * The OpenGLBufferObject must be bound, and must be unmapped before it
+     * is used by OpenGL again.
+     *
+     * \param offset Offset of the range in bytes.
+     * \param length Length of the range in bytes.
+     * \param access Combination of GL_MAP_READ_BIT, GL_MAP_WRITE_BIT, etc.
+     *
+     * \return Pointer to the mapped range, \c nullptr on failure.
+     *
+     * \sa unmap
+     */
+    void *mapRange(GLintptr offset, GLsizeiptr length,
+                   GLbitfield access) noexcept;
+    /**
+     * \brief Unmap the data storage mapped by mapRange.
+     *
+     * \return \c false if the content was corrupted while it was mapped.
+     *
+     * \sa mapRange
+     */
+    bool unmap() noexcept;
+
     /**
      * \brief Bind the OpenGLBufferObject to the current OpenGL content.
      *
@@ -156,6 +191,15 @@ public:
      * \sa bind
      */
     void release() noexcept;
+    /**
+     * \brief Bind the OpenGLBufferObject to the indexed binding point \a index
+     * of its type, e.g. the uniform block binding of a shader.
+     *
+     * \param index Index of the binding point.
+     *
+     * \sa OpenGLShaderProgram::setUniformBlockBinding
+     */
+    void bindBase(GLuint index) noexcept;
 
     /**
      * \brief Gets the id of the OpenGLBufferObject
@@ -0,0 +1,168 @@
+#include "OpenGLFramebuffer.hpp"
+
+#include "OpenGLException.hpp"
+
+#include "Utils/Global.hpp"
+#include "Utils/StringFormat/StringFormat.hpp"
+
+#include <utility>
+
+namespace OpenGL
+{
+
+namespace Detail
+{
+
+constexpr GLuint noId{0};
+
+bool isCreated(GLuint id) noexcept;
+const char *statusName(GLenum status) noexcept;
+
+inline bool isCreated(GLuint id) noexcept { return static_cast<bool>(id); }
+
+const char *statusName(GLenum status) noexcept
+{
+    switch (status)
+    {
+    case GL_FRAMEBUFFER_COMPLETE:
+        return "GL_FRAMEBUFFER_COMPLETE";
+    case GL_FRAMEBUFFER_UNDEFINED:
+        return "GL_FRAMEBUFFER_UNDEFINED";
+    case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
+        return "GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT";
+    case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
+        return "GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT";
+    case GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER:
+        return "GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER";
+    case GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER:
+        return "GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER";
+    case GL_FRAMEBUFFER_UNSUPPORTED:
+        return "GL_FRAMEBUFFER_UNSUPPORTED";
+    case GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE:
+        return "GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE";
+    case GL_FRAMEBUFFER_INCOMPLETE_LAYER_TARGETS:
+        return "GL_FRAMEBUFFER_INCOMPLETE_LAYER_TARGETS";
+    default:
+        return "unknown status";
+    }
+}
+
+} // namespace Detail
+
+OpenGLFramebuffer::OpenGLFramebuffer() : id_{Detail::noId} { create(); }
+
+OpenGLFramebuffer::OpenGLFramebuffer(OpenGLFramebuffer &&other) noexcept
+    : id_{std::move(other.id_)}
+{
+    other.id_ = Detail::noId; // Avoid double deletion
+}
+
+OpenGLFramebuffer &
+OpenGLFramebuffer::operator=(OpenGLFramebuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (Detail::isCreated(id_))
+        {
+            tidy();
+        }
+
+        id_ = std::move(other.id_);
+
+        other.id_ = Detail::noId; // Avoid double deletion
+    }
+
+    return *this;
+}
+
+OpenGLFramebuffer::~OpenGLFramebuffer()
+{
+    if (Detail::isCreated(id_))
+    {
+        tidy();
+    }
+}
+
+void OpenGLFramebuffer::attachRenderbuffer(
+    GLenum attachment, OpenGLRenderbuffer &renderbuffer) noexcept
+{
+    bind();
+
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER,
+                              renderbuffer.id());
+}
+
+void OpenGLFramebuffer::attachTexture(GLenum attachment,
+                                      OpenGLTexture &texture,
+                                      GLint level) noexcept
+{
+    bind();
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D,
+                           texture.id(), level);
+}
+
+void OpenGLFramebuffer::bind(Target target) noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glBindFramebuffer(static_cast<GLenum>(target), id_);
+}
+
+void OpenGLFramebuffer::checkComplete()
+{
+    const GLenum framebufferStatus{status()};
+
+    if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw OpenGLException(StringFormat::StringFormat(
+            "OpenGLFramebuffer is incomplete: %s.",
+            Detail::statusName(framebufferStatus)));
+    }
+}
+
+void OpenGLFramebuffer::create()
+{
+    PROGRAM_ASSERT(!Detail::isCreated(id_));
+
+    glGenFramebuffers(1, &id_);
+
+    if (!Detail::isCreated(id_))
+    {
+        throw OpenGLException("OpenGLFramebuffer failed to instantiate.");
+    }
+}
+
+void OpenGLFramebuffer::detach(GLenum attachment) noexcept
+{
+    bind();
+
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, 0);
+}
+
+GLuint OpenGLFramebuffer::id() const noexcept { return id_; }
+
+void OpenGLFramebuffer::release(Target target) noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glBindFramebuffer(static_cast<GLenum>(target), 0);
+}
+
+GLenum OpenGLFramebuffer::status() noexcept
+{
+    bind();
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER);
+}
+
+void OpenGLFramebuffer::tidy() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glDeleteFramebuffers(1, &id_);
+
+    id_ = Detail::noId;
+}
+
+} // namespace OpenGL
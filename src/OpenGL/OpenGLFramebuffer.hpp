@@ -0,0 +1,150 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLFRAMEBUFFER_HPP_
+#define HOMEWORK01_OPENGL_OPENGLFRAMEBUFFER_HPP_
+
+#include "OpenGLRenderbuffer.hpp"
+#include "OpenGLTexture.hpp"
+
+#include "glad/glad.h"
+
+namespace OpenGL
+{
+
+/**
+ * \brief This class represents the OpenGL framebuffer object.
+ *
+ * \details The framebuffer does not own its attachments, they must outlive
+ * it or be detached first.
+ *
+ * \par Warning:
+ * This class is not thread safe. Please use it under the same thread which
+ * creates OpenGL content.
+ *
+ * \sa OpenGLRenderbuffer, OpenGLRenderTargetPool
+ */
+class OpenGLFramebuffer
+{
+public:
+    /**
+     *  \brief This enum represents the binding target of OpenGLFramebuffer.
+     */
+    enum Target
+    {
+        /**
+         * \brief Both draw and read framebuffer
+         */
+        Framebuffer = GL_FRAMEBUFFER,
+        /**
+         * \brief Destination of the rendering
+         */
+        DrawFramebuffer = GL_DRAW_FRAMEBUFFER,
+        /**
+         * \brief Source of glReadPixels and glBlitFramebuffer
+         */
+        ReadFramebuffer = GL_READ_FRAMEBUFFER
+    };
+
+    /**
+     * \brief Initializes a new instance of the OpenGLFramebuffer class.
+     *
+     * \exception OpenGLException Framebuffer failed to instantiate.
+     */
+    explicit OpenGLFramebuffer();
+
+    /**
+     * \brief Initializes a new instance of the OpenGLFramebuffer class with
+     * the content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLFramebuffer(OpenGLFramebuffer &&other) noexcept;
+    /**
+     * \brief Initializes a new instance of the OpenGLFramebuffer class with
+     * the content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLFramebuffer &operator=(OpenGLFramebuffer &&other) noexcept;
+    /**
+     * \brief Destroy the instance of the OpenGLFramebuffer class.
+     */
+    ~OpenGLFramebuffer();
+
+    OpenGLFramebuffer(const OpenGLFramebuffer &other) = delete;
+    OpenGLFramebuffer &operator=(const OpenGLFramebuffer &other) = delete;
+
+    /**
+     * \brief Bind the OpenGLFramebuffer to \a target.
+     *
+     * \sa release
+     */
+    void bind(Target target = Target::Framebuffer) noexcept;
+    /**
+     * \brief Bind the default framebuffer to \a target.
+     *
+     * \sa bind
+     */
+    void release(Target target = Target::Framebuffer) noexcept;
+
+    /**
+     * \brief Attach \a renderbuffer at \a attachment, e.g. \c
+     * GL_COLOR_ATTACHMENT0 or \c GL_DEPTH_STENCIL_ATTACHMENT.
+     *
+     * \par Note:
+     * The framebuffer is left bound to \c GL_FRAMEBUFFER.
+     */
+    void attachRenderbuffer(GLenum attachment,
+                            OpenGLRenderbuffer &renderbuffer) noexcept;
+    /**
+     * \brief Attach the \a level mipmap of \a texture at \a attachment.
+     *
+     * \par Note:
+     * The framebuffer is left bound to \c GL_FRAMEBUFFER.
+     */
+    void attachTexture(GLenum attachment, OpenGLTexture &texture,
+                       GLint level = 0) noexcept;
+    /**
+     * \brief Remove whatever is attached at \a attachment.
+     */
+    void detach(GLenum attachment) noexcept;
+
+    /**
+     * \brief Gets the completeness status of the framebuffer, \c
+     * GL_FRAMEBUFFER_COMPLETE if it can be rendered to.
+     */
+    GLenum status() noexcept;
+    /**
+     * \brief Throw if the framebuffer is not complete.
+     *
+     * \exception OpenGLException Framebuffer is incomplete, the message names
+     * the status.
+     */
+    void checkComplete();
+
+    /**
+     * \brief Gets the id of the OpenGLFramebuffer
+     *
+     * \return Specified id.
+     */
+    GLuint id() const noexcept;
+
+private:
+    /**
+     * \brief Create the framebuffer.
+     *
+     * \exception OpenGLException Framebuffer failed to instantiate.
+     */
+    void create();
+    /**
+     * \brief Clean up and delete the framebuffer.
+     */
+    void tidy() noexcept;
+
+    /**
+     * \brief The id of the OpenGLFramebuffer.
+     */
+    GLuint id_;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLFRAMEBUFFER_HPP_
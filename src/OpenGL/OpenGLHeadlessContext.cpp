@@ -0,0 +1,203 @@
+#include "OpenGLHeadlessContext.hpp"
+
+#include "OpenGLException.hpp"
+
+#include "Utils/Global.hpp"
+
+#ifdef PROGRAM_HAS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace OpenGL
+{
+
+OpenGLHeadlessContext::OpenGLHeadlessContext(int majorVersion,
+                                             int minorVersion)
+    : display_{nullptr}, context_{nullptr}, framebuffer_{nullptr},
+      colorRenderbuffer_{nullptr}, depthRenderbuffer_{nullptr}, width_{0},
+      height_{0}
+{
+    create(majorVersion, minorVersion);
+}
+
+OpenGLHeadlessContext::~OpenGLHeadlessContext() { tidy(); }
+
+#ifdef PROGRAM_HAS_EGL
+
+void OpenGLHeadlessContext::create(int majorVersion, int minorVersion)
+{
+    EGLDisplay display{EGL_NO_DISPLAY};
+
+    // Prefer the surfaceless platform, it never touches X11, Wayland or DRM
+    auto getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+    {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                     EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        throw OpenGLException("OpenGLHeadlessContext failed to get a display.");
+    }
+    display_ = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        tidy();
+        throw OpenGLException(
+            "OpenGLHeadlessContext failed to bind the OpenGL API.");
+    }
+
+    const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                       EGL_NONE};
+    EGLConfig config{nullptr};
+    EGLint configCount{0};
+    if (!eglChooseConfig(display, configAttributes, &config, 1,
+                         &configCount) ||
+        configCount < 1)
+    {
+        // Surfaceless contexts do not need a config
+        config = EGL_NO_CONFIG_KHR;
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION,
+        majorVersion,
+        EGL_CONTEXT_MINOR_VERSION,
+        minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK,
+        EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    context_ = eglCreateContext(display, config, EGL_NO_CONTEXT,
+                                contextAttributes);
+    if (context_ == EGL_NO_CONTEXT)
+    {
+        context_ = nullptr;
+        tidy();
+        throw OpenGLException(
+            "OpenGLHeadlessContext failed to create the context.");
+    }
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context_))
+    {
+        tidy();
+        throw OpenGLException(
+            "OpenGLHeadlessContext failed to make the context current.");
+    }
+}
+
+void *OpenGLHeadlessContext::getProcAddress(const char *name)
+{
+    return reinterpret_cast<void *>(eglGetProcAddress(name));
+}
+
+void OpenGLHeadlessContext::tidy() noexcept
+{
+    tidyFramebuffer();
+
+    if (display_)
+    {
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                       EGL_NO_CONTEXT);
+        if (context_)
+        {
+            eglDestroyContext(display_, context_);
+            context_ = nullptr;
+        }
+        eglTerminate(display_);
+        display_ = nullptr;
+    }
+}
+
+#else
+
+void OpenGLHeadlessContext::create(int majorVersion, int minorVersion)
+{
+    PROGRAM_MAYBE_UNUSED(majorVersion)
+    PROGRAM_MAYBE_UNUSED(minorVersion)
+
+    throw OpenGLException(
+        "OpenGLHeadlessContext is not available, the program was built "
+        "without EGL.");
+}
+
+void *OpenGLHeadlessContext::getProcAddress(const char *name)
+{
+    PROGRAM_MAYBE_UNUSED(name)
+
+    return nullptr;
+}
+
+void OpenGLHeadlessContext::tidy() noexcept {}
+
+#endif
+
+void OpenGLHeadlessContext::createFramebuffer(GLsizei width, GLsizei height)
+{
+    PROGRAM_ASSERT(context_);
+    PROGRAM_ASSERT(!framebuffer_);
+
+    width_ = width;
+    height_ = height;
+
+    colorRenderbuffer_.reset(new OpenGLRenderbuffer{GL_RGBA8, width, height});
+    depthRenderbuffer_.reset(
+        new OpenGLRenderbuffer{GL_DEPTH24_STENCIL8, width, height});
+
+    framebuffer_.reset(new OpenGLFramebuffer{});
+    framebuffer_->attachRenderbuffer(GL_COLOR_ATTACHMENT0,
+                                     *colorRenderbuffer_);
+    framebuffer_->attachRenderbuffer(GL_DEPTH_STENCIL_ATTACHMENT,
+                                     *depthRenderbuffer_);
+
+    try
+    {
+        framebuffer_->checkComplete();
+    }
+    catch (OpenGLException &)
+    {
+        tidyFramebuffer();
+        throw;
+    }
+
+    glViewport(0, 0, width, height);
+}
+
+void OpenGLHeadlessContext::bindFramebuffer() noexcept
+{
+    PROGRAM_ASSERT(framebuffer_);
+
+    framebuffer_->bind();
+}
+
+OpenGLFramebuffer &OpenGLHeadlessContext::framebuffer() noexcept
+{
+    return *framebuffer_;
+}
+
+void OpenGLHeadlessContext::tidyFramebuffer() noexcept
+{
+    if (framebuffer_)
+    {
+        framebuffer_->release();
+    }
+
+    framebuffer_.reset();
+    colorRenderbuffer_.reset();
+    depthRenderbuffer_.reset();
+}
+
+GLsizei OpenGLHeadlessContext::width() const noexcept { return width_; }
+
+GLsizei OpenGLHeadlessContext::height() const noexcept { return height_; }
+
+} // namespace OpenGL
@@ -0,0 +1,97 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLHEADLESSCONTEXT_HPP_
+#define HOMEWORK01_OPENGL_OPENGLHEADLESSCONTEXT_HPP_
+
+#include "OpenGLFramebuffer.hpp"
+#include "OpenGLRenderbuffer.hpp"
+
+#include "glad/glad.h"
+
+#include <memory>
+
+namespace OpenGL
+{
+
+/**
+ * \brief This class represents an OpenGL context without any window.
+ *
+ * \details The context is created through EGL on the Mesa surfaceless
+ * platform, so it works on servers without a display or a GPU (Mesa llvmpipe).
+ * Since there is no default framebuffer, rendering goes to an offscreen
+ * framebuffer object of the requested size.
+ *
+ * \par Warning:
+ * This class is not thread safe. Please use it under the same thread which
+ * creates OpenGL content.
+ */
+class OpenGLHeadlessContext
+{
+public:
+    /**
+     * \brief Initializes a new instance of the OpenGLHeadlessContext class
+     * and make it current on the calling thread.
+     *
+     * \param majorVersion Requested OpenGL major version.
+     * \param minorVersion Requested OpenGL minor version.
+     *
+     * \exception OpenGLException Context failed to instantiate, or the build
+     * has no EGL support.
+     */
+    explicit OpenGLHeadlessContext(int majorVersion, int minorVersion);
+    /**
+     * \brief Destroy the offscreen framebuffer and the context.
+     */
+    ~OpenGLHeadlessContext();
+
+    OpenGLHeadlessContext(OpenGLHeadlessContext &&other) = delete;
+    OpenGLHeadlessContext &operator=(OpenGLHeadlessContext &&other) = delete;
+    OpenGLHeadlessContext(const OpenGLHeadlessContext &other) = delete;
+    OpenGLHeadlessContext &operator=(const OpenGLHeadlessContext &other) =
+        delete;
+
+    /**
+     * \brief Create the offscreen framebuffer of \a width x \a height pixels.
+     *
+     * \par Note:
+     * OpenGL functions must be loaded (see getProcAddress) before calling
+     * this function.
+     *
+     * \exception OpenGLException Framebuffer is incomplete.
+     */
+    void createFramebuffer(GLsizei width, GLsizei height);
+    /**
+     * \brief Bind the offscreen framebuffer as the render target.
+     */
+    void bindFramebuffer() noexcept;
+    /**
+     * \brief Gets the offscreen framebuffer.
+     */
+    OpenGLFramebuffer &framebuffer() noexcept;
+
+    /**
+     * \brief Gets the address of the OpenGL function \a name, usable as
+     * GLADloadproc.
+     */
+    static void *getProcAddress(const char *name);
+
+    GLsizei width() const noexcept;
+    GLsizei height() const noexcept;
+
+private:
+    void create(int majorVersion, int minorVersion);
+    void tidy() noexcept;
+    void tidyFramebuffer() noexcept;
+
+    void *display_;
+    void *context_;
+
+    std::unique_ptr<OpenGLFramebuffer> framebuffer_;
+    std::unique_ptr<OpenGLRenderbuffer> colorRenderbuffer_;
+    std::unique_ptr<OpenGLRenderbuffer> depthRenderbuffer_;
+
+    GLsizei width_;
+    GLsizei height_;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLHEADLESSCONTEXT_HPP_
@@ -0,0 +1,134 @@
+#include "OpenGLQuery.hpp"
+
+#include "OpenGLException.hpp"
+
+#include "Utils/Global.hpp"
+
+#include <utility>
+
+namespace OpenGL
+{
+
+namespace Detail
+{
+
+constexpr GLuint noId{0};
+
+bool isCreated(GLuint id) noexcept;
+
+inline bool isCreated(GLuint id) noexcept { return static_cast<bool>(id); }
+
+} // namespace Detail
+
+OpenGLQuery::OpenGLQuery(GLenum target)
+    : id_{Detail::noId}, target_{target}, pending_{false}
+{
+    create();
+}
+
+OpenGLQuery::OpenGLQuery(OpenGLQuery &&other) noexcept
+    : id_{std::move(other.id_)}, target_{std::move(other.target_)},
+      pending_{std::move(other.pending_)}
+{
+    other.id_ = Detail::noId; // Avoid double deletion
+    other.pending_ = false;
+}
+
+OpenGLQuery &OpenGLQuery::operator=(OpenGLQuery &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (Detail::isCreated(id_))
+        {
+            tidy();
+        }
+
+        id_ = std::move(other.id_);
+        target_ = std::move(other.target_);
+        pending_ = std::move(other.pending_);
+
+        other.id_ = Detail::noId; // Avoid double deletion
+        other.pending_ = false;
+    }
+
+    return *this;
+}
+
+OpenGLQuery::~OpenGLQuery()
+{
+    if (Detail::isCreated(id_))
+    {
+        tidy();
+    }
+}
+
+void OpenGLQuery::begin() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glBeginQuery(target_, id_);
+}
+
+void OpenGLQuery::create()
+{
+    PROGRAM_ASSERT(!Detail::isCreated(id_));
+
+    glGenQueries(1, &id_);
+
+    if (!Detail::isCreated(id_))
+    {
+        throw OpenGLException("OpenGLQuery failed to instantiate.");
+    }
+}
+
+void OpenGLQuery::end() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glEndQuery(target_);
+    pending_ = true;
+}
+
+GLuint OpenGLQuery::id() const noexcept { return id_; }
+
+bool OpenGLQuery::isPending() const noexcept { return pending_; }
+
+bool OpenGLQuery::isResultAvailable() const noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    if (!pending_)
+    {
+        return false;
+    }
+
+    GLuint available{GL_FALSE};
+    glGetQueryObjectuiv(id_, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    return available != GL_FALSE;
+}
+
+GLuint OpenGLQuery::result() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    GLuint value{0};
+    glGetQueryObjectuiv(id_, GL_QUERY_RESULT, &value);
+    pending_ = false;
+
+    return value;
+}
+
+GLenum OpenGLQuery::target() const noexcept { return target_; }
+
+void OpenGLQuery::tidy() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glDeleteQueries(1, &id_);
+
+    id_ = Detail::noId;
+    pending_ = false;
+}
+
+} // namespace OpenGL
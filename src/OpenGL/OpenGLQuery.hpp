@@ -0,0 +1,118 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLQUERY_HPP_
+#define HOMEWORK01_OPENGL_OPENGLQUERY_HPP_
+
+#include "glad/glad.h"
+
+namespace OpenGL
+{
+
+/**
+ * \brief This class represents the OpenGL query object.
+ *
+ * \details A query counts what the draws between begin and end produce, e.g.
+ * whether any sample passed the depth test for \c GL_ANY_SAMPLES_PASSED. The
+ * result arrives some time after end, poll isResultAvailable instead of
+ * stalling the pipeline on result.
+ *
+ * \par Warning:
+ * This class is not thread safe. Please use it under the same thread which
+ * creates OpenGL content.
+ */
+class OpenGLQuery
+{
+public:
+    /**
+     * \brief Initializes a new instance of the OpenGLQuery class.
+     *
+     * \param target Query target, e.g. \c GL_ANY_SAMPLES_PASSED or \c
+     * GL_TIME_ELAPSED.
+     *
+     * \exception OpenGLException Query failed to instantiate.
+     */
+    explicit OpenGLQuery(GLenum target = GL_ANY_SAMPLES_PASSED);
+
+    /**
+     * \brief Initializes a new instance of the OpenGLQuery class with the
+     * content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLQuery(OpenGLQuery &&other) noexcept;
+    /**
+     * \brief Initializes a new instance of the OpenGLQuery class with the
+     * content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLQuery &operator=(OpenGLQuery &&other) noexcept;
+    /**
+     * \brief Destroy the instance of the OpenGLQuery class.
+     */
+    ~OpenGLQuery();
+
+    OpenGLQuery(const OpenGLQuery &other) = delete;
+    OpenGLQuery &operator=(const OpenGLQuery &other) = delete;
+
+    /**
+     * \brief Start counting the draws which follow, only one query per target
+     * may be active.
+     *
+     * \sa end
+     */
+    void begin() noexcept;
+    /**
+     * \brief Stop counting, the query is pending until its result is read.
+     *
+     * \sa begin
+     */
+    void end() noexcept;
+
+    /**
+     * \brief Gets whether the query ended and its result was not read yet.
+     */
+    bool isPending() const noexcept;
+    /**
+     * \brief Gets whether the result of the pending query arrived, never
+     * waits for the GPU.
+     */
+    bool isResultAvailable() const noexcept;
+    /**
+     * \brief Gets the result of the pending query, waits for the GPU if it
+     * has not arrived yet.
+     *
+     * \return Specified result, the query is no longer pending.
+     */
+    GLuint result() noexcept;
+
+    /**
+     * \brief Gets the id of the OpenGLQuery
+     *
+     * \return Specified id.
+     */
+    GLuint id() const noexcept;
+    GLenum target() const noexcept;
+
+private:
+    /**
+     * \brief Create the query.
+     *
+     * \exception OpenGLException Query failed to instantiate.
+     */
+    void create();
+    /**
+     * \brief Clean up and delete the query.
+     */
+    void tidy() noexcept;
+
+    /**
+     * \brief The id of the OpenGLQuery.
+     */
+    GLuint id_;
+
+    GLenum target_;
+    bool pending_;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLQUERY_HPP_
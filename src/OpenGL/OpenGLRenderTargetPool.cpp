@@ -0,0 +1,141 @@
+#include "OpenGLRenderTargetPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenGL
+{
+
+std::unique_ptr<OpenGLRenderbuffer>
+OpenGLRenderTargetPool::acquireRenderbuffer(GLenum internalFormat,
+                                            GLsizei width, GLsizei height,
+                                            GLsizei samples)
+{
+    for (auto it = renderbuffers_.begin(); it != renderbuffers_.end(); ++it)
+    {
+        const OpenGLRenderbuffer &candidate{*(it->object)};
+
+        if (candidate.internalFormat() == internalFormat &&
+            candidate.width() == width && candidate.height() == height &&
+            candidate.samples() == samples)
+        {
+            std::unique_ptr<OpenGLRenderbuffer> renderbuffer{
+                std::move(it->object)};
+            renderbuffers_.erase(it);
+
+            return renderbuffer;
+        }
+    }
+
+    ++createdCount_;
+
+    return std::unique_ptr<OpenGLRenderbuffer>{
+        new OpenGLRenderbuffer{internalFormat, width, height, samples}};
+}
+
+std::unique_ptr<OpenGLTexture>
+OpenGLRenderTargetPool::acquireTexture(GLenum internalFormat, GLenum format,
+                                       GLenum type, GLsizei width,
+                                       GLsizei height)
+{
+    for (auto it = textures_.begin(); it != textures_.end(); ++it)
+    {
+        const OpenGLTexture &candidate{*(it->object)};
+
+        if (candidate.format() == internalFormat &&
+            candidate.width() == width && candidate.height() == height)
+        {
+            std::unique_ptr<OpenGLTexture> texture{std::move(it->object)};
+            textures_.erase(it);
+
+            return texture;
+        }
+    }
+
+    ++createdCount_;
+
+    return std::unique_ptr<OpenGLTexture>{
+        new OpenGLTexture{width, height, internalFormat, format, type}};
+}
+
+std::unique_ptr<OpenGLFramebuffer> OpenGLRenderTargetPool::acquireFramebuffer()
+{
+    if (!framebuffers_.empty())
+    {
+        std::unique_ptr<OpenGLFramebuffer> framebuffer{
+            std::move(framebuffers_.back().object)};
+        framebuffers_.pop_back();
+
+        return framebuffer;
+    }
+
+    ++createdCount_;
+
+    return std::unique_ptr<OpenGLFramebuffer>{new OpenGLFramebuffer{}};
+}
+
+void OpenGLRenderTargetPool::release(
+    std::unique_ptr<OpenGLRenderbuffer> renderbuffer)
+{
+    if (renderbuffer)
+    {
+        renderbuffers_.push_back({std::move(renderbuffer), frame_});
+    }
+}
+
+void OpenGLRenderTargetPool::release(std::unique_ptr<OpenGLTexture> texture)
+{
+    if (texture)
+    {
+        textures_.push_back({std::move(texture), frame_});
+    }
+}
+
+void OpenGLRenderTargetPool::release(
+    std::unique_ptr<OpenGLFramebuffer> framebuffer)
+{
+    if (framebuffer)
+    {
+        framebuffers_.push_back({std::move(framebuffer), frame_});
+    }
+}
+
+template <typename T>
+void OpenGLRenderTargetPool::evict(std::vector<Entry<T>> &entries,
+                                   std::uint64_t frame)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [frame](const Entry<T> &entry) {
+                                     return frame - entry.releasedFrame >
+                                            MaxIdleFrames;
+                                 }),
+                  entries.end());
+}
+
+void OpenGLRenderTargetPool::endFrame()
+{
+    ++frame_;
+
+    evict(renderbuffers_, frame_);
+    evict(textures_, frame_);
+    evict(framebuffers_, frame_);
+}
+
+void OpenGLRenderTargetPool::clear() noexcept
+{
+    renderbuffers_.clear();
+    textures_.clear();
+    framebuffers_.clear();
+}
+
+std::size_t OpenGLRenderTargetPool::size() const noexcept
+{
+    return renderbuffers_.size() + textures_.size() + framebuffers_.size();
+}
+
+std::uint64_t OpenGLRenderTargetPool::createdCount() const noexcept
+{
+    return createdCount_;
+}
+
+} // namespace OpenGL
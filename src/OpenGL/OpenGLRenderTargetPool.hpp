@@ -0,0 +1,108 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLRENDERTARGETPOOL_HPP_
+#define HOMEWORK01_OPENGL_OPENGLRENDERTARGETPOOL_HPP_
+
+#include "OpenGLFramebuffer.hpp"
+#include "OpenGLRenderbuffer.hpp"
+#include "OpenGLTexture.hpp"
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace OpenGL
+{
+
+/**
+ * \brief This class recycles framebuffers and their attachments across
+ * frames.
+ *
+ * \details Offscreen passes acquire what they need each frame and release it
+ * when done. Released objects are kept and handed out again to the next
+ * request with the same size and format, so steady state rendering does not
+ * create or delete any OpenGL object. Objects which have not been requested
+ * for OpenGLRenderTargetPool::MaxIdleFrames frames are deleted by endFrame.
+ *
+ * \par Warning:
+ * This class is not thread safe. Please use it under the same thread which
+ * creates OpenGL content.
+ */
+class OpenGLRenderTargetPool
+{
+public:
+    static constexpr std::uint64_t MaxIdleFrames = 60;
+
+    explicit OpenGLRenderTargetPool() = default;
+
+    OpenGLRenderTargetPool(const OpenGLRenderTargetPool &other) = delete;
+    OpenGLRenderTargetPool &
+    operator=(const OpenGLRenderTargetPool &other) = delete;
+
+    /**
+     * \brief Gets a renderbuffer of \a internalFormat, \a width x \a height
+     * and \a samples, recycled if one is available.
+     */
+    std::unique_ptr<OpenGLRenderbuffer>
+    acquireRenderbuffer(GLenum internalFormat, GLsizei width, GLsizei height,
+                        GLsizei samples = 0);
+    /**
+     * \brief Gets a texture of \a internalFormat, \a width x \a height,
+     * recycled if one is available. \a format and \a type are only used when
+     * a new texture is created.
+     */
+    std::unique_ptr<OpenGLTexture> acquireTexture(GLenum internalFormat,
+                                                  GLenum format, GLenum type,
+                                                  GLsizei width,
+                                                  GLsizei height);
+    /**
+     * \brief Gets a framebuffer, recycled if one is available. Its previous
+     * attachments are left in place and must be replaced by the caller.
+     */
+    std::unique_ptr<OpenGLFramebuffer> acquireFramebuffer();
+
+    void release(std::unique_ptr<OpenGLRenderbuffer> renderbuffer);
+    void release(std::unique_ptr<OpenGLTexture> texture);
+    void release(std::unique_ptr<OpenGLFramebuffer> framebuffer);
+
+    /**
+     * \brief Advance the frame counter and delete idle objects.
+     */
+    void endFrame();
+    /**
+     * \brief Delete every pooled object.
+     */
+    void clear() noexcept;
+
+    /**
+     * \brief Gets the number of objects waiting in the pool.
+     */
+    std::size_t size() const noexcept;
+    /**
+     * \brief Gets the number of objects created because no pooled object
+     * matched, a steady state frame adds none.
+     */
+    std::uint64_t createdCount() const noexcept;
+
+private:
+    template <typename T>
+    struct Entry
+    {
+        std::unique_ptr<T> object;
+        std::uint64_t releasedFrame;
+    };
+
+    template <typename T>
+    static void evict(std::vector<Entry<T>> &entries, std::uint64_t frame);
+
+    std::vector<Entry<OpenGLRenderbuffer>> renderbuffers_;
+    std::vector<Entry<OpenGLTexture>> textures_;
+    std::vector<Entry<OpenGLFramebuffer>> framebuffers_;
+
+    std::uint64_t frame_ = 0;
+    std::uint64_t createdCount_ = 0;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLRENDERTARGETPOOL_HPP_
@@ -0,0 +1,133 @@
+#include "OpenGLRenderbuffer.hpp"
+
+#include "OpenGLException.hpp"
+
+#include "Utils/Global.hpp"
+
+#include <utility>
+
+namespace OpenGL
+{
+
+namespace Detail
+{
+
+constexpr GLuint noId{0};
+
+bool isCreated(GLuint id) noexcept;
+
+inline bool isCreated(GLuint id) noexcept { return static_cast<bool>(id); }
+
+} // namespace Detail
+
+OpenGLRenderbuffer::OpenGLRenderbuffer(GLenum internalFormat, GLsizei width,
+                                       GLsizei height, GLsizei samples)
+    : id_{Detail::noId}, internalFormat_{internalFormat}, width_{width},
+      height_{height}, samples_{samples}
+{
+    create();
+}
+
+OpenGLRenderbuffer::OpenGLRenderbuffer(OpenGLRenderbuffer &&other) noexcept
+    : id_{std::move(other.id_)},
+      internalFormat_{std::move(other.internalFormat_)},
+      width_{std::move(other.width_)}, height_{std::move(other.height_)},
+      samples_{std::move(other.samples_)}
+{
+    other.id_ = Detail::noId; // Avoid double deletion
+}
+
+OpenGLRenderbuffer &
+OpenGLRenderbuffer::operator=(OpenGLRenderbuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (Detail::isCreated(id_))
+        {
+            tidy();
+        }
+
+        id_ = std::move(other.id_);
+        internalFormat_ = std::move(other.internalFormat_);
+        width_ = std::move(other.width_);
+        height_ = std::move(other.height_);
+        samples_ = std::move(other.samples_);
+
+        other.id_ = Detail::noId; // Avoid double deletion
+    }
+
+    return *this;
+}
+
+OpenGLRenderbuffer::~OpenGLRenderbuffer()
+{
+    if (Detail::isCreated(id_))
+    {
+        tidy();
+    }
+}
+
+void OpenGLRenderbuffer::bind() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glBindRenderbuffer(GL_RENDERBUFFER, id_);
+}
+
+void OpenGLRenderbuffer::create()
+{
+    PROGRAM_ASSERT(!Detail::isCreated(id_));
+
+    glGenRenderbuffers(1, &id_);
+
+    if (!Detail::isCreated(id_))
+    {
+        throw OpenGLException("OpenGLRenderbuffer failed to instantiate.");
+    }
+
+    bind();
+
+    if (samples_ > 0)
+    {
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples_,
+                                         internalFormat_, width_, height_);
+    }
+    else
+    {
+        glRenderbufferStorage(GL_RENDERBUFFER, internalFormat_, width_,
+                              height_);
+    }
+
+    release();
+}
+
+GLuint OpenGLRenderbuffer::id() const noexcept { return id_; }
+
+GLenum OpenGLRenderbuffer::internalFormat() const noexcept
+{
+    return internalFormat_;
+}
+
+GLsizei OpenGLRenderbuffer::width() const noexcept { return width_; }
+
+GLsizei OpenGLRenderbuffer::height() const noexcept { return height_; }
+
+GLsizei OpenGLRenderbuffer::samples() const noexcept { return samples_; }
+
+void OpenGLRenderbuffer::release() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+void OpenGLRenderbuffer::tidy() noexcept
+{
+    PROGRAM_ASSERT(Detail::isCreated(id_));
+
+    glDeleteRenderbuffers(1, &id_);
+
+    id_ = Detail::noId;
+}
+
+} // namespace OpenGL
@@ -0,0 +1,110 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLRENDERBUFFER_HPP_
+#define HOMEWORK01_OPENGL_OPENGLRENDERBUFFER_HPP_
+
+#include "glad/glad.h"
+
+namespace OpenGL
+{
+
+/**
+ * \brief This class represents the OpenGL renderbuffer object.
+ *
+ * \details A renderbuffer is an image which can only be used as a
+ * framebuffer attachment, e.g. a depth buffer which is never sampled.
+ *
+ * \par Warning:
+ * This class is not thread safe. Please use it under the same thread which
+ * creates OpenGL content.
+ *
+ * \sa OpenGLFramebuffer
+ */
+class OpenGLRenderbuffer
+{
+public:
+    /**
+     * \brief Initializes a new instance of the OpenGLRenderbuffer class and
+     * allocate its storage.
+     *
+     * \param internalFormat Sized internal format, e.g. \c GL_RGBA8 or \c
+     * GL_DEPTH24_STENCIL8.
+     * \param width Width in pixels.
+     * \param height Height in pixels.
+     * \param samples Number of samples, 0 for a single sampled storage.
+     *
+     * \exception OpenGLException Renderbuffer failed to instantiate.
+     */
+    explicit OpenGLRenderbuffer(GLenum internalFormat, GLsizei width,
+                                GLsizei height, GLsizei samples = 0);
+
+    /**
+     * \brief Initializes a new instance of the OpenGLRenderbuffer class with
+     * the content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLRenderbuffer(OpenGLRenderbuffer &&other) noexcept;
+    /**
+     * \brief Initializes a new instance of the OpenGLRenderbuffer class with
+     * the content of \a other.
+     *
+     * \param other Another object to assign with.
+     */
+    OpenGLRenderbuffer &operator=(OpenGLRenderbuffer &&other) noexcept;
+    /**
+     * \brief Destroy the instance of the OpenGLRenderbuffer class.
+     */
+    ~OpenGLRenderbuffer();
+
+    OpenGLRenderbuffer(const OpenGLRenderbuffer &other) = delete;
+    OpenGLRenderbuffer &operator=(const OpenGLRenderbuffer &other) = delete;
+
+    /**
+     * \brief Bind the OpenGLRenderbuffer to the current OpenGL content.
+     *
+     * \sa release
+     */
+    void bind() noexcept;
+    /**
+     * \brief Release the OpenGLRenderbuffer from the current OpenGL content.
+     *
+     * \sa bind
+     */
+    void release() noexcept;
+
+    /**
+     * \brief Gets the id of the OpenGLRenderbuffer
+     *
+     * \return Specified id.
+     */
+    GLuint id() const noexcept;
+    GLenum internalFormat() const noexcept;
+    GLsizei width() const noexcept;
+    GLsizei height() const noexcept;
+    GLsizei samples() const noexcept;
+
+private:
+    /**
+     * \brief Create the renderbuffer and allocate its storage.
+     *
+     * \exception OpenGLException Renderbuffer failed to instantiate.
+     */
+    void create();
+    /**
+     * \brief Clean up and delete the renderbuffer.
+     */
+    void tidy() noexcept;
+
+    /**
+     * \brief The id of the OpenGLRenderbuffer.
+     */
+    GLuint id_;
+
+    GLenum internalFormat_;
+    GLsizei width_;
+    GLsizei height_;
+    GLsizei samples_;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLRENDERBUFFER_HPP_
@@ -1,6 +1,7 @@
 #include "OpenGLShaderProgram.hpp"
 
 #include "OpenGLException.hpp"
+#include "OpenGLStatistics.hpp"
 
 #include "Utils/Global.hpp"
 
@@ -200,6 +201,26 @@ void OpenGLShaderProgram::mapAttributePointer(GLuint index, GLint size,
                           reinterpret_cast<void *>(offset));
 }
 
+void OpenGLShaderProgram::setAttributeDivisor(GLuint index,
+                                              GLuint divisor) noexcept
+{
+    glVertexAttribDivisor(index, divisor);
+}
+
+bool OpenGLShaderProgram::setUniformBlockBinding(const char *name,
+                                                 GLuint binding) noexcept
+{
+    const GLuint index{glGetUniformBlockIndex(id_, name)};
+
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+
+    glUniformBlockBinding(id_, index, binding);
+    return true;
+}
+
 void OpenGLShaderProgram::tidy() noexcept
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
@@ -208,6 +229,11 @@ void OpenGLShaderProgram::tidy() noexcept
     destroyProgram();
 }
 
-void OpenGLShaderProgram::use() noexcept { glUseProgram(id_); }
+void OpenGLShaderProgram::use() noexcept
+{
+    ++OpenGLStatistics::current().programBinds;
+
+    glUseProgram(id_);
+}
 
 } // namespace OpenGL
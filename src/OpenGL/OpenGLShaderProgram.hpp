@@ -123,6 +123,28 @@ public:
     void mapAttributePointer(GLuint index, GLint size, GLenum type,
                              GLboolean normalized, GLsizei stride,
                              int offset) noexcept;
+    /**
+     * \brief Set how often the attribute at \a index advances during an
+     * instanced draw.
+     *
+     * \param index The index location of the shader.
+     * \param divisor \c 0 advances once per vertex, \c n once every \a n
+     * instances.
+     */
+    void setAttributeDivisor(GLuint index, GLuint divisor) noexcept;
+
+    /**
+     * \brief Assign the uniform block \a name to the indexed binding point
+     * \a binding.
+     *
+     * \param name Name of the uniform block.
+     * \param binding Index of the binding point.
+     * \return Return \c false if the OpenGLShaderProgram has no uniform
+     * block \a name.
+     *
+     * \sa OpenGLBufferObject::bindBase
+     */
+    bool setUniformBlockBinding(const char *name, GLuint binding) noexcept;
 
     /**
      * \brief Use the OpenGLShaderProgram to the current rendering state.
@@ -0,0 +1,20 @@
+#include "OpenGLStatistics.hpp"
+
+namespace OpenGL
+{
+
+namespace Detail
+{
+
+OpenGLStatistics statistics;
+
+} // namespace Detail
+
+OpenGLStatistics &OpenGLStatistics::current() noexcept
+{
+    return Detail::statistics;
+}
+
+void OpenGLStatistics::reset() noexcept { Detail::statistics = {}; }
+
+} // namespace OpenGL
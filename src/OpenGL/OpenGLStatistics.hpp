@@ -0,0 +1,46 @@
+#ifndef HOMEWORK01_OPENGL_OPENGLSTATISTICS_HPP_
+#define HOMEWORK01_OPENGL_OPENGLSTATISTICS_HPP_
+
+#include <cstdint>
+
+namespace OpenGL
+{
+
+/**
+ * \brief Counters of the OpenGL work submitted through the wrapper classes.
+ *
+ * \par Warning:
+ * The counters are not thread safe. Please use them under the same thread
+ * which creates OpenGL content.
+ */
+struct OpenGLStatistics
+{
+    std::uint32_t drawCalls = 0;
+    std::uint32_t triangles = 0; // of every instance
+    std::uint32_t programBinds = 0;
+    std::uint32_t vertexArrayBinds = 0;
+    std::uint32_t textureBinds = 0;
+    std::uint32_t bufferBinds = 0;
+
+    /**
+     * \brief Gets the number of state changes (program, vertex array,
+     * texture and buffer binds).
+     */
+    std::uint32_t stateChanges() const noexcept
+    {
+        return programBinds + vertexArrayBinds + textureBinds + bufferBinds;
+    }
+
+    /**
+     * \brief Gets the counters of the current frame.
+     */
+    static OpenGLStatistics &current() noexcept;
+    /**
+     * \brief Reset the counters of the current frame.
+     */
+    static void reset() noexcept;
+};
+
+} // namespace OpenGL
+
+#endif // HOMEWORK01_OPENGL_OPENGLSTATISTICS_HPP_
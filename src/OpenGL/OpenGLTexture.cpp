@@ -1,7 +1,9 @@
 #include "OpenGLTexture.hpp"
 
 #include "OpenGLException.hpp"
+#include "OpenGLStatistics.hpp"
 #include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 
 namespace OpenGL
 {
@@ -39,6 +41,23 @@ OpenGLTexture::OpenGLTexture(GLsizei width, GLsizei height, GLenum format,
     bindBuffer(buffer);
 }
 
+OpenGLTexture::OpenGLTexture(GLsizei width, GLsizei height,
+                             GLenum internalFormat, GLenum format, GLenum type,
+                             Filter minificationFilter,
+                             Filter magnificationFilter, WrapOption wrapOption)
+    : id_{Detail::noId}, format_{internalFormat}, height_{height},
+      width_{width}, mipmapCount_{0}, minificationFilter_{minificationFilter},
+      magnificationFilter_{magnificationFilter}, wrapOption_{wrapOption}
+{
+    create();
+
+    bind();
+
+    allocateStorage(format, type);
+
+    release();
+}
+
 OpenGLTexture::OpenGLTexture(OpenGLTexture &&other) noexcept
     : id_{std::move(other.id_)}, format_{std::move(other.format_)},
       height_{std::move(other.height_)}, width_{std::move(other.width_)},
@@ -85,11 +104,15 @@ void OpenGLTexture::bind()
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
 
+    ++OpenGLStatistics::current().textureBinds;
+
     glBindTexture(GL_TEXTURE_2D, id_);
 }
 
 void OpenGLTexture::bindBuffer(const std::vector<unsigned char> &buffer) const
 {
+    PROGRAM_TRACE_SCOPE("upload", "OpenGLTexture::bindBuffer");
+
     glTexImage2D(GL_TEXTURE_2D, 0, format_, width_, height_, 0, format_,
                  GL_UNSIGNED_BYTE, buffer.data());
 
@@ -101,6 +124,19 @@ void OpenGLTexture::bindBuffer(const std::vector<unsigned char> &buffer) const
     glGenerateMipmap(GL_TEXTURE_2D);
 }
 
+void OpenGLTexture::allocateStorage(GLenum format, GLenum type) const
+{
+    PROGRAM_TRACE_SCOPE("upload", "OpenGLTexture::allocateStorage");
+
+    glTexImage2D(GL_TEXTURE_2D, 0, format_, width_, height_, 0, format, type,
+                 nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minificationFilter_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magnificationFilter_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapOption_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapOption_);
+}
+
 void OpenGLTexture::create()
 {
     PROGRAM_ASSERT(!Detail::isCreated(id_));
@@ -36,6 +36,12 @@ public:
                            Filter minificationFilter = Filter::Nearest,
                            Filter magnificationFilter = Filter::Linear,
                            WrapOption wrapOption = WrapOption::Repeat);
+    // Empty storage without mipmaps, e.g. a render target attachment
+    explicit OpenGLTexture(GLsizei width, GLsizei height, GLenum internalFormat,
+                           GLenum format, GLenum type,
+                           Filter minificationFilter = Filter::Linear,
+                           Filter magnificationFilter = Filter::Linear,
+                           WrapOption wrapOption = WrapOption::ClampToEdge);
     OpenGLTexture(OpenGLTexture &&other) noexcept;
     OpenGLTexture &operator=(OpenGLTexture &&other) noexcept;
     ~OpenGLTexture();
@@ -60,6 +66,7 @@ public:
 
 private:
     void bindBuffer(const std::vector<unsigned char> &buffer) const;
+    void allocateStorage(GLenum format, GLenum type) const;
     void create();
     void tidy();
 
@@ -1,6 +1,7 @@
 #include "OpenGLVertexArrayObject.hpp"
 
 #include "OpenGLException.hpp"
+#include "OpenGLStatistics.hpp"
 
 #include "Utils/Global.hpp"
 
@@ -60,6 +61,8 @@ void OpenGLVertexArrayObject::bind() noexcept
 {
     PROGRAM_ASSERT(Detail::isCreated(id_));
 
+    ++OpenGLStatistics::current().vertexArrayBinds;
+
     glBindVertexArray(id_);
 }
 
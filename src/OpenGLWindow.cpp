@@ -2,8 +2,11 @@
 
 #include "Model/TextureFactory.hpp"
 #include "OpenGL/OpenGLException.hpp"
+#include "OpenGL/OpenGLStatistics.hpp"
 #include "Utils/Compilers.hpp"
 #include "Utils/Global.hpp"
+#include "Utils/Math/Frustum.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 #include "Utils/StringFormat/StringFormat.hpp"
 #include "Utils/imguiSliderFloat_GetterSetter.hpp"
 
@@ -16,6 +19,8 @@
 
 #include "tiny_obj_loader.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <utility>
 #include <vector>
@@ -53,8 +58,9 @@ void mouseCallback(GLFWwindow *window, double xpos, double ypos)
 } // namespace Detail
 
 OpenGLWindow::OpenGLWindow(glm::ivec2 windowSize, std::string title,
-                           glm::ivec2 openglVersion)
-    : window_{nullptr}, size_{windowSize}, title_{title},
+                           glm::ivec2 openglVersion, bool headless)
+    : window_{nullptr}, headless_{headless}, headlessContext_{nullptr},
+      size_{windowSize}, title_{title},
       version_{openglVersion}, renderMode_{RenderMode::Fill},
       backgroundColor_{0}, lookAt_{0}, cameraPosition_{lookAt_ + glm::vec3{8}}
 {
@@ -69,6 +75,71 @@ void OpenGLWindow::setMouseLastPosition(float x, float y) noexcept
     mouse_lastY_ = y;
 }
 
+void OpenGLWindow::setTraceFrames(int frames) noexcept
+{
+    traceFrames_ = frames;
+}
+
+void OpenGLWindow::setFrameLimit(int frames) noexcept
+{
+    frameLimit_ = frames;
+}
+
+void OpenGLWindow::setBenchmark(int frames, float timestep,
+                                const std::string &output)
+{
+    benchmark_.reset(new Benchmark::FrameBenchmark{frames, timestep});
+    benchmarkOutput_ = output;
+    frameLimit_ = benchmark_->totalFrames();
+
+    if (!headless_)
+    {
+        // Measure the frame, not the display refresh rate
+        glfwSwapInterval(0);
+    }
+}
+
+void OpenGLWindow::setCapture(const std::string &prefix,
+                              Capture::FrameCapture::Format format)
+{
+    capturePrefix_ = prefix;
+    captureFormat_ = format;
+    capture_.reset(new Capture::FrameCapture{capturePrefix_, captureFormat_});
+    capturing_ = true;
+}
+
+void OpenGLWindow::setCrowd(int count, bool occlusionCulling)
+{
+    if (!crowdSimulation_)
+    {
+        crowdSimulation_.reset(new CrowdSimulation{});
+    }
+
+    crowdSimulation_->setCrowd(nullptr);
+    crowd_.reset(new Crowd{*animal_, count, crowdSimulation_->jobSystem()});
+    crowd_->setOcclusionCulling(occlusionCulling);
+    crowdSimulation_->setCrowd(crowd_.get());
+    // Keep the far side of the crowd visible from the benchmark orbit
+    farPlane_ = std::max(100.0f, crowd_->radius() * 3.0f);
+
+    std::cout << "[Crowd] " << crowd_->size() << " avatars, "
+              << crowd_->instanceCount() << " instances in "
+              << crowd_->batchCount() << " batches, "
+              << crowdSimulation_->jobSystem().threadCount()
+              << " simulation threads"
+              << (occlusionCulling ? ", occlusion culling" : "") << std::endl;
+}
+
+void OpenGLWindow::setLevelOfDetail(float pixels) noexcept
+{
+    lodError_ = pixels;
+}
+
+void OpenGLWindow::setSimulation(float tick, int maxTicks) noexcept
+{
+    simulation_.setTick(tick, maxTicks);
+}
+
 void OpenGLWindow::frameBufferSizeCallbackImpl(GLFWwindow *window, int width,
                                                int height)
 {
@@ -136,6 +207,25 @@ float OpenGLWindow::aspectRatio() const noexcept
 
 void OpenGLWindow::create()
 {
+    PROGRAM_TRACE_SCOPE("loading", "OpenGLWindow::create");
+
+    if (headless_)
+    {
+        if (!createHeadless())
+        {
+            throw OpenGL::OpenGLException{"Failed to initialize GLAD"};
+        }
+
+        glEnable(GL_DEPTH_TEST);
+
+        if (!ModelCreate())
+        {
+            throw OpenGL::OpenGLException{"Failed to create model"};
+        }
+
+        return;
+    }
+
     if (!initializeOpenGL())
     {
         throw OpenGL::OpenGLException{"Failed to initialize OpenGL"};
@@ -195,13 +285,45 @@ bool OpenGLWindow::createWindow()
     return true;
 }
 
+bool OpenGLWindow::createHeadless()
+{
+    headlessContext_.reset(
+        new OpenGL::OpenGLHeadlessContext{version_[0], version_[1]});
+
+    if (!gladLoadGLLoader(static_cast<GLADloadproc>(
+            &OpenGL::OpenGLHeadlessContext::getProcAddress)))
+    {
+        return false;
+    }
+
+    headlessContext_->createFramebuffer(width(), height());
+
+    std::cout << "[Headless] " << glGetString(GL_RENDERER) << ", "
+              << glGetString(GL_VERSION) << ", " << width() << "x" << height()
+              << std::endl;
+
+    return true;
+}
+
 void OpenGLWindow::destroy()
 {
+    // Still needs the context to finish the read backs in flight
+    capture_.reset();
+
     destroyModel();
+
+    if (headless_)
+    {
+        destroyHeadless();
+        return;
+    }
+
     destroyImgui();
     destroyOpenGL();
 }
 
+void OpenGLWindow::destroyHeadless() { headlessContext_.reset(); }
+
 void OpenGLWindow::destroyImgui()
 {
     ImGui_ImplOpenGL3_Shutdown();
@@ -217,6 +339,10 @@ void OpenGLWindow::destroyOpenGL()
 
 void OpenGLWindow::destroyModel()
 {
+    // The crowd shares the meshes of the Animal
+    crowdSimulation_.reset();
+    crowd_.reset();
+
     if (animal_)
     {
         animal_.reset();
@@ -265,8 +391,13 @@ bool OpenGLWindow::initializeOpenGL()
 
 void OpenGLWindow::processInput()
 {
+    PROGRAM_TRACE_SCOPE("input", "processInput");
+
     cameraMovement();
     shouldExit();
+    shouldCaptureTrace();
+    shouldCaptureFrames();
+    shouldPick();
 }
 
 void OpenGLWindow::captureMouse()
@@ -303,6 +434,68 @@ void OpenGLWindow::captureMouse()
     cameraDirectionLoop(window_, mouse_lastX_, mouse_lastY_);
 }
 
+void OpenGLWindow::shouldPick()
+{
+    static bool buttonPressed = false;
+
+    if (glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS)
+    {
+        buttonPressed = false;
+        return;
+    }
+    // One pick per click, none through the UI or while the camera owns the
+    // cursor
+    if (buttonPressed || ImGui::GetIO().WantCaptureMouse ||
+        glfwGetInputMode(window_, GLFW_CURSOR) == GLFW_CURSOR_DISABLED)
+    {
+        buttonPressed = true;
+        return;
+    }
+    buttonPressed = true;
+
+    double cursorX, cursorY;
+    int windowWidth, windowHeight;
+    glfwGetCursorPos(window_, &cursorX, &cursorY);
+    glfwGetWindowSize(window_, &windowWidth, &windowHeight);
+    if (windowWidth <= 0 || windowHeight <= 0)
+    {
+        return;
+    }
+
+    // The segment under the cursor from the near to the far plane
+    const glm::mat4 inverse{glm::inverse(cameraProjection() * cameraView())};
+    const float x = static_cast<float>(2.0 * cursorX / windowWidth - 1.0);
+    const float y = static_cast<float>(1.0 - 2.0 * cursorY / windowHeight);
+    const glm::vec4 nearPoint = inverse * glm::vec4{x, y, -1.0f, 1.0f};
+    const glm::vec4 farPoint = inverse * glm::vec4{x, y, 1.0f, 1.0f};
+    const glm::vec3 origin{nearPoint / nearPoint.w};
+    const glm::vec3 direction{glm::vec3{farPoint / farPoint.w} - origin};
+
+    const auto start = std::chrono::steady_clock::now();
+    int joint = -1;
+    if (crowd_)
+    {
+        // Against the frame on screen, the simulation keeps running. The
+        // tree shows the shared rig, select the joint of the same name
+        const Crowd::Pick pick =
+            crowd_->pick(crowdSimulation_->frame(), origin, direction);
+        if (pick.joint >= 0)
+        {
+            joint = animal_->getSkeleton().find(pick.rig->name(pick.joint));
+        }
+    }
+    else
+    {
+        float distance = 1.0f;
+        joint = animal_->pick(origin, direction, distance);
+    }
+    pickMilliseconds_ = std::chrono::duration<float, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+    skeletonPanel_.select(joint);
+}
+
 void OpenGLWindow::cameraMovement()
 {
     if (isFreeCamera_)
@@ -340,7 +533,61 @@ void OpenGLWindow::shouldExit()
     }
 }
 
-void OpenGLWindow::startRender() { windowRenderLoop(); }
+void OpenGLWindow::shouldCaptureTrace()
+{
+    static bool keyPressed = false;
+
+    if (glfwGetKey(window_, GLFW_KEY_F12) == GLFW_PRESS)
+    {
+        if (!keyPressed)
+        {
+            keyPressed = true;
+            Profiler::TraceRecorder::instance().requestCapture(traceFrames_,
+                                                               "trace.json");
+        }
+    }
+    else
+    {
+        keyPressed = false;
+    }
+}
+
+void OpenGLWindow::shouldCaptureFrames()
+{
+    static bool keyPressed = false;
+
+    if (glfwGetKey(window_, GLFW_KEY_F11) == GLFW_PRESS)
+    {
+        if (!keyPressed)
+        {
+            keyPressed = true;
+
+            if (!capture_)
+            {
+                capture_.reset(new Capture::FrameCapture{capturePrefix_,
+                                                         captureFormat_});
+            }
+            capturing_ = !capturing_;
+
+            std::cout << "[Capture] " << (capturing_ ? "Started" : "Stopped")
+                      << " capturing to " << capturePrefix_ << std::endl;
+        }
+    }
+    else
+    {
+        keyPressed = false;
+    }
+}
+
+void OpenGLWindow::startRender()
+{
+    windowRenderLoop();
+
+    if (benchmark_)
+    {
+        benchmark_->writeReport(benchmarkOutput_);
+    }
+}
 
 int OpenGLWindow::width() const noexcept { return size_.x; }
 
@@ -377,39 +624,88 @@ void OpenGLWindow::windowImguiGeneralSetting()
     }
 }
 
-void OpenGLWindow::_windowImguiModelSetting(std::shared_ptr<Joint> &joint)
-{
-    ImGui::Text("%s", joint->getName().c_str());
-    ImGui::SliderFloat3(("Position##" + joint->getName()).c_str(), glm::value_ptr(joint->getOffset()), -10.0f, 10.0f);
-    ImGui::SliderFloat3(("Rotation##" + joint->getName()).c_str(), glm::value_ptr(joint->getRotation()), -180.0f, 180.0f);
-    ImGui::SliderFloat3(("Scale##" + joint->getName()).c_str(), joint.get(), &Joint::getSize, &Joint::setSize, 0.1f, 5.0f);
-    ImGui::Separator();
-     
-    for(auto& child : joint->getChildren()) {
-        _windowImguiModelSetting(child);
-    }
-}
-
 bool animal_transform_state = false;
 void OpenGLWindow::windowImguiModelSetting() 
 {
     ImGui::Text("Model Settings");
+    // Counters of the previous frame, the UI is drawn after the models
+    const SkeletonStatistics &statistics = SkeletonStatistics::current();
+    ImGui::Text("Transforms recomputed: %u local, %u world",
+                statistics.localTransforms, statistics.worldTransforms);
+    const Math::CullingStatistics &culling = Math::CullingStatistics::current();
+    ImGui::Text("Avatars: %u drawn, %u culled, %u occluded",
+                culling.avatarsDrawn, culling.avatarsCulled,
+                culling.avatarsOccluded);
+    ImGui::Text("Parts: %u drawn, %u culled", culling.partsDrawn,
+                culling.partsCulled);
+    const Skeleton &picked = animal_->getSkeleton();
+    const int selected = skeletonPanel_.selected();
+    ImGui::Text("Picked: %s (%.3f ms)",
+                selected >= 0 && selected < picked.jointCount()
+                    ? picked.name(selected).c_str()
+                    : "none",
+                pickMilliseconds_);
+    ImGui::Text("Triangles: %u in %u draw calls",
+                OpenGL::OpenGLStatistics::current().triangles,
+                OpenGL::OpenGLStatistics::current().drawCalls);
+    ImGui::SliderFloat("LOD error (px)", &lodError_, 0.0f, 8.0f);
+    if (!crowd_ && !animal_->isTransforming())
+    {
+        // Only the morph is drawn part by part
+        ImGui::TextDisabled("Skinned rig: full detail, culled as a whole");
+    }
+    ImGui::Text("Simulation: %d ticks of %.1f ms, %.2f ahead, %llu dropped",
+                simulation_.ticks(), simulation_.tick() * 1000.0f,
+                simulation_.alpha(),
+                static_cast<unsigned long long>(simulation_.droppedTicks()));
+    if (crowd_)
+    {
+        ImGui::Text("Crowd: %d avatars, %zu instances, %zu batches, %zu "
+                    "simulation threads",
+                    crowd_->size(), crowd_->instanceCount(),
+                    crowd_->batchCount(),
+                    crowdSimulation_->jobSystem().threadCount());
+        bool occlusionCulling = crowd_->occlusionCulling();
+        if (ImGui::Checkbox("Occlusion culling", &occlusionCulling))
+        {
+            crowd_->setOcclusionCulling(occlusionCulling);
+        }
+    }
     ImGui::Separator();
 
     if(ImGui::Checkbox("Transforming", &animal_transform_state)){
-        animal_->toggleForm();
+        if (crowd_)
+        {
+            crowdSimulation_->toggleForm();
+        }
+        else
+        {
+            animal_->toggleForm();
+        }
+    }
+    bool walking = animal_->isWalking();
+    if (ImGui::Checkbox("Walk", &walking))
+    {
+        animal_->setWalking(walking);
+    }
+    ImGui::SameLine();
+    bool gesturing = animal_->isGesturing();
+    if (ImGui::Checkbox("Wave", &gesturing))
+    {
+        animal_->setGesturing(gesturing);
     }
 
     ImGui::Separator();
 
-    auto animal_root = animal_->getRootJoint();
-    _windowImguiModelSetting(animal_root);
+    skeletonPanel_.draw(animal_->getSkeleton());
 }
 
 void OpenGLWindow::windowRenderLateUpdate() {}
 
 void OpenGLWindow::windowRenderImguiUpdate()
 {
+    PROGRAM_TRACE_SCOPE("render", "windowRenderImguiUpdate");
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -422,28 +718,133 @@ void OpenGLWindow::windowRenderImguiUpdate()
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+bool OpenGLWindow::shouldStopRender(int frame)
+{
+    if (frameLimit_ > 0 && frame >= frameLimit_)
+    {
+        return true;
+    }
+
+    return !headless_ && glfwWindowShouldClose(window_);
+}
+
+float OpenGLWindow::currentTime() const
+{
+    if (!headless_)
+    {
+        return static_cast<float>(glfwGetTime());
+    }
+
+    static const std::chrono::steady_clock::time_point start{
+        std::chrono::steady_clock::now()};
+
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() -
+                                        start)
+        .count();
+}
+
 void OpenGLWindow::windowRenderLoop()
 {
-    while (!(glfwWindowShouldClose(window_)))
+    Profiler::TraceRecorder &recorder = Profiler::TraceRecorder::instance();
+
+    lastFrame_ = currentTime();
+
+    for (int frame = 0; !shouldStopRender(frame); ++frame)
     {
-        float currentFrame = glfwGetTime();
+        recorder.beginFrame();
+        OpenGL::OpenGLStatistics::reset();
+        SkeletonStatistics::reset();
+        Math::CullingStatistics::reset();
+
+        float currentFrame = currentTime();
         deltaTime_ = currentFrame - lastFrame_;
         lastFrame_ = currentFrame;
 
-        processInput();
+        if (benchmark_)
+        {
+            benchmark_->beginFrame();
+            windowBenchmarkUpdate(frame);
+        }
+
+        if (headless_)
+        {
+            headlessContext_->bindFramebuffer();
+        }
+        else
+        {
+            processInput();
+        }
+        if (capture_)
+        {
+            capture_->poll();
+        }
         clearColor();
 
         windowRenderUpdate();
         windowRenderLateUpdate();
 
-        windowRenderImguiUpdate();
+        if (capturing_)
+        {
+            // Before the UI is drawn, captures only contain the scene
+            capture_->capture(frame, width(), height());
+        }
+
+        if (headless_)
+        {
+            // No swap chain to throttle on, keep at most one frame in flight
+            PROGRAM_TRACE_SCOPE("render", "glFinish");
+            glFinish();
+        }
+        else
+        {
+            windowRenderImguiUpdate();
+
+            {
+                PROGRAM_TRACE_SCOPE("render", "glfwSwapBuffers");
+                glfwSwapBuffers(window_);
+            }
+            glfwPollEvents();
+        }
+
+        if (benchmark_)
+        {
+            glFinish();
+            benchmark_->endFrame(frame, OpenGL::OpenGLStatistics::current(),
+                                 SkeletonStatistics::current(),
+                                 Math::CullingStatistics::current());
+        }
 
-        glfwSwapBuffers(window_);
-        glfwPollEvents();
+        recorder.endFrame();
     }
 }
 
-void OpenGLWindow::windowRenderUpdate()
+void OpenGLWindow::windowBenchmarkUpdate(int frame)
+{
+    PROGRAM_TRACE_SCOPE("benchmark", "windowBenchmarkUpdate");
+
+    // Fixed timestep instead of the wall clock delta
+    deltaTime_ = benchmark_->timestep();
+
+    isFreeCamera_ = false;
+    cameraPosition_ = crowd_ ? benchmark_->cameraPosition(frame, crowd_->radius())
+                             : benchmark_->cameraPosition(frame);
+    lookAt_ = glm::vec3{0.0f};
+
+    if (benchmark_->shouldToggleForm(frame))
+    {
+        animal_transform_state = !animal_transform_state;
+        if (crowd_)
+        {
+            crowdSimulation_->toggleForm();
+        }
+        else
+        {
+            animal_->toggleForm();
+        }
+    }
+}
+
+glm::mat4 OpenGLWindow::cameraView() const
 {
     PRAGMA_WARNING_PUSH
     PRAGMA_WARNING_DISABLE_CONSTANTCONDITIONAL
@@ -451,11 +852,53 @@ void OpenGLWindow::windowRenderUpdate()
                      glm::mat4(1);
     PRAGMA_WARNING_POP
 
-    glm::mat4 projection{
-        glm::perspective(glm::radians(45.0f), aspectRatio(), 0.1f, 100.0f)};
+    return view;
+}
+
+glm::mat4 OpenGLWindow::cameraProjection() const
+{
+    return glm::perspective(glm::radians(45.0f), aspectRatio(), 0.1f,
+                            farPlane_);
+}
+
+void OpenGLWindow::windowRenderUpdate()
+{
+    PROGRAM_TRACE_SCOPE("render", "windowRenderUpdate");
+
+    glm::mat4 view = cameraView();
+    glm::mat4 projection = cameraProjection();
+    const Model::LodView lod = Model::MakeLodView(
+        view, projection, static_cast<float>(height()), lodError_);
+
+    // The simulation advances by whole ticks whatever the frame time
+    const int ticks = simulation_.advance(deltaTime_);
+    const float tick = simulation_.tick();
 
     // draw models
-    animal_->draw(view, projection);
-    if(animal_->isTransforming())
-        animal_->updateTransformation(deltaTime_);
+    if (crowd_)
+    {
+        // The frame the simulation thread finished is drawn while it poses
+        // the next, once per frame at the last tick. Benchmarks and captures
+        // wait for it so every run draws the same frames
+        if (crowd_->occlusionCulling())
+        {
+            crowd_->collectOcclusion();
+        }
+        const Crowd::Frame &frame =
+            crowdSimulation_->acquire(benchmark_ || headless_);
+        crowdSimulation_->submit(static_cast<float>(ticks) * tick, view,
+                                 projection, lod);
+        crowd_->draw(frame);
+        return;
+    }
+
+    for (int i = 0; i < ticks; ++i)
+    {
+        // A finished morph switches the rig before it is animated
+        if (animal_->isTransforming())
+            animal_->updateTransformation(tick);
+        animal_->updateAnimation(tick);
+    }
+    animal_->interpolate(simulation_.alpha());
+    animal_->draw(view, projection, lod);
 }
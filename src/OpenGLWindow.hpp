@@ -1,8 +1,15 @@
 #ifndef HOMEWORK01_WINDOW_HPP_
 #define HOMEWORK01_WINDOW_HPP_
 
+#include "Benchmark/FrameBenchmark.hpp"
+#include "Capture/FrameCapture.hpp"
 #include "Model/Mesh.hpp"
 #include "Avatar/Animal.hpp"
+#include "Avatar/Crowd.hpp"
+#include "Avatar/CrowdSimulation.hpp"
+#include "Avatar/SkeletonPanel.hpp"
+#include "OpenGL/OpenGLHeadlessContext.hpp"
+#include "Utils/Time/FixedTimestep.hpp"
 
 #include "glad/glad.h"
 
@@ -26,7 +33,7 @@ private:
 
 public:
     explicit OpenGLWindow(glm::ivec2 windowSize, std::string title,
-                          glm::ivec2 openglVersion);
+                          glm::ivec2 openglVersion, bool headless = false);
     ~OpenGLWindow();
 
     OpenGLWindow(OpenGLWindow &&other) = delete;
@@ -41,6 +48,23 @@ public:
                   OpenGL::OpenGLShaderProgram &program);
 
     void setMouseLastPosition(float x, float y) noexcept;
+    void setTraceFrames(int frames) noexcept;
+    // Stop rendering after \a frames frames, 0 renders until the window closes
+    void setFrameLimit(int frames) noexcept;
+    // Run the scripted benchmark and write the report to \a output
+    void setBenchmark(int frames, float timestep, const std::string &output);
+    // Capture every frame to \a prefix<frame>.png|raw from the first frame
+    void setCapture(const std::string &prefix,
+                    Capture::FrameCapture::Format format);
+    // Replace the Animal with a crowd of \a count avatars sharing its rigs,
+    // see Crowd::setOcclusionCulling for \a occlusionCulling
+    void setCrowd(int count, bool occlusionCulling = false);
+    // Draw every mesh at the coarsest level of detail whose error stays
+    // within \a pixels on screen, 0 draws them all in full
+    void setLevelOfDetail(float pixels) noexcept;
+    // Simulate the avatars in ticks of \a tick seconds, at most \a maxTicks
+    // per frame, and draw them interpolated between the last two
+    void setSimulation(float tick, int maxTicks) noexcept;
 
     void frameBufferSizeCallbackImpl(GLFWwindow *window, int width, int height);
 
@@ -54,6 +78,7 @@ public:
 
 private:
     bool createWindow();
+    bool createHeadless();
     bool initializeGLAD();
     void initializeImgui();
     bool initializeOpenGL();
@@ -63,15 +88,18 @@ private:
     void destroyImgui();
     void destroyOpenGL();
     void destroyModel();
+    void destroyHeadless();
 
     void windowRenderLoop();
+    bool shouldStopRender(int frame);
+    float currentTime() const;
     void windowRenderUpdate();
+    void windowBenchmarkUpdate(int frame);
     void windowRenderLateUpdate();
     void windowRenderImguiUpdate();
 
     void windowImguiMain();
     void windowImguiGeneralSetting();
-    void _windowImguiModelSetting(std::shared_ptr<Joint> &joint);
     void windowImguiModelSetting();
 
     void clearColor();
@@ -81,6 +109,13 @@ private:
     void cameraMovement();
     void shouldExit();
     void shouldShowPolygonMode();
+    void shouldCaptureTrace();
+    void shouldCaptureFrames();
+    // Select the joint under the cursor on a left click
+    void shouldPick();
+
+    glm::mat4 cameraView() const;
+    glm::mat4 cameraProjection() const;
 
     float aspectRatio() const noexcept;
     int height() const noexcept;
@@ -90,6 +125,20 @@ private:
 
     GLFWwindow *window_;
 
+    // Offscreen rendering without GLFW, see OpenGL::OpenGLHeadlessContext
+    bool headless_;
+    std::unique_ptr<OpenGL::OpenGLHeadlessContext> headlessContext_;
+    int frameLimit_ = 0;
+
+    std::unique_ptr<Benchmark::FrameBenchmark> benchmark_;
+    std::string benchmarkOutput_;
+
+    // Asynchronous read back of the rendered frames, see Capture::FrameCapture
+    std::unique_ptr<Capture::FrameCapture> capture_;
+    std::string capturePrefix_ = "capture_";
+    Capture::FrameCapture::Format captureFormat_ = Capture::FrameCapture::Png;
+    bool capturing_ = false;
+
     glm::ivec2 size_;
     std::string title_;
     glm::ivec2 version_;
@@ -107,6 +156,8 @@ private:
 
     float deltaTime_ = 0.0f; // time between current frame and last frame
     float lastFrame_ = 0.0f;
+    // Splits deltaTime_ into the simulation's fixed ticks
+    Time::FixedTimestep simulation_;
 
     static bool mouseCaptured_;
     float mouse_lastX_ = 400, mouse_lastY_ = 300;
@@ -115,7 +166,20 @@ private:
     float mouse_fov_ = 45.0f;
     float sensitivity_ = 1.0f;
 
+    int traceFrames_ = 120;
+
+    // Joints of the shown skeleton, the picked one selected
+    SkeletonPanel skeletonPanel_;
+    float pickMilliseconds_ = 0.0f;
+
     std::unique_ptr<Animal> animal_;
+
+    // Crowd mode, see Crowd, simulated on the thread of crowdSimulation_
+    std::unique_ptr<Crowd> crowd_;
+    std::unique_ptr<CrowdSimulation> crowdSimulation_;
+    float farPlane_ = 100.0f;
+
+    float lodError_ = 1.0f; // pixels, see setLevelOfDetail
 };
 
 #endif // HOMEWORK01_WINDOW_HPP_
@@ -0,0 +1,74 @@
+#ifndef HOMEWORK01_SCENE_COMPONENTS_HPP_
+#define HOMEWORK01_SCENE_COMPONENTS_HPP_
+
+#include "Avatar/AnimationGraph.hpp"
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+
+namespace Model
+{
+class Geometry;
+} // namespace Model
+
+namespace OpenGL
+{
+class OpenGLShaderProgram;
+class OpenGLTexture;
+} // namespace OpenGL
+
+namespace Scene
+{
+
+/**
+ * @brief Placement of an entity in the world.
+ */
+struct Transform
+{
+    glm::mat4 world;
+};
+
+/**
+ * @brief Sphere around an entity in world space, centre and radius, which
+ * contains it in any pose.
+ */
+struct Bounds
+{
+    glm::vec4 sphere;
+};
+
+/**
+ * @brief Geometry drawn at an entity's Transform.
+ */
+struct MeshRef
+{
+    const Model::Geometry *geometry;
+    std::size_t level; // of detail, 0 is the full mesh
+};
+
+/**
+ * @brief How a MeshRef is shaded.
+ */
+struct Material
+{
+    OpenGL::OpenGLShaderProgram *shader;
+    const OpenGL::OpenGLTexture *texture; // nullptr for none
+    glm::vec4 tint;
+};
+
+/**
+ * @brief Playback of both rigs of an Animal, see Animal::spawn.
+ */
+struct AnimationState
+{
+    AnimationGraph::Instance human;
+    AnimationGraph::Instance pig;
+    float morphProgress; // 1 once the last morph ended
+    bool humanForm;
+};
+
+} // namespace Scene
+
+#endif // HOMEWORK01_SCENE_COMPONENTS_HPP_
@@ -0,0 +1,183 @@
+#include <initializer_list>
+#include <utility>
+
+namespace Scene
+{
+
+template <typename Component>
+inline bool
+ComponentPool<Component>::contains(const Entity &entity) const noexcept
+{
+    return entity.index < sparse_.size() &&
+           sparse_[entity.index] != Absent &&
+           entities_[sparse_[entity.index]] == entity;
+}
+
+template <typename Component>
+template <typename... Arguments>
+inline Component &ComponentPool<Component>::emplace(const Entity &entity,
+                                                    Arguments &&...arguments)
+{
+    if (entity.index >= sparse_.size())
+    {
+        sparse_.resize(entity.index + 1, Absent);
+    }
+
+    sparse_[entity.index] = static_cast<std::uint32_t>(components_.size());
+    entities_.push_back(entity);
+    components_.emplace_back(std::forward<Arguments>(arguments)...);
+
+    return components_.back();
+}
+
+template <typename Component>
+inline void ComponentPool<Component>::remove(const Entity &entity)
+{
+    if (!contains(entity))
+    {
+        return;
+    }
+
+    // The last component fills the gap
+    const std::uint32_t position{sparse_[entity.index]};
+    if (position + 1 != components_.size())
+    {
+        components_[position] = std::move(components_.back());
+        entities_[position] = entities_.back();
+        sparse_[entities_[position].index] = position;
+    }
+    components_.pop_back();
+    entities_.pop_back();
+    sparse_[entity.index] = Absent;
+}
+
+template <typename Component>
+inline void ComponentPool<Component>::clear() noexcept
+{
+    sparse_.clear();
+    entities_.clear();
+    components_.clear();
+}
+
+template <typename Component>
+inline void ComponentPool<Component>::reserve(std::size_t count)
+{
+    entities_.reserve(count);
+    components_.reserve(count);
+}
+
+template <typename Component>
+inline Component &ComponentPool<Component>::get(const Entity &entity) noexcept
+{
+    return components_[sparse_[entity.index]];
+}
+
+template <typename Component>
+inline const Component &
+ComponentPool<Component>::get(const Entity &entity) const noexcept
+{
+    return components_[sparse_[entity.index]];
+}
+
+template <typename Component>
+inline Component *ComponentPool<Component>::tryGet(const Entity &entity) noexcept
+{
+    return contains(entity) ? &components_[sparse_[entity.index]] : nullptr;
+}
+
+namespace Detail
+{
+
+inline bool allOf(std::initializer_list<bool> values) noexcept
+{
+    for (bool value : values)
+    {
+        if (!value)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The pools looked up once for Registry::each
+template <typename First, typename Function, typename... Rest>
+inline void eachOf(ComponentPool<First> &first, Function &function,
+                   ComponentPool<Rest> &...rest)
+{
+    for (std::size_t position = 0; position < first.size(); ++position)
+    {
+        const Entity &entity{first.entity(position)};
+        if (allOf({rest.contains(entity)...}))
+        {
+            function(entity, first[position], rest.get(entity)...);
+        }
+    }
+}
+
+} // namespace Detail
+
+template <typename Component>
+inline std::size_t Registry::ComponentId() noexcept
+{
+    // Numbered on first use, the same in every translation unit
+    static const std::size_t id{NextComponentId()};
+
+    return id;
+}
+
+template <typename Component>
+inline ComponentPool<Component> &Registry::pool()
+{
+    const std::size_t id{ComponentId<Component>()};
+    if (id >= pools_.size())
+    {
+        pools_.resize(id + 1);
+    }
+    if (!pools_[id])
+    {
+        pools_[id].reset(new ComponentPool<Component>{});
+    }
+
+    return static_cast<ComponentPool<Component> &>(*pools_[id]);
+}
+
+template <typename Component, typename... Arguments>
+inline Component &Registry::emplace(const Entity &entity,
+                                    Arguments &&...arguments)
+{
+    return pool<Component>().emplace(entity,
+                                     std::forward<Arguments>(arguments)...);
+}
+
+template <typename Component>
+inline void Registry::remove(const Entity &entity)
+{
+    pool<Component>().remove(entity);
+}
+
+template <typename Component> inline bool Registry::has(const Entity &entity)
+{
+    return pool<Component>().contains(entity);
+}
+
+template <typename Component>
+inline Component &Registry::get(const Entity &entity)
+{
+    return pool<Component>().get(entity);
+}
+
+template <typename Component>
+inline Component *Registry::tryGet(const Entity &entity)
+{
+    return pool<Component>().tryGet(entity);
+}
+
+template <typename First, typename... Rest, typename Function>
+inline void Registry::each(Function &&function)
+{
+    Detail::eachOf(pool<First>(), function, pool<Rest>()...);
+}
+
+} // namespace Scene
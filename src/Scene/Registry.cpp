@@ -0,0 +1,88 @@
+#include "Registry.hpp"
+
+#include <atomic>
+
+namespace Scene
+{
+
+Registry::~Registry() = default;
+
+Entity Registry::create()
+{
+    std::uint32_t index;
+    if (!freeIndices_.empty())
+    {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(generations_.size());
+        generations_.push_back(0);
+        alive_.push_back(0);
+    }
+
+    alive_[index] = 1;
+    ++size_;
+
+    return Entity{index, generations_[index]};
+}
+
+void Registry::destroy(const Entity &entity)
+{
+    if (!alive(entity))
+    {
+        return;
+    }
+
+    for (const std::unique_ptr<PoolBase> &pool : pools_)
+    {
+        if (pool)
+        {
+            pool->remove(entity);
+        }
+    }
+
+    // Handles of the old generation no longer match
+    ++generations_[entity.index];
+    alive_[entity.index] = 0;
+    freeIndices_.push_back(entity.index);
+    --size_;
+}
+
+bool Registry::alive(const Entity &entity) const noexcept
+{
+    return entity.index < generations_.size() && alive_[entity.index] &&
+           generations_[entity.index] == entity.generation;
+}
+
+void Registry::clear()
+{
+    for (const std::unique_ptr<PoolBase> &pool : pools_)
+    {
+        if (pool)
+        {
+            pool->clear();
+        }
+    }
+
+    // Lowest indices first again
+    freeIndices_.clear();
+    for (std::uint32_t index = static_cast<std::uint32_t>(generations_.size());
+         index-- > 0;)
+    {
+        generations_[index] += alive_[index];
+        alive_[index] = 0;
+        freeIndices_.push_back(index);
+    }
+    size_ = 0;
+}
+
+std::size_t Registry::NextComponentId() noexcept
+{
+    static std::atomic<std::size_t> next{0};
+
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace Scene
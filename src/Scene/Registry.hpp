@@ -0,0 +1,173 @@
+#ifndef HOMEWORK01_SCENE_REGISTRY_HPP_
+#define HOMEWORK01_SCENE_REGISTRY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Scene
+{
+
+/**
+ * @brief Handle of an entity, stale once the entity is destroyed even if its
+ * index is reused.
+ */
+struct Entity
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+inline bool operator==(const Entity &first, const Entity &second) noexcept
+{
+    return first.index == second.index && first.generation == second.generation;
+}
+
+inline bool operator!=(const Entity &first, const Entity &second) noexcept
+{
+    return !(first == second);
+}
+
+/**
+ * @brief What Registry::destroy needs of a ComponentPool of any type.
+ */
+class PoolBase
+{
+public:
+    virtual ~PoolBase() = default;
+
+    virtual bool contains(const Entity &entity) const noexcept = 0;
+    // Does nothing if the entity has no component
+    virtual void remove(const Entity &entity) = 0;
+    virtual void clear() noexcept = 0;
+};
+
+/**
+ * @brief Components of one type, a sparse set.
+ *
+ * @details The components and their entities are packed in two arrays
+ * without gaps, a sparse array maps an entity's index to its position.
+ * Systems walk the packed arrays front to back, which streams them through
+ * the cache. Removing a component moves the last one into its place, so
+ * positions are stable only while nothing is removed. Pointers and
+ * references to components are invalidated by ComponentPool::emplace.
+ */
+template <typename Component>
+class ComponentPool final : public PoolBase
+{
+public:
+    bool contains(const Entity &entity) const noexcept override;
+    /**
+     * @brief Add a component constructed from \a arguments to \a entity,
+     * which must not have one.
+     */
+    template <typename... Arguments>
+    Component &emplace(const Entity &entity, Arguments &&...arguments);
+    void remove(const Entity &entity) override;
+    void clear() noexcept override;
+    void reserve(std::size_t count);
+
+    // The entity must have a component
+    Component &get(const Entity &entity) noexcept;
+    const Component &get(const Entity &entity) const noexcept;
+    // nullptr if the entity has no component
+    Component *tryGet(const Entity &entity) noexcept;
+
+    std::size_t size() const noexcept { return components_.size(); }
+    // Packed array of the components
+    Component *data() noexcept { return components_.data(); }
+    const Component *data() const noexcept { return components_.data(); }
+    Component &operator[](std::size_t position) noexcept
+    {
+        return components_[position];
+    }
+    const Component &operator[](std::size_t position) const noexcept
+    {
+        return components_[position];
+    }
+    // Entity of the component at \a position of the packed array
+    const Entity &entity(std::size_t position) const noexcept
+    {
+        return entities_[position];
+    }
+
+private:
+    static constexpr std::uint32_t Absent = 0xffffffffu;
+
+    std::vector<std::uint32_t> sparse_; // per entity index
+    std::vector<Entity> entities_;
+    std::vector<Component> components_;
+};
+
+/**
+ * @brief Entities and a ComponentPool of every component type added to one.
+ *
+ * @details Entities are indices with a generation, destroyed indices are
+ * reused by later Registry::create calls with the next generation. Pools are
+ * created on first use and live as long as the registry, so a reference to
+ * one stays valid. Registry::each visits the entities of the first
+ * component's pool in its packed order, the rest are looked up through
+ * their sparse arrays; list the rarest component first.
+ *
+ * A registry is not synchronized. Threads may read and write components of
+ * different entities concurrently, but not create, destroy, emplace or
+ * remove.
+ */
+class Registry
+{
+public:
+    Registry() = default;
+    ~Registry();
+
+    Registry(const Registry &other) = delete;
+    Registry &operator=(const Registry &other) = delete;
+
+    Entity create();
+    /**
+     * @brief Remove every component of \a entity and free its index.
+     */
+    void destroy(const Entity &entity);
+    bool alive(const Entity &entity) const noexcept;
+    /**
+     * @brief Destroy every entity, the pools are kept.
+     */
+    void clear();
+    // Entities alive
+    std::size_t size() const noexcept { return size_; }
+
+    template <typename Component> ComponentPool<Component> &pool();
+
+    template <typename Component, typename... Arguments>
+    Component &emplace(const Entity &entity, Arguments &&...arguments);
+    template <typename Component> void remove(const Entity &entity);
+    template <typename Component> bool has(const Entity &entity);
+    template <typename Component> Component &get(const Entity &entity);
+    template <typename Component> Component *tryGet(const Entity &entity);
+
+    /**
+     * @brief Call \a function(entity, first, rest...) for every entity with
+     * all the components, in the packed order of \a First.
+     *
+     * @details Components of these types must not be added or removed until
+     * it returns.
+     */
+    template <typename First, typename... Rest, typename Function>
+    void each(Function &&function);
+
+private:
+    static std::size_t NextComponentId() noexcept;
+    template <typename Component> static std::size_t ComponentId() noexcept;
+
+    std::vector<std::uint32_t> generations_; // per index
+    std::vector<std::uint32_t> freeIndices_;
+    std::vector<std::uint8_t> alive_;         // per index
+    std::size_t size_ = 0;
+    std::vector<std::unique_ptr<PoolBase>> pools_; // per component id
+};
+
+} // namespace Scene
+
+#include "Registry-inl.hpp"
+
+#endif // HOMEWORK01_SCENE_REGISTRY_HPP_
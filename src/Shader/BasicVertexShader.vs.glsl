@@ -4,6 +4,10 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
 layout(location = 2) in vec2 textureCoordinate;
 
+// Morph target of the geometry, see Model::Geometry::setMorphTarget
+layout(location = 6) in vec3 morphPosition;
+layout(location = 7) in vec3 morphNormal;
+
 out VertexToFragment
 {
     vec3 worldPosition;
@@ -13,13 +17,14 @@ out VertexToFragment
 vertexToFragment;
 
 uniform mat4 mvp;
+uniform float morphWeight;
 
 void main()
 {
-    vec4 pos = mvp * vec4(position, 1.0);
+    vec4 pos = mvp * vec4(mix(position, morphPosition, morphWeight), 1.0);
 
     vertexToFragment.worldPosition = pos.xyz;
-    vertexToFragment.normal = normal;
+    vertexToFragment.normal = normalize(mix(normal, morphNormal, morphWeight));
     vertexToFragment.textureCoordinate = textureCoordinate;
 
     gl_Position = pos;
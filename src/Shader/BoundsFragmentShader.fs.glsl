@@ -0,0 +1,10 @@
+#version 330 core
+
+out vec4 fragColor;
+
+// Colour writes are masked off, only whether a sample passes the depth test
+// counts
+void main()
+{
+    fragColor = vec4(1.0);
+}
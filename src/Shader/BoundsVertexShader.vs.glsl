@@ -0,0 +1,11 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+
+// Projection, view and the box's placement, see Crowd::queryOcclusion
+uniform mat4 transform;
+
+void main()
+{
+    gl_Position = transform * vec4(position, 1.0);
+}
@@ -0,0 +1,38 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 textureCoordinate;
+
+// Rows of the instance's 3x4 model matrix, see Model::InstanceBatch
+layout(location = 3) in vec4 modelRow0;
+layout(location = 4) in vec4 modelRow1;
+layout(location = 5) in vec4 modelRow2;
+
+// Morph target of the geometry and the instance's weight towards it
+layout(location = 6) in vec3 morphPosition;
+layout(location = 7) in vec3 morphNormal;
+layout(location = 8) in float morphWeight;
+
+out VertexToFragment
+{
+    vec3 worldPosition;
+    vec3 normal;
+    vec2 textureCoordinate;
+}
+vertexToFragment;
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    vec4 local = vec4(mix(position, morphPosition, morphWeight), 1.0);
+    vec4 world = vec4(dot(modelRow0, local), dot(modelRow1, local),
+                      dot(modelRow2, local), 1.0);
+
+    vertexToFragment.worldPosition = world.xyz;
+    vertexToFragment.normal = normalize(mix(normal, morphNormal, morphWeight));
+    vertexToFragment.textureCoordinate = textureCoordinate;
+
+    gl_Position = viewProjection * world;
+}
@@ -0,0 +1,40 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 textureCoordinate;
+
+// Bones of the vertex and their weights, see Model::SkinnedMesh
+layout(location = 3) in vec4 boneIndices;
+layout(location = 4) in vec4 boneWeights;
+
+out VertexToFragment
+{
+    vec3 worldPosition;
+    vec3 normal;
+    vec2 textureCoordinate;
+}
+vertexToFragment;
+
+// Model::SkinnedMesh::MaxBones matrices, uploaded once per draw
+layout(std140) uniform Palette
+{
+    mat4 bones[64];
+};
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    mat4 skin = bones[int(boneIndices.x)] * boneWeights.x +
+                bones[int(boneIndices.y)] * boneWeights.y +
+                bones[int(boneIndices.z)] * boneWeights.z +
+                bones[int(boneIndices.w)] * boneWeights.w;
+    vec4 world = skin * vec4(position, 1.0);
+
+    vertexToFragment.worldPosition = world.xyz;
+    vertexToFragment.normal = normalize(mat3(skin) * normal);
+    vertexToFragment.textureCoordinate = textureCoordinate;
+
+    gl_Position = viewProjection * world;
+}
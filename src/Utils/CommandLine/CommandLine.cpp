@@ -0,0 +1,245 @@
+#include "CommandLine.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace CommandLine
+{
+
+namespace Detail
+{
+
+bool ParseInt(const char *text, int &value);
+// Positive, or also zero with \a allowZero
+bool ParseFloat(const char *text, float &value, bool allowZero = false);
+bool ParseSize(const char *text, int &width, int &height);
+
+bool ParseInt(const char *text, int &value)
+{
+    char *end{nullptr};
+    const long parsed{std::strtol(text, &end, 10)};
+
+    if (end == text || *end != '\0' || parsed <= 0)
+    {
+        return false;
+    }
+
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool ParseFloat(const char *text, float &value, bool allowZero)
+{
+    char *end{nullptr};
+    const float parsed{std::strtof(text, &end)};
+
+    if (end == text || *end != '\0' ||
+        !(parsed > 0.0f || (allowZero && parsed == 0.0f)))
+    {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+bool ParseSize(const char *text, int &width, int &height)
+{
+    char *end{nullptr};
+    const long parsedWidth{std::strtol(text, &end, 10)};
+
+    if (end == text || (*end != 'x' && *end != 'X'))
+    {
+        return false;
+    }
+
+    const char *heightText{end + 1};
+    const long parsedHeight{std::strtol(heightText, &end, 10)};
+
+    if (end == heightText || *end != '\0' || parsedWidth <= 0 ||
+        parsedHeight <= 0)
+    {
+        return false;
+    }
+
+    width = static_cast<int>(parsedWidth);
+    height = static_cast<int>(parsedHeight);
+    return true;
+}
+
+} // namespace Detail
+
+bool Parse(int argc, char *argv[], Options &options, std::string &error)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *argument{argv[i]};
+        const bool hasValue{i + 1 < argc};
+
+        if (std::strcmp(argument, "--headless") == 0)
+        {
+            options.headless = true;
+        }
+        else if (std::strcmp(argument, "--size") == 0 && hasValue)
+        {
+            if (!Detail::ParseSize(argv[++i], options.width, options.height))
+            {
+                error = "--size expects <width>x<height>";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--frames") == 0 && hasValue)
+        {
+            if (!Detail::ParseInt(argv[++i], options.frames))
+            {
+                error = "--frames expects a positive integer";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--benchmark") == 0)
+        {
+            options.benchmark = true;
+        }
+        else if (std::strcmp(argument, "--benchmark-output") == 0 && hasValue)
+        {
+            options.benchmarkOutput = argv[++i];
+        }
+        else if (std::strcmp(argument, "--microbenchmark") == 0 && hasValue)
+        {
+            options.microbenchmark = argv[++i];
+        }
+        else if (std::strcmp(argument, "--timestep") == 0 && hasValue)
+        {
+            if (!Detail::ParseFloat(argv[++i], options.timestep))
+            {
+                error = "--timestep expects a positive number of seconds";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--tick") == 0 && hasValue)
+        {
+            if (!Detail::ParseFloat(argv[++i], options.tick))
+            {
+                error = "--tick expects a positive number of seconds";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--max-ticks") == 0 && hasValue)
+        {
+            if (!Detail::ParseInt(argv[++i], options.maxTicks))
+            {
+                error = "--max-ticks expects a positive integer";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--crowd") == 0 && hasValue)
+        {
+            if (!Detail::ParseInt(argv[++i], options.crowd))
+            {
+                error = "--crowd expects a positive integer";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--occlusion") == 0)
+        {
+            options.occlusion = true;
+        }
+        else if (std::strcmp(argument, "--lod-error") == 0 && hasValue)
+        {
+            if (!Detail::ParseFloat(argv[++i], options.lodError, true))
+            {
+                error = "--lod-error expects a number of pixels, 0 or more";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--trace") == 0 && hasValue)
+        {
+            options.traceFile = argv[++i];
+        }
+        else if (std::strcmp(argument, "--trace-frames") == 0 && hasValue)
+        {
+            if (!Detail::ParseInt(argv[++i], options.traceFrames))
+            {
+                error = "--trace-frames expects a positive integer";
+                return false;
+            }
+        }
+        else if (std::strcmp(argument, "--capture") == 0 && hasValue)
+        {
+            options.capturePrefix = argv[++i];
+        }
+        else if (std::strcmp(argument, "--capture-format") == 0 && hasValue)
+        {
+            const char *format{argv[++i]};
+
+            if (std::strcmp(format, "png") != 0 &&
+                std::strcmp(format, "raw") != 0)
+            {
+                error = "--capture-format expects png or raw";
+                return false;
+            }
+            options.captureRaw = std::strcmp(format, "raw") == 0;
+        }
+        else
+        {
+            error = std::string{"Unknown or incomplete argument: "} + argument;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PrintUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --headless            Render offscreen without a window "
+                 "(EGL)\n"
+              << "  --size <w>x<h>        Window or offscreen size (default "
+                 "800x600)\n"
+              << "  --frames <n>          Stop after n frames (headless "
+                 "default 300,\n"
+              << "                        benchmark default 600)\n"
+              << "  --benchmark           Run the scripted benchmark\n"
+              << "  --benchmark-output <file>\n"
+              << "                        Benchmark report, .json or .csv "
+                 "(default\n"
+              << "                        benchmark.json)\n"
+              << "  --timestep <s>        Benchmark simulation step (default "
+                 "1/60)\n"
+              << "  --tick <s>            Simulation tick (default 1/60)\n"
+              << "  --max-ticks <n>       Most ticks simulated per frame, "
+                 "the rest is\n"
+              << "                        dropped (default 8)\n"
+              << "  --microbenchmark <suite|all>\n"
+              << "                        Run CPU microbenchmarks (skeleton, "
+                 "transform,\n"
+              << "                        jobs, clips, graphs, culling, bvh, "
+                 "picking, lod,\n"
+              << "                        ecs)\n"
+              << "                        and exit, report to "
+                 "--benchmark-output\n"
+              << "  --crowd <n>           Render a crowd of n animated "
+                 "avatars\n"
+              << "  --occlusion           Skip crowd avatars hidden behind "
+                 "nearer ones\n"
+              << "  --lod-error <px>      Largest level of detail error on "
+                 "screen (default\n"
+              << "                        1, 0 draws every mesh in full)\n"
+              << "  --trace <file>        Capture a Chrome trace from startup\n"
+              << "  --trace-frames <n>    Frames per trace capture (default "
+                 "120)\n"
+              << "  --capture <prefix>    Write every frame to "
+                 "<prefix>NNNNNN.png\n"
+              << "  --capture-format <png|raw>\n"
+              << "                        Frame capture format (default "
+                 "png)\n"
+              << "Hotkeys:\n"
+              << "  F11                   Toggle frame capture to "
+                 "capture_NNNNNN.png\n"
+              << "  F12                   Capture a Chrome trace to "
+                 "trace.json\n";
+}
+
+} // namespace CommandLine
@@ -0,0 +1,69 @@
+#ifndef HOMEWORK01_UTILS_COMMANDLINE_COMMANDLINE_HPP_
+#define HOMEWORK01_UTILS_COMMANDLINE_COMMANDLINE_HPP_
+
+#include <string>
+
+namespace CommandLine
+{
+
+/**
+ * @brief Options of the Homework03 executable.
+ */
+struct Options
+{
+    int width = 800;
+    int height = 600;
+
+    // Render offscreen through an EGL surfaceless context, no window
+    bool headless = false;
+    // Number of frames to render, 0 renders until the window closes
+    int frames = 0;
+
+    // Scripted benchmark with a fixed timestep, TEST_MODE builds run it by
+    // default
+#ifdef TEST_MODE
+    bool benchmark = true;
+#else
+    bool benchmark = false;
+#endif
+    std::string benchmarkOutput = "benchmark.json";
+    // CPU microbenchmark suite to run instead of rendering, empty means none
+    std::string microbenchmark;
+    float timestep = 1.0f / 60.0f;
+
+    // Fixed simulation tick in seconds and the most ticks a frame simulates
+    float tick = 1.0f / 60.0f;
+    int maxTicks = 8;
+
+    // Number of crowd avatars replacing the single Animal, 0 means no crowd
+    int crowd = 0;
+    // Skip crowd avatars hidden behind nearer ones, see Crowd
+    bool occlusion = false;
+    // Largest level of detail error in pixels, 0 draws every mesh in full
+    float lodError = 1.0f;
+
+    // Chrome trace capture, empty traceFile means no capture at startup
+    std::string traceFile;
+    int traceFrames = 120;
+
+    // Frame capture, empty capturePrefix means no capture at startup
+    std::string capturePrefix;
+    bool captureRaw = false;
+};
+
+/**
+ * @brief Parse \a argv into \a options.
+ *
+ * @return \c false if an argument is unknown or malformed, \a error is set to
+ * a human readable message.
+ */
+bool Parse(int argc, char *argv[], Options &options, std::string &error);
+
+/**
+ * @brief Print the usage of \a program to stdout.
+ */
+void PrintUsage(const char *program);
+
+} // namespace CommandLine
+
+#endif // HOMEWORK01_UTILS_COMMANDLINE_COMMANDLINE_HPP_
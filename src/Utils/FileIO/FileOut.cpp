@@ -0,0 +1,290 @@
+#include "FileOut.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace FileIO
+{
+
+namespace Detail
+{
+
+// Largest payload of a single deflate stored block
+constexpr std::size_t maxStoredBlock{65535};
+// Largest byte count before the Adler-32 sums have to be reduced
+constexpr std::size_t adlerChunk{5552};
+
+using CrcTable = std::array<std::array<std::uint32_t, 256>, 8>;
+
+CrcTable MakeCrcTable();
+const CrcTable &GetCrcTable();
+std::uint32_t UpdateCrc(std::uint32_t crc, const unsigned char *data,
+                        std::size_t size);
+std::uint32_t UpdateAdler(std::uint32_t adler, const unsigned char *data,
+                          std::size_t size);
+void PutBigEndian(unsigned char *output, std::uint32_t value);
+void AppendStored(std::vector<unsigned char> &zlib, std::size_t &blockLeft,
+                  std::size_t &streamLeft, const unsigned char *data,
+                  std::size_t size);
+void WriteChunk(std::ofstream &out, const char *type,
+                const unsigned char *data, std::size_t size);
+const unsigned char *GetRow(const unsigned char *pixels, int row, int height,
+                            std::size_t stride, bool flipVertically);
+
+CrcTable MakeCrcTable()
+{
+    CrcTable table{};
+
+    for (std::uint32_t i = 0; i < 256; ++i)
+    {
+        std::uint32_t c{i};
+        for (int k = 0; k < 8; ++k)
+        {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[0][i] = c;
+    }
+
+    // Slicing-by-8 tables, eight input bytes per step
+    for (std::uint32_t i = 0; i < 256; ++i)
+    {
+        for (std::size_t t = 1; t < table.size(); ++t)
+        {
+            const std::uint32_t previous{table[t - 1][i]};
+            table[t][i] = (previous >> 8) ^ table[0][previous & 0xFF];
+        }
+    }
+
+    return table;
+}
+
+const CrcTable &GetCrcTable()
+{
+    static const CrcTable table{MakeCrcTable()};
+    return table;
+}
+
+std::uint32_t UpdateCrc(std::uint32_t crc, const unsigned char *data,
+                        std::size_t size)
+{
+    const CrcTable &table{GetCrcTable()};
+
+    crc = ~crc;
+
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        crc ^= static_cast<std::uint32_t>(data[0]) |
+               static_cast<std::uint32_t>(data[1]) << 8 |
+               static_cast<std::uint32_t>(data[2]) << 16 |
+               static_cast<std::uint32_t>(data[3]) << 24;
+        crc = table[7][crc & 0xFF] ^ table[6][(crc >> 8) & 0xFF] ^
+              table[5][(crc >> 16) & 0xFF] ^ table[4][crc >> 24] ^
+              table[3][data[4]] ^ table[2][data[5]] ^ table[1][data[6]] ^
+              table[0][data[7]];
+    }
+
+    for (; size > 0; --size, ++data)
+    {
+        crc = table[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+std::uint32_t UpdateAdler(std::uint32_t adler, const unsigned char *data,
+                          std::size_t size)
+{
+    std::uint32_t a{adler & 0xFFFF};
+    std::uint32_t b{adler >> 16};
+
+    while (size > 0)
+    {
+        const std::size_t chunk{size < adlerChunk ? size : adlerChunk};
+
+        // b gains chunk * a plus every byte weighted by its distance to the
+        // end, which drops the serial dependency of the textbook loop
+        std::uint32_t sum{0};
+        std::uint32_t weighted{0};
+        for (std::size_t i = 0; i < chunk; ++i)
+        {
+            sum += data[i];
+            weighted += static_cast<std::uint32_t>(chunk - i) * data[i];
+        }
+
+        b += static_cast<std::uint32_t>(chunk) * a + weighted;
+        a += sum;
+
+        a %= 65521;
+        b %= 65521;
+        data += chunk;
+        size -= chunk;
+    }
+
+    return (b << 16) | a;
+}
+
+void PutBigEndian(unsigned char *output, std::uint32_t value)
+{
+    output[0] = static_cast<unsigned char>(value >> 24);
+    output[1] = static_cast<unsigned char>(value >> 16);
+    output[2] = static_cast<unsigned char>(value >> 8);
+    output[3] = static_cast<unsigned char>(value);
+}
+
+void AppendStored(std::vector<unsigned char> &zlib, std::size_t &blockLeft,
+                  std::size_t &streamLeft, const unsigned char *data,
+                  std::size_t size)
+{
+    while (size > 0)
+    {
+        if (blockLeft == 0)
+        {
+            blockLeft = streamLeft < maxStoredBlock ? streamLeft
+                                                    : maxStoredBlock;
+
+            zlib.push_back(blockLeft == streamLeft ? 1 : 0); // final block
+            zlib.push_back(static_cast<unsigned char>(blockLeft));
+            zlib.push_back(static_cast<unsigned char>(blockLeft >> 8));
+            zlib.push_back(static_cast<unsigned char>(~blockLeft));
+            zlib.push_back(static_cast<unsigned char>(~blockLeft >> 8));
+        }
+
+        const std::size_t length{size < blockLeft ? size : blockLeft};
+        zlib.insert(zlib.end(), data, data + length);
+
+        data += length;
+        size -= length;
+        blockLeft -= length;
+        streamLeft -= length;
+    }
+}
+
+void WriteChunk(std::ofstream &out, const char *type,
+                const unsigned char *data, std::size_t size)
+{
+    unsigned char header[8];
+    PutBigEndian(header, static_cast<std::uint32_t>(size));
+    std::memcpy(header + 4, type, 4);
+
+    std::uint32_t crc{UpdateCrc(0, header + 4, 4)};
+    crc = UpdateCrc(crc, data, size);
+
+    unsigned char footer[4];
+    PutBigEndian(footer, crc);
+
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(data),
+              static_cast<std::streamsize>(size));
+    out.write(reinterpret_cast<const char *>(footer), sizeof(footer));
+}
+
+const unsigned char *GetRow(const unsigned char *pixels, int row, int height,
+                            std::size_t stride, bool flipVertically)
+{
+    const int source{flipVertically ? height - 1 - row : row};
+    return pixels + static_cast<std::size_t>(source) * stride;
+}
+
+} // namespace Detail
+
+bool WriteImagePng(const char *fileName, int width, int height, int channels,
+                   const unsigned char *pixels, bool flipVertically)
+{
+    static const unsigned char colorTypes[]{0, 0, 4, 2, 6};
+    static const unsigned char signature[]{0x89, 'P', 'N', 'G',
+                                           '\r', '\n', 0x1A, '\n'};
+
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4)
+    {
+        return false;
+    }
+
+    std::ofstream out(fileName,
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+
+    unsigned char header[13]{};
+    Detail::PutBigEndian(header, static_cast<std::uint32_t>(width));
+    Detail::PutBigEndian(header + 4, static_cast<std::uint32_t>(height));
+    header[8] = 8; // bit depth
+    header[9] = colorTypes[channels];
+    Detail::WriteChunk(out, "IHDR", header, sizeof(header));
+
+    // Every row is prefixed with filter type 0 (None)
+    const std::size_t stride{static_cast<std::size_t>(width) * channels};
+    const std::size_t rawSize{(stride + 1) * static_cast<std::size_t>(height)};
+    const std::size_t blocks{
+        (rawSize + Detail::maxStoredBlock - 1) / Detail::maxStoredBlock};
+
+    // Reused per thread, a fresh frame sized buffer costs more in page
+    // faults than the encoding itself
+    thread_local std::vector<unsigned char> zlib;
+    zlib.clear();
+    zlib.reserve(2 + blocks * 5 + rawSize + 4);
+    zlib.push_back(0x78); // deflate, 32K window
+    zlib.push_back(0x01); // no compression preset, check bits
+
+    const unsigned char filter{0};
+    std::uint32_t adler{1};
+    std::size_t blockLeft{0};
+    std::size_t streamLeft{rawSize};
+
+    for (int row = 0; row < height; ++row)
+    {
+        const unsigned char *source{
+            Detail::GetRow(pixels, row, height, stride, flipVertically)};
+
+        Detail::AppendStored(zlib, blockLeft, streamLeft, &filter, 1);
+        Detail::AppendStored(zlib, blockLeft, streamLeft, source, stride);
+        adler = Detail::UpdateAdler(adler, &filter, 1);
+        adler = Detail::UpdateAdler(adler, source, stride);
+    }
+
+    unsigned char trailer[4];
+    Detail::PutBigEndian(trailer, adler);
+    zlib.insert(zlib.end(), trailer, trailer + sizeof(trailer));
+
+    Detail::WriteChunk(out, "IDAT", zlib.data(), zlib.size());
+    Detail::WriteChunk(out, "IEND", nullptr, 0);
+
+    return out.good();
+}
+
+bool WriteImageRaw(const char *fileName, int width, int height, int channels,
+                   const unsigned char *pixels, bool flipVertically)
+{
+    if (width <= 0 || height <= 0 || channels <= 0)
+    {
+        return false;
+    }
+
+    std::ofstream out(fileName,
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    const std::size_t stride{static_cast<std::size_t>(width) * channels};
+    for (int row = 0; row < height; ++row)
+    {
+        out.write(reinterpret_cast<const char *>(Detail::GetRow(
+                      pixels, row, height, stride, flipVertically)),
+                  static_cast<std::streamsize>(stride));
+    }
+
+    return out.good();
+}
+
+} // namespace FileIO
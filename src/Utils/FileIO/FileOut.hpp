@@ -0,0 +1,25 @@
+#ifndef HOMEWORK01_UTILS_FILEIO_FILEOUT_HPP_
+#define HOMEWORK01_UTILS_FILEIO_FILEOUT_HPP_
+
+namespace FileIO
+{
+
+/**
+ * @brief Write 8 bit \a pixels (\a channels 1 to 4) as an uncompressed PNG.
+ *
+ * The image data is stored with deflate "stored" blocks, it trades file size
+ * for an encoder that runs at memory bandwidth. Rows are read bottom-up when
+ * \a flipVertically is set, which matches glReadPixels output.
+ */
+bool WriteImagePng(const char *fileName, int width, int height, int channels,
+                   const unsigned char *pixels, bool flipVertically);
+
+/**
+ * @brief Write 8 bit \a pixels as headerless raw bytes, top row first.
+ */
+bool WriteImageRaw(const char *fileName, int width, int height, int channels,
+                   const unsigned char *pixels, bool flipVertically);
+
+} // namespace FileIO
+
+#endif // HOMEWORK01_UTILS_FILEIO_FILEOUT_HPP_
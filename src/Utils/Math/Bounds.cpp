@@ -0,0 +1,118 @@
+#include "Bounds.hpp"
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Math
+{
+
+Bounds ComputeBounds(const float *positions, std::size_t vertexCount) noexcept
+{
+    Bounds bounds;
+    if (vertexCount == 0)
+    {
+        return bounds;
+    }
+
+    bounds.minimum = bounds.maximum =
+        glm::vec3{positions[0], positions[1], positions[2]};
+    for (std::size_t vertex = 1; vertex < vertexCount; ++vertex)
+    {
+        const glm::vec3 position{positions[vertex * 3],
+                                 positions[vertex * 3 + 1],
+                                 positions[vertex * 3 + 2]};
+        bounds.minimum = glm::min(bounds.minimum, position);
+        bounds.maximum = glm::max(bounds.maximum, position);
+    }
+
+    // Centred on the box but only as large as the farthest vertex, tighter
+    // than the box's own sphere for round meshes
+    const glm::vec3 centre{(bounds.minimum + bounds.maximum) * 0.5f};
+    float radius{0.0f};
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        const glm::vec3 position{positions[vertex * 3],
+                                 positions[vertex * 3 + 1],
+                                 positions[vertex * 3 + 2]};
+        radius = std::max(radius, glm::length(position - centre));
+    }
+    bounds.sphere = glm::vec4{centre, radius};
+
+    return bounds;
+}
+
+Bounds MergeBounds(const Bounds &first, const Bounds &second) noexcept
+{
+    if (first.empty() || second.empty())
+    {
+        return first.empty() ? second : first;
+    }
+
+    Bounds bounds;
+    bounds.minimum = glm::min(first.minimum, second.minimum);
+    bounds.maximum = glm::max(first.maximum, second.maximum);
+
+    const glm::vec4 spheres[]{first.sphere, second.sphere};
+    bounds.sphere = EncloseSpheres(spheres, 2);
+
+    return bounds;
+}
+
+glm::vec4 TransformSphere(const glm::vec4 &sphere,
+                          const glm::mat4 &transform) noexcept
+{
+    const float scale{std::sqrt(std::max(
+        {glm::dot(glm::vec3{transform[0]}, glm::vec3{transform[0]}),
+         glm::dot(glm::vec3{transform[1]}, glm::vec3{transform[1]}),
+         glm::dot(glm::vec3{transform[2]}, glm::vec3{transform[2]})}))};
+
+    return glm::vec4{glm::vec3{transform * glm::vec4{glm::vec3{sphere}, 1.0f}},
+                     sphere.w * scale};
+}
+
+glm::vec4 EncloseSpheres(const glm::vec4 *spheres, std::size_t count) noexcept
+{
+    glm::vec3 minimum{0.0f};
+    glm::vec3 maximum{0.0f};
+    bool any{false};
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (spheres[i].w < 0.0f)
+        {
+            continue;
+        }
+
+        const glm::vec3 centre{spheres[i]};
+        minimum = any ? glm::min(minimum, centre - spheres[i].w)
+                      : centre - spheres[i].w;
+        maximum = any ? glm::max(maximum, centre + spheres[i].w)
+                      : centre + spheres[i].w;
+        any = true;
+    }
+
+    if (!any)
+    {
+        return glm::vec4{0.0f, 0.0f, 0.0f, -1.0f};
+    }
+
+    // Every sphere lies inside the box, the radius reaches the farthest
+    glm::vec4 enclosing{(minimum + maximum) * 0.5f, 0.0f};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (spheres[i].w >= 0.0f)
+        {
+            enclosing.w = std::max(
+                enclosing.w, glm::length(glm::vec3{spheres[i]} -
+                                         glm::vec3{enclosing}) +
+                                 spheres[i].w);
+        }
+    }
+
+    return enclosing;
+}
+
+} // namespace Math
@@ -0,0 +1,51 @@
+#ifndef HOMEWORK01_UTILS_MATH_BOUNDS_HPP_
+#define HOMEWORK01_UTILS_MATH_BOUNDS_HPP_
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+
+namespace Math
+{
+
+/**
+ * @brief Axis aligned box and bounding sphere of a mesh in its own space.
+ *
+ * @details The sphere is centred on the box and stored as (centre, radius),
+ * the layout Math::CullSpheres takes. Empty bounds have a negative radius.
+ */
+struct Bounds
+{
+    glm::vec3 minimum{0.0f};
+    glm::vec3 maximum{0.0f};
+    glm::vec4 sphere{0.0f, 0.0f, 0.0f, -1.0f};
+
+    bool empty() const noexcept { return sphere.w < 0.0f; }
+};
+
+/**
+ * @brief Compute the bounds of \a vertexCount tightly packed positions.
+ */
+Bounds ComputeBounds(const float *positions, std::size_t vertexCount) noexcept;
+/**
+ * @brief Gets bounds which contain both \a first and \a second.
+ */
+Bounds MergeBounds(const Bounds &first, const Bounds &second) noexcept;
+
+/**
+ * @brief Transform \a sphere by the affine \a transform, the radius grows by
+ * the largest scale of its axes.
+ */
+glm::vec4 TransformSphere(const glm::vec4 &sphere,
+                          const glm::mat4 &transform) noexcept;
+/**
+ * @brief Gets a sphere which contains the \a count \a spheres, centred on
+ * their box. Spheres with a negative radius are skipped.
+ */
+glm::vec4 EncloseSpheres(const glm::vec4 *spheres, std::size_t count) noexcept;
+
+} // namespace Math
+
+#endif // HOMEWORK01_UTILS_MATH_BOUNDS_HPP_
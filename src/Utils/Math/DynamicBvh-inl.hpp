@@ -0,0 +1,165 @@
+#include "glm/common.hpp"
+#include "glm/vector_relational.hpp"
+
+namespace Math
+{
+
+template <typename Visit>
+inline void DynamicBvh::queryFrustum(const Frustum &frustum,
+                                     Visit &&visit) const
+{
+    if (root_ == Null)
+    {
+        return;
+    }
+
+    // Nodes with a flag in the low bit, set below a node entirely inside
+    int stack[MaxDepth];
+    int count{0};
+    stack[count++] = root_ * 2;
+
+    while (count > 0)
+    {
+        const int entry{stack[--count]};
+        const Node &node{nodes_[entry / 2]};
+        bool inside{(entry & 1) != 0};
+
+        if (!inside)
+        {
+            const Frustum::Containment containment{
+                frustum.contains(node.minimum, node.maximum)};
+            if (containment == Frustum::Containment::Outside)
+            {
+                continue;
+            }
+            inside = containment == Frustum::Containment::Inside;
+        }
+
+        if (node.leaf())
+        {
+            visit(entry / 2);
+            continue;
+        }
+
+        stack[count++] = node.children[0] * 2 + (inside ? 1 : 0);
+        stack[count++] = node.children[1] * 2 + (inside ? 1 : 0);
+    }
+}
+
+template <typename Visit>
+inline void DynamicBvh::queryOverlap(const glm::vec3 &minimum,
+                                     const glm::vec3 &maximum,
+                                     Visit &&visit) const
+{
+    if (root_ == Null)
+    {
+        return;
+    }
+
+    int stack[MaxDepth];
+    int count{0};
+    stack[count++] = root_;
+
+    while (count > 0)
+    {
+        const int index{stack[--count]};
+        const Node &node{nodes_[index]};
+
+        if (glm::any(glm::lessThan(node.maximum, minimum)) ||
+            glm::any(glm::greaterThan(node.minimum, maximum)))
+        {
+            continue;
+        }
+
+        if (node.leaf())
+        {
+            visit(index);
+            continue;
+        }
+
+        stack[count++] = node.children[0];
+        stack[count++] = node.children[1];
+    }
+}
+
+template <typename Visit>
+inline void DynamicBvh::raycast(const glm::vec3 &origin,
+                                const glm::vec3 &direction, float maxDistance,
+                                Visit &&visit) const
+{
+    if (root_ == Null)
+    {
+        return;
+    }
+
+    const glm::vec3 inverseDirection{1.0f / direction};
+
+    int stack[MaxDepth];
+    int count{0};
+    stack[count++] = root_;
+
+    while (count > 0)
+    {
+        const int index{stack[--count]};
+        const Node &node{nodes_[index]};
+
+        const float distance{RayDistance(origin, inverseDirection,
+                                         node.minimum, node.maximum,
+                                         maxDistance)};
+        if (distance < 0.0f)
+        {
+            continue;
+        }
+
+        if (node.leaf())
+        {
+            const float clipped{visit(index, distance)};
+            if (clipped < 0.0f)
+            {
+                return;
+            }
+            maxDistance = glm::min(maxDistance, clipped);
+            continue;
+        }
+
+        // The nearer child is popped first, it clips the ray for the other
+        const int first{node.children[0]};
+        const int second{node.children[1]};
+        const float firstDistance{RayDistance(origin, inverseDirection,
+                                              nodes_[first].minimum,
+                                              nodes_[first].maximum,
+                                              maxDistance)};
+        const float secondDistance{RayDistance(origin, inverseDirection,
+                                               nodes_[second].minimum,
+                                               nodes_[second].maximum,
+                                               maxDistance)};
+        const bool firstNearer{firstDistance >= 0.0f &&
+                               (secondDistance < 0.0f ||
+                                firstDistance <= secondDistance)};
+        stack[count++] = firstNearer ? second : first;
+        stack[count++] = firstNearer ? first : second;
+    }
+}
+
+inline float DynamicBvh::RayDistance(const glm::vec3 &origin,
+                                     const glm::vec3 &inverseDirection,
+                                     const glm::vec3 &minimum,
+                                     const glm::vec3 &maximum,
+                                     float maxDistance) noexcept
+{
+    // Slabs of the three axes, the ray is inside all of them at once or
+    // misses
+    const glm::vec3 toMinimum{(minimum - origin) * inverseDirection};
+    const glm::vec3 toMaximum{(maximum - origin) * inverseDirection};
+    const glm::vec3 entry{glm::min(toMinimum, toMaximum)};
+    const glm::vec3 exit{glm::max(toMinimum, toMaximum)};
+
+    const float enter{
+        glm::max(glm::max(entry.x, entry.y), glm::max(entry.z, 0.0f))};
+    const float leave{
+        glm::min(glm::min(exit.x, exit.y), glm::min(exit.z, maxDistance))};
+
+    return enter <= leave ? enter : -1.0f;
+}
+
+} // namespace Math
@@ -0,0 +1,363 @@
+#include "DynamicBvh.hpp"
+
+#include "glm/common.hpp"
+#include "glm/vector_relational.hpp"
+
+#include <algorithm>
+
+namespace Math
+{
+
+namespace Detail
+{
+
+float surfaceArea(const glm::vec3 &minimum, const glm::vec3 &maximum) noexcept;
+
+float surfaceArea(const glm::vec3 &minimum, const glm::vec3 &maximum) noexcept
+{
+    const glm::vec3 size{maximum - minimum};
+
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+} // namespace Detail
+
+DynamicBvh::DynamicBvh(float margin) : margin_{margin} {}
+
+int DynamicBvh::insert(const glm::vec3 &minimum, const glm::vec3 &maximum,
+                       std::uint32_t userData)
+{
+    const int leaf{allocateNode()};
+    Node &node{nodes_[leaf]};
+    node.minimum = minimum - glm::vec3{margin_};
+    node.maximum = maximum + glm::vec3{margin_};
+    node.userData = userData;
+
+    insertLeaf(leaf);
+    ++proxyCount_;
+
+    return leaf;
+}
+
+void DynamicBvh::remove(int proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --proxyCount_;
+}
+
+bool DynamicBvh::move(int proxy, const glm::vec3 &minimum,
+                      const glm::vec3 &maximum)
+{
+    if (glm::all(glm::greaterThanEqual(minimum, nodes_[proxy].minimum)) &&
+        glm::all(glm::lessThanEqual(maximum, nodes_[proxy].maximum)))
+    {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    nodes_[proxy].minimum = minimum - glm::vec3{margin_};
+    nodes_[proxy].maximum = maximum + glm::vec3{margin_};
+    insertLeaf(proxy);
+
+    return true;
+}
+
+void DynamicBvh::clear()
+{
+    nodes_.clear();
+    root_ = Null;
+    free_ = Null;
+    proxyCount_ = 0;
+}
+
+int DynamicBvh::height() const noexcept
+{
+    return root_ == Null ? 0 : nodes_[root_].height;
+}
+
+float DynamicBvh::areaRatio() const noexcept
+{
+    if (root_ == Null)
+    {
+        return 0.0f;
+    }
+
+    float area{0.0f};
+    for (const Node &node : nodes_)
+    {
+        if (node.height > 0)
+        {
+            area += Detail::surfaceArea(node.minimum, node.maximum);
+        }
+    }
+
+    const float rootArea{
+        Detail::surfaceArea(nodes_[root_].minimum, nodes_[root_].maximum)};
+
+    return rootArea > 0.0f ? area / rootArea : 0.0f;
+}
+
+bool DynamicBvh::validate() const
+{
+    std::size_t reached{0};
+    std::size_t leaves{0};
+
+    std::vector<int> stack;
+    if (root_ != Null)
+    {
+        if (nodes_[root_].parent != Null)
+        {
+            return false;
+        }
+        stack.push_back(root_);
+    }
+
+    while (!stack.empty())
+    {
+        const int index{stack.back()};
+        stack.pop_back();
+        const Node &node{nodes_[index]};
+        ++reached;
+
+        if (node.leaf())
+        {
+            ++leaves;
+            if (node.children[1] != Null || node.height != 0)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        const Node &first{nodes_[node.children[0]]};
+        const Node &second{nodes_[node.children[1]]};
+        if (first.parent != index || second.parent != index ||
+            node.height != 1 + std::max(first.height, second.height) ||
+            node.minimum != glm::min(first.minimum, second.minimum) ||
+            node.maximum != glm::max(first.maximum, second.maximum))
+        {
+            return false;
+        }
+
+        stack.push_back(node.children[0]);
+        stack.push_back(node.children[1]);
+    }
+
+    std::size_t freeNodes{0};
+    for (int index = free_; index != Null; index = nodes_[index].parent)
+    {
+        ++freeNodes;
+    }
+
+    return leaves == proxyCount_ && reached + freeNodes == nodes_.size();
+}
+
+int DynamicBvh::allocateNode()
+{
+    int index{free_};
+    if (index == Null)
+    {
+        nodes_.push_back(Node{});
+        index = static_cast<int>(nodes_.size()) - 1;
+    }
+    else
+    {
+        free_ = nodes_[index].parent;
+    }
+
+    Node &node{nodes_[index]};
+    node.parent = Null;
+    node.children[0] = Null;
+    node.children[1] = Null;
+    node.height = 0;
+    node.userData = 0;
+
+    return index;
+}
+
+void DynamicBvh::freeNode(int node)
+{
+    nodes_[node].parent = free_;
+    nodes_[node].height = -1;
+    free_ = node;
+}
+
+void DynamicBvh::insertLeaf(int leaf)
+{
+    if (root_ == Null)
+    {
+        root_ = leaf;
+        nodes_[leaf].parent = Null;
+        return;
+    }
+
+    const glm::vec3 minimum{nodes_[leaf].minimum};
+    const glm::vec3 maximum{nodes_[leaf].maximum};
+
+    // Descend while the leaf is cheaper below than as a sibling here. A new
+    // parent costs its area, every node passed on the way grows too
+    int index{root_};
+    while (!nodes_[index].leaf())
+    {
+        const Node &node{nodes_[index]};
+        const float area{Detail::surfaceArea(node.minimum, node.maximum)};
+        const float combined{Detail::surfaceArea(
+            glm::min(node.minimum, minimum), glm::max(node.maximum, maximum))};
+        const float cost{2.0f * combined};
+        const float inheritance{2.0f * (combined - area)};
+
+        float childCosts[2];
+        for (int side = 0; side < 2; ++side)
+        {
+            const Node &child{nodes_[node.children[side]]};
+            const float merged{
+                Detail::surfaceArea(glm::min(child.minimum, minimum),
+                                    glm::max(child.maximum, maximum))};
+            childCosts[side] =
+                (child.leaf() ? merged
+                              : merged - Detail::surfaceArea(child.minimum,
+                                                             child.maximum)) +
+                inheritance;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+        {
+            break;
+        }
+        index = node.children[childCosts[0] < childCosts[1] ? 0 : 1];
+    }
+
+    const int sibling{index};
+    const int oldParent{nodes_[sibling].parent};
+    const int newParent{allocateNode()};
+
+    Node &parent{nodes_[newParent]};
+    parent.parent = oldParent;
+    parent.children[0] = sibling;
+    parent.children[1] = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+    refitNode(newParent);
+
+    if (oldParent == Null)
+    {
+        root_ = newParent;
+    }
+    else
+    {
+        Node &grandParent{nodes_[oldParent]};
+        grandParent.children[grandParent.children[0] == sibling ? 0 : 1] =
+            newParent;
+    }
+
+    for (index = newParent; index != Null; index = nodes_[index].parent)
+    {
+        index = balance(index);
+        refitNode(index);
+    }
+}
+
+void DynamicBvh::removeLeaf(int leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = Null;
+        return;
+    }
+
+    const int parent{nodes_[leaf].parent};
+    const int grandParent{nodes_[parent].parent};
+    const int sibling{
+        nodes_[parent].children[nodes_[parent].children[0] == leaf ? 1 : 0]};
+
+    nodes_[sibling].parent = grandParent;
+    freeNode(parent);
+
+    if (grandParent == Null)
+    {
+        root_ = sibling;
+        return;
+    }
+
+    Node &node{nodes_[grandParent]};
+    node.children[node.children[0] == parent ? 0 : 1] = sibling;
+
+    for (int index = grandParent; index != Null; index = nodes_[index].parent)
+    {
+        index = balance(index);
+        refitNode(index);
+    }
+}
+
+int DynamicBvh::balance(int node)
+{
+    const Node &a{nodes_[node]};
+    if (a.leaf() || a.height < 2)
+    {
+        return node;
+    }
+
+    const int difference{nodes_[a.children[1]].height -
+                         nodes_[a.children[0]].height};
+    if (difference > 1)
+    {
+        return rotate(node, 1);
+    }
+    if (difference < -1)
+    {
+        return rotate(node, 0);
+    }
+
+    return node;
+}
+
+int DynamicBvh::rotate(int node, int side)
+{
+    const int up{nodes_[node].children[side]};
+    Node &a{nodes_[node]};
+    Node &c{nodes_[up]};
+
+    // The child takes the node's place, the node becomes its child
+    c.parent = a.parent;
+    a.parent = up;
+    if (c.parent == Null)
+    {
+        root_ = up;
+    }
+    else
+    {
+        Node &parent{nodes_[c.parent]};
+        parent.children[parent.children[0] == node ? 0 : 1] = up;
+    }
+
+    // The taller grandchild stays up, the other moves down in its place
+    const int first{c.children[0]};
+    const int second{c.children[1]};
+    const bool keepFirst{nodes_[first].height > nodes_[second].height};
+    const int kept{keepFirst ? first : second};
+    const int moved{keepFirst ? second : first};
+
+    c.children[0] = node;
+    c.children[1] = kept;
+    a.children[side] = moved;
+    nodes_[moved].parent = node;
+
+    refitNode(node);
+    refitNode(up);
+
+    return up;
+}
+
+void DynamicBvh::refitNode(int node) noexcept
+{
+    Node &parent{nodes_[node]};
+    const Node &first{nodes_[parent.children[0]]};
+    const Node &second{nodes_[parent.children[1]]};
+
+    parent.minimum = glm::min(first.minimum, second.minimum);
+    parent.maximum = glm::max(first.maximum, second.maximum);
+    parent.height = 1 + std::max(first.height, second.height);
+}
+
+} // namespace Math
@@ -0,0 +1,156 @@
+#ifndef HOMEWORK01_UTILS_MATH_DYNAMICBVH_HPP_
+#define HOMEWORK01_UTILS_MATH_DYNAMICBVH_HPP_
+
+#include "Utils/Math/Frustum.hpp"
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Math
+{
+
+/**
+ * @brief Dynamic bounding volume hierarchy of axis aligned boxes.
+ *
+ * @details Every proxy is a leaf holding its box grown by a margin, so small
+ * moves do not touch the tree. A leaf is inserted next to the sibling which
+ * adds the least surface area to the tree (the surface area heuristic) and
+ * the path to the root is rebalanced by rotations, the tree stays about
+ * log2 of the proxies high under any order of inserts, removes and moves.
+ *
+ * Queries walk the tree with a fixed stack and call back with every proxy
+ * whose grown box passes, the caller tests its exact bounds. Queries do not
+ * modify the tree, any number of threads may run them between updates.
+ */
+class DynamicBvh
+{
+public:
+    static constexpr int Null = -1;
+    // Deeper than any balanced tree of 2^32 proxies
+    static constexpr int MaxDepth = 96;
+
+    /**
+     * @brief Create an empty tree growing every box by \a margin.
+     */
+    explicit DynamicBvh(float margin = 0.1f);
+
+    /**
+     * @brief Add a proxy for the box from \a minimum to \a maximum carrying
+     * \a userData.
+     *
+     * @return The proxy, valid until DynamicBvh::remove.
+     */
+    int insert(const glm::vec3 &minimum, const glm::vec3 &maximum,
+               std::uint32_t userData);
+    void remove(int proxy);
+    /**
+     * @brief Refit \a proxy to the box from \a minimum to \a maximum.
+     *
+     * @return \c true if the box left the grown box and the proxy was
+     * reinserted, \c false if the tree is unchanged.
+     */
+    bool move(int proxy, const glm::vec3 &minimum, const glm::vec3 &maximum);
+    void clear();
+
+    std::uint32_t userData(int proxy) const noexcept
+    {
+        return nodes_[proxy].userData;
+    }
+    const glm::vec3 &minimum(int proxy) const noexcept
+    {
+        return nodes_[proxy].minimum;
+    }
+    const glm::vec3 &maximum(int proxy) const noexcept
+    {
+        return nodes_[proxy].maximum;
+    }
+
+    std::size_t proxyCount() const noexcept { return proxyCount_; }
+    int height() const noexcept;
+    /**
+     * @brief Gets the surface area of every internal node over the root's,
+     * lower is a better tree.
+     */
+    float areaRatio() const noexcept;
+    /**
+     * @brief Check the links, heights and boxes of every node.
+     *
+     * @return \c false if any node is inconsistent.
+     */
+    bool validate() const;
+
+    /**
+     * @brief Call \a visit(proxy) for every proxy whose box is at least
+     * partly inside \a frustum.
+     *
+     * @details Subtrees entirely inside are reported without further tests.
+     */
+    template <typename Visit>
+    void queryFrustum(const Frustum &frustum, Visit &&visit) const;
+    /**
+     * @brief Call \a visit(proxy) for every proxy whose box overlaps the box
+     * from \a minimum to \a maximum.
+     */
+    template <typename Visit>
+    void queryOverlap(const glm::vec3 &minimum, const glm::vec3 &maximum,
+                      Visit &&visit) const;
+    /**
+     * @brief Call \a visit(proxy, distance) for every proxy whose box the ray
+     * from \a origin along \a direction hits within \a maxDistance.
+     *
+     * @details \a visit returns the distance the ray is clipped to, the
+     * distance it was given to keep looking, a negative value to stop.
+     * Distances are in units of \a direction.
+     */
+    template <typename Visit>
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                 float maxDistance, Visit &&visit) const;
+
+    /**
+     * @brief Gets the distance along the ray at which it enters the box, or
+     * a negative value if it misses the box within \a maxDistance.
+     */
+    static float RayDistance(const glm::vec3 &origin,
+                             const glm::vec3 &inverseDirection,
+                             const glm::vec3 &minimum,
+                             const glm::vec3 &maximum,
+                             float maxDistance) noexcept;
+
+private:
+    struct Node
+    {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int parent; // next free node while on the free list
+        int children[2];
+        int height; // 0 for leaves, -1 for free nodes
+        std::uint32_t userData;
+
+        bool leaf() const noexcept { return children[0] == Null; }
+    };
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    // Rotate the taller child of \a node up if the children's heights differ
+    // by more than one, returns the node now at its place
+    int balance(int node);
+    int rotate(int node, int side);
+    void refitNode(int node) noexcept;
+
+    std::vector<Node> nodes_;
+    int root_ = Null;
+    int free_ = Null;
+    std::size_t proxyCount_ = 0;
+    float margin_;
+};
+
+} // namespace Math
+
+#include "DynamicBvh-inl.hpp"
+
+#endif // HOMEWORK01_UTILS_MATH_DYNAMICBVH_HPP_
@@ -0,0 +1,388 @@
+#include "EulerTransform.hpp"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PROGRAM_EULER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#define PROGRAM_EULER_SSE2
+#endif
+
+namespace Math
+{
+
+namespace Detail
+{
+
+constexpr float degreesToRadians{0.01745329251994329576923690768489f};
+
+/**
+ * @brief Write the rotation \a rotation (row-major 3x3), scaled per column by
+ * \a scale and placed at \a offset, into the column-major \a output.
+ */
+void writeTransform(const float (&rotation)[9], const glm::vec3 &offset,
+                    const glm::vec3 &scale, glm::mat4 &output) noexcept;
+
+void writeTransform(const float (&rotation)[9], const glm::vec3 &offset,
+                    const glm::vec3 &scale, glm::mat4 &output) noexcept
+{
+    output[0] = glm::vec4{rotation[0] * scale.x, rotation[3] * scale.x,
+                          rotation[6] * scale.x, 0.0f};
+    output[1] = glm::vec4{rotation[1] * scale.y, rotation[4] * scale.y,
+                          rotation[7] * scale.y, 0.0f};
+    output[2] = glm::vec4{rotation[2] * scale.z, rotation[5] * scale.z,
+                          rotation[8] * scale.z, 0.0f};
+    output[3] = glm::vec4{offset, 1.0f};
+}
+
+#if defined(PROGRAM_EULER_SSE2) || defined(PROGRAM_EULER_AVX2)
+
+// Cody-Waite split of pi / 2 and the minimax polynomials of sin and cos on
+// [-pi / 4, pi / 4] (Cephes single precision)
+constexpr float twoOverPi{0.636619772367581343f};
+constexpr float halfPiPart1{1.5703125f};
+constexpr float halfPiPart2{4.837512969970703125e-4f};
+constexpr float halfPiPart3{7.54978995489188216e-8f};
+constexpr float sine1{-1.6666654611e-1f};
+constexpr float sine2{8.3321608736e-3f};
+constexpr float sine3{-1.9515295891e-4f};
+constexpr float cosine1{4.166664568298827e-2f};
+constexpr float cosine2{-1.388731625493765e-3f};
+constexpr float cosine3{2.443315711809948e-5f};
+
+/**
+ * @brief Transpose four lanes of \a x, \a y, \a z, \a w into column
+ * \a column of output[0] to output[3].
+ */
+inline void storeColumn(__m128 x, __m128 y, __m128 z, __m128 w,
+                        glm::mat4 *output, int column) noexcept
+{
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&output[0][column][0], x);
+    _mm_storeu_ps(&output[1][column][0], y);
+    _mm_storeu_ps(&output[2][column][0], z);
+    _mm_storeu_ps(&output[3][column][0], w);
+}
+
+#endif
+
+#if defined(PROGRAM_EULER_SSE2)
+
+struct Float4
+{
+    using Vector = __m128;
+    using Integer = __m128i;
+
+    static constexpr std::size_t Width = 4;
+
+    // Every third float from \a values, one component of consecutive vec3
+    static Vector gather(const float *values) noexcept
+    {
+        return _mm_setr_ps(values[0], values[3], values[6], values[9]);
+    }
+    static Vector broadcast(float value) noexcept { return _mm_set1_ps(value); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) noexcept { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) noexcept { return _mm_mul_ps(a, b); }
+    static Integer round(Vector value) noexcept
+    {
+        return _mm_cvtps_epi32(value);
+    }
+    static Integer increment(Integer value) noexcept
+    {
+        return _mm_add_epi32(value, _mm_set1_epi32(1));
+    }
+    static Vector toFloat(Integer value) noexcept
+    {
+        return _mm_cvtepi32_ps(value);
+    }
+    static Vector bitSet(Integer value, int bit) noexcept
+    {
+        const Integer mask{_mm_set1_epi32(bit)};
+        return _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_and_si128(value, mask), mask));
+    }
+    static Vector select(Vector mask, Vector a, Vector b) noexcept
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static Vector negate(Vector mask, Vector value) noexcept
+    {
+        return _mm_xor_ps(value, _mm_and_ps(mask, _mm_set1_ps(-0.0f)));
+    }
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w,
+                            glm::mat4 *output, int column) noexcept
+    {
+        Detail::storeColumn(x, y, z, w, output, column);
+    }
+};
+
+using Batch = Float4;
+
+#elif defined(PROGRAM_EULER_AVX2)
+
+struct Float8
+{
+    using Vector = __m256;
+    using Integer = __m256i;
+
+    static constexpr std::size_t Width = 8;
+
+    // Every third float from \a values, one component of consecutive vec3
+    static Vector gather(const float *values) noexcept
+    {
+        return _mm256_setr_ps(values[0], values[3], values[6], values[9],
+                              values[12], values[15], values[18],
+                              values[21]);
+    }
+    static Vector broadcast(float value) noexcept
+    {
+        return _mm256_set1_ps(value);
+    }
+    static Vector add(Vector a, Vector b) noexcept
+    {
+        return _mm256_add_ps(a, b);
+    }
+    static Vector sub(Vector a, Vector b) noexcept
+    {
+        return _mm256_sub_ps(a, b);
+    }
+    static Vector mul(Vector a, Vector b) noexcept
+    {
+        return _mm256_mul_ps(a, b);
+    }
+    static Integer round(Vector value) noexcept
+    {
+        return _mm256_cvtps_epi32(value);
+    }
+    static Integer increment(Integer value) noexcept
+    {
+        return _mm256_add_epi32(value, _mm256_set1_epi32(1));
+    }
+    static Vector toFloat(Integer value) noexcept
+    {
+        return _mm256_cvtepi32_ps(value);
+    }
+    static Vector bitSet(Integer value, int bit) noexcept
+    {
+        const Integer mask{_mm256_set1_epi32(bit)};
+        return _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(value, mask), mask));
+    }
+    static Vector select(Vector mask, Vector a, Vector b) noexcept
+    {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+    static Vector negate(Vector mask, Vector value) noexcept
+    {
+        return _mm256_xor_ps(value,
+                             _mm256_and_ps(mask, _mm256_set1_ps(-0.0f)));
+    }
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w,
+                            glm::mat4 *output, int column) noexcept
+    {
+        Detail::storeColumn(
+            _mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+            _mm256_castps256_ps128(z), _mm256_castps256_ps128(w), output,
+            column);
+        Detail::storeColumn(
+            _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+            _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1),
+            output + 4, column);
+    }
+};
+
+using Batch = Float8;
+
+#endif
+
+#if defined(PROGRAM_EULER_SSE2) || defined(PROGRAM_EULER_AVX2)
+
+/**
+ * @brief Sine and cosine of every lane of \a angle (radians).
+ */
+template <typename Simd>
+inline void sinCos(typename Simd::Vector angle, typename Simd::Vector &sine,
+                   typename Simd::Vector &cosine) noexcept;
+
+/**
+ * @brief Compose Simd::Width transforms, see Math::ComposeEulerTransforms.
+ */
+template <typename Simd>
+void composeBlock(const glm::vec3 *offsets, const glm::vec3 *rotations,
+                  const glm::vec3 *scales, glm::mat4 *output) noexcept;
+
+template <typename Simd>
+inline void sinCos(typename Simd::Vector angle, typename Simd::Vector &sine,
+                   typename Simd::Vector &cosine) noexcept
+{
+    using Vector = typename Simd::Vector;
+
+    // Reduce to [-pi / 4, pi / 4], the quadrant picks the result below
+    const typename Simd::Integer quadrant{
+        Simd::round(Simd::mul(angle, Simd::broadcast(twoOverPi)))};
+    const Vector turns{Simd::toFloat(quadrant)};
+
+    Vector x{Simd::sub(angle, Simd::mul(turns, Simd::broadcast(halfPiPart1)))};
+    x = Simd::sub(x, Simd::mul(turns, Simd::broadcast(halfPiPart2)));
+    x = Simd::sub(x, Simd::mul(turns, Simd::broadcast(halfPiPart3)));
+
+    const Vector x2{Simd::mul(x, x)};
+
+    Vector s{Simd::add(Simd::broadcast(sine2),
+                       Simd::mul(x2, Simd::broadcast(sine3)))};
+    s = Simd::add(Simd::broadcast(sine1), Simd::mul(x2, s));
+    s = Simd::add(x, Simd::mul(Simd::mul(x, x2), s));
+
+    Vector c{Simd::add(Simd::broadcast(cosine2),
+                       Simd::mul(x2, Simd::broadcast(cosine3)))};
+    c = Simd::add(Simd::broadcast(cosine1), Simd::mul(x2, c));
+    c = Simd::add(
+        Simd::sub(Simd::broadcast(1.0f),
+                  Simd::mul(Simd::broadcast(0.5f), x2)),
+        Simd::mul(Simd::mul(x2, x2), c));
+
+    // Quadrants 1 and 3 swap sine and cosine, the sign follows the quadrant
+    const Vector swap{Simd::bitSet(quadrant, 1)};
+    sine = Simd::negate(Simd::bitSet(quadrant, 2), Simd::select(swap, c, s));
+    cosine = Simd::negate(Simd::bitSet(Simd::increment(quadrant), 2),
+                          Simd::select(swap, s, c));
+}
+
+template <typename Simd>
+void composeBlock(const glm::vec3 *offsets, const glm::vec3 *rotations,
+                  const glm::vec3 *scales, glm::mat4 *output) noexcept
+{
+    using Vector = typename Simd::Vector;
+
+    // One register per axis
+    const float *angles{&rotations[0].x};
+    const Vector toRadians{Simd::broadcast(degreesToRadians)};
+    Vector sx, cx, sy, cy, sz, cz;
+    sinCos<Simd>(Simd::mul(Simd::gather(angles), toRadians), sx, cx);
+    sinCos<Simd>(Simd::mul(Simd::gather(angles + 1), toRadians), sy, cy);
+    sinCos<Simd>(Simd::mul(Simd::gather(angles + 2), toRadians), sz, cz);
+
+    const Vector one{Simd::broadcast(1.0f)};
+    const float *sizes{scales ? &scales[0].x : nullptr};
+    const Vector kx{sizes ? Simd::gather(sizes) : one};
+    const Vector ky{sizes ? Simd::gather(sizes + 1) : one};
+    const Vector kz{sizes ? Simd::gather(sizes + 2) : one};
+
+    // Rx * Ry * Rz expanded, each column scaled by its axis
+    const Vector zero{Simd::broadcast(0.0f)};
+    const Vector sxsy{Simd::mul(sx, sy)};
+    const Vector cxsy{Simd::mul(cx, sy)};
+
+    Simd::storeColumn(
+        Simd::mul(Simd::mul(cy, cz), kx),
+        Simd::mul(Simd::add(Simd::mul(sxsy, cz), Simd::mul(cx, sz)), kx),
+        Simd::mul(Simd::sub(Simd::mul(sx, sz), Simd::mul(cxsy, cz)), kx),
+        zero, output, 0);
+
+    Simd::storeColumn(
+        Simd::mul(Simd::sub(zero, Simd::mul(cy, sz)), ky),
+        Simd::mul(Simd::sub(Simd::mul(cx, cz), Simd::mul(sxsy, sz)), ky),
+        Simd::mul(Simd::add(Simd::mul(cxsy, sz), Simd::mul(sx, cz)), ky),
+        zero, output, 1);
+
+    Simd::storeColumn(Simd::mul(sy, kz),
+                      Simd::mul(Simd::sub(zero, Simd::mul(sx, cy)), kz),
+                      Simd::mul(Simd::mul(cx, cy), kz), zero, output, 2);
+
+    for (std::size_t lane = 0; lane < Simd::Width; ++lane)
+    {
+        output[lane][3] = glm::vec4{offsets[lane], 1.0f};
+    }
+}
+
+#endif
+
+} // namespace Detail
+
+glm::mat4 ComposeEulerTransform(const glm::vec3 &offset,
+                                const glm::vec3 &rotation,
+                                const glm::vec3 &scale) noexcept
+{
+    glm::mat4 transform;
+    ComposeEulerTransformsScalar(&offset, &rotation, &scale, 1, &transform);
+
+    return transform;
+}
+
+void ComposeEulerTransforms(const glm::vec3 *offsets,
+                            const glm::vec3 *rotations,
+                            const glm::vec3 *scales, std::size_t count,
+                            glm::mat4 *output) noexcept
+{
+    std::size_t joint{0};
+
+#if defined(PROGRAM_EULER_SSE2) || defined(PROGRAM_EULER_AVX2)
+    constexpr std::size_t width{Detail::Batch::Width};
+
+    for (; joint + width <= count; joint += width)
+    {
+        Detail::composeBlock<Detail::Batch>(offsets + joint, rotations + joint,
+                                            scales ? scales + joint : nullptr,
+                                            output + joint);
+    }
+#endif
+
+    ComposeEulerTransformsScalar(offsets + joint, rotations + joint,
+                                 scales ? scales + joint : nullptr,
+                                 count - joint, output + joint);
+}
+
+void ComposeEulerTransformsScalar(const glm::vec3 *offsets,
+                                  const glm::vec3 *rotations,
+                                  const glm::vec3 *scales, std::size_t count,
+                                  glm::mat4 *output) noexcept
+{
+    for (std::size_t joint = 0; joint < count; ++joint)
+    {
+        const glm::vec3 angles{rotations[joint] * Detail::degreesToRadians};
+        const float sx{std::sin(angles.x)}, cx{std::cos(angles.x)};
+        const float sy{std::sin(angles.y)}, cy{std::cos(angles.y)};
+        const float sz{std::sin(angles.z)}, cz{std::cos(angles.z)};
+
+        const float rotation[9]{cy * cz,
+                                -cy * sz,
+                                sy,
+                                sx * sy * cz + cx * sz,
+                                cx * cz - sx * sy * sz,
+                                -sx * cy,
+                                sx * sz - cx * sy * cz,
+                                cx * sy * sz + sx * cz,
+                                cx * cy};
+
+        Detail::writeTransform(rotation, offsets[joint],
+                               scales ? scales[joint] : glm::vec3{1.0f},
+                               output[joint]);
+    }
+}
+
+std::size_t EulerTransformWidth() noexcept
+{
+#if defined(PROGRAM_EULER_SSE2) || defined(PROGRAM_EULER_AVX2)
+    return Detail::Batch::Width;
+#else
+    return 1;
+#endif
+}
+
+const char *EulerTransformPath() noexcept
+{
+#if defined(PROGRAM_EULER_AVX2)
+    return "avx2";
+#elif defined(PROGRAM_EULER_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Math
@@ -0,0 +1,60 @@
+#ifndef HOMEWORK01_UTILS_MATH_EULERTRANSFORM_HPP_
+#define HOMEWORK01_UTILS_MATH_EULERTRANSFORM_HPP_
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+
+namespace Math
+{
+
+/**
+ * @brief Compose translate(offset) * rotateX * rotateY * rotateZ *
+ * scale(scale) in closed form.
+ *
+ * @details \a rotation holds Euler angles in degrees, applied in X, Y, Z order
+ * like Skeleton and Joint. Only the upper 3x4 block is computed, the last row
+ * is always (0, 0, 0, 1).
+ */
+glm::mat4 ComposeEulerTransform(const glm::vec3 &offset,
+                                const glm::vec3 &rotation,
+                                const glm::vec3 &scale = glm::vec3{
+                                    1.0f}) noexcept;
+
+/**
+ * @brief Compose \a count transforms like Math::ComposeEulerTransform.
+ *
+ * @details Joints are processed EulerTransformWidth at a time with SSE2, or
+ * AVX2 when the program is built with ENABLE_AVX2, the remainder goes through
+ * the scalar path. \a scales may be \c nullptr for unit scales. \a output must
+ * not alias the inputs.
+ */
+void ComposeEulerTransforms(const glm::vec3 *offsets,
+                            const glm::vec3 *rotations,
+                            const glm::vec3 *scales, std::size_t count,
+                            glm::mat4 *output) noexcept;
+
+/**
+ * @brief Scalar reference of Math::ComposeEulerTransforms, using the standard
+ * library sine and cosine.
+ */
+void ComposeEulerTransformsScalar(const glm::vec3 *offsets,
+                                  const glm::vec3 *rotations,
+                                  const glm::vec3 *scales, std::size_t count,
+                                  glm::mat4 *output) noexcept;
+
+/**
+ * @brief Gets the number of joints the batch kernel processes at once, 1 for
+ * the scalar fallback.
+ */
+std::size_t EulerTransformWidth() noexcept;
+/**
+ * @brief Gets the instruction set of the batch kernel, "avx2", "sse2" or
+ * "scalar".
+ */
+const char *EulerTransformPath() noexcept;
+
+} // namespace Math
+
+#endif // HOMEWORK01_UTILS_MATH_EULERTRANSFORM_HPP_
@@ -0,0 +1,166 @@
+#include "Frustum.hpp"
+
+#include "glm/geometric.hpp"
+#include "glm/vec3.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define PROGRAM_FRUSTUM_SSE2
+#endif
+
+namespace Math
+{
+
+namespace Detail
+{
+
+CullingStatistics cullingStatistics;
+
+glm::vec4 normalizePlane(const glm::vec4 &plane) noexcept;
+
+glm::vec4 normalizePlane(const glm::vec4 &plane) noexcept
+{
+    const float length{glm::length(glm::vec3{plane})};
+
+    return length > 0.0f ? plane / length : plane;
+}
+
+} // namespace Detail
+
+CullingStatistics &CullingStatistics::current() noexcept
+{
+    return Detail::cullingStatistics;
+}
+
+void CullingStatistics::reset() noexcept { Detail::cullingStatistics = {}; }
+
+Frustum::Frustum() noexcept
+{
+    // Every point is a unit in front of every plane
+    for (glm::vec4 &plane : planes_)
+    {
+        plane = glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+    }
+}
+
+Frustum::Frustum(const glm::mat4 &viewProjection) noexcept
+{
+    // Rows of the matrix, glm is column major
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; ++row)
+    {
+        rows[row] = glm::vec4{viewProjection[0][row], viewProjection[1][row],
+                              viewProjection[2][row], viewProjection[3][row]};
+    }
+
+    // Left, right, bottom, top, near and far, -w <= x, y, z <= w in clip space
+    planes_[0] = Detail::normalizePlane(rows[3] + rows[0]);
+    planes_[1] = Detail::normalizePlane(rows[3] - rows[0]);
+    planes_[2] = Detail::normalizePlane(rows[3] + rows[1]);
+    planes_[3] = Detail::normalizePlane(rows[3] - rows[1]);
+    planes_[4] = Detail::normalizePlane(rows[3] + rows[2]);
+    planes_[5] = Detail::normalizePlane(rows[3] - rows[2]);
+}
+
+bool Frustum::intersects(const glm::vec4 &sphere) const noexcept
+{
+    // Summed in the order of the SSE2 path, both agree on the boundary
+    for (const glm::vec4 &plane : planes_)
+    {
+        const float distance{(plane.x * sphere.x + plane.y * sphere.y) +
+                             (plane.z * sphere.z + plane.w)};
+        if (distance < -sphere.w)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Frustum::Containment Frustum::contains(const glm::vec3 &minimum,
+                                       const glm::vec3 &maximum) const noexcept
+{
+    Containment containment{Containment::Inside};
+
+    for (const glm::vec4 &plane : planes_)
+    {
+        const glm::vec3 farthest{plane.x >= 0.0f ? maximum.x : minimum.x,
+                                 plane.y >= 0.0f ? maximum.y : minimum.y,
+                                 plane.z >= 0.0f ? maximum.z : minimum.z};
+        if (glm::dot(glm::vec3{plane}, farthest) + plane.w < 0.0f)
+        {
+            return Containment::Outside;
+        }
+
+        const glm::vec3 nearest{plane.x >= 0.0f ? minimum.x : maximum.x,
+                                plane.y >= 0.0f ? minimum.y : maximum.y,
+                                plane.z >= 0.0f ? minimum.z : maximum.z};
+        if (glm::dot(glm::vec3{plane}, nearest) + plane.w < 0.0f)
+        {
+            containment = Containment::Intersects;
+        }
+    }
+
+    return containment;
+}
+
+void CullSpheres(const Frustum &frustum, const glm::vec4 *spheres,
+                 std::size_t count, std::uint8_t *visible) noexcept
+{
+    std::size_t first{0};
+
+#if defined(PROGRAM_FRUSTUM_SSE2)
+    for (; first + 4 <= count; first += 4)
+    {
+        // Four spheres to one register per component
+        __m128 x{_mm_loadu_ps(&spheres[first].x)};
+        __m128 y{_mm_loadu_ps(&spheres[first + 1].x)};
+        __m128 z{_mm_loadu_ps(&spheres[first + 2].x)};
+        __m128 radius{_mm_loadu_ps(&spheres[first + 3].x)};
+        _MM_TRANSPOSE4_PS(x, y, z, radius);
+
+        const __m128 limit{_mm_sub_ps(_mm_setzero_ps(), radius)};
+        __m128 outside{_mm_setzero_ps()};
+        for (int plane = 0; plane < Frustum::PlaneCount; ++plane)
+        {
+            const glm::vec4 &normal{frustum.plane(plane)};
+            const __m128 distance{_mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.x), x),
+                           _mm_mul_ps(_mm_set1_ps(normal.y), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.z), z),
+                           _mm_set1_ps(normal.w)))};
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, limit));
+        }
+
+        const int mask{_mm_movemask_ps(outside)};
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            visible[first + lane] = ((mask >> lane) & 1) ? 0 : 1;
+        }
+    }
+#endif
+
+    CullSpheresScalar(frustum, spheres + first, count - first, visible + first);
+}
+
+void CullSpheresScalar(const Frustum &frustum, const glm::vec4 *spheres,
+                       std::size_t count, std::uint8_t *visible) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        visible[i] = frustum.intersects(spheres[i]) ? 1 : 0;
+    }
+}
+
+const char *CullSpheresPath() noexcept
+{
+#if defined(PROGRAM_FRUSTUM_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Math
@@ -0,0 +1,102 @@
+#ifndef HOMEWORK01_UTILS_MATH_FRUSTUM_HPP_
+#define HOMEWORK01_UTILS_MATH_FRUSTUM_HPP_
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Math
+{
+
+/**
+ * @brief Counters of the avatars and body parts tested against the view
+ * frustum, and of the avatars in view skipped as occluded.
+ */
+struct CullingStatistics
+{
+    std::uint32_t avatarsDrawn = 0;
+    std::uint32_t avatarsCulled = 0;
+    std::uint32_t avatarsOccluded = 0;
+    std::uint32_t partsDrawn = 0;
+    std::uint32_t partsCulled = 0;
+
+    /**
+     * @brief Gets the counters of the current frame.
+     */
+    static CullingStatistics &current() noexcept;
+    /**
+     * @brief Reset the counters of the current frame.
+     */
+    static void reset() noexcept;
+};
+
+/**
+ * @brief The six planes of a view frustum, normals pointing inwards.
+ *
+ * @details The planes are extracted from the combined projection and view
+ * matrix (Gribb and Hartmann) and normalized, a point's distance to a plane
+ * is dot(plane, (point, 1)). A default constructed frustum contains
+ * everything.
+ */
+class Frustum
+{
+public:
+    static constexpr int PlaneCount = 6;
+
+    enum class Containment
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    Frustum() noexcept;
+    explicit Frustum(const glm::mat4 &viewProjection) noexcept;
+
+    const glm::vec4 &plane(int plane) const noexcept { return planes_[plane]; }
+
+    /**
+     * @brief Gets whether the sphere (centre, radius) \a sphere is at least
+     * partly inside.
+     */
+    bool intersects(const glm::vec4 &sphere) const noexcept;
+    /**
+     * @brief Gets whether the box from \a minimum to \a maximum is outside,
+     * partly inside or entirely inside.
+     *
+     * @details Tests the corner farthest along and against each plane's
+     * normal, a box inside a culled box is culled too.
+     */
+    Containment contains(const glm::vec3 &minimum,
+                         const glm::vec3 &maximum) const noexcept;
+
+private:
+    glm::vec4 planes_[PlaneCount];
+};
+
+/**
+ * @brief Test \a count spheres (centre, radius) against \a frustum and set
+ * \a visible[i] to 1 if sphere i is at least partly inside, else 0.
+ *
+ * @details Spheres are tested four at a time with SSE2, every plane against
+ * all four lanes, the remainder goes through the scalar path.
+ */
+void CullSpheres(const Frustum &frustum, const glm::vec4 *spheres,
+                 std::size_t count, std::uint8_t *visible) noexcept;
+
+/**
+ * @brief Scalar reference of Math::CullSpheres.
+ */
+void CullSpheresScalar(const Frustum &frustum, const glm::vec4 *spheres,
+                       std::size_t count, std::uint8_t *visible) noexcept;
+/**
+ * @brief Gets the instruction set of Math::CullSpheres, "sse2" or "scalar".
+ */
+const char *CullSpheresPath() noexcept;
+
+} // namespace Math
+
+#endif // HOMEWORK01_UTILS_MATH_FRUSTUM_HPP_
@@ -0,0 +1,203 @@
+#include "TriangleSet.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROGRAM_TRIANGLES_SSE2
+#endif
+
+namespace Math
+{
+
+namespace Detail
+{
+
+// Floats of one block, nine coordinates of four lanes
+constexpr std::size_t blockFloats{9 * TriangleSet::BlockWidth};
+// Rays closer to parallel to a triangle miss it
+constexpr float parallelLimit{1.0e-12f};
+
+float raycastLane(const float *block, std::size_t lane,
+                  const glm::vec3 &origin, const glm::vec3 &direction) noexcept;
+
+// Moller-Trumbore, written out like the SSE2 kernel so both round alike
+float raycastLane(const float *block, std::size_t lane,
+                  const glm::vec3 &origin, const glm::vec3 &direction) noexcept
+{
+    const std::size_t width{TriangleSet::BlockWidth};
+    const float ax{block[0 * width + lane]};
+    const float ay{block[1 * width + lane]};
+    const float az{block[2 * width + lane]};
+    const float e1x{block[3 * width + lane]};
+    const float e1y{block[4 * width + lane]};
+    const float e1z{block[5 * width + lane]};
+    const float e2x{block[6 * width + lane]};
+    const float e2y{block[7 * width + lane]};
+    const float e2z{block[8 * width + lane]};
+
+    const float px{direction.y * e2z - direction.z * e2y};
+    const float py{direction.z * e2x - direction.x * e2z};
+    const float pz{direction.x * e2y - direction.y * e2x};
+    const float determinant{(e1x * px + e1y * py) + e1z * pz};
+    const float inverse{1.0f / determinant};
+
+    const float sx{origin.x - ax};
+    const float sy{origin.y - ay};
+    const float sz{origin.z - az};
+    const float u{((sx * px + sy * py) + sz * pz) * inverse};
+
+    const float qx{sy * e1z - sz * e1y};
+    const float qy{sz * e1x - sx * e1z};
+    const float qz{sx * e1y - sy * e1x};
+    const float v{((direction.x * qx + direction.y * qy) + direction.z * qz) *
+                  inverse};
+    const float distance{((e2x * qx + e2y * qy) + e2z * qz) * inverse};
+
+    const bool hit{std::abs(determinant) > parallelLimit && u >= 0.0f &&
+                   v >= 0.0f && u + v <= 1.0f && distance > 0.0f};
+
+    return hit ? distance : std::numeric_limits<float>::infinity();
+}
+
+} // namespace Detail
+
+void TriangleSet::build(const float *positions, const unsigned int *indices,
+                        std::size_t indexCount)
+{
+    triangleCount_ = indexCount / 3;
+    const std::size_t blocks{(triangleCount_ + BlockWidth - 1) / BlockWidth};
+    blocks_.assign(blocks * Detail::blockFloats, 0.0f);
+
+    for (std::size_t triangle = 0; triangle < triangleCount_; ++triangle)
+    {
+        float *block{&blocks_[triangle / BlockWidth * Detail::blockFloats]};
+        const std::size_t lane{triangle % BlockWidth};
+
+        const float *a{positions + 3 * indices[triangle * 3]};
+        const float *b{positions + 3 * indices[triangle * 3 + 1]};
+        const float *c{positions + 3 * indices[triangle * 3 + 2]};
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            block[axis * BlockWidth + lane] = a[axis];
+            block[(3 + axis) * BlockWidth + lane] = b[axis] - a[axis];
+            block[(6 + axis) * BlockWidth + lane] = c[axis] - a[axis];
+        }
+    }
+}
+
+float TriangleSet::raycast(const glm::vec3 &origin,
+                           const glm::vec3 &direction,
+                           float maxDistance) const noexcept
+{
+#if defined(PROGRAM_TRIANGLES_SSE2)
+    const __m128 ox{_mm_set1_ps(origin.x)};
+    const __m128 oy{_mm_set1_ps(origin.y)};
+    const __m128 oz{_mm_set1_ps(origin.z)};
+    const __m128 dx{_mm_set1_ps(direction.x)};
+    const __m128 dy{_mm_set1_ps(direction.y)};
+    const __m128 dz{_mm_set1_ps(direction.z)};
+    const __m128 zero{_mm_setzero_ps()};
+    const __m128 one{_mm_set1_ps(1.0f)};
+    const __m128 limit{_mm_set1_ps(Detail::parallelLimit)};
+    const __m128 signBit{_mm_set1_ps(-0.0f)};
+    __m128 nearest{_mm_set1_ps(std::numeric_limits<float>::infinity())};
+
+    for (std::size_t first = 0; first < blocks_.size();
+         first += Detail::blockFloats)
+    {
+        const float *block{&blocks_[first]};
+        const __m128 ax{_mm_loadu_ps(block + 0 * BlockWidth)};
+        const __m128 ay{_mm_loadu_ps(block + 1 * BlockWidth)};
+        const __m128 az{_mm_loadu_ps(block + 2 * BlockWidth)};
+        const __m128 e1x{_mm_loadu_ps(block + 3 * BlockWidth)};
+        const __m128 e1y{_mm_loadu_ps(block + 4 * BlockWidth)};
+        const __m128 e1z{_mm_loadu_ps(block + 5 * BlockWidth)};
+        const __m128 e2x{_mm_loadu_ps(block + 6 * BlockWidth)};
+        const __m128 e2y{_mm_loadu_ps(block + 7 * BlockWidth)};
+        const __m128 e2z{_mm_loadu_ps(block + 8 * BlockWidth)};
+
+        const __m128 px{_mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y))};
+        const __m128 py{_mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z))};
+        const __m128 pz{_mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x))};
+        const __m128 determinant{
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+                       _mm_mul_ps(e1z, pz))};
+        const __m128 inverse{_mm_div_ps(one, determinant)};
+
+        const __m128 sx{_mm_sub_ps(ox, ax)};
+        const __m128 sy{_mm_sub_ps(oy, ay)};
+        const __m128 sz{_mm_sub_ps(oz, az)};
+        const __m128 u{_mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)),
+                       _mm_mul_ps(sz, pz)),
+            inverse)};
+
+        const __m128 qx{_mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y))};
+        const __m128 qy{_mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z))};
+        const __m128 qz{_mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x))};
+        const __m128 v{_mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)),
+                       _mm_mul_ps(dz, qz)),
+            inverse)};
+        const __m128 distance{_mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)),
+                       _mm_mul_ps(e2z, qz)),
+            inverse)};
+
+        // NaN lanes of degenerate triangles fail every ordered compare
+        __m128 hit{_mm_cmpgt_ps(_mm_andnot_ps(signBit, determinant), limit)};
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        hit = _mm_and_ps(hit, _mm_cmpgt_ps(distance, zero));
+
+        nearest = _mm_min_ps(
+            nearest, _mm_or_ps(_mm_and_ps(hit, distance),
+                               _mm_andnot_ps(hit, nearest)));
+    }
+
+    float lanes[BlockWidth];
+    _mm_storeu_ps(lanes, nearest);
+    const float closest{
+        std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]))};
+
+    return closest < maxDistance ? closest : -1.0f;
+#else
+    return raycastScalar(origin, direction, maxDistance);
+#endif
+}
+
+float TriangleSet::raycastScalar(const glm::vec3 &origin,
+                                 const glm::vec3 &direction,
+                                 float maxDistance) const noexcept
+{
+    float closest{std::numeric_limits<float>::infinity()};
+
+    for (std::size_t first = 0; first < blocks_.size();
+         first += Detail::blockFloats)
+    {
+        for (std::size_t lane = 0; lane < BlockWidth; ++lane)
+        {
+            closest = std::min(closest, Detail::raycastLane(&blocks_[first],
+                                                            lane, origin,
+                                                            direction));
+        }
+    }
+
+    return closest < maxDistance ? closest : -1.0f;
+}
+
+const char *TriangleSetPath() noexcept
+{
+#if defined(PROGRAM_TRIANGLES_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Math
@@ -0,0 +1,64 @@
+#ifndef HOMEWORK01_UTILS_MATH_TRIANGLESET_HPP_
+#define HOMEWORK01_UTILS_MATH_TRIANGLESET_HPP_
+
+#include "glm/vec3.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Math
+{
+
+/**
+ * @brief Triangles of a mesh laid out for ray casts.
+ *
+ * @details Triangles are stored as a corner and two edges in blocks of four,
+ * one array of four lanes per coordinate, the layout the SSE2 kernel loads
+ * directly. The last block is padded with degenerate triangles, which no ray
+ * hits.
+ */
+class TriangleSet
+{
+public:
+    static constexpr std::size_t BlockWidth = 4;
+
+    /**
+     * @brief Replace the triangles with those of \a indexCount indices into
+     * tightly packed \a positions.
+     */
+    void build(const float *positions, const unsigned int *indices,
+               std::size_t indexCount);
+
+    std::size_t triangleCount() const noexcept { return triangleCount_; }
+
+    /**
+     * @brief Gets the distance to the nearest triangle the ray from \a origin
+     * along \a direction hits before \a maxDistance, or a negative value.
+     *
+     * @details Moller-Trumbore on four triangles at a time, both faces hit.
+     * Distances are in units of \a direction.
+     */
+    float raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                  float maxDistance) const noexcept;
+    /**
+     * @brief Scalar reference of TriangleSet::raycast, the same arithmetic
+     * one triangle at a time.
+     */
+    float raycastScalar(const glm::vec3 &origin, const glm::vec3 &direction,
+                        float maxDistance) const noexcept;
+
+private:
+    // Per block the corner, first and second edge, x, y and z of each
+    std::vector<float> blocks_;
+    std::size_t triangleCount_ = 0;
+};
+
+/**
+ * @brief Gets the instruction set of TriangleSet::raycast, "sse2" or
+ * "scalar".
+ */
+const char *TriangleSetPath() noexcept;
+
+} // namespace Math
+
+#endif // HOMEWORK01_UTILS_MATH_TRIANGLESET_HPP_
@@ -1,9 +1,11 @@
 #include "ModelAdder.hpp"
 
+#include "Model/LevelOfDetail.hpp"
 #include "Model/TextureFactory.hpp"
 #include "OpenGL/OpenGLException.hpp"
 #include "Utils/Compilers.hpp"
 #include "Utils/Global.hpp"
+#include "Utils/Profiler/TraceRecorder.hpp"
 #include "Utils/StringFormat/StringFormat.hpp"
 
 #include "glm/gtc/matrix_transform.hpp"
@@ -14,11 +16,11 @@
 
 #include <vector>
 
-bool ModuleAdder::loadModel(const char * modelSource, const char * textureSource,
-                            OpenGL::OpenGLShaderProgram & program, 
-                            std::vector<std::shared_ptr<Model::Mesh>>& models, 
-                            std::vector<std::unique_ptr<OpenGL::OpenGLTexture>>& textures)
+bool ModuleAdder::loadMeshData(const char * modelSource, Model::MeshData& mesh,
+                               const std::vector<float> &lodRatios)
 {
+    PROGRAM_TRACE_SCOPE("loading", "ModuleAdder::loadMeshData");
+
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string errorMessage;
@@ -32,10 +34,16 @@ bool ModuleAdder::loadModel(const char * modelSource, const char * textureSource
         return false;
     }
 
-    std::vector<float> positions;
-    std::vector<float> normals;
-    std::vector<float> textureCoordinates;
-    std::vector<unsigned int> indices;
+    std::vector<float> &positions = mesh.positions;
+    std::vector<float> &normals = mesh.normals;
+    std::vector<float> &textureCoordinates = mesh.textureCoordinates;
+    std::vector<unsigned int> &indices = mesh.indices;
+
+    positions.clear();
+    normals.clear();
+    textureCoordinates.clear();
+    indices.clear();
+    mesh.levels.clear();
 
     for (auto& shape : shapes) {
         positions.insert(positions.end(), shape.mesh.positions.begin(),
@@ -55,6 +63,33 @@ bool ModuleAdder::loadModel(const char * modelSource, const char * textureSource
                        shape.mesh.indices.end());
     }
 
+    Model::ComputeNormals(mesh);
+    mesh.bounds = Math::ComputeBounds(positions.data(), positions.size() / 3);
+    if (!lodRatios.empty()) {
+        Model::BuildLevelsOfDetail(mesh, lodRatios);
+    }
+
+    return true;
+}
+
+bool ModuleAdder::loadModel(const char * modelSource, const char * textureSource,
+                            OpenGL::OpenGLShaderProgram & program, 
+                            std::vector<std::shared_ptr<Model::Mesh>>& models, 
+                            std::vector<std::unique_ptr<OpenGL::OpenGLTexture>>& textures,
+                            const std::vector<float> &lodRatios)
+{
+    PROGRAM_TRACE_SCOPE("loading", "ModuleAdder::loadModel");
+
+    Model::MeshData data;
+    if (!loadMeshData(modelSource, data, lodRatios)) {
+        return false;
+    }
+
+    const std::vector<float> &positions = data.positions;
+    const std::vector<float> &normals = data.normals;
+    const std::vector<float> &textureCoordinates = data.textureCoordinates;
+    const std::vector<unsigned int> &indices = data.indices;
+
     std::unique_ptr<OpenGL::OpenGLTexture> texture;
     std::unique_ptr<Model::Mesh> mesh;
 
@@ -69,6 +104,8 @@ bool ModuleAdder::loadModel(const char * modelSource, const char * textureSource
                                    indices, program});
     }
 
+    mesh->geometry()->setBounds(data.bounds);
+    mesh->geometry()->setLevels(data.levels);
     models.push_back(std::move(mesh));
     return true;
 }
@@ -1,10 +1,20 @@
 #include "Model/Mesh.hpp"
+#include "Model/MorphTarget.hpp"
 #include "OpenGL/OpenGLShaderProgram.hpp"
 #include "OpenGL/OpenGLTexture.hpp"
 
+#include <vector>
+
 class ModuleAdder {
    public:
+      // Read every shape of an OBJ file into \a mesh, normals are computed if
+      // the file has none, bounds always. A level of detail is built for
+      // every ratio of the triangles in \a lodRatios, see
+      // Model::BuildLevelsOfDetail
+      static bool loadMeshData(const char *modelSource, Model::MeshData &mesh,
+                               const std::vector<float> &lodRatios = std::vector<float>{});
       static bool loadModel(const char *modelSource, const char *textureSource,
                           OpenGL::OpenGLShaderProgram &program, std::vector<std::shared_ptr<Model::Mesh>> &models,
-                          std::vector<std::unique_ptr<OpenGL::OpenGLTexture>> &textures);
+                          std::vector<std::unique_ptr<OpenGL::OpenGLTexture>> &textures,
+                          const std::vector<float> &lodRatios = std::vector<float>{});
 };
\ No newline at end of file
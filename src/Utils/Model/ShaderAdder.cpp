@@ -1,5 +1,7 @@
 #include "ShaderAdder.hpp"
 
+#include "Utils/Profiler/TraceRecorder.hpp"
+
 bool ShaderAdder::compileShaders(OpenGL::OpenGLShaderProgram & program,
                                 const char * vertexShaderFile,
                                 const char * fragmentShaderFile,
@@ -39,6 +41,8 @@ OpenGL::OpenGLShaderProgram *ShaderAdder::addShader(const char * vertexShaderSou
                                                     const char *geometryShaderSource,
                                                     std::vector<std::unique_ptr<OpenGL::OpenGLShaderProgram>>& shaders)
 {
+    PROGRAM_TRACE_SCOPE("loading", "ShaderAdder::addShader");
+
     std::unique_ptr<OpenGL::OpenGLShaderProgram> program{new OpenGL::OpenGLShaderProgram{}};
     if (!compileShaders(*program, vertexShaderSource,
                         fragmentShaderSource, nullptr))
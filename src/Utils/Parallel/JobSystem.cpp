@@ -0,0 +1,294 @@
+#include "JobSystem.hpp"
+
+#include "Utils/Profiler/TraceRecorder.hpp"
+
+#include <algorithm>
+
+namespace Parallel
+{
+
+namespace Detail
+{
+
+// Failed attempts to find a job before a worker goes to sleep
+constexpr int idleSpins{64};
+
+struct CurrentThread
+{
+    const JobSystem *system;
+    int index;
+};
+
+thread_local CurrentThread currentThread{nullptr, -1};
+thread_local std::uint32_t victimSeed{0};
+
+std::uint32_t nextVictim() noexcept;
+
+std::uint32_t nextVictim() noexcept
+{
+    // xorshift, only spreads the thieves over the deques
+    std::uint32_t x{victimSeed ? victimSeed : 0x9E3779B9u};
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    victimSeed = x;
+
+    return x;
+}
+
+} // namespace Detail
+
+struct JobSystem::Loop
+{
+    JobSystem *system;
+    const Range *body;
+    std::size_t count;
+    std::size_t grain;
+    Job *jobs; // one per chunk, a split at chunk c stores its half at jobs[c]
+};
+
+JobSystem::JobSystem(unsigned workers)
+{
+    for (unsigned i = 0; i <= workers; ++i)
+    {
+        deques_.emplace_back(new WorkStealingDeque<Job *>{DequeCapacity});
+    }
+
+    Detail::currentThread = {this, 0};
+
+    workers_.reserve(workers);
+    for (unsigned i = 1; i <= workers; ++i)
+    {
+        workers_.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+
+    if (Detail::currentThread.system == this)
+    {
+        Detail::currentThread = {nullptr, -1};
+    }
+}
+
+std::size_t JobSystem::threadCount() const noexcept
+{
+    return workers_.size() + 1;
+}
+
+std::uint64_t JobSystem::stealCount() const noexcept
+{
+    return steals_.load(std::memory_order_relaxed);
+}
+
+unsigned JobSystem::DefaultWorkers() noexcept
+{
+    const unsigned threads{std::thread::hardware_concurrency()};
+
+    return threads > 1 ? threads - 1 : 0;
+}
+
+void JobSystem::run(Job &job, JobCounter &counter)
+{
+    job.counter = &counter;
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    const int thread{threadIndex()};
+    if (thread < 0 || workers_.empty())
+    {
+        execute(&job);
+        return;
+    }
+
+    // Counted before the push, a sleeper checking queued_ cannot miss it
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    if (!deques_[thread]->push(&job))
+    {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        execute(&job);
+        return;
+    }
+
+    if (sleeping_.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        wake_.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+    const int thread{threadIndex()};
+
+    while (!counter.done())
+    {
+        if (!runOne(thread))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grain,
+                            const Range &body)
+{
+    grain = std::max<std::size_t>(grain, 1);
+
+    if (count == 0)
+    {
+        return;
+    }
+    if (workers_.empty() || count <= grain || threadIndex() < 0)
+    {
+        body(0, count);
+        return;
+    }
+
+    const std::size_t chunks{(count + grain - 1) / grain};
+    std::vector<Job> jobs(chunks);
+    const Loop loop{this, &body, count, grain, jobs.data()};
+    JobCounter counter;
+
+    // The calling thread starts on the whole range, the others steal halves
+    jobs[0].function = &JobSystem::runLoop;
+    jobs[0].data = &loop;
+    jobs[0].begin = 0;
+    jobs[0].end = chunks;
+    jobs[0].counter = &counter;
+    runLoop(jobs[0]);
+
+    wait(counter);
+}
+
+void JobSystem::runLoop(const Job &job)
+{
+    const Loop &loop{*static_cast<const Loop *>(job.data)};
+    std::size_t begin{job.begin};
+    std::size_t end{job.end};
+
+    // Hand the upper half to the deque until a single chunk is left
+    while (end - begin > 1)
+    {
+        const std::size_t middle{begin + (end - begin) / 2};
+        Job &half{loop.jobs[middle]};
+
+        half.function = &JobSystem::runLoop;
+        half.data = &loop;
+        half.begin = middle;
+        half.end = end;
+        loop.system->run(half, *job.counter);
+
+        end = middle;
+    }
+
+    (*loop.body)(begin * loop.grain, std::min(end * loop.grain, loop.count));
+}
+
+int JobSystem::threadIndex() const noexcept
+{
+    return Detail::currentThread.system == this ? Detail::currentThread.index
+                                                : -1;
+}
+
+void JobSystem::execute(Job *job)
+{
+    // The job's storage may be released as soon as its counter is done
+    JobCounter *counter{job->counter};
+
+    job->function(*job);
+
+    counter->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+bool JobSystem::runOne(int thread)
+{
+    Job *job{nullptr};
+
+    if (!takeJob(thread, job))
+    {
+        return false;
+    }
+
+    execute(job);
+    return true;
+}
+
+bool JobSystem::takeJob(int thread, Job *&job)
+{
+    if (thread >= 0 && deques_[thread]->pop(job))
+    {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    const std::size_t deques{deques_.size()};
+    const std::size_t first{Detail::nextVictim() % deques};
+
+    for (std::size_t i = 0; i < deques; ++i)
+    {
+        const std::size_t victim{(first + i) % deques};
+
+        if (static_cast<int>(victim) != thread && deques_[victim]->steal(job))
+        {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::workerLoop(int thread)
+{
+    Detail::currentThread = {this, thread};
+    Detail::victimSeed = 0x9E3779B9u * static_cast<std::uint32_t>(thread + 1);
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            wake_.wait(lock, [this] {
+                return stopping_ ||
+                       queued_.load(std::memory_order_seq_cst) > 0;
+            });
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (stopping_)
+            {
+                return;
+            }
+        }
+
+        PROGRAM_TRACE_SCOPE("parallel", "JobSystem::work");
+
+        // Keep looking for a while, a loop usually pushes more jobs soon
+        for (int idle = 0; idle < Detail::idleSpins;)
+        {
+            if (runOne(thread))
+            {
+                idle = 0;
+            }
+            else
+            {
+                ++idle;
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+} // namespace Parallel
@@ -0,0 +1,144 @@
+#ifndef HOMEWORK01_UTILS_PARALLEL_JOBSYSTEM_HPP_
+#define HOMEWORK01_UTILS_PARALLEL_JOBSYSTEM_HPP_
+
+#include "WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+
+class JobSystem;
+
+/**
+ * @brief Number of jobs still running, JobSystem::wait blocks until it drops
+ * to zero. A job which must run after others waits on their counter.
+ */
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter &other) = delete;
+    JobCounter &operator=(const JobCounter &other) = delete;
+
+    bool done() const noexcept
+    {
+        return pending_.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<std::uint32_t> pending_{0};
+};
+
+/**
+ * @brief Unit of work, \a function is called with the job itself and must not
+ * throw. The storage belongs to the caller of JobSystem::run and has to stay
+ * alive until the job's counter is done.
+ */
+struct Job
+{
+    using Function = void (*)(const Job &job);
+
+    Function function = nullptr;
+    const void *data = nullptr;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    JobCounter *counter = nullptr;
+};
+
+/**
+ * @brief Work stealing job system for the per-frame simulation tasks.
+ *
+ * @details Every thread owns a Chase-Lev deque, see WorkStealingDeque. A
+ * thread pushes and pops its own jobs last in first out, idle threads steal
+ * the oldest job of another thread, which for JobSystem::parallelFor is the
+ * largest unsplit range. Idle workers sleep until a job is pushed.
+ *
+ * The thread which creates the system takes part as thread 0; jobs may only
+ * be run from it or from inside another job. JobSystem::wait runs other jobs
+ * while it waits instead of blocking, so jobs may wait on their children.
+ */
+class JobSystem
+{
+public:
+    /**
+     * @brief Body of a loop, called with the half open range [begin, end).
+     */
+    using Range = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // Jobs a thread can hold before JobSystem::run runs them inline
+    static constexpr std::size_t DequeCapacity = 4096;
+
+    /**
+     * @brief Start \a workers worker threads, by default one less than the
+     * hardware threads since the creating thread takes part in every wait.
+     */
+    explicit JobSystem(unsigned workers = DefaultWorkers());
+    ~JobSystem();
+
+    JobSystem(const JobSystem &other) = delete;
+    JobSystem &operator=(const JobSystem &other) = delete;
+
+    /**
+     * @brief Gets the number of threads running jobs, workers and creator.
+     */
+    std::size_t threadCount() const noexcept;
+    /**
+     * @brief Gets the number of jobs taken from another thread's deque.
+     */
+    std::uint64_t stealCount() const noexcept;
+
+    /**
+     * @brief Schedule \a job and add it to \a counter.
+     */
+    void run(Job &job, JobCounter &counter);
+    /**
+     * @brief Run jobs until \a counter is done.
+     */
+    void wait(JobCounter &counter);
+
+    /**
+     * @brief Run \a body over [0, \a count) in chunks of \a grain items and
+     * wait for it. The range is split in halves on demand, so a thief takes
+     * half of the remaining work with one steal.
+     */
+    void parallelFor(std::size_t count, std::size_t grain, const Range &body);
+
+    static unsigned DefaultWorkers() noexcept;
+
+private:
+    struct Loop;
+
+    static void runLoop(const Job &job);
+
+    int threadIndex() const noexcept;
+    void execute(Job *job);
+    bool runOne(int thread);
+    bool takeJob(int thread, Job *&job);
+    void workerLoop(int thread);
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Job *>>> deques_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<std::int64_t> queued_{0}; // jobs pushed but not yet taken
+    std::atomic<std::uint64_t> steals_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<unsigned> sleeping_{0};
+    bool stopping_ = false;
+};
+
+} // namespace Parallel
+
+#endif // HOMEWORK01_UTILS_PARALLEL_JOBSYSTEM_HPP_
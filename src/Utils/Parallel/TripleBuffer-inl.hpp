@@ -0,0 +1,32 @@
+namespace Parallel
+{
+
+template <typename T>
+inline TripleBuffer<T>::TripleBuffer() : middle_{1}, back_{0}, front_{2}
+{
+}
+
+template <typename T> inline void TripleBuffer<T>::publish() noexcept
+{
+    // Release the writes to the slot, take whichever slot sat in the middle
+    const std::uint8_t previous{middle_.exchange(
+        static_cast<std::uint8_t>(back_ | Fresh), std::memory_order_acq_rel)};
+    back_ = static_cast<std::uint8_t>(previous & IndexMask);
+}
+
+template <typename T> inline bool TripleBuffer<T>::update() noexcept
+{
+    if (!(middle_.load(std::memory_order_relaxed) & Fresh))
+    {
+        return false;
+    }
+
+    // Acquire the producer's writes, leave the old front for it to reuse
+    const std::uint8_t previous{
+        middle_.exchange(front_, std::memory_order_acq_rel)};
+    front_ = static_cast<std::uint8_t>(previous & IndexMask);
+
+    return true;
+}
+
+} // namespace Parallel
@@ -0,0 +1,73 @@
+#ifndef HOMEWORK01_UTILS_PARALLEL_TRIPLEBUFFER_HPP_
+#define HOMEWORK01_UTILS_PARALLEL_TRIPLEBUFFER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Parallel
+{
+
+/**
+ * @brief Three slots handing the newest value of a producer thread to a
+ * consumer thread without locks or copies.
+ *
+ * @details The producer writes TripleBuffer::back and publishes it, the
+ * consumer reads TripleBuffer::front after TripleBuffer::update took the
+ * newest published slot. The third slot sits between them, publishing and
+ * updating swap it in a single atomic exchange. Neither side ever waits for
+ * the other, nor sees a slot the other is writing or reading. Values the
+ * consumer did not take in time are overwritten, slots are reused as they
+ * are, so a producer must rewrite everything of \a T it publishes.
+ */
+template <typename T> class TripleBuffer
+{
+public:
+    TripleBuffer();
+
+    TripleBuffer(const TripleBuffer &other) = delete;
+    TripleBuffer &operator=(const TripleBuffer &other) = delete;
+
+    /**
+     * @brief Gets the slot the producer writes, producer only.
+     */
+    T &back() noexcept { return slots_[back_]; }
+    /**
+     * @brief Hand the back slot to the consumer, producer only.
+     */
+    void publish() noexcept;
+
+    /**
+     * @brief Take the newest published slot, if any, consumer only.
+     *
+     * @return \c true if TripleBuffer::front changed.
+     */
+    bool update() noexcept;
+    /**
+     * @brief Gets the slot the consumer reads, consumer only.
+     */
+    const T &front() const noexcept { return slots_[front_]; }
+
+private:
+    // Set in middle_ while it holds a slot the consumer did not take yet
+    static constexpr std::uint8_t Fresh = 0x4;
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::size_t CacheLine = 64;
+
+    // A cache line each. Padded rather than aligned, so that a TripleBuffer
+    // member does not make its owner over-aligned for new
+    T slots_[3];
+    char middlePadding_[CacheLine];
+    std::atomic<std::uint8_t> middle_;
+    char backPadding_[CacheLine - sizeof(std::atomic<std::uint8_t>)];
+    std::uint8_t back_; // owned by the producer
+    char frontPadding_[CacheLine - 1];
+    std::uint8_t front_; // owned by the consumer
+    char endPadding_[CacheLine - 1];
+};
+
+} // namespace Parallel
+
+#include "TripleBuffer-inl.hpp"
+
+#endif // HOMEWORK01_UTILS_PARALLEL_TRIPLEBUFFER_HPP_
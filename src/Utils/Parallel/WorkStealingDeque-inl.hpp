@@ -0,0 +1,90 @@
+#include "Utils/Global.hpp"
+
+#include <type_traits>
+
+namespace Parallel
+{
+
+template <typename T>
+inline WorkStealingDeque<T>::WorkStealingDeque(std::size_t capacity)
+    : items_{new std::atomic<T>[capacity]},
+      mask_{static_cast<std::int64_t>(capacity) - 1}
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only accept trivially copyable items");
+    // Indices wrap through mask_
+    PROGRAM_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+}
+
+template <typename T>
+inline bool WorkStealingDeque<T>::push(T item) noexcept
+{
+    const std::int64_t bottom{bottom_.load(std::memory_order_relaxed)};
+    const std::int64_t top{top_.load(std::memory_order_acquire)};
+
+    if (bottom - top > mask_)
+    {
+        return false;
+    }
+
+    items_[bottom & mask_].store(item, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T> inline bool WorkStealingDeque<T>::pop(T &item) noexcept
+{
+    const std::int64_t bottom{bottom_.load(std::memory_order_relaxed) - 1};
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top{top_.load(std::memory_order_relaxed)};
+
+    if (top > bottom)
+    {
+        // Empty, undo the reservation
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    item = items_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last item, race the thieves for it
+        const bool won{top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst,
+            std::memory_order_relaxed)};
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    return true;
+}
+
+template <typename T>
+inline bool WorkStealingDeque<T>::steal(T &item) noexcept
+{
+    std::int64_t top{top_.load(std::memory_order_acquire)};
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom{bottom_.load(std::memory_order_acquire)};
+
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    item = items_[top & mask_].load(std::memory_order_relaxed);
+
+    return top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed);
+}
+
+template <typename T>
+inline bool WorkStealingDeque<T>::empty() const noexcept
+{
+    return top_.load(std::memory_order_relaxed) >=
+           bottom_.load(std::memory_order_relaxed);
+}
+
+} // namespace Parallel
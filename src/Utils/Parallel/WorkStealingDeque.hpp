@@ -0,0 +1,69 @@
+#ifndef HOMEWORK01_UTILS_PARALLEL_WORKSTEALINGDEQUE_HPP_
+#define HOMEWORK01_UTILS_PARALLEL_WORKSTEALINGDEQUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Parallel
+{
+
+/**
+ * @brief Chase-Lev work stealing deque of a fixed capacity.
+ *
+ * @details The owning thread pushes and pops at the bottom, any other thread
+ * steals from the top. The memory orders follow Le, Pop, Cohen and Nardelli,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models". \a T must be
+ * trivially copyable and lock free as a std::atomic, e.g. a pointer.
+ */
+template <typename T> class WorkStealingDeque
+{
+public:
+    /**
+     * @brief Create a deque holding up to \a capacity items, a power of two.
+     */
+    explicit WorkStealingDeque(std::size_t capacity);
+
+    WorkStealingDeque(const WorkStealingDeque &other) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &other) = delete;
+
+    /**
+     * @brief Push \a item at the bottom, owner only.
+     *
+     * @return \c false if the deque is full.
+     */
+    bool push(T item) noexcept;
+    /**
+     * @brief Pop the most recently pushed item, owner only.
+     */
+    bool pop(T &item) noexcept;
+    /**
+     * @brief Steal the least recently pushed item, any thread.
+     *
+     * @return \c false if the deque is empty or another thread won the item.
+     */
+    bool steal(T &item) noexcept;
+
+    bool empty() const noexcept;
+
+private:
+    static constexpr std::size_t CacheLine = 64;
+
+    std::unique_ptr<std::atomic<T>[]> items_;
+    std::int64_t mask_;
+
+    // Separate cache lines, thieves hammer top_ while the owner moves
+    // bottom_. Padded, not alignas, so plain new allocates the deque
+    char topPadding_[CacheLine];
+    std::atomic<std::int64_t> top_{0};
+    char bottomPadding_[CacheLine - sizeof(std::atomic<std::int64_t>)];
+    std::atomic<std::int64_t> bottom_{0};
+    char endPadding_[CacheLine - sizeof(std::atomic<std::int64_t>)];
+};
+
+} // namespace Parallel
+
+#include "WorkStealingDeque-inl.hpp"
+
+#endif // HOMEWORK01_UTILS_PARALLEL_WORKSTEALINGDEQUE_HPP_
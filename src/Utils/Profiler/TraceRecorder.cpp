@@ -0,0 +1,245 @@
+#include "TraceRecorder.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace Profiler
+{
+
+namespace Detail
+{
+
+constexpr std::size_t bufferMask{TraceBuffer::Capacity - 1};
+
+static_assert((TraceBuffer::Capacity & bufferMask) == 0,
+              "TraceBuffer::Capacity must be a power of two");
+
+const std::chrono::steady_clock::time_point epoch{
+    std::chrono::steady_clock::now()};
+
+thread_local TraceBuffer *threadBuffer{nullptr};
+
+void writeEscaped(std::ostream &out, const char *text);
+
+void writeEscaped(std::ostream &out, const char *text)
+{
+    for (const char *c = text; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            out << '\\';
+        }
+        out << *c;
+    }
+}
+
+} // namespace Detail
+
+TraceBuffer::TraceBuffer(std::uint32_t threadId) noexcept
+    : events_{}, head_{0}, tail_{0}, dropped_{0}, threadId_{threadId}
+{
+}
+
+bool TraceBuffer::push(const TraceEvent &event) noexcept
+{
+    const std::size_t head{head_.load(std::memory_order_relaxed)};
+    const std::size_t tail{tail_.load(std::memory_order_acquire)};
+
+    if (head - tail >= Capacity)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    events_[head & Detail::bufferMask] = event;
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+void TraceBuffer::drain(std::vector<TraceEvent> &output)
+{
+    const std::size_t tail{tail_.load(std::memory_order_relaxed)};
+    const std::size_t head{head_.load(std::memory_order_acquire)};
+
+    for (std::size_t i = tail; i != head; ++i)
+    {
+        output.push_back(events_[i & Detail::bufferMask]);
+    }
+
+    tail_.store(head, std::memory_order_release);
+}
+
+std::uint32_t TraceBuffer::threadId() const noexcept { return threadId_; }
+
+std::size_t TraceBuffer::takeDropped() noexcept
+{
+    return dropped_.exchange(0, std::memory_order_relaxed);
+}
+
+TraceRecorder::TraceRecorder()
+    : recording_{false}, dropped_{0}, framesRemaining_{0}, frameBegin_{0}
+{
+}
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+std::uint64_t TraceRecorder::now() noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - Detail::epoch)
+            .count());
+}
+
+bool TraceRecorder::requestCapture(int frames, const std::string &path)
+{
+    if (isRecording() || frames <= 0)
+    {
+        return false;
+    }
+
+    // Discard anything left over from scopes that straddled the last capture
+    collect();
+    events_.clear();
+    eventThreads_.clear();
+    dropped_ = 0;
+
+    path_ = path;
+    framesRemaining_ = frames;
+    frameBegin_ = now();
+    recording_.store(true, std::memory_order_relaxed);
+
+    std::cout << "[Trace] Capturing " << frames << " frames to " << path
+              << std::endl;
+
+    return true;
+}
+
+void TraceRecorder::beginFrame() noexcept { frameBegin_ = now(); }
+
+void TraceRecorder::endFrame()
+{
+    if (!isRecording())
+    {
+        return;
+    }
+
+    record("Frame", "frame", frameBegin_, now());
+    collect();
+
+    if (--framesRemaining_ <= 0)
+    {
+        finishCapture();
+    }
+}
+
+void TraceRecorder::record(const char *name, const char *category,
+                           std::uint64_t begin, std::uint64_t end) noexcept
+{
+    threadBuffer().push(TraceEvent{name, category, begin, end});
+}
+
+TraceBuffer &TraceRecorder::threadBuffer()
+{
+    if (!Detail::threadBuffer)
+    {
+        std::lock_guard<std::mutex> lock{buffersMutex_};
+
+        buffers_.emplace_back(
+            new TraceBuffer{static_cast<std::uint32_t>(buffers_.size() + 1)});
+        Detail::threadBuffer = buffers_.back().get();
+    }
+
+    return *Detail::threadBuffer;
+}
+
+void TraceRecorder::collect()
+{
+    std::lock_guard<std::mutex> lock{buffersMutex_};
+
+    for (auto &buffer : buffers_)
+    {
+        buffer->drain(events_);
+        eventThreads_.resize(events_.size(), buffer->threadId());
+        dropped_ += buffer->takeDropped();
+    }
+}
+
+void TraceRecorder::finishCapture()
+{
+    recording_.store(false, std::memory_order_relaxed);
+
+    if (exportChromeTrace(path_))
+    {
+        std::cout << "[Trace] Wrote " << events_.size() << " events to "
+                  << path_ << std::endl;
+    }
+    else
+    {
+        std::cerr << "[Error] Failed to write trace " << path_ << std::endl;
+    }
+
+    events_.clear();
+    eventThreads_.clear();
+    dropped_ = 0;
+}
+
+bool TraceRecorder::exportChromeTrace(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first{true};
+    {
+        std::lock_guard<std::mutex> lock{buffersMutex_};
+
+        for (const auto &buffer : buffers_)
+        {
+            out << (first ? "" : ",")
+                << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"tid\":"
+                << buffer->threadId() << ",\"args\":{\"name\":\""
+                << (buffer->threadId() == 1 ? "Main" : "Worker") << " "
+                << buffer->threadId() << "\"}}";
+            first = false;
+        }
+    }
+
+    char number[32];
+    for (std::size_t i = 0; i < events_.size(); ++i)
+    {
+        const TraceEvent &event{events_[i]};
+
+        out << (first ? "" : ",") << "\n{\"name\":\"";
+        Detail::writeEscaped(out, event.name);
+        out << "\",\"cat\":\"";
+        Detail::writeEscaped(out, event.category);
+
+        std::snprintf(number, sizeof(number), "%.3f", event.begin / 1000.0);
+        out << "\",\"ph\":\"X\",\"ts\":" << number;
+        std::snprintf(number, sizeof(number), "%.3f",
+                      (event.end - event.begin) / 1000.0);
+        out << ",\"dur\":" << number << ",\"pid\":1,\"tid\":"
+            << eventThreads_[i] << "}";
+        first = false;
+    }
+
+    out << "\n],\"otherData\":{\"droppedEvents\":" << dropped_ << "}}\n";
+
+    return out.good();
+}
+
+} // namespace Profiler
@@ -0,0 +1,204 @@
+#ifndef HOMEWORK01_UTILS_PROFILER_TRACERECORDER_HPP_
+#define HOMEWORK01_UTILS_PROFILER_TRACERECORDER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Profiler
+{
+
+/**
+ * \brief A single completed CPU scope.
+ *
+ * \a name and \a category must point to string literals (or any storage that
+ * outlives the recorder), they are stored by pointer and only read when the
+ * trace is exported.
+ */
+struct TraceEvent
+{
+    const char *name;
+    const char *category;
+    std::uint64_t begin; // nanoseconds since the recorder epoch
+    std::uint64_t end;   // nanoseconds since the recorder epoch
+};
+
+/**
+ * \brief Fixed size single-producer single-consumer ring of TraceEvent.
+ *
+ * \details Each thread owns exactly one TraceBuffer and is the only producer.
+ * The render thread drains every buffer once per frame and is the only
+ * consumer, so neither side ever takes a lock.
+ */
+class TraceBuffer
+{
+public:
+    static constexpr std::size_t Capacity = 1 << 14;
+
+    explicit TraceBuffer(std::uint32_t threadId) noexcept;
+
+    TraceBuffer(const TraceBuffer &other) = delete;
+    TraceBuffer &operator=(const TraceBuffer &other) = delete;
+
+    /**
+     * \brief Push \a event into the ring.
+     *
+     * \return \c false if the ring is full and the event was dropped.
+     */
+    bool push(const TraceEvent &event) noexcept;
+    /**
+     * \brief Move every pending event into \a output.
+     */
+    void drain(std::vector<TraceEvent> &output);
+
+    std::uint32_t threadId() const noexcept;
+    /**
+     * \brief Gets the number of events dropped since the last call and
+     * resets it.
+     */
+    std::size_t takeDropped() noexcept;
+
+private:
+    static constexpr std::size_t CacheLine = 64;
+
+    // Padded rather than aligned to keep head_ and tail_ on cache lines of
+    // their own, an over-aligned type needs C++17 to be allocated with new
+    std::array<TraceEvent, Capacity> events_;
+    char headPadding_[CacheLine];
+    std::atomic<std::size_t> head_; // written by the producer
+    char tailPadding_[CacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail_; // written by the consumer
+    std::atomic<std::size_t> dropped_;
+    std::uint32_t threadId_;
+    char endPadding_[CacheLine];
+};
+
+/**
+ * \brief Collects TraceEvent from every thread and exports them as a Chrome
+ * trace-event JSON file (chrome://tracing, Perfetto).
+ *
+ * \details A capture is armed with TraceRecorder::requestCapture, it starts
+ * recording immediately and stops after the requested number of frames have
+ * been closed with TraceRecorder::endFrame. The trace is written to disk when
+ * the capture stops.
+ */
+class TraceRecorder
+{
+public:
+    static TraceRecorder &instance();
+
+    TraceRecorder(const TraceRecorder &other) = delete;
+    TraceRecorder &operator=(const TraceRecorder &other) = delete;
+
+    /**
+     * \brief Start recording for \a frames frames then write them to \a path.
+     *
+     * \return \c false if a capture is already running.
+     */
+    bool requestCapture(int frames, const std::string &path);
+
+    /**
+     * \brief Mark the beginning of a frame on the render thread.
+     */
+    void beginFrame() noexcept;
+    /**
+     * \brief Mark the end of a frame on the render thread. Drains the thread
+     * buffers and finishes the capture once enough frames were recorded.
+     */
+    void endFrame();
+
+    /**
+     * \brief Record a completed scope on the calling thread.
+     */
+    void record(const char *name, const char *category, std::uint64_t begin,
+                std::uint64_t end) noexcept;
+
+    bool isRecording() const noexcept
+    {
+        return recording_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Gets the current time in nanoseconds since the recorder epoch.
+     */
+    static std::uint64_t now() noexcept;
+
+private:
+    TraceRecorder();
+
+    TraceBuffer &threadBuffer();
+    void collect();
+    void finishCapture();
+    bool exportChromeTrace(const std::string &path) const;
+
+    std::atomic<bool> recording_;
+
+    mutable std::mutex buffersMutex_; // guards registration and iteration
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+
+    std::vector<TraceEvent> events_;
+    std::vector<std::uint32_t> eventThreads_;
+    std::size_t dropped_; // events the buffers dropped since the capture began
+
+    std::string path_;
+    int framesRemaining_;
+    std::uint64_t frameBegin_;
+};
+
+/**
+ * \brief RAII helper which records the lifetime of the enclosing scope.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *name, const char *category) noexcept
+        : name_{name}, category_{category}, begin_{0},
+          active_{TraceRecorder::instance().isRecording()}
+    {
+        if (active_)
+        {
+            begin_ = TraceRecorder::now();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (active_)
+        {
+            TraceRecorder::instance().record(name_, category_, begin_,
+                                             TraceRecorder::now());
+        }
+    }
+
+    TraceScope(const TraceScope &other) = delete;
+    TraceScope &operator=(const TraceScope &other) = delete;
+
+private:
+    const char *name_;
+    const char *category_;
+    std::uint64_t begin_;
+    bool active_;
+};
+
+} // namespace Profiler
+
+#define PROGRAM_TRACE_CONCAT_IMPL(x, y) x##y
+#define PROGRAM_TRACE_CONCAT(x, y) PROGRAM_TRACE_CONCAT_IMPL(x, y)
+
+// Instrumentation, compiled out unless PROGRAM_ENABLE_TRACE is defined
+#ifdef PROGRAM_ENABLE_TRACE
+#define PROGRAM_TRACE_SCOPE(category, name)                                    \
+    Profiler::TraceScope PROGRAM_TRACE_CONCAT(traceScope_, __LINE__)           \
+    {                                                                          \
+        name, category                                                         \
+    }
+#else
+#define PROGRAM_TRACE_SCOPE(category, name) ((void)0)
+#endif
+
+#endif // HOMEWORK01_UTILS_PROFILER_TRACERECORDER_HPP_
@@ -0,0 +1,57 @@
+#include "FixedTimestep.hpp"
+
+#include <cmath>
+
+namespace Time
+{
+
+FixedTimestep::FixedTimestep(float tick, int maxTicks)
+    : tick_{tick}, maxTicks_{maxTicks}
+{
+}
+
+int FixedTimestep::advance(float deltaTime) noexcept
+{
+    // A stalled or rewound clock adds nothing
+    if (deltaTime > 0.0f)
+    {
+        accumulator_ += deltaTime;
+    }
+
+    const double tick{tick_};
+    ticks_ = 0;
+    while (accumulator_ >= tick && ticks_ < maxTicks_)
+    {
+        accumulator_ -= tick;
+        ++ticks_;
+    }
+
+    // Whatever is still a whole tick behind is given up, the fraction stays
+    if (accumulator_ >= tick)
+    {
+        const double behind{std::floor(accumulator_ / tick)};
+        droppedTicks_ += static_cast<std::uint64_t>(behind);
+        accumulator_ -= behind * tick;
+    }
+
+    return ticks_;
+}
+
+void FixedTimestep::reset() noexcept
+{
+    accumulator_ = 0.0;
+    ticks_ = 0;
+}
+
+void FixedTimestep::setTick(float tick, int maxTicks) noexcept
+{
+    tick_ = tick;
+    maxTicks_ = maxTicks;
+}
+
+float FixedTimestep::alpha() const noexcept
+{
+    return static_cast<float>(accumulator_ / tick_);
+}
+
+} // namespace Time
@@ -0,0 +1,67 @@
+#ifndef HOMEWORK01_UTILS_TIME_FIXEDTIMESTEP_HPP_
+#define HOMEWORK01_UTILS_TIME_FIXEDTIMESTEP_HPP_
+
+#include <cstdint>
+
+namespace Time
+{
+
+/**
+ * @brief Accumulator turning frame times into a whole number of simulation
+ * ticks of a fixed length.
+ *
+ * @details Every frame adds its time with FixedTimestep::advance and
+ * simulates the ticks it returns, the remainder carries over to the next
+ * frame. The simulation then advances by the same steps whatever the frame
+ * rate, FixedTimestep::alpha is how far the frame lies between the last two
+ * simulated states for rendering them interpolated. After a slow frame at
+ * most FixedTimestep::maxTicks ticks are simulated and the rest of the
+ * backlog is dropped, so a frame too slow to catch up with the simulation
+ * does not make the next one slower still.
+ */
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(float tick = 1.0f / 60.0f, int maxTicks = 8);
+
+    /**
+     * @brief Add \a deltaTime seconds of frame time.
+     *
+     * @return Ticks to simulate this frame, at most FixedTimestep::maxTicks.
+     */
+    int advance(float deltaTime) noexcept;
+    /**
+     * @brief Drop the accumulated time, the next frame starts from a tick.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Set the length of a tick in seconds and the most ticks a frame
+     * simulates, the accumulated time is kept.
+     */
+    void setTick(float tick, int maxTicks) noexcept;
+    float tick() const noexcept { return tick_; }
+    int maxTicks() const noexcept { return maxTicks_; }
+
+    /**
+     * @brief Gets the fraction of a tick accumulated since the last one, in
+     * [0, 1).
+     */
+    float alpha() const noexcept;
+    // Ticks simulated by the last advance
+    int ticks() const noexcept { return ticks_; }
+    // Ticks dropped by the guard since construction
+    std::uint64_t droppedTicks() const noexcept { return droppedTicks_; }
+
+private:
+    float tick_;
+    int maxTicks_;
+    // Seconds not simulated yet, in double to stay exact over long runs
+    double accumulator_ = 0.0;
+    int ticks_ = 0;
+    std::uint64_t droppedTicks_ = 0;
+};
+
+} // namespace Time
+
+#endif // HOMEWORK01_UTILS_TIME_FIXEDTIMESTEP_HPP_